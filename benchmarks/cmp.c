@@ -118,5 +118,35 @@ int main (void)
 	}
 	timePrint ("natcmp");
 
+	// key name predicates on a deep hierarchy
+	Key * parent = keyNew ("user:/some/deep/hierarchy/with/many/parts/to/be/compared/with/each/other", KEY_END);
+	Key * child = keyDup (parent, KEY_CP_NAME);
+	keyAddBaseName (child, "child with a long basename, and only a bit different");
+	Key * grandchild = keyDup (child, KEY_CP_NAME);
+	keyAddBaseName (grandchild, "grandchild");
+
+	nrIterations /= 10;
+	timeInit ();
+	for (int i = 0; i < nrIterations; ++i)
+	{
+		res ^= keyIsBelow (parent, grandchild);
+	}
+	timePrint ("keyIsBelow");
+	for (int i = 0; i < nrIterations; ++i)
+	{
+		res ^= keyIsDirectlyBelow (parent, child);
+		res ^= keyIsDirectlyBelow (parent, grandchild);
+	}
+	timePrint ("keyIsDirectlyBelow");
+	for (int i = 0; i < nrIterations; ++i)
+	{
+		res ^= keyBaseName (child)[i % 8];
+	}
+	timePrint ("keyBaseName");
+
+	keyDel (grandchild);
+	keyDel (child);
+	keyDel (parent);
+
 	printf ("%d\n", res);
 }
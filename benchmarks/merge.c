@@ -0,0 +1,85 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the three-way merge of libelektra-merge
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <kdbmerge.h>
+
+#define MERGE_KEYS 100000
+
+/**
+ * Creates a key set with @p size keys below @p root.
+ *
+ * Every @p modify -th key gets the value @p value, all other keys the same value as in base.
+ * Every @p drop -th key is left out and @p size / @p drop keys are added at the end.
+ */
+static KeySet * createTree (const char * root, size_t size, size_t modify, const char * value, size_t drop)
+{
+	KeySet * ks = ksNew (size, KS_END);
+	char name[KEY_NAME_LENGTH];
+	char buffer[BUF_SIZ];
+
+	ksAppendKey (ks, keyNew (root, KEY_END));
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (drop != 0 && i % drop == 0) continue;
+
+		snprintf (name, sizeof (name), "%s/dir%zu/key%zu", root, i / 100, i);
+		if (modify != 0 && i % modify == 0)
+		{
+			snprintf (buffer, sizeof (buffer), "%s%zu", value, i);
+		}
+		else
+		{
+			snprintf (buffer, sizeof (buffer), "value%zu", i);
+		}
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, buffer, KEY_END));
+	}
+	for (size_t i = 0; drop != 0 && i < size / drop; ++i)
+	{
+		snprintf (name, sizeof (name), "%s/added/%s%zu", root, value, i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, value, KEY_END));
+	}
+	return ks;
+}
+
+int main (int argc, char ** argv)
+{
+	size_t size = MERGE_KEYS;
+	if (argc > 1)
+	{
+		size = strtoul (argv[1], NULL, 10);
+	}
+
+	timeInit ();
+	// every 15th key is modified on both sides with different values -> overlap conflicts
+	KeySet * base = createTree ("user:/base", size, 0, NULL, 0);
+	KeySet * ours = createTree ("user:/ours", size, 3, "ours", 7);
+	KeySet * theirs = createTree ("user:/theirs", size, 5, "theirs", 11);
+	timePrint ("Created trees");
+
+	Key * baseRoot = keyNew ("user:/base", KEY_END);
+	Key * ourRoot = keyNew ("user:/ours", KEY_END);
+	Key * theirRoot = keyNew ("user:/theirs", KEY_END);
+	Key * resultRoot = keyNew ("user:/result", KEY_END);
+	Key * informationKey = keyNew ("/", KEY_END);
+
+	KeySet * result = elektraMerge (ours, ourRoot, theirs, theirRoot, base, baseRoot, resultRoot, MERGE_STRATEGY_OUR, informationKey);
+	timePrint ("Merged trees");
+
+	printf ("%zd keys, %d conflicts\n", result == NULL ? -1 : ksGetSize (result), elektraMergeGetConflicts (informationKey));
+
+	ksDel (result);
+	keyDel (informationKey);
+	keyDel (resultRoot);
+	keyDel (theirRoot);
+	keyDel (ourRoot);
+	keyDel (baseRoot);
+	ksDel (theirs);
+	ksDel (ours);
+	ksDel (base);
+}
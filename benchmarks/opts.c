@@ -0,0 +1,95 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for elektraGetOpts with and without a precompiled specification
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <kdbopts.h>
+
+#define OPTS_KEYS 1000
+#define OPTS_RUNS 100
+
+#define SPEC_PARENT "spec:/benchmark/opts"
+
+/**
+ * Creates a specification with @p size keys, every key has a long option, an environment variable and a help text.
+ */
+static KeySet * createSpec (size_t size)
+{
+	KeySet * ks = ksNew (size + 1, keyNew (SPEC_PARENT, KEY_END), KS_END);
+	char name[KEY_NAME_LENGTH];
+	char option[64];
+	char env[64];
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		snprintf (name, sizeof (name), SPEC_PARENT "/key%zu", i);
+		snprintf (option, sizeof (option), "option%zu", i);
+		snprintf (env, sizeof (env), "ENV_%zu", i);
+		ksAppendKey (ks, keyNew (name, KEY_META, "opt/long", option, KEY_META, "env", env, KEY_META, "opt/help", "some help text",
+					 KEY_END));
+	}
+	return ks;
+}
+
+int main (int argc, char ** argv)
+{
+	size_t size = OPTS_KEYS;
+	if (argc > 1)
+	{
+		size = strtoul (argv[1], NULL, 10);
+	}
+
+	const char * args[] = { "benchmark", "--option1=value", "--option2", "value" };
+	const char * envp[] = { "ENV_3=value", NULL };
+
+	timeInit ();
+	KeySet * spec = createSpec (size);
+	timePrint ("Created spec");
+
+	for (int i = 0; i < OPTS_RUNS; ++i)
+	{
+		KeySet * ks = ksDup (spec);
+		Key * parentKey = keyNew (SPEC_PARENT, KEY_END);
+		elektraGetOpts (ks, 4, args, envp, parentKey);
+		keyDel (parentKey);
+		ksDel (ks);
+	}
+	timePrint ("elektraGetOpts");
+
+	KeySet * table = ksNew (0, KS_END);
+	Key * tableRoot = keyNew ("user:/benchmark/table", KEY_END);
+	Key * parentKey = keyNew (SPEC_PARENT, KEY_END);
+	elektraGetOptsPrecompile (spec, parentKey, table, tableRoot);
+	keyDel (parentKey);
+	timePrint ("elektraGetOptsPrecompile");
+
+	for (int i = 0; i < OPTS_RUNS; ++i)
+	{
+		KeySet * ks = ksDup (spec);
+		parentKey = keyNew (SPEC_PARENT, KEY_END);
+		elektraGetOptsPrecompiled (ks, table, tableRoot, 4, args, envp, parentKey);
+		keyDel (parentKey);
+		ksDel (ks);
+	}
+	timePrint ("elektraGetOptsPrecompiled");
+
+	ElektraOptsTable * decoded = elektraOptsTableNew (table, tableRoot);
+	for (int i = 0; i < OPTS_RUNS; ++i)
+	{
+		KeySet * ks = ksDup (spec);
+		parentKey = keyNew (SPEC_PARENT, KEY_END);
+		elektraGetOptsTable (ks, decoded, 4, args, envp, parentKey);
+		keyDel (parentKey);
+		ksDel (ks);
+	}
+	elektraOptsTableDel (decoded);
+	timePrint ("elektraGetOptsTable");
+
+	keyDel (tableRoot);
+	ksDel (table);
+	ksDel (spec);
+}
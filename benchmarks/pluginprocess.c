@@ -0,0 +1,112 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the transports of the pluginprocess library
+ *
+ * Measures the round-trip latency of a kdbGet call on a plugin executed in
+ * a child process for different KeySet sizes and transports.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <kdbpluginprocess.h>
+#include <kdbprivate.h>
+
+#define CSV_STR_FMT "%s;%zd;%d\n"
+#define ROUND_TRIPS 10
+
+static ElektraPluginProcessTransport transport;
+
+static int benchmarkOpen (Plugin * handle, Key * errorKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (pp == NULL)
+	{
+		if ((pp = elektraPluginProcessInitTransport (errorKey, transport)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
+		elektraPluginSetData (handle, pp);
+		if (!elektraPluginProcessIsParent (pp)) elektraPluginProcessStart (handle, pp);
+	}
+	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessOpen (pp, errorKey);
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+static int benchmarkClose (Plugin * handle, Key * errorKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (pp && elektraPluginProcessIsParent (pp))
+	{
+		ElektraPluginProcessCloseResult result = elektraPluginProcessClose (pp, errorKey);
+		if (result.cleanedUp) elektraPluginSetData (handle, NULL);
+		return result.result;
+	}
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+static int benchmarkGet (Plugin * handle, KeySet * returned, Key * parentKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessSend (pp, ELEKTRA_PLUGINPROCESS_GET, returned, parentKey);
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+static void benchmarkTransport (const char * transportName, KeySet * ks)
+{
+	struct _Plugin plugin;
+	memset (&plugin, 0, sizeof (plugin));
+	plugin.kdbOpen = &benchmarkOpen;
+	plugin.kdbClose = &benchmarkClose;
+	plugin.kdbGet = &benchmarkGet;
+	plugin.name = "benchmark";
+	plugin.refcounter = 1;
+
+	Key * parentKey = keyNew (KEY_ROOT, KEY_END);
+	// the child process must not inherit buffered output
+	fflush (stdout);
+	if (plugin.kdbOpen (&plugin, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+	{
+		fprintf (stderr, "error: could not start the plugin process for the %s transport\n", transportName);
+		keyDel (parentKey);
+		return;
+	}
+
+	timeInit ();
+	for (int i = 0; i < ROUND_TRIPS; ++i)
+	{
+		if (plugin.kdbGet (&plugin, ks, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+		{
+			fprintf (stderr, "error: kdbGet failed for the %s transport\n", transportName);
+			break;
+		}
+	}
+	fprintf (stdout, CSV_STR_FMT, transportName, ksGetSize (ks), timeGetDiffMicroseconds () / ROUND_TRIPS);
+
+	plugin.kdbClose (&plugin, parentKey);
+	keyDel (parentKey);
+}
+
+int main (void)
+{
+	fprintf (stdout, "%s;%s;%s\n", "transport", "keys", "microseconds per round trip");
+
+	benchmarkCreate ();
+	benchmarkFillup ();
+
+	for (elektraCursor size = 10; size <= ksGetSize (large); size *= 10)
+	{
+		KeySet * part = ksNew (size, KS_END);
+		for (elektraCursor i = 0; i < size; ++i)
+		{
+			ksAppendKey (part, ksAtCursor (large, i));
+		}
+
+		transport = ELEKTRA_PLUGINPROCESS_TRANSPORT_DUMP;
+		benchmarkTransport ("dump", part);
+		transport = ELEKTRA_PLUGINPROCESS_TRANSPORT_SHM;
+		benchmarkTransport ("shm", part);
+
+		ksDel (part);
+	}
+
+	ksDel (large);
+}
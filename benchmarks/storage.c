@@ -14,12 +14,15 @@
 
 #define CSV_STR_FMT "%s;%s;%d\n"
 
-#define NUM_PLUGINS 4
+#define NUM_PLUGINS 5
 #define NUM_RUNS 7
 
 KeySet * modules[NUM_PLUGINS];
 Plugin * plugins[NUM_PLUGINS];
-char * pluginNames[NUM_PLUGINS] = { "dump", "mmapstorage_crc", "mmapstorage", "quickdump" };
+char * pluginNames[NUM_PLUGINS] = { "dump", "mmapstorage_crc", "mmapstorage", "quickdump", "quickdump" };
+// value of the /version config of quickdump, NULL for the default
+char * pluginVersions[NUM_PLUGINS] = { NULL, NULL, NULL, "3", "4" };
+char * pluginLabels[NUM_PLUGINS] = { "dump", "mmapstorage_crc", "mmapstorage", "quickdump_v3", "quickdump_v4" };
 
 static void benchmarkDel (void)
 {
@@ -33,6 +36,10 @@ static int benchmarkOpenPlugins (void)
 		modules[i] = ksNew (0, KS_END);
 		elektraModulesInit (modules[i], 0);
 		KeySet * conf = ksNew (0, KS_END);
+		if (pluginVersions[i] != NULL)
+		{
+			ksAppendKey (conf, keyNew ("user:/version", KEY_VALUE, pluginVersions[i], KEY_END));
+		}
 		Key * errorKey = keyNew ("/", KEY_END);
 		Plugin * plugin = elektraPluginOpen (pluginNames[i], modules[i], conf, errorKey);
 
@@ -117,54 +124,54 @@ int main (int argc, char ** argv)
 			timeInit ();
 			if (plugin->kdbSet (plugin, large, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
 			{
-				printf ("Error writing with plugin: %s\n", pluginNames[i]);
+				printf ("Error writing with plugin: %s\n", pluginLabels[i]);
 				return -1;
 			}
-			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "write keyset", timeGetDiffMicroseconds ());
+			fprintf (stdout, CSV_STR_FMT, pluginLabels[i], "write keyset", timeGetDiffMicroseconds ());
 
 			KeySet * returned = ksNew (0, KS_END);
 			if (plugin->kdbGet (plugin, returned, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
 			{
-				printf ("Error reading with plugin: %s\n", pluginNames[i]);
+				printf ("Error reading with plugin: %s\n", pluginLabels[i]);
 				return -1;
 			}
-			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "read keyset", timeGetDiffMicroseconds ());
+			fprintf (stdout, CSV_STR_FMT, pluginLabels[i], "read keyset", timeGetDiffMicroseconds ());
 			benchmarkIterate (returned);
-			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "iterate keyset", timeGetDiffMicroseconds ());
+			fprintf (stdout, CSV_STR_FMT, pluginLabels[i], "iterate keyset", timeGetDiffMicroseconds ());
 			ksDel (returned);
-			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "delete keyset", timeGetDiffMicroseconds ());
+			fprintf (stdout, CSV_STR_FMT, pluginLabels[i], "delete keyset", timeGetDiffMicroseconds ());
 
 			KeySet * returned2 = ksNew (0, KS_END);
 			if (plugin->kdbGet (plugin, returned2, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
 			{
-				printf ("Error reading with plugin: %s\n", pluginNames[i]);
+				printf ("Error reading with plugin: %s\n", pluginLabels[i]);
 				return -1;
 			}
-			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "re-read keyset", timeGetDiffMicroseconds ());
+			fprintf (stdout, CSV_STR_FMT, pluginLabels[i], "re-read keyset", timeGetDiffMicroseconds ());
 			ksDel (returned2);
 			timeInit ();
 
 			KeySet * returned3 = ksNew (0, KS_END);
 			if (plugin->kdbGet (plugin, returned3, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
 			{
-				printf ("Error reading with plugin: %s\n", pluginNames[i]);
+				printf ("Error reading with plugin: %s\n", pluginLabels[i]);
 				return -1;
 			}
 			timeInit ();
 			benchmarkIterateName (returned3);
-			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "strcmp key name", timeGetDiffMicroseconds ());
+			fprintf (stdout, CSV_STR_FMT, pluginLabels[i], "strcmp key name", timeGetDiffMicroseconds ());
 			ksDel (returned3);
 			timeInit ();
 
 			KeySet * returned4 = ksNew (0, KS_END);
 			if (plugin->kdbGet (plugin, returned4, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
 			{
-				printf ("Error reading with plugin: %s\n", pluginNames[i]);
+				printf ("Error reading with plugin: %s\n", pluginLabels[i]);
 				return -1;
 			}
 			timeInit ();
 			benchmarkIterateValue (returned4);
-			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "strcmp key value", timeGetDiffMicroseconds ());
+			fprintf (stdout, CSV_STR_FMT, pluginLabels[i], "strcmp key value", timeGetDiffMicroseconds ());
 			ksDel (returned4);
 			timeInit ();
 		}
@@ -771,6 +771,9 @@ function (generate_readme p) # rerun cmake when README.md is changed  also allow
 	string (REGEX
 		REPLACE "\"- +infos/metadata *= *([/#a-zA-Z0-9 ]*)\\\\n\""
 			"keyNew(\"system:/elektra/modules/${p}/infos/metadata\",\nKEY_VALUE, \"\\1\", KEY_END)," contents "${contents}")
+	string (REGEX
+		REPLACE "\"- +infos/concurrency *= *([a-zA-Z0-9 ]*)\\\\n\""
+			"keyNew(\"system:/elektra/modules/${p}/infos/concurrency\",\nKEY_VALUE, \"\\1\", KEY_END)," contents "${contents}")
 	string (REGEX
 		REPLACE "\"- +infos/plugins *= *([a-zA-Z0-9 ]*)\\\\n\""
 			"keyNew(\"system:/elektra/modules/${p}/infos/plugins\",\nKEY_VALUE, \"\\1\", KEY_END)," contents "${contents}")
@@ -7,6 +7,10 @@
 #include <elektra/gelektra-key.h>
 #include <elektra/gelektra-keyset.h>
 
+#include <kdbhelper.h>
+#include <kdbio.h>
+#include <kdbio/glib.h>
+
 #undef G_LOG_DOMAIN
 #define G_LOG_DOMAIN "ElektraSettings"
 
@@ -36,6 +40,11 @@ typedef struct
 	GElektraKeySet * gks_user;
 	GElektraKeySet * gks_system;
 
+	/* pending writes to gks_user are flushed from an idle callback */
+	ElektraIoInterface * io_binding;
+	ElektraIoIdleOperation * sync_idle;
+	gboolean dirty;
+
 	GElektraKeySet * subscription_gks_keys;
 	GElektraKeySet * subscription_gks_paths;
 
@@ -90,6 +99,14 @@ static void elektra_settings_backend_sync (GSettingsBackend * backend)
 	// TODO: use three-way merge when ready
 	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) backend;
 
+	if (!esb->dirty)
+	{
+		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s\n", "Nothing to sync");
+		return;
+	}
+	esb->dirty = FALSE;
+	elektraIoBindingRemoveIdle (esb->sync_idle);
+
 	if (gelektra_kdb_set (esb->gkdb, esb->gks_user, esb->gkey_user) == -1 ||
 	    gelektra_kdb_get (esb->gkdb, esb->gks_user, esb->gkey_user) == -1)
 	{
@@ -99,11 +116,64 @@ static void elektra_settings_backend_sync (GSettingsBackend * backend)
 	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s\n", "Sync state");
 }
 
-static GVariant * elektra_settings_read_string (GElektraKdb * kdb, GElektraKeySet * ks, GElektraKey * parentKey, gchar * keypathname,
-						const GVariantType * expected_type)
+/* < private >
+ * elektra_settings_sync_idle:
+ * @idleOp: the idle operation of the backend
+ *
+ * Writes all changes made since the last main loop iteration with a single kdbSet.
+ */
+static void elektra_settings_sync_idle (ElektraIoIdleOperation * idleOp)
+{
+	elektra_settings_backend_sync ((GSettingsBackend *) elektraIoIdleGetData (idleOp));
+}
+
+/* < private >
+ * elektra_settings_schedule_sync:
+ * @esb: the backend with pending changes in its user keyset
+ *
+ * Marks the user keyset as modified and defers the sync to the next idle main loop iteration.
+ */
+static void elektra_settings_schedule_sync (ElektraSettingsBackend * esb)
+{
+	if (esb->dirty)
+	{
+		return;
+	}
+	esb->dirty = TRUE;
+	// the idle source is only attached while changes are pending, glib would dispatch it on every iteration otherwise
+	elektraIoBindingAddIdle (esb->io_binding, esb->sync_idle);
+}
+
+/* < private >
+ * elektra_settings_refresh:
+ * @esb: the backend
+ * @keypathname: the name of the key that was changed in Elektra
+ *
+ * Updates the cached keyset the changed key belongs to.
+ * Pending writes are flushed first, so they are not lost by the kdbGet.
+ */
+static void elektra_settings_refresh (ElektraSettingsBackend * esb, const gchar * keypathname)
+{
+	if (!g_str_has_prefix (keypathname, G_ELEKTRA_SETTINGS_USER))
+	{
+		gelektra_kdb_get (esb->gkdb, esb->gks_system, esb->gkey_system);
+	}
+	if (!g_str_has_prefix (keypathname, G_ELEKTRA_SETTINGS_SYSTEM))
+	{
+		if (esb->dirty)
+		{
+			elektra_settings_backend_sync ((GSettingsBackend *) esb);
+		}
+		else
+		{
+			gelektra_kdb_get (esb->gkdb, esb->gks_user, esb->gkey_user);
+		}
+	}
+}
+
+static GVariant * elektra_settings_read_string (GElektraKeySet * ks, gchar * keypathname, const GVariantType * expected_type)
 {
-	gelektra_kdb_get (kdb, ks, parentKey);
-	/* Lookup the requested key */
+	/* Lookup the requested key in the cached keyset, it is updated on change notifications */
 	GElektraKey * gkey = gelektra_keyset_lookup_byname (ks, keypathname, GELEKTRA_KDB_O_NONE);
 	/* free the passed path string */
 	g_free (keypathname);
@@ -201,12 +271,12 @@ static GVariant * elektra_settings_backend_read (GSettingsBackend * backend, con
 	if (default_value)
 	{
 		gchar * path = g_strconcat (G_ELEKTRA_SETTINGS_SYSTEM, G_ELEKTRA_SETTINGS_PATH, key, NULL);
-		ret = elektra_settings_read_string (esb->gkdb, esb->gks_system, esb->gkey_system, path, expected_type);
+		ret = elektra_settings_read_string (esb->gks_system, path, expected_type);
 	}
 	else
 	{
 		gchar * path = g_strconcat (G_ELEKTRA_SETTINGS_USER, G_ELEKTRA_SETTINGS_PATH, key, NULL);
-		ret = elektra_settings_read_string (esb->gkdb, esb->gks_user, esb->gkey_user, path, expected_type);
+		ret = elektra_settings_read_string (esb->gks_user, path, expected_type);
 	}
 
 	return ret;
@@ -234,7 +304,7 @@ static GVariant * elektra_settings_backend_read_user_value (GSettingsBackend * b
 
 	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) backend;
 	gchar * path = g_strconcat (G_ELEKTRA_SETTINGS_USER, G_ELEKTRA_SETTINGS_PATH, key, NULL);
-	GVariant * ret = elektra_settings_read_string (esb->gkdb, esb->gks_user, esb->gkey_user, path, expected_type);
+	GVariant * ret = elektra_settings_read_string (esb->gks_user, path, expected_type);
 
 	return ret;
 }
@@ -266,7 +336,7 @@ static gboolean elektra_settings_backend_write (GSettingsBackend * backend, cons
 	gboolean ret =
 		elektra_settings_write_string (backend, g_strconcat (G_ELEKTRA_SETTINGS_USER, G_ELEKTRA_SETTINGS_PATH, key, NULL), value);
 
-	elektra_settings_backend_sync (backend);
+	elektra_settings_schedule_sync ((ElektraSettingsBackend *) backend);
 
 	// Notify GSettings that the key has changed
 	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s: %s", "Calling g_settings_backend_changed, Key", key);
@@ -345,7 +415,7 @@ static gboolean elektra_settings_backend_write_tree (GSettingsBackend * backend,
 	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s.", "Function writeTree. ", "We have to loop the tree and add the keys");
 	g_tree_foreach (tree, elektra_settings_keyset_from_tree, esb->gks_user);
 
-	elektra_settings_backend_sync (backend);
+	elektra_settings_schedule_sync (esb);
 
 	/* Notify the GSettings about the changed tree */
 	g_settings_backend_changed_tree (G_SETTINGS_BACKEND (backend), tree, origin_tag);
@@ -373,6 +443,7 @@ static void elektra_settings_backend_reset (GSettingsBackend * backend, const gc
 	if (gkey != NULL)
 	{
 		gelektra_keyset_lookup (esb->gks_user, gkey, GELEKTRA_KDB_O_POP);
+		elektra_settings_schedule_sync (esb);
 		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s: %s.", "Key found and value reset", key);
 		g_settings_backend_changed (G_SETTINGS_BACKEND (backend), key, origin_tag);
 	}
@@ -434,6 +505,9 @@ static void elektra_settings_key_changed (GDBusConnection * connection G_GNUC_UN
 	// we do not expect paths here
 	g_assert (!g_str_has_suffix (keypathname, "/"));
 
+	// changed values must be visible to the signal callbacks
+	elektra_settings_refresh (esb, keypathname);
+
 	GElektraKey * gkey = gelektra_keyset_lookup_byname (gks_keys, keypathname, GELEKTRA_KDB_O_NONE);
 	int found = 0;
 	if (gkey)
@@ -617,6 +691,9 @@ static void elektra_settings_backend_init (ElektraSettingsBackend * esb)
 	esb->subscription_gks_paths = gelektra_keyset_new (0, GELEKTRA_KEYSET_END);
 	gelektra_kdb_get (esb->gkdb, esb->gks_user, esb->gkey_user);
 	gelektra_kdb_get (esb->gkdb, esb->gks_system, esb->gkey_system);
+	esb->dirty = FALSE;
+	esb->io_binding = elektraIoGlibNew (NULL);
+	esb->sync_idle = elektraIoNewIdleOperation (1, elektra_settings_sync_idle, esb);
 	elektra_settings_check_bus_connection (esb);
 }
 
@@ -627,6 +704,9 @@ static void elektra_settings_backend_finalize (GObject * object)
 {
 	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Finalize ElektraSettingsBackend");
 	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) object;
+	elektra_settings_backend_sync ((GSettingsBackend *) esb);
+	elektraFree (esb->sync_idle);
+	elektraIoBindingCleanup (esb->io_binding);
 	gelektra_kdb_close (esb->gkdb, esb->gkey_error);
 	// TODO error handling
 	G_OBJECT_CLASS (elektra_settings_backend_parent_class)->finalize (object);
@@ -1 +1,2 @@
-#include "kdb.h"
\ No newline at end of file
+#include "kdb.h"
+#include "kdbproposal.h"
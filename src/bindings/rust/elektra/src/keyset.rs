@@ -54,7 +54,10 @@
 
 use crate::{ReadOnly, ReadableKey, StringKey, WriteableKey};
 use bitflags::bitflags;
+use std::collections::HashMap;
 use std::convert::TryInto;
+use std::mem::size_of;
+use std::ops::Range;
 
 /// A set of StringKeys.
 #[derive(Debug)]
@@ -388,6 +391,134 @@ impl KeySet {
         None
     }
 
+    /// Serializes the keys in `range` into a single buffer with one call into libelektra.
+    /// The layout of the buffer is described by `elektra_sys::ElektraKsFlatHeader`.
+    /// Returns None if the range is invalid.
+    pub fn export_flat(&self, range: Range<Cursor>) -> Option<Vec<u8>> {
+        let size = unsafe { elektra_sys::elektraKsFlatSize(self.as_ref(), range.start, range.end) };
+        if size == 0 {
+            return None;
+        }
+        let mut buffer = vec![0u8; size];
+        let written = unsafe {
+            elektra_sys::elektraKsFlatExport(
+                self.as_ref(),
+                range.start,
+                range.end,
+                buffer.as_mut_ptr() as *mut std::ffi::c_void,
+                size,
+            )
+        };
+        if written == size {
+            Some(buffer)
+        } else {
+            None
+        }
+    }
+
+    /// Appends all keys of a buffer created by [`export_flat`](#method.export_flat)
+    /// with one call into libelektra.
+    /// Returns the number of keys read or None if the buffer is invalid.
+    pub fn import_flat(&mut self, buffer: &[u8]) -> Option<usize> {
+        let ret = unsafe {
+            elektra_sys::elektraKsFlatImport(
+                self.as_ptr(),
+                buffer.as_ptr() as *const std::ffi::c_void,
+                buffer.len(),
+            )
+        };
+        ret.try_into().ok()
+    }
+
+    /// Returns the names and values of all keys with string values.
+    /// Binary keys and metadata are skipped.
+    /// Uses a single call into libelektra instead of one per key.
+    ///
+    /// # Examples
+    /// ```
+    /// # use elektra::{KeySet, StringKey, WriteableKey, keyset};
+    /// # fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let mut key = StringKey::new("user:/sw/app/host")?;
+    /// key.set_value("localhost");
+    /// let ks = keyset![key];
+    /// assert_eq!(ks.to_map()["user:/sw/app/host"], "localhost");
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub fn to_map(&self) -> HashMap<String, String> {
+        let buffer = self
+            .export_flat(0..self.size().try_into().unwrap())
+            .expect("elektraKsFlatExport: Out of memory");
+        let field = |index: usize| {
+            let start = index * size_of::<u64>();
+            u64::from_ne_bytes(buffer[start..start + size_of::<u64>()].try_into().unwrap()) as usize
+        };
+        let string = |offset: usize, size: usize| {
+            String::from_utf8_lossy(&buffer[offset..offset + size]).into_owned()
+        };
+
+        let header_fields = size_of::<elektra_sys::ElektraKsFlatHeader>() / size_of::<u64>();
+        let key_fields = size_of::<elektra_sys::ElektraKsFlatKey>() / size_of::<u64>();
+        let mut map = HashMap::with_capacity(field(1));
+        for i in 0..field(1) {
+            let entry = header_fields + i * key_fields;
+            if field(entry + 4) as u64 & elektra_sys::ELEKTRA_KS_FLAT_BINARY as u64 == 0 {
+                map.insert(
+                    string(field(entry), field(entry + 1)),
+                    string(field(entry + 2), field(entry + 3)),
+                );
+            }
+        }
+        map
+    }
+
+    /// Appends string keys for all names and values with one call into libelektra.
+    /// Returns the number of keys read or None if one of the names is invalid.
+    ///
+    /// # Examples
+    /// ```
+    /// # use elektra::KeySet;
+    /// let mut ks = KeySet::new();
+    /// ks.append_map(vec![("user:/sw/app/host", "localhost"), ("user:/sw/app/port", "8080")]);
+    /// assert_eq!(ks.size(), 2);
+    /// ```
+    pub fn append_map<K: AsRef<str>, V: AsRef<str>>(
+        &mut self,
+        values: impl IntoIterator<Item = (K, V)>,
+    ) -> Option<usize> {
+        let values: Vec<(K, V)> = values.into_iter().collect();
+        let offset = size_of::<elektra_sys::ElektraKsFlatHeader>()
+            + values.len() * size_of::<elektra_sys::ElektraKsFlatKey>();
+        let mut entries = Vec::with_capacity(offset);
+        let mut data = Vec::new();
+        for (name, value) in &values {
+            let (name, value) = (name.as_ref().as_bytes(), value.as_ref().as_bytes());
+            let name_offset = offset + data.len();
+            data.extend_from_slice(name);
+            data.push(0);
+            let value_offset = offset + data.len();
+            data.extend_from_slice(value);
+            data.push(0);
+            for field in &[name_offset, name.len(), value_offset, value.len(), 0, 0, 0] {
+                entries.extend_from_slice(&(*field as u64).to_ne_bytes());
+            }
+        }
+
+        let mut buffer = Vec::with_capacity(offset + data.len());
+        let header = [
+            elektra_sys::ELEKTRA_KS_FLAT_MAGIC as u64,
+            values.len() as u64,
+            0,
+            (offset + data.len()) as u64,
+        ];
+        for field in &header {
+            buffer.extend_from_slice(&field.to_ne_bytes());
+        }
+        buffer.append(&mut entries);
+        buffer.append(&mut data);
+        self.import_flat(&buffer)
+    }
+
     /// Returns an iterator that should be used to immutably iterate over a keyset.
     pub fn iter(&self) -> ReadOnlyStringKeyIter<'_> {
         ReadOnlyStringKeyIter {
@@ -482,7 +613,7 @@ impl<'a> Iterator for StringKeyIter<'a> {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use crate::{KeyBuilder, KeyNameInvalidError, CopyOption};
+    use crate::{CopyOption, KeyBuilder, KeyNameInvalidError};
     use std::iter::FromIterator;
 
     #[test]
@@ -653,6 +784,38 @@ mod tests {
         Ok(())
     }
 
+    #[test]
+    fn can_convert_flat_keyset() {
+        let mut ks = setup_keyset();
+        let buffer = ks.export_flat(0..2).unwrap();
+        assert!(ks.export_flat(1..3).is_none());
+
+        let mut imported = KeySet::new();
+        assert_eq!(imported.import_flat(&buffer), Some(2));
+        assert_eq!(imported.head().unwrap().name(), "user:/test/key");
+        assert_eq!(imported.tail().unwrap().value(), "value1");
+        assert_eq!(imported.import_flat(&buffer[1..]), None);
+
+        let map = ks.to_map();
+        assert_eq!(map.len(), 2);
+        assert_eq!(map["system:/test/key"], "value1");
+        assert_eq!(map["user:/test/key"], "value2");
+
+        assert_eq!(
+            ks.append_map(vec![("user:/test/b", "b"), ("user:/test/a", "a")]),
+            Some(2)
+        );
+        assert_eq!(ks.size(), 4);
+        assert_eq!(
+            ks.lookup_by_name("user:/test/a", LookupOption::KDB_O_NONE)
+                .unwrap()
+                .value(),
+            "a"
+        );
+        assert_eq!(ks.append_map(vec![("invalid", "name")]), None);
+        assert_eq!(ks.size(), 4);
+    }
+
     #[test]
     fn test_keyset_macro() {
         let ks = keyset![];
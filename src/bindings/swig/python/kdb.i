@@ -38,6 +38,7 @@ ckdb::_Key * ksAt (ckdb::_KeySet * ks, ssize_t pos) {
 %pythoncode {
   import warnings
   import collections
+  import struct
 }
 
 %exceptionclass kdb::Exception;
@@ -381,7 +382,95 @@ ckdb::_Key * ksAt (ckdb::_KeySet * ks, ssize_t pos) {
 %fragment("SwigPyIterator_T");
 %traits_swigtype(kdb::Key);
 %fragment(SWIG_Traits_frag(kdb::Key));
+/*
+ * flat keysets, see kdbproposal.h for the layout
+ */
+%{
+  extern "C" {
+    #include "kdbproposal.h"
+  }
+%}
+
+%constant unsigned long long KS_FLAT_MAGIC = ELEKTRA_KS_FLAT_MAGIC;
+%constant unsigned long long KS_FLAT_BINARY = ELEKTRA_KS_FLAT_BINARY;
+
+%typemap(in) (const void *flatBuffer, size_t flatSize) {
+  Py_ssize_t len;
+  if (PyBytes_AsStringAndSize($input, reinterpret_cast<char **>(&$1), &len) == -1)
+    return NULL;
+  $2 = len;
+}
+
 %extend kdb::KeySet {
+  PyObject *_exportFlat(ssize_t start, ssize_t end) {
+    size_t size = ckdb::elektraKsFlatSize($self->getKeySet(), start, end);
+    if (size == 0) {
+      PyErr_SetString(PyExc_IndexError, "invalid range");
+      return NULL;
+    }
+    PyObject *buffer = PyBytes_FromStringAndSize(NULL, size);
+    if (buffer)
+      ckdb::elektraKsFlatExport($self->getKeySet(), start, end, PyBytes_AS_STRING(buffer), size);
+    return buffer;
+  }
+
+  ssize_t _importFlat(const void *flatBuffer, size_t flatSize) {
+    return ckdb::elektraKsFlatImport($self->getKeySet(), flatBuffer, flatSize);
+  }
+
+  %pythoncode %{
+    _FLAT_HEADER = struct.Struct("=4Q")
+    _FLAT_KEY = struct.Struct("=7Q")
+
+    def export_flat(self, start = 0, end = None):
+      """Serialize the keys from start to end (default: all keys) into one
+      bytes object with a single call into libelektra.
+      See kdbproposal.h for the layout.
+      """
+      return self._exportFlat(start, len(self) if end is None else end)
+
+    def import_flat(self, buffer):
+      """Append all keys of a flat keyset, e.g. from export_flat.
+      Returns the number of keys appended, raises a ValueError if the buffer is invalid.
+      """
+      ret = self._importFlat(bytes(buffer))
+      if ret < 0:
+        raise ValueError("invalid flat keyset")
+      return ret
+
+    def to_dict(self, start = 0, end = None):
+      """Return a dict mapping the names of the keys from start to end to their values.
+      String values are returned as str, binary values as bytes. Metadata is not included.
+      """
+      buffer = self.export_flat(start, end)
+      count = KeySet._FLAT_HEADER.unpack_from(buffer)[1]
+      fields = memoryview(buffer)[KeySet._FLAT_HEADER.size:KeySet._FLAT_HEADER.size + count * KeySet._FLAT_KEY.size].cast("Q")
+      result = {}
+      for i in range(0, len(fields), 7):
+        name = buffer[fields[i]:fields[i] + fields[i + 1]].decode()
+        value = buffer[fields[i + 2]:fields[i + 2] + fields[i + 3]]
+        result[name] = value if fields[i + 4] & KS_FLAT_BINARY else value.decode()
+      return result
+
+    def update(self, values):
+      """Append keys for all items of a dict mapping key names to values
+      with a single call into libelektra. Values of type bytes create binary keys,
+      all other values are converted with str. Returns the number of keys appended.
+      """
+      offset = KeySet._FLAT_HEADER.size + len(values) * KeySet._FLAT_KEY.size
+      entries = []
+      data = bytearray()
+      for name, value in values.items():
+        binary = isinstance(value, bytes)
+        name = name.encode()
+        value = value if binary else str(value).encode()
+        entries.append(KeySet._FLAT_KEY.pack(offset + len(data), len(name),
+          offset + len(data) + len(name) + 1, len(value), KS_FLAT_BINARY if binary else 0, 0, 0))
+        data += name + b"\0" + value + b"\0"
+      header = KeySet._FLAT_HEADER.pack(KS_FLAT_MAGIC, len(entries), 0, offset + len(data))
+      return self.import_flat(header + b"".join(entries) + data)
+  %}
+
   swig::SwigPyIterator* __iter__(PyObject **PYTHON_SELF) {
     return swig::make_output_iterator(self->begin(), self->begin(),
       self->end(), *PYTHON_SELF);
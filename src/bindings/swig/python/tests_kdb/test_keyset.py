@@ -169,5 +169,28 @@ class KeySet(unittest.TestCase):
 		self.assertEqual(self.ks.unpack_basenames(), set([ 'key1', 'key2', 'key3', 'key4' ]))
 		self.assertEqual(self.ks.filter_below(kdb.Key('user:/')), kdb.KeySet(2, self.ks[0], self.ks[1]))
 
+	def test_flat(self):
+		self.ks.append(kdb.Key("user:/binary", b"\x00\x01"))
+		self.ks["user:/key3"].value = "value3"
+		self.assertEqual(self.ks.to_dict(), {
+			'user:/binary': b'\x00\x01', 'user:/key3': 'value3', 'user:/key4': '',
+			'system:/key1': '', 'system:/key2': '' })
+		self.assertEqual(self.ks.to_dict(1, 3), { 'user:/key3': 'value3', 'user:/key4': '' })
+		with self.assertRaises(IndexError):
+			self.ks.to_dict(3, 1)
+
+		ks = kdb.KeySet(0)
+		self.assertEqual(ks.import_flat(self.ks.export_flat()), len(self.ks))
+		self.assertTrue(ks == self.ks)
+		self.assertTrue(ks["user:/binary"].isBinary())
+		with self.assertRaises(ValueError):
+			ks.import_flat(b"invalid")
+
+		ks = kdb.KeySet(0)
+		self.assertEqual(ks.update({ "user:/b": "b", "user:/a": 1, "user:/bin": b"\x00" }), 3)
+		self.assertEqual(ks.unpack_names(), set([ 'user:/a', 'user:/b', 'user:/bin' ]))
+		self.assertEqual(ks["user:/a"].value, "1")
+		self.assertEqual(ks["user:/bin"].value, b"\x00")
+
 if __name__ == '__main__':
 	unittest.main()
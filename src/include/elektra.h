@@ -18,6 +18,7 @@
 // region Helpers for Code Generation
 #define ELEKTRA_GET(typeName) ELEKTRA_CONCAT (elektraGet, typeName)
 #define ELEKTRA_GET_ARRAY_ELEMENT(typeName) ELEKTRA_CONCAT (ELEKTRA_CONCAT (elektraGet, typeName), ArrayElement)
+#define ELEKTRA_GET_BY_HANDLE(typeName) ELEKTRA_CONCAT (ELEKTRA_CONCAT (elektraGet, typeName), ByHandle)
 #define ELEKTRA_SET(typeName) ELEKTRA_CONCAT (elektraSet, typeName)
 #define ELEKTRA_SET_ARRAY_ELEMENT(typeName) ELEKTRA_CONCAT (ELEKTRA_CONCAT (elektraSet, typeName), ArrayElement)
 
@@ -55,6 +56,36 @@ extern "C" {
 
 typedef struct _Elektra Elektra;
 
+/**
+ * A reference to a key of an Elektra instance that is resolved only once.
+ *
+ * Use #ELEKTRA_KEY_HANDLE_INIT to initialize handles (typically as static const variables)
+ * and never change the fields directly. The handle itself is never modified, the key it
+ * was resolved to is stored in the Elektra instance. The lookup is only repeated, if the
+ * Elektra instance changed in the meantime.
+ *
+ * @see elektraResolveKeyHandle
+ */
+typedef struct _ElektraKeyHandle
+{
+	size_t index;
+	const char * name;
+	KDBType type;
+} ElektraKeyHandle;
+
+/**
+ * Initializer for an #ElektraKeyHandle.
+ *
+ * @param index   The slot used for this handle in the table of each Elektra instance.
+ *                Handles used with the same instance should have distinct indices.
+ * @param keyname The name of the key relative to the parent key as string literal.
+ * @param type    The expected type of the key as string literal (e.g. "long").
+ */
+#define ELEKTRA_KEY_HANDLE_INIT(index, keyname, type)                                                                                      \
+	{                                                                                                                                  \
+		(index), (keyname), (type)                                                                                                 \
+	}
+
 // region Basics
 /**************************************
  *
@@ -91,6 +122,8 @@ Key * elektraFindKey (Elektra * elektra, const char * name, KDBType type);
 Key * elektraFindArrayElementKey (Elektra * elektra, const char * name, kdb_long_long_t index, KDBType type);
 void elektraFatalError (Elektra * elektra, ElektraError * fatalError);
 
+Key * elektraResolveKeyHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+
 const char * elektraFindReference (Elektra * elektra, const char * name);
 const char * elektraFindReferenceArrayElement (Elektra * elektra, const char * name, kdb_long_long_t index);
 
@@ -125,6 +158,25 @@ kdb_long_double_t elektraGetLongDouble (Elektra * elektra, const char * keyname)
 
 #endif
 
+const char * elektraGetStringByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_boolean_t elektraGetBooleanByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_char_t elektraGetCharByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_octet_t elektraGetOctetByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_short_t elektraGetShortByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_unsigned_short_t elektraGetUnsignedShortByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_long_t elektraGetLongByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_unsigned_long_t elektraGetUnsignedLongByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_long_long_t elektraGetLongLongByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_unsigned_long_long_t elektraGetUnsignedLongLongByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_float_t elektraGetFloatByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+kdb_double_t elektraGetDoubleByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+kdb_long_double_t elektraGetLongDoubleByHandle (Elektra * elektra, const ElektraKeyHandle * handle);
+
+#endif
+
 // endregion Getters
 
 // region Setters
@@ -21,6 +21,16 @@ extern "C" {
 int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** envp, Key * parentKey);
 char * elektraGetOptsHelpMessage (Key * helpKey, const char * usage, const char * prefix);
 
+int elektraGetOptsPrecompile (KeySet * ks, Key * parentKey, KeySet * table, const Key * tableRoot);
+int elektraGetOptsPrecompiled (KeySet * ks, KeySet * table, const Key * tableRoot, int argc, const char ** argv, const char ** envp,
+			       Key * parentKey);
+
+typedef struct _ElektraOptsTable ElektraOptsTable;
+
+ElektraOptsTable * elektraOptsTableNew (KeySet * table, const Key * tableRoot);
+int elektraGetOptsTable (KeySet * ks, ElektraOptsTable * table, int argc, const char ** argv, const char ** envp, Key * parentKey);
+void elektraOptsTableDel (ElektraOptsTable * table);
+
 #ifdef __cplusplus
 }
 }
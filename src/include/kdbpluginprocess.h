@@ -31,6 +31,15 @@ ELEKTRA_PLUGINPROCESS_END=0			/*!< End of arguments */
 	// clang-format on
 } pluginprocess_t;
 
+/**
+ * Transports for the communication between the parent and the child process.
+ */
+typedef enum
+{
+	ELEKTRA_PLUGINPROCESS_TRANSPORT_SHM = 0, /*!< Binary KeySets in a shared memory segment, control messages via pipes (default) */
+	ELEKTRA_PLUGINPROCESS_TRANSPORT_DUMP,	 /*!< KeySets serialized by the dump plugin via pipes */
+} ElektraPluginProcessTransport;
+
 typedef struct _ElektraPluginProcess ElektraPluginProcess;
 
 typedef struct ElektraPluginProcessCloseResult
@@ -39,6 +48,7 @@ typedef struct ElektraPluginProcessCloseResult
 } ElektraPluginProcessCloseResult;
 
 ElektraPluginProcess * elektraPluginProcessInit (Key *);
+ElektraPluginProcess * elektraPluginProcessInitTransport (Key *, ElektraPluginProcessTransport);
 void elektraPluginProcessStart (Plugin *, ElektraPluginProcess *);
 
 int elektraPluginProcessOpen (ElektraPluginProcess *, Key *);
@@ -25,6 +25,7 @@
 #endif
 
 #include <limits.h>
+#include <string.h>
 
 /** The minimal allocation size of a keyset inclusive
 	NULL byte. ksGetAlloc() will return one less because
@@ -101,6 +102,25 @@ typedef int (*kdbHookSendNotificationSetPtr) (Plugin * handle, KeySet * returned
 typedef Plugin * (*OpenMapper) (const char *, const char *, KeySet *);
 typedef int (*CloseMapper) (Plugin *);
 
+/**
+ * Types of decoded values, which can be cached in struct _KeyData.
+ *
+ * @see keyDataGetCachedValue(), keyDataSetCachedValue()
+ */
+typedef enum
+{
+	KEY_VALUE_CACHE_NONE = 0,
+	KEY_VALUE_CACHE_OCTET,
+	KEY_VALUE_CACHE_SHORT,
+	KEY_VALUE_CACHE_UNSIGNED_SHORT,
+	KEY_VALUE_CACHE_LONG,
+	KEY_VALUE_CACHE_UNSIGNED_LONG,
+	KEY_VALUE_CACHE_LONG_LONG,
+	KEY_VALUE_CACHE_UNSIGNED_LONG_LONG,
+	KEY_VALUE_CACHE_FLOAT,
+	KEY_VALUE_CACHE_DOUBLE,
+} KeyValueCacheType;
+
 /**
  * The private copy-on-write key data structure.
  *
@@ -128,6 +148,23 @@ struct _KeyData
 	 */
 	size_t dataSize;
 
+	/**
+	 * The value decoded by a conversion function (e.g. elektraKeyToLong()).
+	 * Only valid if cacheType is not KEY_VALUE_CACHE_NONE.
+	 */
+	union
+	{
+		kdb_octet_t octet;
+		kdb_short_t shortValue;
+		kdb_unsigned_short_t unsignedShortValue;
+		kdb_long_t longValue;
+		kdb_unsigned_long_t unsignedLongValue;
+		kdb_long_long_t longLongValue;
+		kdb_unsigned_long_long_t unsignedLongLongValue;
+		kdb_float_t floatValue;
+		kdb_double_t doubleValue;
+	} cache;
+
 	/**
 	 * Reference counter
 	 */
@@ -138,11 +175,17 @@ struct _KeyData
 	 */
 	bool isInMmap : 1;
 
+	/**
+	 * The KeyValueCacheType of cache.
+	 * Reset to KEY_VALUE_CACHE_NONE whenever the value changes.
+	 */
+	unsigned int cacheType : 4;
+
 	/**
 	 * Bitfield reserved for future use.
 	 * Decrease size when adding new flags.
 	 */
-	int : 15;
+	int : 11;
 };
 
 /**
@@ -179,6 +222,20 @@ struct _KeyName
 	 */
 	size_t keyUSize;
 
+	/**
+	 * Offset of the last part (the basename) within ukey.
+	 * Kept up to date whenever ukey changes, see keyNameUpdateParts().
+	 * @see keyBaseName()
+	 */
+	size_t ukeyBaseNameOffset;
+
+	/**
+	 * Number of parts of the name, not counting the namespace.
+	 * Kept up to date whenever ukey changes, see keyNameUpdateParts().
+	 * @see keyIsDirectlyBelow()
+	 */
+	size_t depth;
+
 	/**
 	 * Reference counter
 	 */
@@ -199,6 +256,7 @@ struct _KeyName
 // private methods for COW keys
 struct _KeyName * keyNameNew (void);
 struct _KeyName * keyNameCopy (struct _KeyName * source);
+void keyNameUpdateParts (struct _KeyName * keyname);
 uint16_t keyNameRefInc (struct _KeyName * keyname);
 uint16_t keyNameRefDec (struct _KeyName * keyname);
 uint16_t keyNameRefDecAndDel (struct _KeyName * keyname);
@@ -232,6 +290,49 @@ static inline void setKeyDataIsInMmap (struct _KeyData * keydata, bool isInMmap)
 	keydata->isInMmap = isInMmap;
 }
 
+/**
+ * @internal
+ *
+ * Get the cached decoded value of a KeyData object.
+ *
+ * @param keydata the KeyData object, may be NULL
+ * @param type    the expected type of the cached value
+ *
+ * @return pointer to the cached value
+ * @retval NULL if no value of type @p type is cached
+ */
+static inline const void * keyDataGetCachedValue (const struct _KeyData * keydata, KeyValueCacheType type)
+{
+	if (keydata == NULL || keydata->cacheType != type || keydata->isInMmap)
+	{
+		return NULL;
+	}
+	return &keydata->cache;
+}
+
+/**
+ * @internal
+ *
+ * Cache a decoded value in a KeyData object.
+ *
+ * Only the conversion functions that decoded @p value from the current value of
+ * @p keydata may call this function. Values in mmap()ed KeyData objects are never cached.
+ *
+ * @param keydata the KeyData object, may be NULL
+ * @param type    the type of @p value
+ * @param value   pointer to the decoded value of type @p type
+ * @param size    the size of @p value
+ */
+static inline void keyDataSetCachedValue (struct _KeyData * keydata, KeyValueCacheType type, const void * value, size_t size)
+{
+	if (keydata == NULL || keydata->isInMmap || size > sizeof (keydata->cache))
+	{
+		return;
+	}
+	memcpy (&keydata->cache, value, size);
+	keydata->cacheType = type;
+}
+
 /**
  * The private Key struct.
  *
@@ -631,6 +732,14 @@ int elektraIsArrayPart (const char * namePart);
 extern "C" {
 #endif
 
+struct _ElektraResolvedKey
+{
+	const char * name;
+	KDBType type;
+	Key * key;
+	kdb_unsigned_long_long_t generation;
+};
+
 struct _Elektra
 {
 	KDB * kdb;
@@ -641,6 +750,9 @@ struct _Elektra
 	ElektraErrorHandler fatalErrorHandler;
 	char * resolvedReference;
 	size_t parentKeyLength;
+	kdb_unsigned_long_long_t generation;
+	struct _ElektraResolvedKey * resolvedKeys;
+	size_t resolvedKeysSize;
 };
 
 struct _ElektraError
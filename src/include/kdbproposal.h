@@ -19,6 +19,68 @@ namespace ckdb
 extern "C" {
 #endif
 
+/**
+ * @brief Flat KeySet layout
+ *
+ * A flat KeySet is a single contiguous buffer, which is made of
+ *
+ * 1. an #ElektraKsFlatHeader,
+ * 2. `keyCount` #ElektraKsFlatKey entries,
+ * 3. `metaCount` #ElektraKsFlatMeta entries and
+ * 4. the names and values the entries refer to.
+ *
+ * All fields are `uint64_t` in native byte order, offsets are relative to the start of the buffer.
+ * Sizes do not include the terminating null byte, which is always present after names and values.
+ * The metadata of a key is stored in the entries `metaIndex` to `metaIndex + metaCount - 1`.
+ *
+ * The layout is meant for transferring KeySets within one process, e.g. to language bindings.
+ *
+ * Keys with the flag #ELEKTRA_KS_FLAT_UNESCAPED also contain the unescaped name (see keyUnescapedName()),
+ * which starts directly after the terminating null byte of the name and ends at `valueOffset`.
+ * elektraKsFlatExportMappable() writes such buffers, elektraKsFlatMap() creates Keys that use
+ * the names and values within the buffer without copying them.
+ */
+typedef struct
+{
+	uint64_t magic;	    /**< #ELEKTRA_KS_FLAT_MAGIC */
+	uint64_t keyCount;  /**< number of keys */
+	uint64_t metaCount; /**< number of metakeys of all keys */
+	uint64_t size;	    /**< size of the whole buffer */
+} ElektraKsFlatHeader;
+
+typedef struct
+{
+	uint64_t nameOffset;
+	uint64_t nameSize;
+	uint64_t valueOffset;
+	uint64_t valueSize;
+	uint64_t flags; /**< #ELEKTRA_KS_FLAT_BINARY for binary values, #ELEKTRA_KS_FLAT_UNESCAPED, #ELEKTRA_KS_FLAT_NULL */
+	uint64_t metaIndex;
+	uint64_t metaCount;
+} ElektraKsFlatKey;
+
+typedef struct
+{
+	uint64_t nameOffset;
+	uint64_t nameSize;
+	uint64_t valueOffset;
+	uint64_t valueSize;
+} ElektraKsFlatMeta;
+
+/** magic number of flat KeySets, the lowest byte is the version of the layout */
+#define ELEKTRA_KS_FLAT_MAGIC 0x54414c46534b4501ULL
+#define ELEKTRA_KS_FLAT_BINARY 1
+#define ELEKTRA_KS_FLAT_UNESCAPED 2
+/** the key has no value, as opposed to an empty string, which is also stored with `valueSize` 0 */
+#define ELEKTRA_KS_FLAT_NULL 4
+
+size_t elektraKsFlatSize (const KeySet * ks, elektraCursor start, elektraCursor end);
+size_t elektraKsFlatExport (const KeySet * ks, elektraCursor start, elektraCursor end, void * buffer, size_t size);
+ssize_t elektraKsFlatImport (KeySet * ks, const void * buffer, size_t size);
+size_t elektraKsFlatSizeMappable (const KeySet * ks, elektraCursor start, elektraCursor end);
+size_t elektraKsFlatExportMappable (const KeySet * ks, elektraCursor start, elektraCursor end, void * buffer, size_t size);
+ssize_t elektraKsFlatMap (KeySet * ks, const void * buffer, size_t size);
+int elektraKsFlatMapInUse (const KeySet * ks);
 
 #ifdef __cplusplus
 }
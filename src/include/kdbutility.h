@@ -1,6 +1,8 @@
 #ifndef KDBUTILITY_H
 #define KDBUTILITY_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 namespace ckdb
 {
@@ -12,6 +14,22 @@ char * elektraLskip (char const * const keyname);
 char * elektraRstrip (char * const start, char ** end);
 char * elektraStrip (char * text);
 
+/* Buffered Writing for Storage Plugins */
+
+/** data of at least this size is referenced instead of copied by elektraWriterWrite() */
+#define ELEKTRA_WRITER_REFERENCE_SIZE 512
+
+typedef struct _ElektraWriter ElektraWriter;
+typedef int (*ElektraWriterCallback) (void * context, const char * data, size_t size);
+
+ElektraWriter * elektraWriterNew (int fd);
+ElektraWriter * elektraWriterNewCallback (ElektraWriterCallback callback, void * context);
+void elektraWriterDel (ElektraWriter * writer);
+int elektraWriterWrite (ElektraWriter * writer, const char * data, size_t size);
+int elektraWriterWriteString (ElektraWriter * writer, const char * string);
+int elektraWriterFlush (ElektraWriter * writer);
+int elektraWriterError (const ElektraWriter * writer);
+
 #ifdef __cplusplus
 }
 }
@@ -25,6 +25,9 @@
  *                                    (e.g. ELEKTRA_TYPE_NEGATIVE_PRE_CHECK).
  * @param  PRE_CHECK_FAIL_BLOCK       optional, defaults to logging a warning in the key. The code to be executed (before returning 0), if
  *                                    PRE_CHECK_CONVERSION evaluates to false.
+ * @param  VALUE_CACHE_TYPE           optional. A KeyValueCacheType (see kdbprivate.h). If set, successfully converted values are
+ *                                    cached in the key data and returned directly by later conversions of the same value.
+ *                                    Requires kdbprivate.h.
  * @param  DISABLE_UNDEF_PARAMETERS   define to disable undefining of parameters after the macro. Use if parameters
  *                                    are used within another supermacro.
  * @param  CODE_ONLY           optional, defaults to 0. Set to 1 to only generate the function body. This is useful, if you want to create a
@@ -121,6 +124,14 @@
  */
 TYPE_CONVERSION_SIGNATURE (TYPE, TYPE_NAME, NAME_MACRO)
 {
+#endif
+#ifdef VALUE_CACHE_TYPE
+	const TYPE * cached = keyDataGetCachedValue ((KEY_PARAM_NAME)->keyData, VALUE_CACHE_TYPE);
+	if (cached != NULL)
+	{
+		*(VARIABLE_PARAM_NAME) = *cached;
+		return 1;
+	}
 #endif
 	char * end ELEKTRA_UNUSED;
 	const char * string = keyValue (KEY_PARAM_NAME);
@@ -137,6 +148,9 @@ TYPE_CONVERSION_SIGNATURE (TYPE, TYPE_NAME, NAME_MACRO)
 	{
 		// only update if conversion was successful
 		*(VARIABLE_PARAM_NAME) = (TYPE) value;
+#ifdef VALUE_CACHE_TYPE
+		keyDataSetCachedValue ((KEY_PARAM_NAME)->keyData, VALUE_CACHE_TYPE, VARIABLE_PARAM_NAME, sizeof (TYPE));
+#endif
 		return 1;
 	}
 	else
@@ -161,6 +175,7 @@ TYPE_CONVERSION_SIGNATURE (TYPE, TYPE_NAME, NAME_MACRO)
 #undef PRE_CHECK_CONVERSION
 #undef PRE_CHECK_FAIL_BLOCK
 #undef CHECK_FAIL_BLOCK
+#undef VALUE_CACHE_TYPE
 #undef CODE_ONLY
 #undef KEY_PARAM_NAME
 #undef VARIABLE_PARAM_NAME
@@ -8,6 +8,7 @@
 
 #include "kdbease.h"
 #include "kdbhelper.h"
+#include "kdbprivate.h"
 #include <ctype.h>
 #include <errno.h>
 #include <stdint.h>
@@ -128,6 +129,7 @@ int elektraKeyToChar (const Key * key ELEKTRA_UNUSED, kdb_char_t * variable ELEK
 int elektraKeyToOctet (const Key * key ELEKTRA_UNUSED, kdb_octet_t * variable ELEKTRA_UNUSED)
 {
 #define TYPE_NAME Octet
+#define VALUE_CACHE_TYPE KEY_VALUE_CACHE_OCTET
 #define TYPE kdb_octet_t
 #define KDB_TYPE KDB_TYPE_OCTET
 #define PRE_CHECK_BLOCK ELEKTRA_TYPE_NEGATIVE_PRE_CHECK_BLOCK
@@ -162,6 +164,7 @@ int elektraKeyToOctet (const Key * key ELEKTRA_UNUSED, kdb_octet_t * variable EL
 int elektraKeyToShort (const Key * key ELEKTRA_UNUSED, kdb_short_t * variable ELEKTRA_UNUSED)
 {
 #define TYPE_NAME Short
+#define VALUE_CACHE_TYPE KEY_VALUE_CACHE_SHORT
 #define TYPE kdb_short_t
 #define KDB_TYPE KDB_TYPE_SHORT
 #define PRE_CHECK_FAIL_BLOCK
@@ -194,6 +197,7 @@ int elektraKeyToShort (const Key * key ELEKTRA_UNUSED, kdb_short_t * variable EL
 int elektraKeyToUnsignedShort (const Key * key ELEKTRA_UNUSED, kdb_unsigned_short_t * variable ELEKTRA_UNUSED)
 {
 #define TYPE_NAME UnsignedShort
+#define VALUE_CACHE_TYPE KEY_VALUE_CACHE_UNSIGNED_SHORT
 #define TYPE kdb_unsigned_short_t
 #define KDB_TYPE KDB_TYPE_UNSIGNED_SHORT
 #define PRE_CHECK_BLOCK ELEKTRA_TYPE_NEGATIVE_PRE_CHECK_BLOCK
@@ -228,6 +232,7 @@ int elektraKeyToUnsignedShort (const Key * key ELEKTRA_UNUSED, kdb_unsigned_shor
 int elektraKeyToLong (const Key * key ELEKTRA_UNUSED, kdb_long_t * variable ELEKTRA_UNUSED)
 {
 #define TYPE_NAME Long
+#define VALUE_CACHE_TYPE KEY_VALUE_CACHE_LONG
 #define TYPE kdb_long_t
 #define KDB_TYPE KDB_TYPE_LONG
 #define PRE_CHECK_FAIL_BLOCK
@@ -260,6 +265,7 @@ int elektraKeyToLong (const Key * key ELEKTRA_UNUSED, kdb_long_t * variable ELEK
 int elektraKeyToUnsignedLong (const Key * key ELEKTRA_UNUSED, kdb_unsigned_long_t * variable ELEKTRA_UNUSED)
 {
 #define TYPE_NAME UnsignedLong
+#define VALUE_CACHE_TYPE KEY_VALUE_CACHE_UNSIGNED_LONG
 #define TYPE kdb_unsigned_long_t
 #define KDB_TYPE KDB_TYPE_UNSIGNED_LONG
 #define PRE_CHECK_BLOCK ELEKTRA_TYPE_NEGATIVE_PRE_CHECK_BLOCK
@@ -294,6 +300,7 @@ int elektraKeyToUnsignedLong (const Key * key ELEKTRA_UNUSED, kdb_unsigned_long_
 int elektraKeyToLongLong (const Key * key ELEKTRA_UNUSED, kdb_long_long_t * variable ELEKTRA_UNUSED)
 {
 #define TYPE_NAME LongLong
+#define VALUE_CACHE_TYPE KEY_VALUE_CACHE_LONG_LONG
 #define TYPE kdb_long_long_t
 #define KDB_TYPE KDB_TYPE_LONG_LONG
 #define PRE_CHECK_FAIL_BLOCK
@@ -326,6 +333,7 @@ int elektraKeyToLongLong (const Key * key ELEKTRA_UNUSED, kdb_long_long_t * vari
 int elektraKeyToUnsignedLongLong (const Key * key ELEKTRA_UNUSED, kdb_unsigned_long_long_t * variable ELEKTRA_UNUSED)
 {
 #define TYPE_NAME UnsignedLongLong
+#define VALUE_CACHE_TYPE KEY_VALUE_CACHE_UNSIGNED_LONG_LONG
 #define TYPE kdb_unsigned_long_long_t
 #define KDB_TYPE KDB_TYPE_UNSIGNED_LONG_LONG
 #define PRE_CHECK_BLOCK ELEKTRA_TYPE_NEGATIVE_PRE_CHECK_BLOCK
@@ -360,6 +368,7 @@ int elektraKeyToUnsignedLongLong (const Key * key ELEKTRA_UNUSED, kdb_unsigned_l
 int elektraKeyToFloat (const Key * key ELEKTRA_UNUSED, kdb_float_t * variable ELEKTRA_UNUSED)
 {
 #define TYPE_NAME Float
+#define VALUE_CACHE_TYPE KEY_VALUE_CACHE_FLOAT
 #define TYPE kdb_float_t
 #define KDB_TYPE KDB_TYPE_FLOAT
 #define PRE_CHECK_FAIL_BLOCK
@@ -391,6 +400,7 @@ int elektraKeyToFloat (const Key * key ELEKTRA_UNUSED, kdb_float_t * variable EL
 int elektraKeyToDouble (const Key * key ELEKTRA_UNUSED, kdb_double_t * variable ELEKTRA_UNUSED)
 {
 #define TYPE_NAME Double
+#define VALUE_CACHE_TYPE KEY_VALUE_CACHE_DOUBLE
 #define TYPE kdb_double_t
 #define KDB_TYPE KDB_TYPE_DOUBLE
 #define PRE_CHECK_FAIL_BLOCK
@@ -207,6 +207,9 @@ void o(KeySet *ks)
 }
  * @endcode
  *
+ * If the metadata of @p dest changes, @p dest is marked as changed (see keyNeedSync()).
+ * Copying metadata that @p dest already shares with @p source does not mark it.
+ *
  * @pre @p dest's metadata is not read-only
  * @post keyGetMeta(source, metaName) == keyGetMeta(dest, metaName)
  *
@@ -247,6 +250,7 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
 			{
 				/*It was already there, so lets drop that one*/
 				keyDel (r);
+				dest->needsSync = true;
 			}
 		}
 		return 0;
@@ -257,7 +261,13 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
 	{
 		Key * r;
 		r = ksLookup (dest->meta, ret, KDB_O_POP);
-		if (r && r != ret)
+		if (r == ret)
+		{
+			/*Same metadata is already shared, nothing changes*/
+			ksAppendKey (dest->meta, ret);
+			return 1;
+		}
+		if (r)
 		{
 			/*It was already there, so lets drop that one*/
 			keyDel (r);
@@ -275,6 +285,7 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
 
 	// now we can simply append that key
 	ksAppendKey (dest->meta, ret);
+	dest->needsSync = true;
 
 	return 1;
 }
@@ -306,6 +317,8 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
  *
  * @snippet keyMeta.c Shared Meta All
  *
+ * If @p source has metadata, @p dest is marked as changed (see keyNeedSync()).
+ *
  * @pre @p dest's metadata is not read-only
  * @post for every metaName present in source: keyGetMeta(source, metaName) == keyGetMeta(dest, metaName)
  *
@@ -338,6 +351,7 @@ int keyCopyAllMeta (Key * dest, const Key * source)
 		{
 			dest->meta = ksDup (source->meta);
 		}
+		dest->needsSync = true;
 		return 1;
 	}
 
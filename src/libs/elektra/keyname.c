@@ -161,10 +161,63 @@
 
 #include <ctype.h>
 
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#include <stdint.h>
+#define ELEKTRA_KEYNAME_SSE2
+#endif
+
 #include "kdb.h"
 #include "kdbhelper.h"
 #include "kdbinternal.h"
 
+/**
+ * @internal
+ *
+ * @brief Helper method: finds the first part separator, escape character or terminator in a key name.
+ *
+ * With SSE2 16 bytes are classified at once. Only aligned blocks are loaded, so we never read
+ * across a page boundary, even though we may read past the terminator of @p name.
+ *
+ * @param name the (part of a) key name to search
+ *
+ * @return pointer to the first `/`, `\` or `\0` in @p name
+ */
+#ifdef ELEKTRA_KEYNAME_SSE2
+__attribute__ ((no_sanitize_address))
+#endif
+static inline const char * findNameSpecial (const char * name)
+{
+#ifdef ELEKTRA_KEYNAME_SSE2
+	const __m128i zero = _mm_setzero_si128 ();
+	const __m128i slash = _mm_set1_epi8 ('/');
+	const __m128i backslash = _mm_set1_epi8 ('\\');
+
+	size_t misalignment = (uintptr_t) name & 15;
+	const __m128i * block = (const __m128i *) (name - misalignment);
+	unsigned int mask = 0xFFFFu << misalignment;
+	while (1)
+	{
+		__m128i chunk = _mm_load_si128 (block);
+		__m128i special = _mm_or_si128 (_mm_cmpeq_epi8 (chunk, zero),
+						_mm_or_si128 (_mm_cmpeq_epi8 (chunk, slash), _mm_cmpeq_epi8 (chunk, backslash)));
+		mask &= (unsigned int) _mm_movemask_epi8 (special);
+		if (mask != 0)
+		{
+			return (const char *) block + __builtin_ctz (mask);
+		}
+		mask = 0xFFFFu;
+		++block;
+	}
+#else
+	while (*name != '\0' && *name != '/' && *name != '\\')
+	{
+		++name;
+	}
+	return name;
+#endif
+}
+
 /**
  * @internal
  *
@@ -203,6 +256,9 @@ static struct _KeyName * keyNameCopyWithSize (struct _KeyName * source, size_t e
 
 	memcpy (dest->ukey, source->ukey, copySize);
 
+	dest->ukeyBaseNameOffset = source->ukeyBaseNameOffset;
+	dest->depth = source->depth;
+
 	return dest;
 }
 
@@ -220,6 +276,36 @@ struct _KeyName * keyNameCopy (struct _KeyName * source)
 	return keyNameCopyWithSize (source, source->keySize, source->keyUSize);
 }
 
+/**
+ * @internal
+ *
+ * @brief Helper method: recalculates the depth and the basename offset of a keyname from its unescaped name.
+ *
+ * Must be called whenever @c ukey was modified in a way that changes its parts.
+ *
+ * @param keyname the keyname to update
+ */
+void keyNameUpdateParts (struct _KeyName * keyname)
+{
+	keyname->depth = 0;
+	keyname->ukeyBaseNameOffset = keyname->keyUSize > 0 ? keyname->keyUSize - 1 : 0;
+	if (keyname->ukey == NULL || keyname->keyUSize <= 3)
+	{
+		// only namespace
+		return;
+	}
+
+	// ukey is: namespace, '\0', parts separated by '\0', '\0'
+	const char * cur = keyname->ukey + 1;
+	const char * end = keyname->ukey + keyname->keyUSize - 1;
+	while (cur < end)
+	{
+		++keyname->depth;
+		keyname->ukeyBaseNameOffset = cur + 1 - keyname->ukey;
+		cur = memchr (cur + 1, '\0', end - cur);
+	}
+}
+
 /**
  * @internal
  *
@@ -699,6 +785,7 @@ ssize_t keySetName (Key * key, const char * newName)
 	elektraRealloc ((void **) &key->keyName->ukey, key->keyName->keyUSize);
 
 	elektraKeyNameUnescape (key->keyName->key, key->keyName->ukey);
+	keyNameUpdateParts (key->keyName);
 
 	key->needsSync = true;
 
@@ -775,6 +862,7 @@ ssize_t keyAddName (Key * key, const char * newName)
 	elektraRealloc ((void **) &key->keyName->ukey, key->keyName->keyUSize);
 
 	elektraKeyNameUnescape (key->keyName->key, key->keyName->ukey);
+	keyNameUpdateParts (key->keyName);
 
 	key->needsSync = true;
 	return key->keyName->keySize;
@@ -889,6 +977,7 @@ int keyReplacePrefix (Key * key, const Key * oldPrefix, const Key * newPrefix)
 
 	key->keyName->keySize = replacePrefix (&key->keyName->key, key->keyName->keySize, oldSize, newPrefix->keyName->key, newSize);
 	key->keyName->keyUSize = replacePrefix (&key->keyName->ukey, key->keyName->keyUSize, oldUSize, newPrefix->keyName->ukey, newUSize);
+	keyNameUpdateParts (key->keyName);
 
 	return 1;
 }
@@ -1239,6 +1328,11 @@ void elektraKeyNameCanonicalize (const char * name, char ** canonicalName, size_
 		const char * end = name;
 		while (*end != '\0')
 		{
+			// skip characters without special meaning at once
+			const char * special = findNameSpecial (end);
+			usize += special - end;
+			end = special;
+
 			size_t backslashes = 0;
 			while (*end == '\\')
 			{
@@ -1352,12 +1446,15 @@ void elektraKeyNameUnescape (const char * canonicalName, char * unescapedName)
 				++canonicalName;
 			}
 			break;
-		default:
-			// nothing special, just output
-			*outPtr++ = *canonicalName;
-			++canonicalName;
+		default: {
+			// nothing special, just output everything up to the next separator or escape sequence
+			const char * end = findNameSpecial (canonicalName);
+			memcpy (outPtr, canonicalName, end - canonicalName);
+			outPtr += end - canonicalName;
+			canonicalName = end;
 			break;
 		}
+		}
 	}
 
 	// terminate
@@ -1402,12 +1499,7 @@ const char * keyBaseName (const Key * key)
 	if (!key) return 0;
 	if (!key->keyName || !key->keyName->key) return "";
 
-	const char * baseName = key->keyName->ukey + key->keyName->keyUSize - 2;
-	while (*baseName != '\0')
-	{
-		--baseName;
-	}
-	return baseName + 1;
+	return key->keyName->ukey + key->keyName->ukeyBaseNameOffset;
 }
 
 
@@ -1650,6 +1742,7 @@ static size_t keyAddBaseNameInternal (Key * key, const char * baseName)
 		// for keySetBaseName
 		key->keyName->key[key->keyName->keySize - 1] = '\0';
 		key->keyName->ukey[key->keyName->keyUSize - 1] = '\0';
+		keyNameUpdateParts (key->keyName);
 
 		return key->keyName->keySize;
 	}
@@ -1685,6 +1778,17 @@ static size_t keyAddBaseNameInternal (Key * key, const char * baseName)
 	// terminate unescaped name
 	key->keyName->ukey[key->keyName->keyUSize - 1] = '\0';
 
+	if (hasPath)
+	{
+		// the new basename is the last part
+		++key->keyName->depth;
+		key->keyName->ukeyBaseNameOffset = oldKeyUSize;
+	}
+	else
+	{
+		keyNameUpdateParts (key->keyName);
+	}
+
 	key->needsSync = true;
 	return key->keyName->keySize;
 }
@@ -1802,12 +1906,11 @@ ssize_t keySetBaseName (Key * key, const char * baseName)
 	}
 	key->keyName->keySize = baseNamePtr - key->keyName->key + 1;
 
-	const char * ubaseNamePtr = key->keyName->ukey + key->keyName->keyUSize - 2;
-	while (*ubaseNamePtr != '\0')
+	key->keyName->keyUSize = key->keyName->ukeyBaseNameOffset;
+	if (key->keyName->depth > 0)
 	{
-		--ubaseNamePtr;
+		--key->keyName->depth;
 	}
-	key->keyName->keyUSize = ubaseNamePtr - key->keyName->ukey + 1;
 
 	if (key->keyName->keyUSize == 2)
 	{
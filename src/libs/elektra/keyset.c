@@ -1342,27 +1342,29 @@ elektraCursor ksFindHierarchy (const KeySet * ks, const Key * root, elektraCurso
 
 	if (end != NULL)
 	{
-		struct _KeyName * oldName = NULL;
+		const Key * searchRoot = root;
+		struct _Key rootCopy;
 		struct _KeyName * copy = NULL;
 
-		if (search >= 0)
+		if (search >= 0 || isKeyNameInMmap (root->keyName))
 		{
-			// root or a copy of root is part of ks
+			// root or a copy of root is part of ks, or the name of root is mapped read-only
 			// we need to temporarily create a copy of the keyName, as to not change the name of keys in ks
+			// the copy must not be assigned to root itself, because the search might compare root with itself
 			copy = keyNameCopy (root->keyName);
-			oldName = root->keyName;
-			((Key *) root)->keyName = copy;
 			keyNameRefInc (copy);
+			rootCopy.keyName = copy;
+			searchRoot = &rootCopy;
 		}
 
-		if (root->keyName->keyUSize == 3)
+		if (searchRoot->keyName->keyUSize == 3)
 		{
 			// special handling for root keys
 			// we just increment the namespace byte and search
 			// for the next theoretically possible namespace
-			root->keyName->ukey[0]++;
-			ssize_t endSearch = ksSearchInternal (ks, root);
-			root->keyName->ukey[0]--;
+			searchRoot->keyName->ukey[0]++;
+			ssize_t endSearch = ksSearchInternal (ks, searchRoot);
+			searchRoot->keyName->ukey[0]--;
 			*end = endSearch < 0 ? -endSearch - 1 : endSearch;
 		}
 		else
@@ -1371,15 +1373,14 @@ elektraCursor ksFindHierarchy (const KeySet * ks, const Key * root, elektraCurso
 			// Overwriting the null terminator works fine, because
 			// all accesses to root->ukey inside of ksSearchInternal()
 			// use root->keyUSize explicitly.
-			root->keyName->ukey[root->keyName->keyUSize - 1] = '\1';
-			ssize_t endSearch = ksSearchInternal (ks, root);
-			root->keyName->ukey[root->keyName->keyUSize - 1] = '\0';
+			searchRoot->keyName->ukey[searchRoot->keyName->keyUSize - 1] = '\1';
+			ssize_t endSearch = ksSearchInternal (ks, searchRoot);
+			searchRoot->keyName->ukey[searchRoot->keyName->keyUSize - 1] = '\0';
 			*end = endSearch < 0 ? -endSearch - 1 : endSearch;
 		}
 
-		if (oldName != NULL)
+		if (copy != NULL)
 		{
-			((Key *) root)->keyName = oldName;
 			keyNameRefDecAndDel (copy);
 		}
 	}
@@ -1418,6 +1419,15 @@ KeySet * ksBelow (const KeySet * ks, const Key * root)
 
 	if (keyGetNamespace (root) == KEY_NS_CASCADING)
 	{
+		if (isKeyNameInMmap (root->keyName))
+		{
+			// the namespace of root is changed below, which is not possible for a name mapped read-only
+			Key * copy = keyNew (keyName (root), KEY_END);
+			KeySet * returned = ksBelow (ks, copy);
+			keyDel (copy);
+			return returned;
+		}
+
 		KeySet * returned = ksNew (0, KS_END);
 
 		// First, find all keys with cascading namespace and add them to the returned keyset
@@ -1626,6 +1636,15 @@ KeySet * ksCut (KeySet * ks, const Key * cutpoint)
 	if (!name) return 0;
 	if (strcmp (name, "") == 0) return 0;
 
+	if (cutpoint->keyName->ukey[0] == KEY_NS_CASCADING && isKeyNameInMmap (cutpoint->keyName))
+	{
+		// the namespace of cutpoint is changed below, which is not possible for a name mapped read-only
+		Key * copy = keyNew (name, KEY_END);
+		returned = ksCut (ks, copy);
+		keyDel (copy);
+		return returned;
+	}
+
 	keySetDetachData (ks);
 
 	elektraOpmphmInvalidate (ks->data);
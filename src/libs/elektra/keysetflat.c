@@ -0,0 +1,457 @@
+/**
+ * @file
+ *
+ * @brief Export and import of KeySets in a flat layout.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <kdbprivate.h>
+#include <kdbproposal.h>
+
+static int checkRange (const KeySet * ks, elektraCursor start, elektraCursor end)
+{
+	return ks != NULL && start >= 0 && start <= end && end <= ksGetSize (ks);
+}
+
+static size_t metaCount (const Key * key)
+{
+	ssize_t size = ksGetSize (key->meta);
+	return size > 0 ? size : 0;
+}
+
+static size_t flatValueSize (const Key * key)
+{
+	ssize_t size = keyGetValueSize (key);
+	if (keyIsBinary (key) == 1 || size <= 0) return size > 0 ? size : 0;
+	return size - 1;
+}
+
+static size_t flatKeySize (const Key * key, bool mappable)
+{
+	size_t size = sizeof (ElektraKsFlatKey) + keyGetNameSize (key) + flatValueSize (key) + 1;
+	if (mappable) size += keyGetUnescapedNameSize (key);
+	for (size_t i = 0; i < metaCount (key); ++i)
+	{
+		const Key * meta = ksAtCursor (key->meta, i);
+		size += sizeof (ElektraKsFlatMeta) + keyGetNameSize (meta) + flatValueSize (meta) + 1;
+	}
+	return size;
+}
+
+static size_t flatSize (const KeySet * ks, elektraCursor start, elektraCursor end, bool mappable)
+{
+	if (!checkRange (ks, start, end)) return 0;
+
+	size_t size = sizeof (ElektraKsFlatHeader);
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		size += flatKeySize (ksAtCursor (ks, it), mappable);
+	}
+	return size;
+}
+
+/**
+ * @brief Calculate the size of the flat layout of a range of a KeySet
+ *
+ * @param ks the KeySet
+ * @param start cursor of the first key
+ * @param end cursor after the last key, use `ksGetSize (ks)` for all keys
+ *
+ * @return the size of the buffer needed by elektraKsFlatExport()
+ * @retval 0 if @p ks is NULL or the range is invalid
+ */
+size_t elektraKsFlatSize (const KeySet * ks, elektraCursor start, elektraCursor end)
+{
+	return flatSize (ks, start, end, false);
+}
+
+/**
+ * @brief Calculate the size of the mappable flat layout of a range of a KeySet
+ *
+ * @param ks the KeySet
+ * @param start cursor of the first key
+ * @param end cursor after the last key, use `ksGetSize (ks)` for all keys
+ *
+ * @return the size of the buffer needed by elektraKsFlatExportMappable()
+ * @retval 0 if @p ks is NULL or the range is invalid
+ */
+size_t elektraKsFlatSizeMappable (const KeySet * ks, elektraCursor start, elektraCursor end)
+{
+	return flatSize (ks, start, end, true);
+}
+
+static uint64_t writeString (char * buffer, size_t * position, const void * data, size_t size)
+{
+	uint64_t offset = *position;
+	if (size > 0) memcpy (buffer + offset, data, size);
+	buffer[offset + size] = '\0';
+	*position += size + 1;
+	return offset;
+}
+
+static size_t flatExport (const KeySet * ks, elektraCursor start, elektraCursor end, void * buffer, size_t size, bool mappable)
+{
+	size_t needed = flatSize (ks, start, end, mappable);
+	if (buffer == NULL || needed == 0 || needed > size) return 0;
+
+	char * data = buffer;
+	ElektraKsFlatHeader header = { ELEKTRA_KS_FLAT_MAGIC, end - start, 0, needed };
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		header.metaCount += metaCount (ksAtCursor (ks, it));
+	}
+	memcpy (data, &header, sizeof (header));
+
+	size_t keyPosition = sizeof (ElektraKsFlatHeader);
+	size_t metaPosition = keyPosition + header.keyCount * sizeof (ElektraKsFlatKey);
+	size_t position = metaPosition + header.metaCount * sizeof (ElektraKsFlatMeta);
+	uint64_t metaIndex = 0;
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		const Key * key = ksAtCursor (ks, it);
+		ElektraKsFlatKey entry;
+		entry.nameSize = keyGetNameSize (key) - 1;
+		entry.nameOffset = writeString (data, &position, keyName (key), entry.nameSize);
+		if (mappable)
+		{
+			// the unescaped name ends at valueOffset
+			memcpy (data + position, keyUnescapedName (key), keyGetUnescapedNameSize (key));
+			position += keyGetUnescapedNameSize (key);
+		}
+		entry.valueSize = flatValueSize (key);
+		entry.valueOffset = writeString (data, &position, keyValue (key), entry.valueSize);
+		entry.flags = (keyIsBinary (key) == 1 ? ELEKTRA_KS_FLAT_BINARY : 0) | (mappable ? ELEKTRA_KS_FLAT_UNESCAPED : 0) |
+			      (key->keyData == NULL || key->keyData->data.v == NULL ? ELEKTRA_KS_FLAT_NULL : 0);
+		entry.metaIndex = metaIndex;
+		entry.metaCount = metaCount (key);
+
+		for (size_t i = 0; i < entry.metaCount; ++i)
+		{
+			const Key * meta = ksAtCursor (key->meta, i);
+			ElektraKsFlatMeta metaEntry;
+			metaEntry.nameSize = keyGetNameSize (meta) - 1;
+			metaEntry.nameOffset = writeString (data, &position, keyName (meta), metaEntry.nameSize);
+			metaEntry.valueSize = flatValueSize (meta);
+			metaEntry.valueOffset = writeString (data, &position, keyValue (meta), metaEntry.valueSize);
+			memcpy (data + metaPosition, &metaEntry, sizeof (metaEntry));
+			metaPosition += sizeof (metaEntry);
+		}
+		metaIndex += entry.metaCount;
+
+		memcpy (data + keyPosition, &entry, sizeof (entry));
+		keyPosition += sizeof (entry);
+	}
+	return needed;
+}
+
+/**
+ * @brief Write a range of a KeySet into a single buffer
+ *
+ * The buffer contains names, values and metadata of all keys in the range,
+ * see #ElektraKsFlatHeader for the layout. Language bindings can convert it in
+ * one step instead of calling the Key functions for every key.
+ *
+ * @param ks the KeySet
+ * @param start cursor of the first key
+ * @param end cursor after the last key, use `ksGetSize (ks)` for all keys
+ * @param buffer the buffer to write to
+ * @param size the size of @p buffer
+ *
+ * @return the number of bytes written, which equals elektraKsFlatSize()
+ * @retval 0 if @p ks or @p buffer is NULL, the range is invalid or @p buffer is too small
+ */
+size_t elektraKsFlatExport (const KeySet * ks, elektraCursor start, elektraCursor end, void * buffer, size_t size)
+{
+	return flatExport (ks, start, end, buffer, size, false);
+}
+
+/**
+ * @brief Write a range of a KeySet into a single buffer, which can be used by elektraKsFlatMap()
+ *
+ * In addition to elektraKsFlatExport(), the unescaped names of the keys are written,
+ * see #ELEKTRA_KS_FLAT_UNESCAPED. elektraKsFlatImport() can read such buffers, too.
+ *
+ * @param ks the KeySet
+ * @param start cursor of the first key
+ * @param end cursor after the last key, use `ksGetSize (ks)` for all keys
+ * @param buffer the buffer to write to
+ * @param size the size of @p buffer
+ *
+ * @return the number of bytes written, which equals elektraKsFlatSizeMappable()
+ * @retval 0 if @p ks or @p buffer is NULL, the range is invalid or @p buffer is too small
+ */
+size_t elektraKsFlatExportMappable (const KeySet * ks, elektraCursor start, elektraCursor end, void * buffer, size_t size)
+{
+	return flatExport (ks, start, end, buffer, size, true);
+}
+
+/**
+ * @internal
+ *
+ * Check that a string of the flat layout lies within the buffer and is null-terminated.
+ *
+ * @return pointer to the string
+ * @retval NULL if the string is invalid
+ */
+static const char * readString (const char * buffer, uint64_t size, uint64_t offset, uint64_t length)
+{
+	if (offset >= size || length >= size - offset || buffer[offset + length] != '\0') return NULL;
+	return buffer + offset;
+}
+
+/**
+ * @internal
+ *
+ * Create a Key, whose name and value are stored in @p buffer.
+ *
+ * Like for keys in mmapstorage, only the structures are allocated. The core copies
+ * the name and value as soon as they are modified, see keyDetachKeyName().
+ */
+static Key * mapKey (const char * buffer, const ElektraKsFlatHeader * header, const ElektraKsFlatKey * entry, const char * name,
+		     const char * value)
+{
+	// the unescaped name has at least a namespace and two null bytes
+	uint64_t unescapedOffset = entry->nameOffset + entry->nameSize + 1;
+	if (entry->valueOffset < unescapedOffset + 3 || entry->valueOffset > header->size || buffer[unescapedOffset + 1] != '\0' ||
+	    buffer[entry->valueOffset - 1] != '\0' || !elektraKeyNameValidate (name, true))
+	{
+		return NULL;
+	}
+
+	Key * key = keyNew ("/", KEY_END);
+	if (key == NULL) return NULL;
+
+	keyNameRefDecAndDel (key->keyName);
+	key->keyName = keyNameNew ();
+	keyNameRefInc (key->keyName);
+	key->keyName->key = (char *) name;
+	key->keyName->keySize = entry->nameSize + 1;
+	key->keyName->ukey = (char *) buffer + unescapedOffset;
+	key->keyName->keyUSize = entry->valueOffset - unescapedOffset;
+	setKeyNameIsInMmap (key->keyName, true);
+	keyNameUpdateParts (key->keyName);
+
+	bool binary = entry->flags & ELEKTRA_KS_FLAT_BINARY;
+	if (!(entry->flags & ELEKTRA_KS_FLAT_NULL) && (!binary || entry->valueSize > 0))
+	{
+		key->keyData = keyDataNew ();
+		keyDataRefInc (key->keyData);
+		key->keyData->data.v = (void *) value;
+		key->keyData->dataSize = binary ? entry->valueSize : entry->valueSize + 1;
+		setKeyDataIsInMmap (key->keyData, true);
+	}
+	if (binary) keySetMeta (key, "binary", "");
+	return key;
+}
+
+static Key * readKey (const char * buffer, const ElektraKsFlatHeader * header, const ElektraKsFlatKey * entry, bool map)
+{
+	const char * name = readString (buffer, header->size, entry->nameOffset, entry->nameSize);
+	const char * value = readString (buffer, header->size, entry->valueOffset, entry->valueSize);
+	if (name == NULL || value == NULL || entry->metaIndex > header->metaCount ||
+	    entry->metaCount > header->metaCount - entry->metaIndex || (map && !(entry->flags & ELEKTRA_KS_FLAT_UNESCAPED)))
+	{
+		return NULL;
+	}
+
+	Key * key;
+	if (map)
+	{
+		key = mapKey (buffer, header, entry, name, value);
+		if (key == NULL) return NULL;
+	}
+	else
+	{
+		key = keyNew (name, KEY_END);
+		if (key == NULL) return NULL;
+		if (entry->flags & ELEKTRA_KS_FLAT_BINARY)
+		{
+			keySetBinary (key, entry->valueSize > 0 ? value : NULL, entry->valueSize);
+		}
+		else if (!(entry->flags & ELEKTRA_KS_FLAT_NULL))
+		{
+			// keySetString() would store an empty string as NULL
+			keySetRaw (key, value, entry->valueSize + 1);
+		}
+	}
+
+	const char * metaEntries = buffer + sizeof (ElektraKsFlatHeader) + header->keyCount * sizeof (ElektraKsFlatKey);
+	for (uint64_t i = entry->metaIndex; i < entry->metaIndex + entry->metaCount; ++i)
+	{
+		ElektraKsFlatMeta metaEntry;
+		memcpy (&metaEntry, metaEntries + i * sizeof (metaEntry), sizeof (metaEntry));
+		const char * metaName = readString (buffer, header->size, metaEntry.nameOffset, metaEntry.nameSize);
+		const char * metaValue = readString (buffer, header->size, metaEntry.valueOffset, metaEntry.valueSize);
+		if (metaName == NULL || metaValue == NULL || keySetMeta (key, metaName, metaValue) < 0)
+		{
+			keyDel (key);
+			return NULL;
+		}
+	}
+	return key;
+}
+
+typedef struct
+{
+	Key * key;
+	uint64_t index;
+} FlatImportedKey;
+
+static int compareImportedKeys (const void * a, const void * b)
+{
+	const FlatImportedKey * first = a;
+	const FlatImportedKey * second = b;
+	int cmp = keyCmp (first->key, second->key);
+	if (cmp != 0) return cmp;
+	// keep the order of duplicates, so the last one replaces the others
+	return first->index < second->index ? -1 : 1;
+}
+
+static void freeImportedKeys (FlatImportedKey * keys, size_t start, size_t end)
+{
+	for (size_t i = start; i < end; ++i)
+	{
+		keyDel (keys[i].key);
+	}
+	elektraFree (keys);
+}
+
+static ssize_t flatImport (KeySet * ks, const void * buffer, size_t size, bool map)
+{
+	if (ks == NULL || buffer == NULL || size < sizeof (ElektraKsFlatHeader)) return -1;
+
+	const char * data = buffer;
+	ElektraKsFlatHeader header;
+	memcpy (&header, data, sizeof (header));
+	uint64_t available = size - sizeof (header);
+	if (header.magic != ELEKTRA_KS_FLAT_MAGIC || header.size != size || header.keyCount > SSIZE_MAX ||
+	    header.keyCount > available / sizeof (ElektraKsFlatKey) ||
+	    header.metaCount > (available - header.keyCount * sizeof (ElektraKsFlatKey)) / sizeof (ElektraKsFlatMeta))
+	{
+		return -1;
+	}
+
+	FlatImportedKey * keys = elektraMalloc (header.keyCount * sizeof (FlatImportedKey) + 1);
+	if (keys == NULL) return -1;
+	int sorted = 1;
+	for (uint64_t i = 0; i < header.keyCount; ++i)
+	{
+		ElektraKsFlatKey entry;
+		memcpy (&entry, data + sizeof (header) + i * sizeof (entry), sizeof (entry));
+		keys[i].key = readKey (data, &header, &entry, map);
+		keys[i].index = i;
+		if (keys[i].key == NULL)
+		{
+			freeImportedKeys (keys, 0, i);
+			return -1;
+		}
+		if (i > 0 && keyCmp (keys[i - 1].key, keys[i].key) >= 0) sorted = 0;
+	}
+
+	// appending sorted keys never moves keys within the KeySet
+	if (!sorted) qsort (keys, header.keyCount, sizeof (FlatImportedKey), compareImportedKeys);
+
+	KeySet * result = ksNew (header.keyCount, KS_END);
+	if (result == NULL)
+	{
+		freeImportedKeys (keys, 0, header.keyCount);
+		return -1;
+	}
+	for (uint64_t i = 0; i < header.keyCount; ++i)
+	{
+		// ksAppendKey deletes the key on errors
+		if (ksAppendKey (result, keys[i].key) < 0)
+		{
+			freeImportedKeys (keys, i + 1, header.keyCount);
+			ksDel (result);
+			return -1;
+		}
+	}
+	elektraFree (keys);
+
+	ssize_t count = header.keyCount;
+	if (ksAppend (ks, result) < 0) count = -1;
+	ksDel (result);
+	return count;
+}
+
+/**
+ * @brief Append the keys of a buffer in the flat layout to a KeySet
+ *
+ * The buffer is validated completely, @p ks is only modified if all keys could be read.
+ * Buffers written by elektraKsFlatExport() are always valid, but bindings may
+ * also create them on their own, see #ElektraKsFlatHeader for the layout.
+ *
+ * @param ks the KeySet to append to
+ * @param buffer the buffer to read from
+ * @param size the size of @p buffer
+ *
+ * If the buffer contains a name more than once, the last key with that name is used.
+ *
+ * @return the number of keys read from @p buffer
+ * @retval -1 if @p ks or @p buffer is NULL or @p buffer is not a valid flat KeySet
+ */
+ssize_t elektraKsFlatImport (KeySet * ks, const void * buffer, size_t size)
+{
+	return flatImport (ks, buffer, size, false);
+}
+
+/**
+ * @brief Append the keys of a buffer in the mappable flat layout to a KeySet without copying names and values
+ *
+ * Works like elektraKsFlatImport(), but the names and values of the keys stay in @p buffer.
+ * Only when a name or value is modified, the key gets its own copy. Metadata is always copied.
+ * This way, processes that map the same file with `MAP_SHARED` share the memory of the keys.
+ *
+ * The buffer must have been written by elektraKsFlatExportMappable(). Names and values are
+ * not validated as thoroughly as by elektraKsFlatImport(), so the buffer must come from a trusted source.
+ *
+ * @warning @p buffer must neither be modified nor freed, as long as any of the keys
+ * or a Key sharing a name or value with them exists. Use elektraKsFlatMapInUse()
+ * to find out when the buffer can be released.
+ *
+ * @param ks the KeySet to append to
+ * @param buffer the buffer created by elektraKsFlatExportMappable()
+ * @param size the size of @p buffer
+ *
+ * @return the number of keys read from @p buffer
+ * @retval -1 if @p ks or @p buffer is NULL, @p buffer is not a valid flat KeySet or does not contain the unescaped names
+ */
+ssize_t elektraKsFlatMap (KeySet * ks, const void * buffer, size_t size)
+{
+	return flatImport (ks, buffer, size, true);
+}
+
+/**
+ * @brief Check whether keys created by elektraKsFlatMap() still use their buffer
+ *
+ * @p ks must contain all keys mapped from the buffer and must be the only place
+ * where the caller holds them, e.g. a new KeySet to which the keys were added with ksAppend()
+ * directly after elektraKsFlatMap(). A copy made with ksDup() does not work, as it shares
+ * the keys without referencing them.
+ *
+ * @param ks the mapped keys
+ *
+ * @retval 1 if a key of @p ks with a name or value in the buffer is used elsewhere,
+ *         or another key shares such a name or value
+ * @retval 0 if the buffer can be released after deleting @p ks
+ */
+int elektraKsFlatMapInUse (const KeySet * ks)
+{
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		const Key * key = ksAtCursor (ks, it);
+		bool nameMapped = key->keyName != NULL && isKeyNameInMmap (key->keyName);
+		bool dataMapped = key->keyData != NULL && isKeyDataInMmap (key->keyData);
+		if ((key->refs > 1 && (nameMapped || dataMapped)) || (nameMapped && key->keyName->refs > 1) ||
+		    (dataMapped && key->keyData->refs > 1))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -78,10 +78,10 @@ void keyClearSync (Key * key)
  * if you changed something in a key after a kdbGet() or kdbSet().
  *
  * @note Note that the sync status will be updated on any change,
- * including metadata.
+ * including metadata set with keySetMeta(), keyCopyMeta() or keyCopyAllMeta().
  *
- * @deprecated The handling of synchronization is done internally and
- * does not need to be checked by neither application nor plugins.
+ * During kdbSet() validation plugins use the flag to only check Keys
+ * that were changed since the last kdbGet() or kdbSet().
  *
  * @param key the Key which should be checked
  *
@@ -257,7 +257,7 @@ int keyIsBelowOrSame (const Key * key, const Key * check)
 		--sizeBelow;
 	}
 
-	if (sizeAbove > sizeBelow)
+	if (sizeAbove > sizeBelow || (key->keyName != NULL && check->keyName != NULL && key->keyName->depth > check->keyName->depth))
 	{
 		return 0;
 	}
@@ -334,13 +334,13 @@ int keyIsDirectlyBelow (const Key * key, const Key * check)
 		++below;
 		--sizeBelow;
 	}
-	if (sizeAbove >= sizeBelow)
+	if (sizeAbove >= sizeBelow || key->keyName == NULL || check->keyName == NULL)
 	{
 		return 0;
 	}
 
-	size_t nextPartSize = strlen (below + sizeAbove);
-	return memcmp (above, below, sizeAbove) == 0 && sizeAbove + nextPartSize + 1 == sizeBelow;
+	// check must have exactly one more part, the prefix check ensures that the other parts are the same
+	return check->keyName->depth == key->keyName->depth + 1 && memcmp (above, below, sizeAbove) == 0;
 }
 
 /**
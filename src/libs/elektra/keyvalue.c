@@ -573,6 +573,7 @@ ssize_t keySetRaw (Key * key, const void * newBinary, size_t dataSize)
 	if (key->hasReadOnlyValue) return -1;
 
 	keyDetachKeyDataWithoutCopy (key);
+	key->keyData->cacheType = KEY_VALUE_CACHE_NONE;
 
 	if (!dataSize || !newBinary)
 	{
@@ -184,6 +184,8 @@ Elektra * elektraOpen (const char * application, KeySet * defaults, KeySet * con
 	elektra->lookupKey = keyNew ("/", KEY_END);
 	elektra->fatalErrorHandler = &defaultFatalErrorHandler;
 	elektra->defaults = ksDup (defaults);
+	// generation 0 marks unused entries of resolvedKeys
+	elektra->generation = 1;
 
 	return elektra;
 }
@@ -502,6 +504,7 @@ void elektraClose (Elektra * elektra)
 		ksDel (elektra->defaults);
 	}
 
+	elektraFree (elektra->resolvedKeys);
 	elektraFree (elektra);
 }
 
@@ -542,6 +545,9 @@ void elektraSetArrayLookupKey (Elektra * elektra, const char * name, kdb_long_lo
 
 void elektraSaveKey (Elektra * elektra, Key * key, ElektraError ** error)
 {
+	// keys may be replaced or reloaded below, invalidate all resolved ElektraKeyHandles
+	++elektra->generation;
+
 	int ret = 0;
 	do
 	{
@@ -0,0 +1,291 @@
+/**
+ * @file
+ *
+ * @brief Elektra High Level API: pre-resolved key handles.
+ *
+ * @copyright BSD License (see doc/LICENSE.md or http://www.libelektra.org)
+ */
+
+#include "elektra.h"
+#include "elektra/conversion.h"
+#include "kdbhelper.h"
+#include "kdbprivate.h"
+
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup highlevel High-level API
+ * @{
+ */
+
+/**
+ * Resolves a key handle.
+ *
+ * The name and the type metadata of the key referenced by @p handle are only checked,
+ * if the handle was never resolved for @p elektra or if the internal state of @p elektra
+ * changed since. Otherwise the Key cached for @p handle is returned directly.
+ *
+ * The resolved keys are stored in a table inside @p elektra, which is allocated on first use
+ * and freed by elektraClose(). The handle itself is never modified, so the same handle may be
+ * used with multiple Elektra instances, even from different threads. An entry of the table is only used,
+ * if it was resolved with the same name and type pointers, so handles sharing an index are still resolved
+ * correctly, but the cache is less effective.
+ *
+ * @param elektra The Elektra instance to use.
+ * @param handle  The handle to resolve. Initialize it with #ELEKTRA_KEY_HANDLE_INIT.
+ * @return the Key referenced by @p handle or NULL, if a fatal error occurs and the fatal error handler returns to this function
+ *   The returned pointer remains valid until the KeySet inside @p elektra is modified. Calls to elektraSet*() functions may
+ *   cause such modifications. In any case, it becomes invalid when elektraClose() is called on @p elektra.
+ */
+Key * elektraResolveKeyHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	if (handle->index < elektra->resolvedKeysSize)
+	{
+		struct _ElektraResolvedKey * entry = &elektra->resolvedKeys[handle->index];
+		if (entry->name == handle->name && entry->type == handle->type && entry->generation == elektra->generation)
+		{
+			return entry->key;
+		}
+	}
+
+	Key * key = elektraFindKey (elektra, handle->name, handle->type);
+	if (key == NULL)
+	{
+		return NULL;
+	}
+
+	if (handle->index >= elektra->resolvedKeysSize)
+	{
+		size_t size = elektra->resolvedKeysSize * 2;
+		if (size <= handle->index)
+		{
+			size = handle->index + 1;
+		}
+
+		struct _ElektraResolvedKey * resolvedKeys = elektra->resolvedKeys;
+		if (elektraRealloc ((void **) &resolvedKeys, size * sizeof (struct _ElektraResolvedKey)) < 0)
+		{
+			// the key was found, we just cannot cache it
+			return key;
+		}
+		memset (&resolvedKeys[elektra->resolvedKeysSize], 0, (size - elektra->resolvedKeysSize) * sizeof (struct _ElektraResolvedKey));
+		elektra->resolvedKeys = resolvedKeys;
+		elektra->resolvedKeysSize = size;
+	}
+
+	struct _ElektraResolvedKey * entry = &elektra->resolvedKeys[handle->index];
+	entry->name = handle->name;
+	entry->type = handle->type;
+	entry->key = key;
+	entry->generation = elektra->generation;
+	return key;
+}
+
+#define ELEKTRA_GET_VALUE_BY_HANDLE(KEY_TO_VALUE, KDB_TYPE, elektra, handle, result)                                                       \
+	const Key * key = elektraResolveKeyHandle (elektra, handle);                                                                       \
+	if (key == NULL || !KEY_TO_VALUE (key, &result))                                                                                   \
+	{                                                                                                                                  \
+		elektraFatalError (elektra, elektraErrorConversionFromString (KDB_TYPE, handle->name, keyString (key)));                   \
+		result = 0;                                                                                                                \
+	}
+
+/**
+ * Gets a string value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the string stored at the given key
+ *   The returned pointer remains valid until the internal state of @p elektra is modified.
+ *   Calls to elektraSet*() functions may cause such modifications. In any case, it becomes
+ *   invalid when elektraClose() is called on @p elektra.
+ */
+const char * elektraGetStringByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	const char * result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToString, KDB_TYPE_STRING, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a boolean value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the boolean stored at the given key
+ */
+kdb_boolean_t elektraGetBooleanByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_boolean_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToBoolean, KDB_TYPE_BOOLEAN, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a char value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the char stored at the given key
+ */
+kdb_char_t elektraGetCharByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_char_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToChar, KDB_TYPE_CHAR, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets an octet value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the octet stored at the given key
+ */
+kdb_octet_t elektraGetOctetByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_octet_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToOctet, KDB_TYPE_OCTET, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a short value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the short stored at the given key
+ */
+kdb_short_t elektraGetShortByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_short_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToShort, KDB_TYPE_SHORT, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a unsigned short value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the unsigned short stored at the given key
+ */
+kdb_unsigned_short_t elektraGetUnsignedShortByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_unsigned_short_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToUnsignedShort, KDB_TYPE_UNSIGNED_SHORT, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a long value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the long stored at the given key
+ */
+kdb_long_t elektraGetLongByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_long_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToLong, KDB_TYPE_LONG, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a unsigned long value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the unsigned long stored at the given key
+ */
+kdb_unsigned_long_t elektraGetUnsignedLongByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_unsigned_long_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToUnsignedLong, KDB_TYPE_UNSIGNED_LONG, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a long long value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the long long stored at the given key
+ */
+kdb_long_long_t elektraGetLongLongByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_long_long_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToLongLong, KDB_TYPE_LONG_LONG, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a unsigned long long value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the unsigned long long stored at the given key
+ */
+kdb_unsigned_long_long_t elektraGetUnsignedLongLongByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_unsigned_long_long_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToUnsignedLongLong, KDB_TYPE_UNSIGNED_LONG_LONG, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a float value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the float stored at the given key
+ */
+kdb_float_t elektraGetFloatByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_float_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToFloat, KDB_TYPE_FLOAT, elektra, handle, result);
+	return result;
+}
+
+/**
+ * Gets a double value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the double stored at the given key
+ */
+kdb_double_t elektraGetDoubleByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_double_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToDouble, KDB_TYPE_DOUBLE, elektra, handle, result);
+	return result;
+}
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+/**
+ * Gets a long double value via a key handle.
+ *
+ * @param elektra The elektra instance to use.
+ * @param handle  The handle of the key to look up.
+ * @return the long double stored at the given key
+ */
+kdb_long_double_t elektraGetLongDoubleByHandle (Elektra * elektra, const ElektraKeyHandle * handle)
+{
+	kdb_long_double_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToLongDouble, KDB_TYPE_LONG_DOUBLE, elektra, handle, result);
+	return result;
+}
+
+#endif // ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+};
+#endif
@@ -34,11 +34,17 @@ static int getStatisticalValue (Key * informationKey, char * metaName)
 	char * test = elektraMalloc (keyGetValueSize (metaKey));
 	if (keyGetString (metaKey, test, keyGetValueSize (metaKey)) < 0)
 	{
+		elektraFree (test);
 		ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not get statistical value.");
 		return -1;
 	}
 	int asInt = atoi (test);
 	elektraFree (test);
+	if (asInt < 0)
+	{
+		ELEKTRA_SET_INTERNAL_ERRORF (informationKey, "Statistical value %s must not be negative.", metaName);
+		return -1;
+	}
 	return asInt;
 }
 
@@ -84,17 +90,89 @@ static int setStatisticalValue (Key * informationKey, char * metaName, int value
 }
 
 /**
- * @brief Increase a statistical value in an information key by one
+ * @brief State of a single merge
+ *
+ * The statistics are counted here and only written to the metadata of the information key once at the end.
+ */
+typedef struct
+{
+	Key * informationKey; ///< errors are set here, statistics are stored in its metadata
+	int nonOverlapOnlyBaseCounter;
+	int nonOverlapAllExistCounter;
+	int nonOverlapBaseEmptyCounter;
+	int overlap3different;
+	int overlap1empty;
+	int libgitConflicts;
+} MergeContext;
+
+/**
+ * @brief Initialize a merge context with the statistics already stored in an information key
+ * @param context the context to initialize
  * @param informationKey contains the statistics in its meta information
- * @param metaName which statistic to increase
- * @retval new value
+ * @retval 0 on success
+ * @retval -1 on error, the error is set in @p informationKey
+ */
+static int initMergeContext (MergeContext * context, Key * informationKey)
+{
+	struct
+	{
+		char * metaName;
+		int * value;
+	} statistics[] = {
+		{ "nonOverlapOnlyBaseCounter", &context->nonOverlapOnlyBaseCounter },
+		{ "nonOverlapAllExistCounter", &context->nonOverlapAllExistCounter },
+		{ "nonOverlapBaseEmptyCounter", &context->nonOverlapBaseEmptyCounter },
+		{ "overlap3different", &context->overlap3different },
+		{ "overlap1empty", &context->overlap1empty },
+		{ "libgitConflicts", &context->libgitConflicts },
+	};
+
+	context->informationKey = informationKey;
+	for (size_t i = 0; i < sizeof (statistics) / sizeof (statistics[0]); ++i)
+	{
+		*statistics[i].value = getStatisticalValue (informationKey, statistics[i].metaName);
+		if (*statistics[i].value < 0)
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Store the statistics of a merge context in the meta information of its information key
+ *
+ * Statistics that are 0 are not stored.
+ *
+ * @param context the context with the statistics
+ * @retval 0 on success
+ * @retval -1 on error
  */
-static int increaseStatisticalValue (Key * informationKey, char * metaName)
+static int writeStatistics (MergeContext * context)
 {
-	int value = getStatisticalValue (informationKey, metaName);
-	value++;
-	setStatisticalValue (informationKey, metaName, value);
-	return value;
+	struct
+	{
+		char * metaName;
+		int value;
+	} statistics[] = {
+		{ "nonOverlapOnlyBaseCounter", context->nonOverlapOnlyBaseCounter },
+		{ "nonOverlapAllExistCounter", context->nonOverlapAllExistCounter },
+		{ "nonOverlapBaseEmptyCounter", context->nonOverlapBaseEmptyCounter },
+		{ "overlap3different", context->overlap3different },
+		{ "overlap1empty", context->overlap1empty },
+		{ "libgitConflicts", context->libgitConflicts },
+	};
+
+	for (size_t i = 0; i < sizeof (statistics) / sizeof (statistics[0]); ++i)
+	{
+		if (statistics[i].value == 0) continue;
+
+		if (setStatisticalValue (context->informationKey, statistics[i].metaName, statistics[i].value) < 0)
+		{
+			return -1;
+		}
+	}
+	return 0;
 }
 
 /**
@@ -373,12 +451,12 @@ static bool keysAreEqual (Key * a, Key * b)
 }
 
 /**
- * @brief Helper function for checkSingleSet for when the key (name is relevant) is only in two of the three key sets
+ * @brief Helper function for checkSingleKey for when the key (name is relevant) is only in two of the three key sets
  * @retval -1 on error
  * @retval 0 on success
  */
 static int twoOfThreeExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, KeySet * result, bool checkedIsDominant,
-				  int baseIndicator, Key * informationKey)
+				  int baseIndicator, MergeContext * context)
 {
 	Key * existingKey;
 	bool thisConflict = false;
@@ -396,23 +474,23 @@ static int twoOfThreeExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyI
 	}
 	else
 	{
-		ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+		ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 		return -1;
 	}
 	if (thisConflict)
 	{
-		increaseStatisticalValue (informationKey, "nonOverlapBaseEmptyCounter");
+		context->nonOverlapBaseEmptyCounter++;
 	}
 	if (!keysAreEqual (checkedKey, existingKey))
 	{
 		// overlap  with single empty
 		// This spot is hit twice for a single overlap conflict. Thus calculate half later on.
-		increaseStatisticalValue (informationKey, "overlap1empty");
+		context->overlap1empty++;
 		if (checkedIsDominant)
 		{
 			if (ksAppendKey (result, checkedKey) < 0)
 			{
-				ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+				ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 				return -1;
 			}
 		}
@@ -432,12 +510,12 @@ static int twoOfThreeExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyI
 		{
 			// base is empty and other and their have the same (non-empty) value
 			// this is a conflict
-			increaseStatisticalValue (informationKey, "nonOverlapBaseEmptyCounter");
+			context->nonOverlapBaseEmptyCounter++;
 			if (checkedIsDominant)
 			{
 				if (ksAppendKey (result, checkedKey) < 0)
 				{
-					ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+					ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 					return -1;
 				}
 			}
@@ -452,7 +530,7 @@ static int twoOfThreeExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyI
  * @retval false otherwise
  */
 static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, KeySet * result, bool checkedIsDominant,
-				    int baseIndicator, Key * informationKey)
+				    int baseIndicator, MergeContext * context)
 {
 	/**
 	 * One example for the next 3 ifs
@@ -477,13 +555,13 @@ static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * ke
 			/** This is a non-overlap conflict
 			 *  Base is currently checked and has value A, their and our have a different value B
 			 */
-			increaseStatisticalValue (informationKey, "nonOverlapAllExistCounter");
+			context->nonOverlapAllExistCounter++;
 			if (checkedIsDominant)
 			{
 				// If base is also dominant then append it's key
 				if (ksAppendKey (result, checkedKey) < 0)
 				{
-					ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+					ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 				}
 			}
 		}
@@ -495,7 +573,7 @@ static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * ke
 		{
 			if (ksAppendKey (result, keyInSecond) < 0)
 			{
-				ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+				ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 			}
 		}
 		else
@@ -506,13 +584,13 @@ static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * ke
 				 *  Base is currently secondCompare and has value A, their and our have a different
 				 *  value B
 				 */
-				increaseStatisticalValue (informationKey, "nonOverlapAllExistCounter");
+				context->nonOverlapAllExistCounter++;
 				if (checkedIsDominant)
 				{
 					// If base is also dominant then append it's key
 					if (ksAppendKey (result, checkedKey) < 0)
 					{
-						ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+						ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 					}
 				}
 			}
@@ -526,7 +604,7 @@ static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * ke
 		{
 			if (ksAppendKey (result, keyInFirst) < 0)
 			{
-				ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+				ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 			}
 		}
 		else
@@ -537,13 +615,13 @@ static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * ke
 				 *  Base is currently firstCompare and has value A, their and our have a different
 				 *  value B
 				 */
-				increaseStatisticalValue (informationKey, "nonOverlapAllExistCounter");
+				context->nonOverlapAllExistCounter++;
 				if (checkedIsDominant)
 				{
 					// If base is also dominant then append it's key
 					if (ksAppendKey (result, checkedKey) < 0)
 					{
-						ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+						ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 					}
 				}
 			}
@@ -557,12 +635,12 @@ static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * ke
 }
 
 /**
- * @brief Helper function for checkSingleSet for when a key exists in all key sets.
+ * @brief Helper function for checkSingleKey for when a key exists in all key sets.
  * @retval -1 on error
  * @retval 0 on success
  */
 static int allExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, KeySet * result, bool checkedIsDominant,
-			   int baseIndicator, Key * informationKey)
+			   int baseIndicator, MergeContext * context)
 {
 	if (keysAreEqual (checkedKey, keyInFirst) && keysAreEqual (checkedKey, keyInSecond))
 	{
@@ -572,27 +650,27 @@ static int allExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyInSecond
 		 */
 		if (ksAppendKey (result, checkedKey) < 0)
 		{
-			ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+			ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 			return -1;
 		}
 	}
 	else
 	{
-		if (!twoOfThoseKeysAreEqual (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator, informationKey))
+		if (!twoOfThoseKeysAreEqual (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator, context))
 		{
 			/**
 			 * Overlap conflict case
 			 *
 			 * The same overlap conflict gets detected three times, once for each of the three invocations of
-			 * checkSingleSet. However, only one of those three times is required. Thus use a getter function
+			 * checkSingleKey. However, only one of those three times is required. Thus use a getter function
 			 * that calculates a third.
 			 */
-			increaseStatisticalValue (informationKey, "overlap3different");
+			context->overlap3different++;
 			if (checkedIsDominant)
 			{
 				if (ksAppendKey (result, checkedKey) < 0)
 				{
-					ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+					ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
 					return -1;
 				}
 			}
@@ -603,62 +681,115 @@ static int allExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyInSecond
 
 
 /**
- * and the element is not already in the result key set.
- * It should be called 3 times, each time with a different of our key set, their key set and base key set as checkedSet parameter.
- * Which of the remaining two key sets is firstCompared or secondCompared is irrelevant.
+ * @brief Classifies a single key with respect to the keys with the same name in the other two key sets.
  *
- * @param checkedIsDominant parameter is for the merge strategy. If a conflict occurs and checkedIsDominant is true then the current element
- * of checkedSet is inserted. Consequently, it has to be set to true for exactly one of the three calls of this function.
+ * It is called up to 3 times per key name, each time with a different of our key, their key and base key as checkedKey parameter.
+ * Which of the remaining two keys is keyInFirst or keyInSecond is irrelevant.
  *
- * @param baseIndicator indicates which of the three key sets is the base key set. 0 is checkedSet, 1 firstcompared, 2 secondCompared
- * @param informationKey will contain information if an error ocurred
+ * @param checkedIsDominant parameter is for the merge strategy. If a conflict occurs and checkedIsDominant is true then checkedKey
+ * is inserted. Consequently, it has to be set to true for exactly one of the three key sets.
+ *
+ * @param baseIndicator indicates which of the three keys is from the base key set. 0 is checkedKey, 1 keyInFirst, 2 keyInSecond
+ * @param context counts the conflicts, errors are set on its information key
  *
  * @retval -1 on error
  * @retval 0 on success
  *
  */
-static int checkSingleSet (KeySet * checkedSet, KeySet * firstCompared, KeySet * secondCompared, KeySet * result, bool checkedIsDominant,
-			   int baseIndicator, Key * informationKey)
+static int checkSingleKey (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, KeySet * result, bool checkedIsDominant,
+			   int baseIndicator, MergeContext * context)
 {
-	for (elektraCursor it = 0; it < ksGetSize (checkedSet); ++it)
+	if (keyInFirst != NULL && keyInSecond != NULL)
 	{
-		Key * checkedKey = ksAtCursor (checkedSet, it);
-		/**
-		 * Check if a key with the same name exists
-		 * Nothing about values is said yet
-		 */
-		Key * keyInFirst = ksLookup (firstCompared, checkedKey, 0);
-		Key * keyInSecond = ksLookup (secondCompared, checkedKey, 0);
-		if (keyInFirst != NULL && keyInSecond != NULL)
+		return allExistHelper (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator, context);
+	}
+	else if (keyInFirst == NULL && keyInSecond == NULL)
+	{
+		if (baseIndicator == 0)
 		{
-			allExistHelper (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator, informationKey);
+			/**
+			 * Non-overlap conflict https://www.gnu.org/software/diffutils/manual/html_node/diff3-Merging.html
+			 *
+			 * Here keys from base could be appended. But doing so is not useful.
+			 */
+			context->nonOverlapOnlyBaseCounter++;
 		}
-		else if (keyInFirst == NULL && keyInSecond == NULL)
+		else
 		{
-			if (baseIndicator == 0)
-			{
-				/**
-				 * Non-overlap conflict https://www.gnu.org/software/diffutils/manual/html_node/diff3-Merging.html
-				 *
-				 * Here keys from base could be appended. But doing so is not useful.
-				 */
-				increaseStatisticalValue (informationKey, "nonOverlapOnlyBaseCounter");
-			}
-			else
+			if (ksAppendKey (result, checkedKey) < 0)
 			{
-				if (ksAppendKey (result, checkedKey) < 0)
-				{
-					ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-				}
+				ELEKTRA_SET_INTERNAL_ERROR (context->informationKey, "Could not append key.");
+				return -1;
 			}
 		}
-		else
+		return 0;
+	}
+	else
+	{
+		return twoOfThreeExistHelper (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator, context);
+	}
+}
+
+/**
+ * @brief Returns the key at @p it in @p ks, if it has the same name as @p name
+ * @retval NULL if there is no such key
+ */
+static Key * keyAtCursorIfSame (KeySet * ks, elektraCursor it, const Key * name)
+{
+	Key * key = ksAtCursor (ks, it);
+	return key != NULL && keyCmp (key, name) == 0 ? key : NULL;
+}
+
+/**
+ * @brief Walks over the three key sets simultaneously and classifies the keys of each name
+ *
+ * All three key sets are sorted, so a single pass with one cursor per key set visits every name exactly once.
+ * The keys of each name are passed to checkSingleKey() in the order base, their, our. Thus, a key appended later
+ * for the same name replaces the one appended earlier, and names are appended to @p result in sorted order.
+ */
+static void checkAllSets (KeySet * baseSet, KeySet * ourSet, KeySet * theirSet, KeySet * result, bool ourDominant, bool theirDominant,
+			 MergeContext * context)
+{
+	elektraCursor baseIt = 0;
+	elektraCursor ourIt = 0;
+	elektraCursor theirIt = 0;
+	while (baseIt < ksGetSize (baseSet) || ourIt < ksGetSize (ourSet) || theirIt < ksGetSize (theirSet))
+	{
+		// find the smallest name at the cursors
+		const Key * name = ksAtCursor (baseSet, baseIt);
+		const Key * ourKey = ksAtCursor (ourSet, ourIt);
+		const Key * theirKey = ksAtCursor (theirSet, theirIt);
+		if (name == NULL || (ourKey != NULL && keyCmp (ourKey, name) < 0))
+		{
+			name = ourKey;
+		}
+		if (name == NULL || (theirKey != NULL && keyCmp (theirKey, name) < 0))
+		{
+			name = theirKey;
+		}
+
+		Key * keyInBase = keyAtCursorIfSame (baseSet, baseIt, name);
+		Key * keyInOur = keyAtCursorIfSame (ourSet, ourIt, name);
+		Key * keyInTheir = keyAtCursorIfSame (theirSet, theirIt, name);
+
+		if (keyInBase != NULL)
+		{
+			// base is never dominant
+			checkSingleKey (keyInBase, keyInOur, keyInTheir, result, false, 0, context);
+		}
+		if (keyInTheir != NULL)
 		{
-			twoOfThreeExistHelper (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator,
-					       informationKey);
+			checkSingleKey (keyInTheir, keyInBase, keyInOur, result, theirDominant, 1, context);
 		}
+		if (keyInOur != NULL)
+		{
+			checkSingleKey (keyInOur, keyInTheir, keyInBase, result, ourDominant, 2, context);
+		}
+
+		if (keyInBase != NULL) ++baseIt;
+		if (keyInOur != NULL) ++ourIt;
+		if (keyInTheir != NULL) ++theirIt;
 	}
-	return 0;
 }
 
 #ifdef LIBGITFOUND
@@ -839,9 +970,10 @@ static int numberOfConflictMarkers (const char * text)
  * @retval 0 on success
  * @retval -1 on error
  */
-static int handleArrays (KeySet * ourSet, KeySet * theirSet, KeySet * baseSet, KeySet * resultSet, Key * informationKey, int strategy)
+static int handleArrays (KeySet * ourSet, KeySet * theirSet, KeySet * baseSet, KeySet * resultSet, MergeContext * context, int strategy)
 {
 	ELEKTRA_LOG ("cmerge now handles arrays");
+	Key * informationKey = context->informationKey;
 	KeySet * toAppend = NULL;
 
 	for (elektraCursor it = 0; it < ksGetSize (baseSet); ++it)
@@ -915,9 +1047,7 @@ static int handleArrays (KeySet * ourSet, KeySet * theirSet, KeySet * baseSet, K
 						ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Expected merge strategy abort.");
 					}
 					int currentNumberOfConflicts = numberOfConflictMarkers (out.ptr);
-					int previousNumberOfConflicts = getStatisticalValue (informationKey, "libgitConflicts");
-					int newNumberOfConflicts = previousNumberOfConflicts + currentNumberOfConflicts;
-					setStatisticalValue (informationKey, "libgitConflicts", newNumberOfConflicts);
+					context->libgitConflicts += currentNumberOfConflicts;
 					char msg[300];
 					snprintf (msg, 300, "libgit could not automerge an array. It contains %d conflict markers.",
 						  currentNumberOfConflicts);
@@ -970,6 +1100,12 @@ KeySet * elektraMerge (KeySet * our, Key * ourRoot, KeySet * their, Key * theirR
 {
 	ELEKTRA_LOG ("cmerge starts with strategy %d (see kdbmerge.h)", strategy);
 
+	MergeContext context;
+	if (initMergeContext (&context, informationKey) < 0)
+	{
+		return NULL;
+	}
+
 	KeySet * ourCropped = removeRoot (our, ourRoot, informationKey);
 	if (ourCropped == NULL)
 	{
@@ -1004,7 +1140,7 @@ KeySet * elektraMerge (KeySet * our, Key * ourRoot, KeySet * their, Key * theirR
 #ifdef LIBGITFOUND
 	git_libgit2_init ();
 	ELEKTRA_LOG ("cmerge can use libgit2 to handle arrays");
-	if (handleArrays (ourCropped, theirCropped, baseCropped, result, informationKey, strategy) > 0)
+	if (handleArrays (ourCropped, theirCropped, baseCropped, result, &context, strategy) > 0)
 	{
 		ksDel (result);
 		return NULL;
@@ -1013,9 +1149,15 @@ KeySet * elektraMerge (KeySet * our, Key * ourRoot, KeySet * their, Key * theirR
 	ELEKTRA_LOG ("cmerge can NOT use libgit2 to handle arrays");
 #endif
 
-	checkSingleSet (baseCropped, ourCropped, theirCropped, result, false, 0, informationKey); // base is never dominant
-	checkSingleSet (theirCropped, baseCropped, ourCropped, result, theirDominant, 1, informationKey);
-	checkSingleSet (ourCropped, theirCropped, baseCropped, result, ourDominant, 2, informationKey);
+	checkAllSets (baseCropped, ourCropped, theirCropped, result, ourDominant, theirDominant, &context);
+	if (writeStatistics (&context) < 0)
+	{
+		ksDel (ourCropped);
+		ksDel (theirCropped);
+		ksDel (baseCropped);
+		ksDel (result);
+		return NULL;
+	}
 	ksRewind (ourCropped);
 
 	if (ksDel (ourCropped) != 0 || ksDel (theirCropped) != 0 || ksDel (baseCropped) != 0)
@@ -8,12 +8,14 @@
 
 #include <kdbopts.h>
 
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <kdbease.h>
 #include <kdbhelper.h>
 #include <kdbmeta.h>
+#include <kdbprivate.h>
 
 #include <kdbassert.h>
 #include <kdberrors.h>
@@ -38,6 +40,18 @@ struct OptionData
 	bool hidden;
 };
 
+// Metadata of a key in Specification.keys, decoded once by indexSpecKeys() for getOpts().
+struct KeyOptions
+{
+	Key ** opts; // lookup keys for the metadata array opt
+	size_t optsSize;
+	Key ** envs; // lookup keys for the metadata array env
+	size_t envsSize;
+	const char * args;
+	bool isCommand;
+	bool isArray;
+};
+
 struct Specification
 {
 	KeySet * options;
@@ -45,6 +59,7 @@ struct Specification
 	KeySet * argIndices;
 	KeySet * commands;
 	bool useSubcommands;
+	struct KeyOptions * keyOptions; // same order as keys, NULL until indexSpecKeys() is called
 };
 
 /**
@@ -101,9 +116,10 @@ static bool processLongOptSpec (struct Specification * spec, struct OptionData *
 static bool processEnvVars (KeySet * usedEnvVars, Key * specKey, Key ** keyWithOpt, Key * errorKey);
 static bool processArgs (Key * command, Key * specKey, KeySet * argIndices, Key ** keyWithOpt, Key * errorKey);
 
-static int writeOptionValues (KeySet * ks, Key * keyWithOpt, KeySet * options, Key * errorKey);
-static int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, KeySet * envValues, Key * errorKey);
-static int writeArgsValues (KeySet * ks, Key * keyWithOpt, Key * command, KeySet * argIndices, KeySet * args, Key * errorKey);
+static int writeOptionValues (KeySet * ks, Key * keyWithOpt, const struct KeyOptions * keyOptions, KeySet * options, Key * errorKey);
+static int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, const struct KeyOptions * keyOptions, KeySet * envValues, Key * errorKey);
+static int writeArgsValues (KeySet * ks, Key * keyWithOpt, const struct KeyOptions * keyOptions, Key * command, KeySet * argIndices,
+			    KeySet * args, Key * errorKey);
 
 static bool parseLongOption (Key * command, KeySet * optionsSpec, KeySet * options, int argc, const char ** argv, int * index,
 			     Key * errorKey);
@@ -113,6 +129,16 @@ static bool parseShortOptions (Key * command, KeySet * optionsSpec, KeySet * opt
 static int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool writeArgs, bool * argsWritten, KeySet * options,
 			 struct Specification * spec, KeySet * ks, const char * progname, const char ** envp, Key * parentKey);
 
+static int getOpts (struct Specification * spec, KeySet * ks, int argc, const char ** argv, const char ** envp, Key * parentKey);
+static void indexSpecKeys (struct Specification * spec);
+static void freeSpec (struct Specification * spec);
+static void writeSpecTable (KeySet * table, KeySet * part, const char * prefix, const Key * tableRoot, const char * partName);
+static KeySet * readSpecTable (KeySet * table, const Key * tableRoot, const char * partName, const char * prefix);
+static char * specFingerprint (KeySet * ks, Key * specParent);
+static bool isVerifiedSpec (ElektraOptsTable * table, KeySet * ks, Key * specParent);
+static void rememberVerifiedSpec (ElektraOptsTable * table, KeySet * ks, Key * specParent);
+static void forgetVerifiedSpec (ElektraOptsTable * table);
+
 /**
  * This functions parses a specification of program options, together with a list of arguments
  * and environment variables to extract the option values.
@@ -155,31 +181,262 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 		keyDel (specParent);
 		return -1;
 	}
+	keyDel (specParent);
 
-	Key * command = keyNew ("/", KEY_END);
-	Key * commandKey = keyNew (keyName (specParent), KEY_END);
-	Key * commandArgs = keyNew ("/", KEY_END);
+	indexSpecKeys (&spec);
+	int result = getOpts (&spec, ks, argc, argv, envp, parentKey);
+	freeSpec (&spec);
+	return result;
+}
+
+/**
+ * Processes the specification of program options in @p ks like elektraGetOpts() does, but instead of parsing
+ * any arguments, the processed specification is stored as a table below @p tableRoot in @p table.
+ *
+ * The table can be passed to elektraGetOptsPrecompiled(), which then skips processing the specification.
+ * This is meant for applications, whose specification is already known at compile-time, e.g. the code
+ * generated by `kdb gen`. The table also stores a fingerprint of the spec keys, so that changes of the
+ * specification after the table was created are detected.
+ *
+ * @param ks	    The KeySet containing the specification for the options.
+ * @param parentKey The parent key below which the function will search for option specifications.
+ *                  Also used for error reporting. It is translated into the spec namespace like in elektraGetOpts().
+ * @param table     The KeySet the table will be added to. Existing keys below @p tableRoot are removed.
+ * @param tableRoot The root key of the table. It must not be a cascading key.
+ *
+ * @retval 0	on success
+ * @retval -1	on error, the error will be set as metadata in @p parentKey, @p table will not be modified
+ */
+int elektraGetOptsPrecompile (KeySet * ks, Key * parentKey, KeySet * table, const Key * tableRoot)
+{
+	Key * specParent = keyDup (parentKey, KEY_CP_ALL);
+	keySetNamespace (specParent, KEY_NS_SPEC);
+
+	// calculated before processSpec, like in elektraGetOptsPrecompiled
+	char * fingerprintValue = specFingerprint (ks, specParent);
+
+	struct Specification spec;
+	if (!processSpec (&spec, ks, specParent, parentKey))
+	{
+		elektraFree (fingerprintValue);
+		keyDel (specParent);
+		return -1;
+	}
+
+	Key * root = keyNew (keyName (tableRoot), KEY_VALUE, keyName (specParent), KEY_END);
+	Key * subcommands = keyNew (keyName (tableRoot), KEY_VALUE, spec.useSubcommands ? "1" : "0", KEY_END);
+	keyAddBaseName (subcommands, "subcommands");
+
+	Key * fingerprint = keyNew (keyName (tableRoot), KEY_VALUE, fingerprintValue, KEY_END);
+	keyAddBaseName (fingerprint, "fingerprint");
+	elektraFree (fingerprintValue);
+
+	KeySet * result = ksNew (3, root, subcommands, fingerprint, KS_END);
+	writeSpecTable (result, spec.options, "/", root, "options");
+	writeSpecTable (result, spec.keys, keyName (specParent), root, "keys");
+	writeSpecTable (result, spec.argIndices, "/", root, "argindices");
+	writeSpecTable (result, spec.commands, "/", root, "commands");
+
+	keyDel (specParent);
+	freeSpec (&spec);
+
+	ksDel (ksCut (table, tableRoot));
+	ksAppend (table, result);
+	ksDel (result);
+	return 0;
+}
+
+/**
+ * Works like elektraGetOpts(), but uses a specification that was already processed by elektraGetOptsPrecompile().
+ *
+ * This decodes @p table on every call. Applications calling this repeatedly with the same table should
+ * decode it once with elektraOptsTableNew() and use elektraGetOptsTable() instead.
+ *
+ * @param ks	    The KeySet containing the specification for the options. The option values will be written to it.
+ * @param table     The KeySet containing the table created by elektraGetOptsPrecompile().
+ * @param tableRoot The root key of the table.
+ * @param argc	    The number of strings in argv.
+ * @param argv	    The arguments to be processed.
+ * @param envp	    A list of environment variables. This needs to be a null-terminated list of
+ * 		    strings of the format 'KEY=VALUE'.
+ * @param parentKey The parent key used to create the table. Also used for error reporting.
+ *
+ * @retval 0	on success, this is the only case in which @p ks will be modified
+ * @retval -1	on error, the error will be set as metadata in @p parentKey
+ * @retval 1	if the help option `--help` was found, use elektraGetOptsHelpMessage() access the
+ * 		generated help message
+ *
+ * @see elektraGetOptsTable()
+ */
+int elektraGetOptsPrecompiled (KeySet * ks, KeySet * table, const Key * tableRoot, int argc, const char ** argv, const char ** envp,
+			       Key * parentKey)
+{
+	Key * specParent = keyDup (parentKey, KEY_CP_NAME);
+	keySetNamespace (specParent, KEY_NS_SPEC);
+
+	const Key * root = ksLookupByName (table, keyName (tableRoot), 0);
+	if (root == NULL || strcmp (keyString (root), keyName (specParent)) != 0)
+	{
+		ELEKTRA_SET_INTERFACE_ERRORF (parentKey, "The option table '%s' was not created for the parent key '%s'",
+					      keyName (tableRoot), keyName (specParent));
+		keyDel (specParent);
+		return -1;
+	}
+	keyDel (specParent);
+
+	ElektraOptsTable * decoded = elektraOptsTableNew (table, tableRoot);
+	int result = elektraGetOptsTable (ks, decoded, argc, argv, envp, parentKey);
+	elektraOptsTableDel (decoded);
+	return result;
+}
+
+struct _ElektraOptsTable
+{
+	char * specParent;
+	char * fingerprint;
+	struct Specification spec;
+
+	// spec keys and their metadata keys, in the order of ks, from the last matching fingerprint
+	Key ** verified;
+	size_t verifiedSize;
+};
+
+/**
+ * Decodes a table created by elektraGetOptsPrecompile(), so that it can be used by elektraGetOptsTable().
+ *
+ * @param table     The KeySet containing the table. It is not referenced by the returned object.
+ * @param tableRoot The root key of the table.
+ *
+ * @return the decoded table, free it with elektraOptsTableDel()
+ * @retval NULL if there is no table below @p tableRoot
+ */
+ElektraOptsTable * elektraOptsTableNew (KeySet * table, const Key * tableRoot)
+{
+	const Key * root = ksLookupByName (table, keyName (tableRoot), 0);
+	if (root == NULL)
+	{
+		return NULL;
+	}
+
+	Key * fingerprintLookup = keyDup (tableRoot, KEY_CP_NAME);
+	keyAddBaseName (fingerprintLookup, "fingerprint");
+	const Key * fingerprint = ksLookup (table, fingerprintLookup, KDB_O_DEL);
+
+	Key * subcommandsLookup = keyDup (tableRoot, KEY_CP_NAME);
+	keyAddBaseName (subcommandsLookup, "subcommands");
+	const Key * subcommands = ksLookup (table, subcommandsLookup, KDB_O_DEL);
+
+	ElektraOptsTable * decoded = elektraCalloc (sizeof (ElektraOptsTable));
+	decoded->specParent = elektraStrDup (keyString (root));
+	decoded->fingerprint = elektraStrDup (fingerprint == NULL ? "" : keyString (fingerprint));
+	decoded->spec.options = readSpecTable (table, root, "options", "/");
+	decoded->spec.keys = readSpecTable (table, root, "keys", decoded->specParent);
+	decoded->spec.argIndices = readSpecTable (table, root, "argindices", "/");
+	decoded->spec.commands = readSpecTable (table, root, "commands", "/");
+	decoded->spec.useSubcommands = subcommands != NULL && strcmp (keyString (subcommands), "1") == 0;
+	indexSpecKeys (&decoded->spec);
+	return decoded;
+}
+
+/**
+ * Frees a table decoded by elektraOptsTableNew().
+ *
+ * @param table the table to free, may be NULL
+ */
+void elektraOptsTableDel (ElektraOptsTable * table)
+{
+	if (table == NULL)
+	{
+		return;
+	}
+
+	forgetVerifiedSpec (table);
+	freeSpec (&table->spec);
+	elektraFree (table->specParent);
+	elektraFree (table->fingerprint);
+	elektraFree (table);
+}
+
+/**
+ * Works like elektraGetOptsPrecompiled(), but uses a table decoded by elektraOptsTableNew().
+ *
+ * The decoded specification is used directly, nothing is copied per call.
+ * The spec keys in @p ks are only used to detect changes of the specification. If it differs from the one
+ * the table was created for, the table is ignored and elektraGetOpts() processes the spec keys in @p ks instead.
+ *
+ * After a successful comparison, @p table keeps references to the spec keys and their metadata. As long as
+ * the same keys (by identity) are passed again, the fingerprint is not recalculated. Since key names are
+ * locked once a key is added to a KeySet and metadata keys are read-only, equal identities imply an equal
+ * specification.
+ *
+ * @param ks	    The KeySet containing the specification for the options. The option values will be written to it.
+ * @param table     The table decoded by elektraOptsTableNew().
+ * @param argc	    The number of strings in argv.
+ * @param argv	    The arguments to be processed.
+ * @param envp	    A list of environment variables. This needs to be a null-terminated list of
+ * 		    strings of the format 'KEY=VALUE'.
+ * @param parentKey The parent key used to create the table. Also used for error reporting.
+ *
+ * @retval 0	on success, this is the only case in which @p ks will be modified
+ * @retval -1	on error, the error will be set as metadata in @p parentKey
+ * @retval 1	if the help option `--help` was found, use elektraGetOptsHelpMessage() access the
+ * 		generated help message
+ */
+int elektraGetOptsTable (KeySet * ks, ElektraOptsTable * table, int argc, const char ** argv, const char ** envp, Key * parentKey)
+{
+	Key * specParent = keyDup (parentKey, KEY_CP_NAME);
+	keySetNamespace (specParent, KEY_NS_SPEC);
 
+	if (strcmp (table->specParent, keyName (specParent)) != 0)
+	{
+		ELEKTRA_SET_INTERFACE_ERRORF (parentKey, "The option table for '%s' was not created for the parent key '%s'",
+					      table->specParent, keyName (specParent));
+		keyDel (specParent);
+		return -1;
+	}
+
+	if (!isVerifiedSpec (table, ks, specParent))
+	{
+		char * currentFingerprint = specFingerprint (ks, specParent);
+		bool outdated = strcmp (table->fingerprint, currentFingerprint) != 0;
+		elektraFree (currentFingerprint);
+		if (outdated)
+		{
+			keyDel (specParent);
+			return elektraGetOpts (ks, argc, argv, envp, parentKey);
+		}
+		rememberVerifiedSpec (table, ks, specParent);
+	}
 	keyDel (specParent);
 
-	if (spec.useSubcommands)
+	return getOpts (&table->spec, ks, argc, argv, envp, parentKey);
+}
+
+/**
+ * Parses @p argv and @p envp according to the already processed specification @p spec
+ * and writes the option values into @p ks. See elektraGetOpts() for details.
+ */
+static int getOpts (struct Specification * spec, KeySet * ks, int argc, const char ** argv, const char ** envp, Key * parentKey)
+{
+	Key * command = keyNew ("/", KEY_END);
+	Key * commandKey = keyDup (parentKey, KEY_CP_NAME);
+	keySetNamespace (commandKey, KEY_NS_SPEC);
+	Key * commandArgs = keyNew ("/", KEY_END);
+
+	if (spec->useSubcommands)
 	{
 		int lastEndArg = 0;
 		while (lastEndArg < argc)
 		{
 			int endArg = -1;
 			KeySet * options =
-				parseArgs (command, spec.options, true, argc - lastEndArg, argv + lastEndArg, &endArg, parentKey);
+				parseArgs (command, spec->options, true, argc - lastEndArg, argv + lastEndArg, &endArg, parentKey);
 
 			if (options == NULL)
 			{
 				keyDel (command);
 				keyDel (commandKey);
 				keyDel (commandArgs);
-				ksDel (spec.options);
-				ksDel (spec.keys);
-				ksDel (spec.argIndices);
-				ksDel (spec.commands);
 				return -1;
 			}
 
@@ -188,14 +445,14 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 			{
 				endArg += lastEndArg;
 
-				Key * commandSpec = ksLookup (spec.keys, commandKey, 0);
+				Key * commandSpec = ksLookup (spec->keys, commandKey, 0);
 				Key * commandLookup = keyNew ("meta:/command", KEY_END);
 				keyAddBaseName (commandLookup, argv[endArg]);
 				subCommand = ksLookup (keyMeta (commandSpec), commandLookup, KDB_O_DEL);
 			}
 
 			bool argsWritten = false;
-			int result = writeOptions (command, commandKey, commandArgs, subCommand == NULL, &argsWritten, options, &spec, ks,
+			int result = writeOptions (command, commandKey, commandArgs, subCommand == NULL, &argsWritten, options, spec, ks,
 						   argv[0], envp, parentKey);
 			ksDel (options);
 
@@ -204,10 +461,6 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 				keyDel (command);
 				keyDel (commandKey);
 				keyDel (commandArgs);
-				ksDel (spec.options);
-				ksDel (spec.keys);
-				ksDel (spec.argIndices);
-				ksDel (spec.commands);
 				return result;
 			}
 
@@ -217,10 +470,6 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 				keyDel (command);
 				keyDel (commandKey);
 				keyDel (commandArgs);
-				ksDel (spec.options);
-				ksDel (spec.keys);
-				ksDel (spec.argIndices);
-				ksDel (spec.commands);
 				return -1;
 			}
 
@@ -233,10 +482,6 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 				keyDel (command);
 				keyDel (commandKey);
 				keyDel (commandArgs);
-				ksDel (spec.options);
-				ksDel (spec.keys);
-				ksDel (spec.argIndices);
-				ksDel (spec.commands);
 				return 0;
 			}
 
@@ -255,29 +500,21 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 	else
 	{
 		int endArg = 0;
-		KeySet * options = parseArgs (command, spec.options, false, argc, argv, &endArg, parentKey);
+		KeySet * options = parseArgs (command, spec->options, false, argc, argv, &endArg, parentKey);
 
 		if (options == NULL)
 		{
 			keyDel (command);
 			keyDel (commandKey);
 			keyDel (commandArgs);
-			ksDel (spec.options);
-			ksDel (spec.keys);
-			ksDel (spec.argIndices);
-			ksDel (spec.commands);
 			return -1;
 		}
 
-		int result = writeOptions (command, commandKey, commandArgs, true, NULL, options, &spec, ks, argv[0], envp, parentKey);
+		int result = writeOptions (command, commandKey, commandArgs, true, NULL, options, spec, ks, argv[0], envp, parentKey);
 		keyDel (command);
 		keyDel (commandKey);
 		keyDel (commandArgs);
 		ksDel (options);
-		ksDel (spec.options);
-		ksDel (spec.keys);
-		ksDel (spec.argIndices);
-		ksDel (spec.commands);
 		return result;
 	}
 }
@@ -647,6 +884,7 @@ bool processSpec (struct Specification * spec, KeySet * ks, Key * specParent, Ke
 	}
 
 	spec->useSubcommands = useSubcommands;
+	spec->keyOptions = NULL;
 
 	return true;
 }
@@ -1207,24 +1445,16 @@ bool processArgs (Key * command, Key * specKey, KeySet * argIndices, Key ** keyW
  * @retval 0 if no key was added
  * @retval 1 if keys were added to @p ks
  */
-int writeOptionValues (KeySet * ks, Key * keyWithOpt, KeySet * options, Key * errorKey)
+int writeOptionValues (KeySet * ks, Key * keyWithOpt, const struct KeyOptions * keyOptions, KeySet * options, Key * errorKey)
 {
 	bool valueFound = false;
-
-	KeySet * optMetas = elektraMetaArrayToKS (keyWithOpt, "opt");
-	if (optMetas == NULL)
-	{
-		return 0;
-	}
-
 	bool shortFound = false;
 
-	for (elektraCursor it = 1; it < ksGetSize (optMetas); ++it) // skip count
+	for (size_t i = 0; i < keyOptions->optsSize; ++i)
 	{
-		Key * optMeta = ksAtCursor (optMetas, it);
-		Key * optLookup = keyNew (keyString (optMeta), KEY_END);
-		Key * optKey = ksLookup (options, optLookup, KDB_O_DEL);
-		bool isShort = strncmp (keyString (optMeta), "/short", 6) == 0;
+		Key * optLookup = keyOptions->opts[i];
+		Key * optKey = ksLookup (options, optLookup, 0);
+		bool isShort = strncmp (keyName (optLookup), "/short", 6) == 0;
 		if (shortFound && !isShort)
 		{
 			// ignore long options, if a short one was found
@@ -1246,13 +1476,10 @@ int writeOptionValues (KeySet * ks, Key * keyWithOpt, KeySet * options, Key * er
 				errorKey, "The option '%s%s' cannot be used, because another option has already been used for the key '%s'",
 				isShort ? "-" : "--", isShort ? (const char[]){ keyBaseName (optKey)[0], '\0' } : keyBaseName (optKey),
 				keyName (keyWithOpt));
-			ksDel (optMetas);
 			return -1;
 		}
 	}
 
-	ksDel (optMetas);
-
 	return valueFound ? 1 : 0;
 }
 
@@ -1263,28 +1490,20 @@ int writeOptionValues (KeySet * ks, Key * keyWithOpt, KeySet * options, Key * er
  * @retval 0 if no key was added
  * @retval 1 if keys were added to @p ks
  */
-int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, KeySet * envValues, Key * errorKey)
+int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, const struct KeyOptions * keyOptions, KeySet * envValues, Key * errorKey)
 {
 	bool valueFound = false;
 
-	KeySet * envMetas = elektraMetaArrayToKS (keyWithOpt, "env");
-	if (envMetas == NULL)
-	{
-		return 0;
-	}
-
-	for (elektraCursor it = 1; it < ksGetSize (envMetas); ++it) // skip count
+	for (size_t i = 0; i < keyOptions->envsSize; ++i)
 	{
-		Key * envMeta = ksAtCursor (envMetas, it);
-		Key * envKey = ksLookupByName (envValues, keyString (envMeta), 0);
+		Key * envKey = ksLookup (envValues, keyOptions->envs[i], 0);
 
-		bool isArray = strcmp (keyBaseName (keyWithOpt), "#") == 0;
 		Key * envValueKey;
 		if (envKey == NULL)
 		{
 			envValueKey = NULL;
 		}
-		else if (isArray)
+		else if (keyOptions->isArray)
 		{
 			envValueKey = splitEnvValue (envKey);
 		}
@@ -1302,7 +1521,6 @@ int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, KeySet * envValues, Key *
 				"already been used for the key '%s'.",
 				keyBaseName (envKey), keyName (keyWithOpt));
 			keyDel (envValueKey);
-			ksDel (envMetas);
 			return -1;
 		}
 		else if (res == 0)
@@ -1311,7 +1529,6 @@ int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, KeySet * envValues, Key *
 		}
 		keyDel (envValueKey);
 	}
-	ksDel (envMetas);
 
 	return valueFound ? 1 : 0;
 }
@@ -1323,9 +1540,10 @@ int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, KeySet * envValues, Key *
  * @retval 0 if no key was added
  * @retval 1 if keys were added to @p ks
  */
-int writeArgsValues (KeySet * ks, Key * keyWithOpt, Key * command, KeySet * argIndices, KeySet * args, Key * errorKey)
+int writeArgsValues (KeySet * ks, Key * keyWithOpt, const struct KeyOptions * keyOptions, Key * command, KeySet * argIndices,
+		     KeySet * args, Key * errorKey)
 {
-	const char * argsMeta = keyGetMetaString (keyWithOpt, "args");
+	const char * argsMeta = keyOptions->args;
 	if (argsMeta == NULL)
 	{
 		return 0;
@@ -1860,10 +2078,11 @@ int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool write
 		for (elektraCursor it = 0; it < ksGetSize (spec->keys); ++it)
 		{
 			Key * keyWithOpt = ksAtCursor (spec->keys, it);
+			const struct KeyOptions * keyOptions = &spec->keyOptions[it];
 			if (spec->useSubcommands)
 			{
-				Key * checkKey = keyDup (keyWithOpt, KEY_CP_ALL);
-				if (strcmp (keyBaseName (keyWithOpt), "#") == 0)
+				Key * checkKey = keyDup (keyWithOpt, KEY_CP_NAME);
+				if (keyOptions->isArray)
 				{
 					keySetBaseName (checkKey, NULL); // remove #
 				}
@@ -1877,14 +2096,14 @@ int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool write
 				}
 			}
 
-			if (keyGetMeta (keyWithOpt, "command") != NULL)
+			if (keyOptions->isCommand)
 			{
 				Key * procKey = keyNew ("proc:/", KEY_VALUE, "", KEY_END);
 				keyAddName (procKey, strchr (keyName (keyWithOpt), '/'));
 				ksAppendKey (ks, procKey);
 			}
 
-			int result = writeOptionValues (ks, keyWithOpt, options, parentKey);
+			int result = writeOptionValues (ks, keyWithOpt, keyOptions, options, parentKey);
 			if (result < 0)
 			{
 				ksDel (envValues);
@@ -1898,7 +2117,7 @@ int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool write
 
 			if (writeArgs)
 			{
-				result = writeArgsValues (ks, keyWithOpt, command, spec->argIndices, args, parentKey);
+				result = writeArgsValues (ks, keyWithOpt, keyOptions, command, spec->argIndices, args, parentKey);
 				if (result < 0)
 				{
 					ksDel (envValues);
@@ -1915,7 +2134,7 @@ int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool write
 				}
 			}
 
-			result = writeEnvVarValues (ks, keyWithOpt, envValues, parentKey);
+			result = writeEnvVarValues (ks, keyWithOpt, keyOptions, envValues, parentKey);
 			if (result < 0)
 			{
 				ksDel (envValues);
@@ -1931,6 +2150,248 @@ int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool write
 	}
 }
 
+/**
+ * Creates lookup keys for the values of the metadata array @p metaName of @p key.
+ */
+static Key ** metaArrayLookupKeys (Key * key, const char * metaName, size_t * size)
+{
+	*size = 0;
+	KeySet * values = elektraMetaArrayToKS (key, metaName);
+	if (values == NULL)
+	{
+		return NULL;
+	}
+
+	Key ** lookupKeys = elektraMalloc ((ksGetSize (values) - 1) * sizeof (Key *) + 1);
+	for (elektraCursor it = 1; it < ksGetSize (values); ++it) // skip count
+	{
+		lookupKeys[(*size)++] = keyNew (keyString (ksAtCursor (values, it)), KEY_END);
+	}
+	ksDel (values);
+	return lookupKeys;
+}
+
+static void delLookupKeys (Key ** lookupKeys, size_t size)
+{
+	for (size_t i = 0; i < size; ++i)
+	{
+		keyDel (lookupKeys[i]);
+	}
+	elektraFree (lookupKeys);
+}
+
+/**
+ * Decodes the metadata of all keys in @p spec that is needed by getOpts(), so that it doesn't
+ * have to be looked up again in every call.
+ */
+void indexSpecKeys (struct Specification * spec)
+{
+	spec->keyOptions = elektraCalloc (ksGetSize (spec->keys) * sizeof (struct KeyOptions) + 1);
+	for (elektraCursor it = 0; it < ksGetSize (spec->keys); ++it)
+	{
+		Key * cur = ksAtCursor (spec->keys, it);
+		struct KeyOptions * keyOptions = &spec->keyOptions[it];
+		keyOptions->opts = metaArrayLookupKeys (cur, "opt", &keyOptions->optsSize);
+		keyOptions->envs = metaArrayLookupKeys (cur, "env", &keyOptions->envsSize);
+		keyOptions->args = keyGetMetaString (cur, "args");
+		keyOptions->isCommand = keyGetMeta (cur, "command") != NULL;
+		keyOptions->isArray = strcmp (keyBaseName (cur), "#") == 0;
+	}
+}
+
+/**
+ * Frees all KeySets and the decoded metadata of @p spec.
+ */
+void freeSpec (struct Specification * spec)
+{
+	if (spec->keyOptions != NULL)
+	{
+		for (elektraCursor it = 0; it < ksGetSize (spec->keys); ++it)
+		{
+			delLookupKeys (spec->keyOptions[it].opts, spec->keyOptions[it].optsSize);
+			delLookupKeys (spec->keyOptions[it].envs, spec->keyOptions[it].envsSize);
+		}
+		elektraFree (spec->keyOptions);
+	}
+	ksDel (spec->options);
+	ksDel (spec->keys);
+	ksDel (spec->argIndices);
+	ksDel (spec->commands);
+}
+
+/**
+ * Appends copies of all keys in @p part to @p table. The prefix @p prefix of the keys
+ * is replaced by @p tableRoot with the basename @p partName added.
+ */
+void writeSpecTable (KeySet * table, KeySet * part, const char * prefix, const Key * tableRoot, const char * partName)
+{
+	Key * oldPrefix = keyNew (prefix, KEY_END);
+	Key * newPrefix = keyDup (tableRoot, KEY_CP_NAME);
+	keyAddBaseName (newPrefix, partName);
+
+	for (elektraCursor it = 0; it < ksGetSize (part); ++it)
+	{
+		Key * cur = keyDup (ksAtCursor (part, it), KEY_CP_ALL);
+		keyReplacePrefix (cur, oldPrefix, newPrefix);
+		ksAppendKey (table, cur);
+	}
+
+	keyDel (oldPrefix);
+	keyDel (newPrefix);
+}
+
+/**
+ * Reverses writeSpecTable(). The returned KeySet contains copies of the keys below @p tableRoot
+ * with the basename @p partName added, the prefix is replaced by @p prefix.
+ */
+KeySet * readSpecTable (KeySet * table, const Key * tableRoot, const char * partName, const char * prefix)
+{
+	Key * oldPrefix = keyDup (tableRoot, KEY_CP_NAME);
+	keyAddBaseName (oldPrefix, partName);
+	Key * newPrefix = keyNew (prefix, KEY_END);
+
+	elektraCursor end;
+	elektraCursor start = ksFindHierarchy (table, oldPrefix, &end);
+	KeySet * part = ksNew (end - start, KS_END);
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		// keys are already sorted, so appending is cheap
+		Key * cur = keyDup (ksAtCursor (table, it), KEY_CP_ALL);
+		keyReplacePrefix (cur, oldPrefix, newPrefix);
+		ksAppendKey (part, cur);
+	}
+
+	keyDel (oldPrefix);
+	keyDel (newPrefix);
+	return part;
+}
+
+static uint64_t fingerprintString (uint64_t hash, const char * string)
+{
+	// FNV-1a, the null terminator is included to separate the strings
+	do
+	{
+		hash ^= (unsigned char) *string;
+		hash *= UINT64_C (0x100000001b3);
+	} while (*string++ != '\0');
+	return hash;
+}
+
+/**
+ * Calculates a fingerprint of the names and metadata of all keys at or below @p specParent in @p ks.
+ *
+ * @return the fingerprint as hex string, must be freed with elektraFree()
+ */
+char * specFingerprint (KeySet * ks, Key * specParent)
+{
+	uint64_t hash = UINT64_C (0xcbf29ce484222325);
+
+	elektraCursor end;
+	for (elektraCursor it = ksFindHierarchy (ks, specParent, &end); it < end; ++it)
+	{
+		Key * cur = ksAtCursor (ks, it);
+		hash = fingerprintString (hash, keyName (cur));
+
+		KeySet * meta = keyMeta (cur);
+		for (elektraCursor i = 0; i < ksGetSize (meta); ++i)
+		{
+			const Key * curMeta = ksAtCursor (meta, i);
+			hash = fingerprintString (hash, keyName (curMeta));
+			hash = fingerprintString (hash, keyString (curMeta));
+		}
+	}
+
+	return elektraFormat ("%016" PRIx64, hash);
+}
+
+/**
+ * @retval true if the spec keys at or below @p specParent in @p ks and their metadata keys are the same
+ * keys as in the last call of rememberVerifiedSpec()
+ */
+bool isVerifiedSpec (ElektraOptsTable * table, KeySet * ks, Key * specParent)
+{
+	if (table->verified == NULL)
+	{
+		return false;
+	}
+
+	size_t index = 0;
+	elektraCursor end;
+	for (elektraCursor it = ksFindHierarchy (ks, specParent, &end); it < end; ++it)
+	{
+		Key * cur = ksAtCursor (ks, it);
+		if (index >= table->verifiedSize || table->verified[index++] != cur)
+		{
+			return false;
+		}
+
+		KeySet * meta = keyMeta (cur);
+		for (elektraCursor i = 0; i < ksGetSize (meta); ++i)
+		{
+			if (index >= table->verifiedSize || table->verified[index++] != ksAtCursor (meta, i))
+			{
+				return false;
+			}
+		}
+	}
+	return index == table->verifiedSize;
+}
+
+/**
+ * Stores references to the spec keys at or below @p specParent in @p ks and their metadata keys.
+ * The references ensure, that the keys are not freed, so their addresses cannot be reused by other keys.
+ */
+void rememberVerifiedSpec (ElektraOptsTable * table, KeySet * ks, Key * specParent)
+{
+	forgetVerifiedSpec (table);
+
+	size_t size = 0;
+	elektraCursor end;
+	elektraCursor start = ksFindHierarchy (ks, specParent, &end);
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		size += 1 + ksGetSize (keyMeta (ksAtCursor (ks, it)));
+	}
+
+	table->verified = elektraMalloc (size * sizeof (Key *));
+	if (table->verified == NULL)
+	{
+		return;
+	}
+
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		Key * cur = ksAtCursor (ks, it);
+		KeySet * meta = keyMeta (cur);
+		for (elektraCursor i = -1; i < ksGetSize (meta); ++i)
+		{
+			Key * key = i < 0 ? cur : ksAtCursor (meta, i);
+			if (keyIncRef (key) == UINT16_MAX)
+			{
+				// too many references, don't remember anything
+				forgetVerifiedSpec (table);
+				return;
+			}
+			table->verified[table->verifiedSize++] = key;
+		}
+	}
+}
+
+/**
+ * Releases the references stored by rememberVerifiedSpec().
+ */
+void forgetVerifiedSpec (ElektraOptsTable * table)
+{
+	for (size_t i = 0; i < table->verifiedSize; ++i)
+	{
+		keyDecRef (table->verified[i]);
+		keyDel (table->verified[i]);
+	}
+	elektraFree (table->verified);
+	table->verified = NULL;
+	table->verifiedSize = 0;
+}
+
 KeySet * ksMetaGetSingleOrArray (Key * key, const char * metaName)
 {
 	const Key * k = keyGetMeta (key, metaName);
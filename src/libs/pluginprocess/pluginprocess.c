@@ -3,7 +3,26 @@
  *
  * @brief Source for the pluginprocess library
  *
- * Executes plugins in a separate process via fork and uses a simple
+ * Executes plugins in a separate process via fork. Two transports are available.
+ *
+ * The default transport (ELEKTRA_PLUGINPROCESS_TRANSPORT_SHM) works as follows:
+ * 1)  Two pipes and a shared memory segment are created before forking
+ *     - parentCommandPipe is used for control messages going from Parent to Child
+ *     - childCommandPipe is used for control messages going from Child to Parent
+ *     - the shared memory segment holds the parent key and the payload keyset
+ *       in a binary layout (see writeSegment)
+ * 2)  Parent writes the parent key and the keyset into the segment
+ *     and sends a SharedMemoryMessage containing the command, the number of
+ *     keys in the payload and the used size of the segment
+ * 3)  Child reads the message, creates the keys from the segment and executes
+ *     the plugin
+ * 4)  Child writes the resulting parent key and keyset into the same segment
+ *     and replies with a SharedMemoryMessage containing the result
+ * 5)  Parent reads the reply, creates the keys from the segment and copies
+ *     them back into the original key and keyset
+ * The segment grows if a KeySet does not fit, both sides remap it as needed.
+ *
+ * The dump transport (ELEKTRA_PLUGINPROCESS_TRANSPORT_DUMP) uses a simple
  * communication protocol based on the dump plugin via named pipes.
  *
  * The communication protocol works as follows, where Child and Parent stand
@@ -55,14 +74,50 @@
 #include <kdbprivate.h> // To access the plugin function pointers
 
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+/** version of the shared memory protocol, sent with every SharedMemoryMessage */
+#define ELEKTRA_PLUGINPROCESS_SHM_VERSION 2
+
+/** minimal size of the shared memory segment */
+#define ELEKTRA_PLUGINPROCESS_SHM_MIN_SIZE (64 * 1024)
+
+/** A shared memory segment mapped into the current process */
+typedef struct
+{
+	int fd;
+	char * data;
+	size_t size;
+} SharedMemorySegment;
+
+/** Control message of the shared memory transport */
+typedef struct
+{
+	int32_t version;
+	int32_t command;      // command for the child, result for the parent
+	int64_t payloadSize;  // number of keys in the payload, -1 if there is no payload
+	uint64_t segmentSize; // number of used bytes in the segment, 0 if the segment contains no parent key
+} SharedMemoryMessage;
+
+/** Header of a key in the shared memory segment, followed by the name, the value and metaCount meta keys */
+typedef struct
+{
+	uint64_t nameSize;
+	uint64_t valueSize;
+	uint64_t metaCount;
+	uint8_t isBinary;
+} SharedMemoryKeyHeader;
+
 struct _ElektraPluginProcess
 {
 	int parentCommandPipe[2];
@@ -77,7 +132,9 @@ struct _ElektraPluginProcess
 
 	int pid;
 	int counter;
+	ElektraPluginProcessTransport transport;
 	ElektraInvokeHandle * dump;
+	SharedMemorySegment * segment;
 	void * pluginData;
 };
 
@@ -85,6 +142,13 @@ static void cleanupPluginData (ElektraPluginProcess * pp, Key * errorKey, int cl
 {
 	if (pp->dump) elektraInvokeClose (pp->dump, errorKey);
 
+	if (pp->segment)
+	{
+		if (pp->segment->data) munmap (pp->segment->data, pp->segment->size);
+		if (pp->segment->fd >= 0) close (pp->segment->fd);
+		elektraFree (pp->segment);
+	}
+
 	if (pp->parentCommandPipeKey) keyDel (pp->parentCommandPipeKey);
 	if (pp->parentPayloadPipeKey) keyDel (pp->parentPayloadPipeKey);
 	if (pp->childCommandPipeKey) keyDel (pp->childCommandPipeKey);
@@ -113,120 +177,468 @@ static char * longToStr (long i)
 	return str;
 }
 
-/** Start the child process' command loop
+/**
+ * @internal
  *
- * This will make the child process wait for plugin commands
- * and execute them, returning the result to the parent. This
- * is typically called in a plugin's open function.
+ * Create an anonymous shared memory segment, which is inherited by the child process.
  *
- * @param handle the plugin's handle
- * @param pp the data structure containing the plugin's process information
- * @see elektraPluginProcessInit how to use this function in a plugin
- * @ingroup processplugin
- **/
-void elektraPluginProcessStart (Plugin * handle, ElektraPluginProcess * pp)
+ * @retval NULL on errors
+ * @return the segment, which is not mapped yet
+ */
+static SharedMemorySegment * createSegment (void)
 {
-	int counter = 0;
-
-	do
+	static unsigned int segmentCounter = 0;
+	int fd = -1;
+	for (int attempt = 0; fd < 0 && attempt < 10; ++attempt)
 	{
-		KeySet * commandKeySet = ksNew (6, KS_END);
-		KeySet * keySet = NULL;
-		ELEKTRA_LOG_DEBUG ("Child: Wait for commands on pipe %s", keyString (pp->parentCommandPipeKey));
-		elektraInvoke2Args (pp->dump, "get", commandKeySet, pp->parentCommandPipeKey);
-
-		if (ksGetSize (commandKeySet) == 0)
+		char name[64];
+		snprintf (name, sizeof (name), "/elektra-pluginprocess-%ld-%u", (long) getpid (),
+			  __sync_add_and_fetch (&segmentCounter, 1));
+		fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+		if (fd >= 0)
+		{
+			// the segment stays accessible via fd, the name is not needed anymore
+			shm_unlink (name);
+		}
+		else if (errno != EEXIST)
 		{
-			ELEKTRA_LOG_DEBUG ("Child: Failed to read from parentCommandPipe, exiting");
-			ksDel (commandKeySet);
-			break;
+			return NULL;
 		}
+	}
+	if (fd < 0) return NULL;
 
-		Key * payloadSizeKey = ksLookupByName (commandKeySet, "/pluginprocess/payload/size", KDB_O_NONE);
-		char * endPtr;
-		// We'll always write some int value into it, so this should be fine
-		int prevErrno = errno;
-		errno = 0;
-		long payloadSize = strtol (keyString (payloadSizeKey), &endPtr, 10);
-		// in case the payload size fails to be transferred, that it shouldn't, we can only assume no payload
-		if (*endPtr == '\0' && errno != ERANGE && payloadSize >= 0)
+	SharedMemorySegment * segment = elektraMalloc (sizeof (SharedMemorySegment));
+	segment->fd = fd;
+	segment->data = NULL;
+	segment->size = 0;
+	return segment;
+}
+
+/**
+ * @internal
+ *
+ * Ensure that at least @p size bytes of the segment are mapped.
+ *
+ * The other process may have grown the segment since we last mapped it.
+ *
+ * @param segment the segment
+ * @param size    the number of bytes which have to be accessible
+ * @param grow    1 if the segment may be enlarged (writer), 0 otherwise (reader)
+ * @retval 1 on success
+ * @retval 0 on errors
+ */
+static int mapSegment (SharedMemorySegment * segment, size_t size, int grow)
+{
+	if (segment->data != NULL && segment->size >= size) return 1;
+
+	struct stat info;
+	if (fstat (segment->fd, &info) != 0) return 0;
+	size_t newSize = info.st_size;
+	if (newSize < size)
+	{
+		if (!grow) return 0;
+		newSize = newSize < ELEKTRA_PLUGINPROCESS_SHM_MIN_SIZE ? ELEKTRA_PLUGINPROCESS_SHM_MIN_SIZE : newSize;
+		while (newSize < size)
 		{
-			keySet = ksNew (payloadSize, KS_END);
-			elektraInvoke2Args (pp->dump, "get", keySet, pp->parentPayloadPipeKey);
-			ELEKTRA_LOG_DEBUG ("Child: We received a KeySet with %zd keys in it", ksGetSize (keySet));
+			newSize *= 2;
 		}
-		errno = prevErrno;
+		if (ftruncate (segment->fd, newSize) != 0) return 0;
+	}
 
-		Key * commandKey = ksLookupByName (commandKeySet, "/pluginprocess/command", KDB_O_NONE);
-		Key * parentNameKey = ksLookupByName (commandKeySet, "/pluginprocess/parent/name", KDB_O_NONE);
-		Key * parentKey = ksLookupByName (commandKeySet, "/pluginprocess/parent", KDB_O_POP);
-		Key * key = keyDup (parentKey, KEY_CP_ALL);
-		keySetName (key, keyString (parentNameKey));
-		int result = ELEKTRA_PLUGIN_STATUS_ERROR;
+	if (segment->data != NULL) munmap (segment->data, segment->size);
+	segment->data = mmap (NULL, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+	if (segment->data == MAP_FAILED)
+	{
+		segment->data = NULL;
+		segment->size = 0;
+		return 0;
+	}
+	segment->size = newSize;
+	return 1;
+}
 
-		// We'll always write some int value into it, so this should be fine
-		prevErrno = errno;
-		errno = 0;
-		long command = strtol (keyString (commandKey), &endPtr, 10);
-		if (*endPtr == '\0' && errno != ERANGE)
+static size_t keySegmentSize (Key * key)
+{
+	size_t size = sizeof (SharedMemoryKeyHeader) + keyGetNameSize (key) + keyGetValueSize (key);
+	KeySet * meta = keyMeta (key);
+	for (elektraCursor it = 0; it < ksGetSize (meta); ++it)
+	{
+		const Key * current = ksAtCursor (meta, it);
+		size += 2 * sizeof (uint64_t) + keyGetNameSize (current) + keyGetValueSize (current);
+	}
+	return size;
+}
+
+static char * writeSegmentData (char * position, const void * data, size_t size)
+{
+	if (size > 0) memcpy (position, data, size);
+	return position + size;
+}
+
+static char * writeSegmentKey (char * position, Key * key)
+{
+	KeySet * meta = keyMeta (key);
+	SharedMemoryKeyHeader header = { keyGetNameSize (key), keyGetValueSize (key), ksGetSize (meta), keyIsBinary (key) == 1 };
+	position = writeSegmentData (position, &header, sizeof (header));
+	position = writeSegmentData (position, keyName (key), header.nameSize);
+	position = writeSegmentData (position, keyValue (key), header.valueSize);
+
+	for (elektraCursor it = 0; it < ksGetSize (meta); ++it)
+	{
+		const Key * current = ksAtCursor (meta, it);
+		uint64_t sizes[2] = { keyGetNameSize (current), keyGetValueSize (current) };
+		position = writeSegmentData (position, sizes, sizeof (sizes));
+		position = writeSegmentData (position, keyName (current), sizes[0]);
+		position = writeSegmentData (position, keyValue (current), sizes[1]);
+	}
+	return position;
+}
+
+/**
+ * @internal
+ *
+ * Write the parent key and the keyset into the shared memory segment.
+ *
+ * @param segment the segment
+ * @param key     the parent key
+ * @param keySet  the keyset or NULL
+ * @return the number of bytes written
+ * @retval 0 if the segment could not be enlarged
+ */
+static size_t writeSegment (SharedMemorySegment * segment, Key * key, const KeySet * keySet)
+{
+	size_t size = keySegmentSize (key);
+	for (elektraCursor it = 0; keySet != NULL && it < ksGetSize (keySet); ++it)
+	{
+		size += keySegmentSize (ksAtCursor (keySet, it));
+	}
+
+	if (!mapSegment (segment, size, 1)) return 0;
+
+	char * position = writeSegmentKey (segment->data, key);
+	for (elektraCursor it = 0; keySet != NULL && it < ksGetSize (keySet); ++it)
+	{
+		position = writeSegmentKey (position, ksAtCursor (keySet, it));
+	}
+	return size;
+}
+
+static const char * readSegmentData (const char ** position, const char * end, uint64_t size)
+{
+	if (size > (uint64_t) (end - *position)) return NULL;
+	const char * data = *position;
+	*position += size;
+	return data;
+}
+
+static int isTerminated (const char * data, uint64_t size)
+{
+	return size > 0 && data[size - 1] == '\0';
+}
+
+static Key * readSegmentKey (const char ** position, const char * end)
+{
+	SharedMemoryKeyHeader header;
+	const char * data = readSegmentData (position, end, sizeof (header));
+	if (data == NULL) return NULL;
+	memcpy (&header, data, sizeof (header));
+
+	const char * name = readSegmentData (position, end, header.nameSize);
+	const char * value = readSegmentData (position, end, header.valueSize);
+	if (name == NULL || value == NULL || !isTerminated (name, header.nameSize)) return NULL;
+
+	Key * key = keyNew (name, KEY_END);
+	if (key == NULL) return NULL;
+	if (header.isBinary)
+	{
+		keySetBinary (key, header.valueSize > 0 ? value : NULL, header.valueSize);
+	}
+	else if (header.valueSize > 0)
+	{
+		if (!isTerminated (value, header.valueSize))
 		{
-			ELEKTRA_LOG ("Child: We want to execute the command with the value %ld now", command);
-			// Its hard to figure out the enum size in a portable way but for this comparison it should be ok
-			switch (command)
-			{
-			case ELEKTRA_PLUGINPROCESS_OPEN:
-				counter++;
-				result = handle->kdbOpen (handle, key);
-				break;
-			case ELEKTRA_PLUGINPROCESS_CLOSE:
-				counter--;
-				result = handle->kdbClose (handle, key);
-				break;
-			case ELEKTRA_PLUGINPROCESS_GET:
-				result = handle->kdbGet (handle, keySet, key);
-				break;
-			case ELEKTRA_PLUGINPROCESS_SET:
-				result = handle->kdbSet (handle, keySet, key);
-				break;
-			case ELEKTRA_PLUGINPROCESS_ERROR:
-				result = handle->kdbError (handle, keySet, key);
-				break;
-			case ELEKTRA_PLUGINPROCESS_COMMIT:
-				result = handle->kdbCommit (handle, keySet, key);
-				break;
-			case ELEKTRA_PLUGINPROCESS_INIT:
-				result = handle->kdbInit (handle, keySet, key);
-				break;
-			default:
-				result = ELEKTRA_PLUGIN_STATUS_ERROR;
-			}
-			ELEKTRA_LOG_DEBUG ("Child: Command executed with return value %d", result);
+			keyDel (key);
+			return NULL;
 		}
-		else
+		keySetString (key, value);
+	}
+
+	for (uint64_t i = 0; i < header.metaCount; ++i)
+	{
+		uint64_t sizes[2];
+		data = readSegmentData (position, end, sizeof (sizes));
+		if (data == NULL)
 		{
-			ELEKTRA_LOG_DEBUG ("Child: Unrecognized command %s", keyString (commandKey));
-			ELEKTRA_SET_PLUGIN_MISBEHAVIOR_ERRORF (key, "Received invalid command code or no KeySet from child process: %s",
-							       keyString (commandKey));
+			keyDel (key);
+			return NULL;
 		}
-		errno = prevErrno;
-		char * resultStr = longToStr (result);
-		ksAppendKey (commandKeySet, keyNew ("/pluginprocess/result", KEY_VALUE, resultStr, KEY_END));
-		elektraFree (resultStr);
-		keySetName (key, "/pluginprocess/parent");
-		ksAppendKey (commandKeySet, key);
-		keyDel (parentKey);
-
-		ELEKTRA_LOG_DEBUG ("Child: Writing the results back to the parent");
-		elektraInvoke2Args (pp->dump, "set", commandKeySet, pp->childCommandPipeKey);
-		if (keySet != NULL)
+		memcpy (sizes, data, sizeof (sizes));
+		const char * metaName = readSegmentData (position, end, sizes[0]);
+		const char * metaValue = readSegmentData (position, end, sizes[1]);
+		if (metaName == NULL || metaValue == NULL || !isTerminated (metaName, sizes[0]) || !isTerminated (metaValue, sizes[1]))
+		{
+			keyDel (key);
+			return NULL;
+		}
+		keySetMeta (key, metaName, metaValue);
+	}
+	return key;
+}
+
+/**
+ * @internal
+ *
+ * Read the parent key and the keyset from the shared memory segment.
+ *
+ * @param segment the segment
+ * @param message the control message describing the contents of the segment
+ * @param key     set to the parent key
+ * @param keySet  set to the keyset, or NULL if the message contains no payload
+ * @retval 1 on success
+ * @retval 0 if the segment does not contain valid data, @p key and @p keySet are NULL then
+ */
+static int readSegment (SharedMemorySegment * segment, const SharedMemoryMessage * message, Key ** key, KeySet ** keySet)
+{
+	*key = NULL;
+	*keySet = NULL;
+	if (message->segmentSize == 0 || message->segmentSize > SIZE_MAX || !mapSegment (segment, message->segmentSize, 0)) return 0;
+
+	const char * position = segment->data;
+	const char * end = segment->data + message->segmentSize;
+	*key = readSegmentKey (&position, end);
+	if (*key == NULL) return 0;
+	if (message->payloadSize < 0) return 1;
+
+	*keySet = ksNew (message->payloadSize, KS_END);
+	for (int64_t i = 0; i < message->payloadSize; ++i)
+	{
+		Key * current = readSegmentKey (&position, end);
+		if (current == NULL)
 		{
-			char * resultPayloadSize = longToStr (ksGetSize (keySet));
-			keySetString (payloadSizeKey, resultPayloadSize);
-			elektraFree (resultPayloadSize);
-			elektraInvoke2Args (pp->dump, "set", keySet, pp->childPayloadPipeKey);
-			ksDel (keySet);
+			keyDel (*key);
+			ksDel (*keySet);
+			*key = NULL;
+			*keySet = NULL;
+			return 0;
 		}
+		ksAppendKey (*keySet, current);
+	}
+	return 1;
+}
+
+static int writeMessage (int fd, const SharedMemoryMessage * message)
+{
+	const char * data = (const char *) message;
+	size_t remaining = sizeof (SharedMemoryMessage);
+	while (remaining > 0)
+	{
+		ssize_t written = write (fd, data, remaining);
+		if (written < 0 && errno == EINTR) continue;
+		if (written <= 0) return 0;
+		data += written;
+		remaining -= written;
+	}
+	return 1;
+}
+
+static int readMessage (int fd, SharedMemoryMessage * message)
+{
+	char * data = (char *) message;
+	size_t remaining = sizeof (SharedMemoryMessage);
+	while (remaining > 0)
+	{
+		ssize_t bytesRead = read (fd, data, remaining);
+		if (bytesRead < 0 && errno == EINTR) continue;
+		if (bytesRead <= 0) return 0;
+		data += bytesRead;
+		remaining -= bytesRead;
+	}
+	return message->version == ELEKTRA_PLUGINPROCESS_SHM_VERSION;
+}
+
+/**
+ * @internal
+ *
+ * Execute a command in the child process.
+ *
+ * @param handle  the plugin's handle
+ * @param command the command to execute
+ * @param keySet  the payload keyset
+ * @param key     the parent key
+ * @param counter the startup counter of the child process
+ * @return the result of the plugin function
+ */
+static int executeCommand (Plugin * handle, long command, KeySet * keySet, Key * key, int * counter)
+{
+	ELEKTRA_LOG ("Child: We want to execute the command with the value %ld now", command);
+	// Its hard to figure out the enum size in a portable way but for this comparison it should be ok
+	switch (command)
+	{
+	case ELEKTRA_PLUGINPROCESS_OPEN:
+		(*counter)++;
+		return handle->kdbOpen (handle, key);
+	case ELEKTRA_PLUGINPROCESS_CLOSE:
+		(*counter)--;
+		return handle->kdbClose (handle, key);
+	case ELEKTRA_PLUGINPROCESS_GET:
+		return handle->kdbGet (handle, keySet, key);
+	case ELEKTRA_PLUGINPROCESS_SET:
+		return handle->kdbSet (handle, keySet, key);
+	case ELEKTRA_PLUGINPROCESS_ERROR:
+		return handle->kdbError (handle, keySet, key);
+	case ELEKTRA_PLUGINPROCESS_COMMIT:
+		return handle->kdbCommit (handle, keySet, key);
+	case ELEKTRA_PLUGINPROCESS_INIT:
+		return handle->kdbInit (handle, keySet, key);
+	default:
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+}
+
+/**
+ * @internal
+ *
+ * Receive, execute and answer a single command using the shared memory transport.
+ *
+ * @retval 1 if the command was handled
+ * @retval 0 if the parent closed the connection
+ */
+static int handleSharedMemoryCommand (Plugin * handle, ElektraPluginProcess * pp, int * counter)
+{
+	SharedMemoryMessage message;
+	ELEKTRA_LOG_DEBUG ("Child: Wait for commands on pipe %d", pp->parentCommandPipe[0]);
+	if (!readMessage (pp->parentCommandPipe[0], &message))
+	{
+		ELEKTRA_LOG_DEBUG ("Child: Failed to read from parentCommandPipe, exiting");
+		return 0;
+	}
+
+	Key * key;
+	KeySet * keySet;
+	int result = ELEKTRA_PLUGIN_STATUS_ERROR;
+	if (readSegment (pp->segment, &message, &key, &keySet))
+	{
+		ELEKTRA_LOG_DEBUG ("Child: We received a KeySet with %zd keys in it", ksGetSize (keySet));
+		result = executeCommand (handle, message.command, keySet, key, counter);
+		ELEKTRA_LOG_DEBUG ("Child: Command executed with return value %d", result);
+	}
+	else
+	{
+		ELEKTRA_LOG_DEBUG ("Child: Received invalid shared memory segment");
+	}
+
+	SharedMemoryMessage reply = { ELEKTRA_PLUGINPROCESS_SHM_VERSION, result, keySet != NULL ? ksGetSize (keySet) : -1, 0 };
+	if (key != NULL) reply.segmentSize = writeSegment (pp->segment, key, keySet);
+	if (reply.segmentSize == 0) reply.payloadSize = -1;
+
+	ELEKTRA_LOG_DEBUG ("Child: Writing the results back to the parent");
+	int written = writeMessage (pp->childCommandPipe[1], &reply);
+	keyDel (key);
+	ksDel (keySet);
+	return written;
+}
+
+/**
+ * @internal
+ *
+ * Receive, execute and answer a single command using the dump transport.
+ *
+ * @retval 1 if the command was handled
+ * @retval 0 if the parent closed the connection
+ */
+static int handleDumpCommand (Plugin * handle, ElektraPluginProcess * pp, int * counter)
+{
+	KeySet * commandKeySet = ksNew (6, KS_END);
+	KeySet * keySet = NULL;
+	ELEKTRA_LOG_DEBUG ("Child: Wait for commands on pipe %s", keyString (pp->parentCommandPipeKey));
+	elektraInvoke2Args (pp->dump, "get", commandKeySet, pp->parentCommandPipeKey);
+
+	if (ksGetSize (commandKeySet) == 0)
+	{
+		ELEKTRA_LOG_DEBUG ("Child: Failed to read from parentCommandPipe, exiting");
 		ksDel (commandKeySet);
+		return 0;
+	}
+
+	Key * payloadSizeKey = ksLookupByName (commandKeySet, "/pluginprocess/payload/size", KDB_O_NONE);
+	char * endPtr;
+	// We'll always write some int value into it, so this should be fine
+	int prevErrno = errno;
+	errno = 0;
+	long payloadSize = strtol (keyString (payloadSizeKey), &endPtr, 10);
+	// in case the payload size fails to be transferred, that it shouldn't, we can only assume no payload
+	if (*endPtr == '\0' && errno != ERANGE && payloadSize >= 0)
+	{
+		keySet = ksNew (payloadSize, KS_END);
+		elektraInvoke2Args (pp->dump, "get", keySet, pp->parentPayloadPipeKey);
+		ELEKTRA_LOG_DEBUG ("Child: We received a KeySet with %zd keys in it", ksGetSize (keySet));
+	}
+	errno = prevErrno;
+
+	Key * commandKey = ksLookupByName (commandKeySet, "/pluginprocess/command", KDB_O_NONE);
+	Key * parentNameKey = ksLookupByName (commandKeySet, "/pluginprocess/parent/name", KDB_O_NONE);
+	Key * parentKey = ksLookupByName (commandKeySet, "/pluginprocess/parent", KDB_O_POP);
+	Key * key = keyDup (parentKey, KEY_CP_ALL);
+	keySetName (key, keyString (parentNameKey));
+	int result = ELEKTRA_PLUGIN_STATUS_ERROR;
+
+	// We'll always write some int value into it, so this should be fine
+	prevErrno = errno;
+	errno = 0;
+	long command = strtol (keyString (commandKey), &endPtr, 10);
+	if (*endPtr == '\0' && errno != ERANGE)
+	{
+		result = executeCommand (handle, command, keySet, key, counter);
+		ELEKTRA_LOG_DEBUG ("Child: Command executed with return value %d", result);
+	}
+	else
+	{
+		ELEKTRA_LOG_DEBUG ("Child: Unrecognized command %s", keyString (commandKey));
+		ELEKTRA_SET_PLUGIN_MISBEHAVIOR_ERRORF (key, "Received invalid command code or no KeySet from child process: %s",
+						       keyString (commandKey));
+	}
+	errno = prevErrno;
+	char * resultStr = longToStr (result);
+	ksAppendKey (commandKeySet, keyNew ("/pluginprocess/result", KEY_VALUE, resultStr, KEY_END));
+	elektraFree (resultStr);
+	keySetName (key, "/pluginprocess/parent");
+	ksAppendKey (commandKeySet, key);
+	keyDel (parentKey);
+
+	ELEKTRA_LOG_DEBUG ("Child: Writing the results back to the parent");
+	elektraInvoke2Args (pp->dump, "set", commandKeySet, pp->childCommandPipeKey);
+	if (keySet != NULL)
+	{
+		char * resultPayloadSize = longToStr (ksGetSize (keySet));
+		keySetString (payloadSizeKey, resultPayloadSize);
+		elektraFree (resultPayloadSize);
+		elektraInvoke2Args (pp->dump, "set", keySet, pp->childPayloadPipeKey);
+		ksDel (keySet);
+	}
+	ksDel (commandKeySet);
+	return 1;
+}
+
+/** Start the child process' command loop
+ *
+ * This will make the child process wait for plugin commands
+ * and execute them, returning the result to the parent. This
+ * is typically called in a plugin's open function.
+ *
+ * @param handle the plugin's handle
+ * @param pp the data structure containing the plugin's process information
+ * @see elektraPluginProcessInit how to use this function in a plugin
+ * @ingroup processplugin
+ **/
+void elektraPluginProcessStart (Plugin * handle, ElektraPluginProcess * pp)
+{
+	int counter = 0;
+
+	do
+	{
+		int handled = pp->transport == ELEKTRA_PLUGINPROCESS_TRANSPORT_SHM ? handleSharedMemoryCommand (handle, pp, &counter) :
+										     handleDumpCommand (handle, pp, &counter);
+		if (!handled) break;
 		ELEKTRA_LOG ("Child: Command handled, startup counter is at %d", counter);
 	} while (counter);
 
@@ -237,45 +649,62 @@ void elektraPluginProcessStart (Plugin * handle, ElektraPluginProcess * pp)
 	_Exit (EXIT_SUCCESS);
 }
 
-/** Call a plugin's function in a child process
+/**
+ * @internal
  *
- * This will wrap all the required information to execute the given
- * command in a keyset and send it over to the child process. Then
- * it waits for the child process's answer and copies the result
- * back into the original plugin keyset and plugin key.
+ * Copy the parent key and the keyset received from the child process back into the original ones.
  *
- * Typically called like
- * @code
-int elektraPluginSet (Plugin * handle, KeySet * returned, Key * parentKey)
+ * @param originalKeySet        the original key set that the parent process receives
+ * @param key                   the original key the parent process receives
+ * @param parentDeserializedKey the parent key received from the child
+ * @param keySet                the keyset received from the child or NULL
+ */
+static void copyResult (KeySet * originalKeySet, Key * key, Key * parentDeserializedKey, KeySet * keySet)
 {
-	ElektraPluginProcess * pp = elektraPluginGetData (handle);
-	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessSend (pp, ELEKTRA_PLUGINPROCESS_SET, returned, parentKey);
+	Key * parentKeyInOriginalKeySet = keySet != NULL ? ksLookup (originalKeySet, key, KDB_O_NONE) : NULL;
+	// maybe there are just 2 keys with the same name, can happen in theory, so compare memory
+	int parentKeyExistsInOriginalKeySet = parentKeyInOriginalKeySet == key;
+	// if the child added the parent key to the keyset pop it from the keyset
+	// then reinsert key after we copied the data and delete this serialized copy
+	Key * parentKeyInKeySet = keySet != NULL ? ksLookup (keySet, key, KDB_O_POP) : NULL;
+	int childAddedParentKey = parentKeyInKeySet != NULL;
 
-	// actual plugin functionality to be executed in a child process
-	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
-}
- * @endcode
- *
- * @param pp the data structure containing the plugin's process information
- * @param command the plugin command that should be executed, e.g. ELEKTRA_PLUGINPROCESS_GET
- * @param originalKeySet the original key set that the parent process receives
- * @param key the original key the parent process receives
- * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the child process communication failed
- * @retval the called plugin's return value otherwise
- * @see elektraPluginProcessIsParent for checking if we are in the parent or child process
- * @ingroup processplugin
- **/
-int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t command, KeySet * originalKeySet, Key * key)
-{
-	// Ensure we have a keyset when trying to call GET SET and ERROR
-	if ((command == ELEKTRA_PLUGINPROCESS_GET || command == ELEKTRA_PLUGINPROCESS_SET || command == ELEKTRA_PLUGINPROCESS_ERROR) &&
-	    originalKeySet == NULL)
+	// Unfortunately we can't use keyCopy here as ksAppendKey locks it so it will fail
+	// This is the case if the parent key is also contained in the originalKeySet / has been appended
+	// As an invariant we assume plugins don't change the parent key's name during a plugin call
+	// This would interfere with keyset memberships
+	keySetString (key, keyString (parentDeserializedKey));
+
+	KeySet * metaKeys = keyMeta (key);
+	for (elektraCursor it = 0; it < ksGetSize (metaKeys); ++it)
 	{
-		ELEKTRA_SET_INTERFACE_ERROR (
-			key, "Variable originalKeySet has to exist when calling GET SET and ERROR via pluginprocess but it is NULL");
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
+		const Key * currentMeta = ksAtCursor (metaKeys, it);
+		keySetMeta (key, keyName (currentMeta), 0);
+	}
+
+	keyCopyAllMeta (key, parentDeserializedKey);
+	if (childAddedParentKey) keyCopyAllMeta (key, parentKeyInKeySet);
+
+	if (keySet != NULL)
+	{
+		// in case originalKeySet contains key this would make it stuck
+		// thus remove it here and re-add it afterwards
+		if (parentKeyExistsInOriginalKeySet) ksLookup (originalKeySet, parentKeyInOriginalKeySet, KDB_O_POP);
+		ksCopy (originalKeySet, keySet);
+		if (parentKeyExistsInOriginalKeySet || childAddedParentKey) ksAppendKey (originalKeySet, key);
+		if (childAddedParentKey) keyDel (parentKeyInKeySet);
 	}
+}
 
+/**
+ * @internal
+ *
+ * Call a plugin's function in a child process using the dump transport.
+ *
+ * @see elektraPluginProcessSend
+ */
+static int sendDump (const ElektraPluginProcess * pp, pluginprocess_t command, KeySet * originalKeySet, Key * key)
+{
 	// Construct the command set that controls the pluginprocess communication
 	KeySet * commandKeySet = ksNew (6, KS_END);
 	ksAppendKey (commandKeySet, keyNew ("/pluginprocess/parent/name", KEY_VALUE, keyName (key), KEY_END));
@@ -294,7 +723,7 @@ int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t c
 		     keyNew ("/pluginprocess/payload/size", KEY_VALUE, originalKeySet == NULL ? "-1" : payloadSizeStr, KEY_END));
 	elektraFree (payloadSizeStr);
 
-	// Serialize, currently statically use dump as our default format, this already writes everything out to the pipe
+	// Serialize, this already writes everything out to the pipe
 	ELEKTRA_LOG ("Parent: Sending data to issue command %u it through pipe %s", command, keyString (pp->parentCommandPipeKey));
 	elektraInvoke2Args (pp->dump, "set", commandKeySet, pp->parentCommandPipeKey);
 	if (keySet != NULL)
@@ -342,39 +771,7 @@ int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t c
 	}
 	else // Copy everything back into the actual keysets
 	{
-		Key * parentKeyInOriginalKeySet = keySet != NULL ? ksLookup (originalKeySet, key, KDB_O_NONE) : NULL;
-		// maybe there are just 2 keys with the same name, can happen in theory, so compare memory
-		int parentKeyExistsInOriginalKeySet = parentKeyInOriginalKeySet == key;
-		// if the child added the parent key to the keyset pop it from the keyset
-		// then reinsert key after we copied the data and delete this serialized copy
-		Key * parentKeyInKeySet = keySet != NULL ? ksLookup (keySet, key, KDB_O_POP) : NULL;
-		int childAddedParentKey = parentKeyInKeySet != NULL;
-
-		// Unfortunately we can't use keyCopy here as ksAppendKey locks it so it will fail
-		// This is the case if the parent key is also contained in the originalKeySet / has been appended
-		// As an invariant we assume plugins don't change the parent key's name during a plugin call
-		// This would interfere with keyset memberships
-		keySetString (key, keyString (parentDeserializedKey));
-
-		KeySet * metaKeys = keyMeta (key);
-		for (elektraCursor it = 0; it < ksGetSize (metaKeys); ++it)
-		{
-			const Key * currentMeta = ksAtCursor (metaKeys, it);
-			keySetMeta (key, keyName (currentMeta), 0);
-		}
-
-		keyCopyAllMeta (key, parentDeserializedKey);
-		if (childAddedParentKey) keyCopyAllMeta (key, parentKeyInKeySet);
-
-		if (keySet != NULL)
-		{
-			// in case originalKeySet contains key this would make it stuck
-			// thus remove it here and re-add it afterwards
-			if (parentKeyExistsInOriginalKeySet) ksLookup (originalKeySet, parentKeyInOriginalKeySet, KDB_O_POP);
-			ksCopy (originalKeySet, keySet);
-			if (parentKeyExistsInOriginalKeySet || childAddedParentKey) ksAppendKey (originalKeySet, key);
-			if (childAddedParentKey) keyDel (parentKeyInKeySet);
-		}
+		copyResult (originalKeySet, key, parentDeserializedKey, keySet);
 	}
 	errno = prevErrno;
 
@@ -385,6 +782,96 @@ int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t c
 	return lresult; // Safe, we had a bound check before, and plugins should return values in the int range
 }
 
+/**
+ * @internal
+ *
+ * Call a plugin's function in a child process using the shared memory transport.
+ *
+ * @see elektraPluginProcessSend
+ */
+static int sendSharedMemory (const ElektraPluginProcess * pp, pluginprocess_t command, KeySet * originalKeySet, Key * key)
+{
+	SharedMemoryMessage message = { ELEKTRA_PLUGINPROCESS_SHM_VERSION, command, originalKeySet != NULL ? ksGetSize (originalKeySet) : -1,
+					0 };
+	message.segmentSize = writeSegment (pp->segment, key, originalKeySet);
+	if (message.segmentSize == 0)
+	{
+		ELEKTRA_SET_RESOURCE_ERROR (key, "Failed to write the KeySet into the shared memory segment of the child process");
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	ELEKTRA_LOG ("Parent: Sending command %u with %zd bytes of payload", command, (ssize_t) message.segmentSize);
+	if (!writeMessage (pp->parentCommandPipe[1], &message) || !readMessage (pp->childCommandPipe[0], &message))
+	{
+		ELEKTRA_SET_PLUGIN_MISBEHAVIOR_ERROR (key, "Failed to communicate with the child process");
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	Key * parentDeserializedKey;
+	KeySet * keySet;
+	if (!readSegment (pp->segment, &message, &parentDeserializedKey, &keySet))
+	{
+		ELEKTRA_SET_PLUGIN_MISBEHAVIOR_ERRORF (key, "Received invalid return code or no KeySet from child process: %d",
+						       message.command);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+	ELEKTRA_LOG ("Parent: We received %zd keys in return", ksGetSize (keySet));
+
+	if (originalKeySet == NULL)
+	{
+		ksDel (keySet);
+		keySet = NULL;
+	}
+	copyResult (originalKeySet, key, parentDeserializedKey, keySet);
+
+	keyDel (parentDeserializedKey);
+	ksDel (keySet);
+	return message.command;
+}
+
+/** Call a plugin's function in a child process
+ *
+ * This will wrap all the required information to execute the given
+ * command in a keyset and send it over to the child process. Then
+ * it waits for the child process's answer and copies the result
+ * back into the original plugin keyset and plugin key.
+ *
+ * Typically called like
+ * @code
+int elektraPluginSet (Plugin * handle, KeySet * returned, Key * parentKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessSend (pp, ELEKTRA_PLUGINPROCESS_SET, returned, parentKey);
+
+	// actual plugin functionality to be executed in a child process
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+ * @endcode
+ *
+ * @param pp the data structure containing the plugin's process information
+ * @param command the plugin command that should be executed, e.g. ELEKTRA_PLUGINPROCESS_GET
+ * @param originalKeySet the original key set that the parent process receives
+ * @param key the original key the parent process receives
+ * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the child process communication failed
+ * @retval the called plugin's return value otherwise
+ * @see elektraPluginProcessIsParent for checking if we are in the parent or child process
+ * @ingroup processplugin
+ **/
+int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t command, KeySet * originalKeySet, Key * key)
+{
+	// Ensure we have a keyset when trying to call GET SET and ERROR
+	if ((command == ELEKTRA_PLUGINPROCESS_GET || command == ELEKTRA_PLUGINPROCESS_SET || command == ELEKTRA_PLUGINPROCESS_ERROR) &&
+	    originalKeySet == NULL)
+	{
+		ELEKTRA_SET_INTERFACE_ERROR (
+			key, "Variable originalKeySet has to exist when calling GET SET and ERROR via pluginprocess but it is NULL");
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	if (pp->transport == ELEKTRA_PLUGINPROCESS_TRANSPORT_SHM) return sendSharedMemory (pp, command, originalKeySet, key);
+	return sendDump (pp, command, originalKeySet, key);
+}
+
 /** Check if a given plugin process is the parent or the child process
  *
  * @param pp the data structure containing the plugin's process information
@@ -462,33 +949,60 @@ int elektraPluginOpen (Plugin * handle, Key * errorKey)
 }
  * @endcode
  *
- * @param handle the plugin's handle
+ * The KeySets are transferred using the shared memory transport,
+ * see elektraPluginProcessInitTransport to select another transport.
+ *
  * @param errorKey a key where error messages will be set
  * @retval NULL if the initialization failed
  * @retval a pointer to the information
  * @ingroup processplugin
  **/
 ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
+{
+	return elektraPluginProcessInitTransport (errorKey, ELEKTRA_PLUGINPROCESS_TRANSPORT_SHM);
+}
+
+/** Initialize a plugin to be executed in its own process using the given transport
+ *
+ * Behaves like elektraPluginProcessInit, but allows to choose how KeySets
+ * are transferred between the parent and the child process.
+ *
+ * @param errorKey a key where error messages will be set
+ * @param transport the transport used for the communication with the child process
+ * @retval NULL if the initialization failed
+ * @retval a pointer to the information
+ * @see elektraPluginProcessInit
+ * @ingroup processplugin
+ **/
+ElektraPluginProcess * elektraPluginProcessInitTransport (Key * errorKey, ElektraPluginProcessTransport transport)
 {
 	// First time initialization
 	ElektraPluginProcess * pp;
-	pp = elektraMalloc (sizeof (ElektraPluginProcess));
-	pp->counter = 0;
-	pp->pluginData = NULL;
-	pp->parentCommandPipeKey = NULL;
-	pp->parentPayloadPipeKey = NULL;
-	pp->childCommandPipeKey = NULL;
-	pp->childPayloadPipeKey = NULL;
-
-	KeySet * config = ksNew (1, keyNew ("user:/fullname", KEY_END), KS_END);
-	pp->dump = elektraInvokeOpen ("dump", config, errorKey);
-	ksDel (config);
-
-	if (!pp->dump)
-	{
-		cleanupPluginData (pp, errorKey, 0);
-		ELEKTRA_SET_INSTALLATION_ERROR (errorKey, "Failed to initialize the dump plugin");
-		return NULL;
+	pp = elektraCalloc (sizeof (ElektraPluginProcess));
+	pp->transport = transport;
+
+	if (transport == ELEKTRA_PLUGINPROCESS_TRANSPORT_SHM)
+	{
+		pp->segment = createSegment ();
+		if (!pp->segment)
+		{
+			cleanupPluginData (pp, errorKey, 0);
+			ELEKTRA_SET_RESOURCE_ERRORF (errorKey, "Failed to create the shared memory segment. Reason: %s", strerror (errno));
+			return NULL;
+		}
+	}
+	else
+	{
+		KeySet * config = ksNew (1, keyNew ("user:/fullname", KEY_END), KS_END);
+		pp->dump = elektraInvokeOpen ("dump", config, errorKey);
+		ksDel (config);
+
+		if (!pp->dump)
+		{
+			cleanupPluginData (pp, errorKey, 0);
+			ELEKTRA_SET_INSTALLATION_ERROR (errorKey, "Failed to initialize the dump plugin");
+			return NULL;
+		}
 	}
 
 	// As generally recommended, ignore SIGPIPE because we will notice that the
@@ -497,9 +1011,11 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 
 	// Prepare the pipes
 	if (!makePipe (pp, errorKey, "parentCommandPipe", pp->parentCommandPipe) ||
-	    !makePipe (pp, errorKey, "parentPayloadPipe", pp->parentPayloadPipe) ||
-	    !makePipe (pp, errorKey, "childCommandPipe", pp->childCommandPipe) ||
-	    !makePipe (pp, errorKey, "childPayloadPipe", pp->childPayloadPipe))
+	    !makePipe (pp, errorKey, "childCommandPipe", pp->childCommandPipe))
+		return NULL;
+	// the shared memory transport only sends the payload via the segment
+	if (transport == ELEKTRA_PLUGINPROCESS_TRANSPORT_DUMP && (!makePipe (pp, errorKey, "parentPayloadPipe", pp->parentPayloadPipe) ||
+								  !makePipe (pp, errorKey, "childPayloadPipe", pp->childPayloadPipe)))
 		return NULL;
 
 	pp->pid = fork ();
@@ -513,25 +1029,30 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 
 	int pipeIdx = elektraPluginProcessIsParent (pp);
 	close (pp->parentCommandPipe[!pipeIdx]);
-	close (pp->parentPayloadPipe[!pipeIdx]);
 	close (pp->childCommandPipe[pipeIdx]);
-	close (pp->childPayloadPipe[pipeIdx]);
 
 	ELEKTRA_LOG_DEBUG ("parentCommandPipe[%d] has file descriptor %d", pipeIdx, pp->parentCommandPipe[pipeIdx]);
-	ELEKTRA_LOG_DEBUG ("parentPayloadPipe[%d] has file descriptor %d", pipeIdx, pp->parentPayloadPipe[pipeIdx]);
 	ELEKTRA_LOG_DEBUG ("childCommandPipe[%d] has file descriptor %d", !pipeIdx, pp->childCommandPipe[!pipeIdx]);
-	ELEKTRA_LOG_DEBUG ("childPayloadPipe[%d] has file descriptor %d", !pipeIdx, pp->childPayloadPipe[!pipeIdx]);
-
-	// Prepare the keys for the pipes to use with dump
-	pp->parentCommandPipeKey = makePipeKey ("parentCommandPipe", pp->parentCommandPipe[pipeIdx]);
-	pp->parentPayloadPipeKey = makePipeKey ("parentPayloadPipe", pp->parentPayloadPipe[pipeIdx]);
-	pp->childCommandPipeKey = makePipeKey ("childCommandPipe", pp->childCommandPipe[!pipeIdx]);
-	pp->childPayloadPipeKey = makePipeKey ("childPayloadPipe", pp->childPayloadPipe[!pipeIdx]);
-
-	ELEKTRA_LOG_DEBUG ("parentCommandPipeKey is %s on %d", keyString (pp->parentCommandPipeKey), pp->pid);
-	ELEKTRA_LOG_DEBUG ("parentPayloadPipeKey is %s on %d", keyString (pp->parentPayloadPipeKey), pp->pid);
-	ELEKTRA_LOG_DEBUG ("childCommandPipeKey is %s on %d", keyString (pp->childCommandPipeKey), pp->pid);
-	ELEKTRA_LOG_DEBUG ("childPayloadPipeKey is %s on %d", keyString (pp->childPayloadPipeKey), pp->pid);
+
+	if (transport == ELEKTRA_PLUGINPROCESS_TRANSPORT_DUMP)
+	{
+		close (pp->parentPayloadPipe[!pipeIdx]);
+		close (pp->childPayloadPipe[pipeIdx]);
+
+		ELEKTRA_LOG_DEBUG ("parentPayloadPipe[%d] has file descriptor %d", pipeIdx, pp->parentPayloadPipe[pipeIdx]);
+		ELEKTRA_LOG_DEBUG ("childPayloadPipe[%d] has file descriptor %d", !pipeIdx, pp->childPayloadPipe[!pipeIdx]);
+
+		// Prepare the keys for the pipes to use with dump
+		pp->parentCommandPipeKey = makePipeKey ("parentCommandPipe", pp->parentCommandPipe[pipeIdx]);
+		pp->parentPayloadPipeKey = makePipeKey ("parentPayloadPipe", pp->parentPayloadPipe[pipeIdx]);
+		pp->childCommandPipeKey = makePipeKey ("childCommandPipe", pp->childCommandPipe[!pipeIdx]);
+		pp->childPayloadPipeKey = makePipeKey ("childPayloadPipe", pp->childPayloadPipe[!pipeIdx]);
+
+		ELEKTRA_LOG_DEBUG ("parentCommandPipeKey is %s on %d", keyString (pp->parentCommandPipeKey), pp->pid);
+		ELEKTRA_LOG_DEBUG ("parentPayloadPipeKey is %s on %d", keyString (pp->parentPayloadPipeKey), pp->pid);
+		ELEKTRA_LOG_DEBUG ("childCommandPipeKey is %s on %d", keyString (pp->childCommandPipeKey), pp->pid);
+		ELEKTRA_LOG_DEBUG ("childPayloadPipeKey is %s on %d", keyString (pp->childPayloadPipeKey), pp->pid);
+	}
 
 	ELEKTRA_LOG_DEBUG ("The pluginprocess is set with the pid %d", pp->pid);
 	return pp;
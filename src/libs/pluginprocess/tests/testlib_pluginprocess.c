@@ -18,12 +18,14 @@
 
 #include <tests.h>
 
+static ElektraPluginProcessTransport transport = ELEKTRA_PLUGINPROCESS_TRANSPORT_SHM;
+
 static int elektraDummyOpen (Plugin * handle, Key * errorKey)
 {
 	ElektraPluginProcess * pp = elektraPluginGetData (handle);
 	if (pp == NULL)
 	{
-		if ((pp = elektraPluginProcessInit (errorKey)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
+		if ((pp = elektraPluginProcessInitTransport (errorKey, transport)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
 		elektraPluginSetData (handle, pp);
 		// pass dummy plugin data over to the child
 		int * testData = (int *) malloc (sizeof (int));
@@ -367,7 +369,7 @@ static int elektraDummyOpenWithError (Plugin * handle, Key * errorKey)
 	ElektraPluginProcess * pp = elektraPluginGetData (handle);
 	if (pp == NULL)
 	{
-		if ((pp = elektraPluginProcessInit (errorKey)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
+		if ((pp = elektraPluginProcessInitTransport (errorKey, transport)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
 		elektraPluginSetData (handle, pp);
 		// Assume some other initialization failed and thus close here without calling open
 		// to free the resources but without sending the command
@@ -412,7 +414,7 @@ static int elektraDummyOpenAndDie (Plugin * handle, Key * errorKey)
 	ElektraPluginProcess * pp = elektraPluginGetData (handle);
 	if (pp == NULL)
 	{
-		if ((pp = elektraPluginProcessInit (errorKey)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
+		if ((pp = elektraPluginProcessInitTransport (errorKey, transport)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
 		elektraPluginSetData (handle, pp);
 		if (!elektraPluginProcessIsParent (pp)) elektraPluginProcessStart (handle, pp);
 	}
@@ -446,9 +448,69 @@ static void test_childDies (void)
 	elektraFree (plugin);
 }
 
-int main (int argc, char ** argv)
+static void test_payload (void)
 {
-	init (argc, argv);
+	printf ("test payload\n");
+
+	Key * parentKey = keyNew ("user:/tests/pluginprocess", KEY_VALUE, "parent value", KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	Plugin * plugin = createDummyPlugin (conf);
+
+	// large enough to require growing the shared memory segment
+	KeySet * ks = ksNew (0, KS_END);
+	for (int i = 0; i < 2000; ++i)
+	{
+		char name[64];
+		snprintf (name, sizeof (name), "user:/tests/pluginprocess/key/#%d", i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, name + sizeof ("user:/") - 1, KEY_META, "meta/number", name + 30, KEY_END));
+	}
+	const char binaryValue[] = { 'b', '\0', 'i', 'n' };
+	ksAppendKey (ks, keyNew ("user:/tests/pluginprocess/binary", KEY_BINARY, KEY_SIZE, sizeof (binaryValue), KEY_VALUE, binaryValue,
+				 KEY_END));
+	ksAppendKey (ks, keyNew ("user:/tests/pluginprocess/empty", KEY_END));
+
+	succeed_if (plugin->kdbOpen (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbOpen was not successful");
+	ElektraPluginProcess * pp = elektraPluginGetData (plugin);
+	if (pp)
+	{
+		succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+		succeed_if (ksGetSize (ks) == 2003, "wrong number of keys returned by the child");
+		succeed_if_same_string (keyString (parentKey), "parent value");
+
+		Key * key = ksLookupByName (ks, "user:/tests/pluginprocess/key/#1999", KDB_O_NONE);
+		succeed_if (key != NULL, "key was lost");
+		if (key != NULL)
+		{
+			succeed_if_same_string (keyString (key), "tests/pluginprocess/key/#1999");
+			succeed_if_same_string (keyString (keyGetMeta (key, "meta/number")), "#1999");
+		}
+
+		key = ksLookupByName (ks, "user:/tests/pluginprocess/binary", KDB_O_NONE);
+		succeed_if (key != NULL && keyIsBinary (key), "binary key was lost");
+		if (key != NULL)
+		{
+			succeed_if (keyGetValueSize (key) == sizeof (binaryValue), "wrong size of binary value");
+			succeed_if (memcmp (keyValue (key), binaryValue, sizeof (binaryValue)) == 0, "wrong binary value");
+		}
+
+		key = ksLookupByName (ks, "user:/tests/pluginprocess/empty", KDB_O_NONE);
+		succeed_if (key != NULL, "empty key was lost");
+		succeed_if (ksLookupByName (ks, "user:/tests/pluginprocess/set", KDB_O_NONE) != NULL, "key added by the child is missing");
+	}
+	succeed_if (plugin->kdbClose (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbClose was not successful");
+
+	output_warnings (parentKey);
+	output_error (parentKey);
+
+	keyDel (parentKey);
+	ksDel (ks);
+	ksDel (conf);
+	elektraFree (plugin);
+}
+
+static void test_transport (ElektraPluginProcessTransport testTransport)
+{
+	transport = testTransport;
 
 	test_communication ();
 	test_emptyKeySet ();
@@ -457,6 +519,17 @@ int main (int argc, char ** argv)
 	test_closeWithoutOpen ();
 	test_childAddingParentKey ();
 	test_childDies ();
+	test_payload ();
+}
+
+int main (int argc, char ** argv)
+{
+	init (argc, argv);
+
+	printf ("\nshared memory transport\n");
+	test_transport (ELEKTRA_PLUGINPROCESS_TRANSPORT_SHM);
+	printf ("\ndump transport\n");
+	test_transport (ELEKTRA_PLUGINPROCESS_TRANSPORT_DUMP);
 
 	print_result ("pluginprocess");
 
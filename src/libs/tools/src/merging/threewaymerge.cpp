@@ -11,6 +11,9 @@
 #include <helper/keyhelper.hpp>
 #include <merging/threewaymerge.hpp>
 
+#include <cstring>
+#include <kdbprivate.h>
+
 using namespace std;
 using namespace kdb::tools::helper;
 
@@ -35,127 +38,253 @@ inline void addAsymmetricConflict (MergeResult & result, Key & key, ConflictOper
 	}
 }
 
-void ThreeWayMerge::detectConflicts (const MergeTask & task, MergeResult & mergeResult, bool reverseConflictMeta = false)
+/**
+ * Walks over the keys of a KeySet that are below (or same as) a parent key.
+ *
+ * The keys are visited in the order of their names relative to the parent. The
+ * relative names are compared in place, i.e. without building rebased names.
+ */
+class HierarchyCursor
 {
-	for (Key our : task.ours)
+public:
+	HierarchyCursor (const KeySet & keys, const Key & parent)
+	: ks (keys.getKeySet ()), parentSize (ckdb::keyGetUnescapedNameSize (*parent)),
+	  // the unescaped name of a root key has a trailing null byte
+	  prefixSize (parentSize == 3 ? 2 : parentSize)
+	{
+		cur = ckdb::ksFindHierarchy (ks, *parent, &end);
+		begin = cur;
+	}
+
+	/**
+	 * @retval true if all keys of the KeySet are part of the hierarchy
+	 */
+	bool coversAll () const
+	{
+		return begin == 0 && end == ckdb::ksGetSize (ks);
+	}
+
+	bool valid () const
+	{
+		return cur < end;
+	}
+
+	Key get () const
+	{
+		return Key (valid () ? ckdb::ksAtCursor (ks, cur) : nullptr);
+	}
+
+	void next ()
+	{
+		++cur;
+	}
+
+	/**
+	 * Compares the relative names of the current keys of two cursors.
+	 * Invalid cursors are greater than all valid ones.
+	 *
+	 * @return < 0, 0 or > 0 like memcmp
+	 */
+	static int compare (const HierarchyCursor & a, const HierarchyCursor & b)
+	{
+		if (!a.valid () || !b.valid ())
+		{
+			return b.valid () - a.valid ();
+		}
+
+		size_t sizeA;
+		size_t sizeB;
+		const char * nameA = a.relativeName (sizeA);
+		const char * nameB = b.relativeName (sizeB);
+
+		int result = memcmp (nameA, nameB, sizeA < sizeB ? sizeA : sizeB);
+		if (result != 0)
+		{
+			return result;
+		}
+		return sizeA < sizeB ? -1 : sizeA > sizeB;
+	}
+
+private:
+	const char * relativeName (size_t & size) const
 	{
-		string theirLookup = rebasePath (our, task.ourParent, task.theirParent);
-		Key theirLookupResult = task.theirs.lookup (theirLookup);
+		const ckdb::Key * key = ckdb::ksAtCursor (ks, cur);
+		size_t keySize = ckdb::keyGetUnescapedNameSize (key);
+		size = keySize <= parentSize ? 0 : keySize - prefixSize;
+		return static_cast<const char *> (ckdb::keyUnescapedName (key)) + prefixSize;
+	}
 
-		// we have to copy it to obtain owner etc...
-		Key mergeKey = rebaseKey (our, task.ourParent, task.mergeRoot);
+	ckdb::KeySet * ks;
+	size_t parentSize;
+	size_t prefixSize;
+	elektraCursor begin;
+	elektraCursor cur;
+	elektraCursor end;
+};
+
+/**
+ * Classifies a single key of ours, given the keys with the same relative name in theirs and base.
+ * Null keys denote that there is no such key.
+ */
+static void detectConflict (const MergeTask & task, MergeResult & mergeResult, Key & our, Key & theirLookupResult, Key & baseLookupResult,
+			    bool rebased, bool reverseConflictMeta)
+{
+	// we have to copy it to obtain owner etc...
+	auto mergeKey = [&] () { return rebaseKey (our, task.ourParent, task.mergeRoot); };
 
-		if (keyDataEqual (our, theirLookupResult))
+	if (keyDataEqual (our, theirLookupResult))
+	{
+		// keydata matches, see if metakeys match
+		if (keyMetaEqual (our, theirLookupResult))
 		{
-			// keydata matches, see if metakeys match
-			if (keyMetaEqual (our, theirLookupResult))
+			if (!rebased)
 			{
-				if (task.ourParent.getName () == task.mergeRoot.getName ())
-				{
-					// the key was not rebased, we can reuse our (prevents that the key is rewritten)
-					mergeResult.addMergeKey (our);
-				}
-				else
-				{
-					// the key causes no merge conflict, but the merge result is below a new parent
-					mergeResult.addMergeKey (mergeKey);
-				}
+				// the key was not rebased, we can reuse our (prevents that the key is rewritten)
+				mergeResult.addMergeKey (our);
 			}
 			else
 			{
-				// metakeys are different
-				mergeResult.addConflict (mergeKey, CONFLICT_META, CONFLICT_META);
+				// the key causes no merge conflict, but the merge result is below a new parent
+				mergeResult.addMergeKey (mergeKey ());
 			}
 		}
 		else
 		{
-			string baseLookup = rebasePath (our, task.ourParent, task.baseParent);
-			Key baseLookupResult = task.base.lookup (baseLookup);
-
-			// check if the keys was newly added in ours
-			if (baseLookupResult)
+			// metakeys are different
+			Key conflictKey = mergeKey ();
+			mergeResult.addConflict (conflictKey, CONFLICT_META, CONFLICT_META);
+		}
+	}
+	else
+	{
+		// check if the keys was newly added in ours
+		if (baseLookupResult)
+		{
+			// the key exists in base, check if the key still exists in theirs
+			if (theirLookupResult)
 			{
-				// the key exists in base, check if the key still exists in theirs
-				if (theirLookupResult)
+				// check if only they modified it
+				if (!keyDataEqual (our, baseLookupResult) && keyDataEqual (theirLookupResult, baseLookupResult))
 				{
-					// check if only they modified it
-					if (!keyDataEqual (our, baseLookupResult) && keyDataEqual (theirLookupResult, baseLookupResult))
-					{
-						// the key was only modified in ours
-						addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_MODIFY, CONFLICT_SAME,
-								       reverseConflictMeta);
-					}
-					else
-					{
-						// check if both modified it
-						if (!keyDataEqual (our, baseLookupResult) &&
-						    !keyDataEqual (theirLookupResult, baseLookupResult))
-						{
-							// the key was modified on both sides
-							mergeResult.addConflict (mergeKey, CONFLICT_MODIFY, CONFLICT_MODIFY);
-						}
-					}
+					// the key was only modified in ours
+					Key conflictKey = mergeKey ();
+					addAsymmetricConflict (mergeResult, conflictKey, CONFLICT_MODIFY, CONFLICT_SAME,
+							       reverseConflictMeta);
 				}
 				else
 				{
-					// the key does not exist in theirs anymore, check if ours has modified it
-					if (keyDataEqual (our, baseLookupResult))
-					{
-						// the key was deleted in theirs, and not modified in ours
-						addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_SAME, CONFLICT_DELETE,
-								       reverseConflictMeta);
-					}
-					else
+					// check if both modified it
+					if (!keyDataEqual (our, baseLookupResult) && !keyDataEqual (theirLookupResult, baseLookupResult))
 					{
-						// the key was deleted in theirs, but modified in ours
-						addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_MODIFY, CONFLICT_DELETE,
-								       reverseConflictMeta);
+						// the key was modified on both sides
+						Key conflictKey = mergeKey ();
+						mergeResult.addConflict (conflictKey, CONFLICT_MODIFY, CONFLICT_MODIFY);
 					}
 				}
 			}
 			else
 			{
-				// the key does not exist in base, check if the key was added in theirs
-				if (theirLookupResult)
+				// the key does not exist in theirs anymore, check if ours has modified it
+				Key conflictKey = mergeKey ();
+				if (keyDataEqual (our, baseLookupResult))
+				{
+					// the key was deleted in theirs, and not modified in ours
+					addAsymmetricConflict (mergeResult, conflictKey, CONFLICT_SAME, CONFLICT_DELETE,
+							       reverseConflictMeta);
+				}
+				else
+				{
+					// the key was deleted in theirs, but modified in ours
+					addAsymmetricConflict (mergeResult, conflictKey, CONFLICT_MODIFY, CONFLICT_DELETE,
+							       reverseConflictMeta);
+				}
+			}
+		}
+		else
+		{
+			// the key does not exist in base, check if the key was added in theirs
+			if (theirLookupResult)
+			{
+				// check if the key was added with the same value in theirs
+				if (keyDataEqual (our, theirLookupResult))
 				{
-					// check if the key was added with the same value in theirs
-					if (keyDataEqual (mergeKey, theirLookupResult))
+					if (keyMetaEqual (our, theirLookupResult))
 					{
-						if (keyMetaEqual (our, theirLookupResult))
+						// the key was added on both sides with the same value
+						if (!rebased)
 						{
-							// the key was added on both sides with the same value
-							if (task.ourParent.getName () == task.mergeRoot.getName ())
-							{
-								// the key was not rebased, we can reuse our and prevent the sync flag being
-								// set
-								mergeResult.addMergeKey (our);
-							}
-							else
-							{
-								// the key causes no merge conflict, but the merge result is below a new
-								// parent
-								mergeResult.addMergeKey (mergeKey);
-							}
+							// the key was not rebased, we can reuse our and prevent the sync flag being
+							// set
+							mergeResult.addMergeKey (our);
 						}
 						else
 						{
-							// metakeys are different
-							mergeResult.addConflict (mergeKey, CONFLICT_META, CONFLICT_META);
+							// the key causes no merge conflict, but the merge result is below a new
+							// parent
+							mergeResult.addMergeKey (mergeKey ());
 						}
 					}
 					else
 					{
-						// the key was added on both sides with different values
-						mergeResult.addConflict (mergeKey, CONFLICT_ADD, CONFLICT_ADD);
+						// metakeys are different
+						Key conflictKey = mergeKey ();
+						mergeResult.addConflict (conflictKey, CONFLICT_META, CONFLICT_META);
 					}
 				}
 				else
 				{
-					// the key was only added to ours
-					addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_ADD, CONFLICT_SAME, reverseConflictMeta);
+					// the key was added on both sides with different values
+					Key conflictKey = mergeKey ();
+					mergeResult.addConflict (conflictKey, CONFLICT_ADD, CONFLICT_ADD);
 				}
 			}
+			else
+			{
+				// the key was only added to ours
+				Key conflictKey = mergeKey ();
+				addAsymmetricConflict (mergeResult, conflictKey, CONFLICT_ADD, CONFLICT_SAME, reverseConflictMeta);
+			}
+		}
+	}
+}
+
+void ThreeWayMerge::detectConflicts (const MergeTask & task, MergeResult & mergeResult, bool reverseConflictMeta = false)
+{
+	bool rebased = task.ourParent.getName () != task.mergeRoot.getName ();
+
+	HierarchyCursor ourCursor (task.ours, task.ourParent);
+	if (!task.ourParent.isCascading () && !task.theirParent.isCascading () && !task.baseParent.isCascading () &&
+	    ourCursor.coversAll ())
+	{
+		// all keys are sorted by their names relative to the parents -> merge-join the three KeySets
+		HierarchyCursor theirCursor (task.theirs, task.theirParent);
+		HierarchyCursor baseCursor (task.base, task.baseParent);
+		ckdb::Key * nullKey = nullptr;
+		for (; ourCursor.valid (); ourCursor.next ())
+		{
+			while (HierarchyCursor::compare (theirCursor, ourCursor) < 0)
+			{
+				theirCursor.next ();
+			}
+			while (HierarchyCursor::compare (baseCursor, ourCursor) < 0)
+			{
+				baseCursor.next ();
+			}
+
+			Key our = ourCursor.get ();
+			Key theirLookupResult = HierarchyCursor::compare (theirCursor, ourCursor) == 0 ? theirCursor.get () : Key (nullKey);
+			Key baseLookupResult = HierarchyCursor::compare (baseCursor, ourCursor) == 0 ? baseCursor.get () : Key (nullKey);
+			detectConflict (task, mergeResult, our, theirLookupResult, baseLookupResult, rebased, reverseConflictMeta);
 		}
+		return;
+	}
+
+	// cascading parents may map several keys to the same rebased name -> look up each key
+	for (Key our : task.ours)
+	{
+		Key theirLookupResult = task.theirs.lookup (rebasePath (our, task.ourParent, task.theirParent));
+		Key baseLookupResult = task.base.lookup (rebasePath (our, task.ourParent, task.baseParent));
+		detectConflict (task, mergeResult, our, theirLookupResult, baseLookupResult, rebased, reverseConflictMeta);
 	}
 }
 
@@ -245,6 +245,11 @@ void Plugin::check (vector<string> & warnings)
 	}
 	if (infos.find ("needs") == infos.end ()) warnings.push_back ("no needs information found");
 
+	if (infos.find ("concurrency") != infos.end () && infos["concurrency"] != "readonly")
+	{
+		warnings.push_back ("not supported concurrency " + infos["concurrency"] + " found");
+	}
+
 	if (infos.find ("author") == infos.end ())
 	{
 		warnings.push_back ("no author found");
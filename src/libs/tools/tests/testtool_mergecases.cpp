@@ -67,6 +67,31 @@ TEST_F (ThreeWayMergeTest, CascadingParentsCauseNoCascadingKeys)
 	}
 }
 
+TEST_F (ThreeWayMergeTest, ParentsInDifferentNamespacesMerge)
+{
+	KeySet ourKeys (5, *Key ("user:/a/b", KEY_END), *Key ("user:/a/b/config/key1", KEY_VALUE, "value1", KEY_END),
+			*Key ("user:/a/b/config/key1/sub", KEY_VALUE, "sub", KEY_END),
+			*Key ("user:/a/b/config/key10", KEY_VALUE, "value10", KEY_END), KS_END);
+	KeySet theirKeys (5, *Key ("dir:/x", KEY_END), *Key ("dir:/x/config/key1", KEY_VALUE, "changed", KEY_END),
+			  *Key ("dir:/x/config/key10", KEY_VALUE, "value10", KEY_END),
+			  *Key ("dir:/x/config/key2", KEY_VALUE, "value2", KEY_END), KS_END);
+	KeySet baseKeys (5, *Key ("system:/", KEY_END), *Key ("system:/config/key1", KEY_VALUE, "value1", KEY_END),
+			 *Key ("system:/config/key10", KEY_VALUE, "value10", KEY_END), KS_END);
+
+	MergeResult result = merger.mergeKeySet (baseKeys, ourKeys, theirKeys, Key ("user:/m", KEY_END));
+
+	KeySet merged = result.getMergedKeys ();
+	EXPECT_EQ (2, merged.size ());
+	EXPECT_TRUE (merged.lookup ("user:/m"));
+	compareKeys (Key ("user:/m/config/key10", KEY_VALUE, "value10", KEY_END), merged.lookup ("user:/m/config/key10"));
+
+	KeySet conflicts = result.getConflictSet ();
+	ASSERT_EQ (3, conflicts.size ()) << "Wrong number of conflicts";
+	testConflictMeta (conflicts.lookup ("user:/m/config/key1"), CONFLICT_SAME, CONFLICT_MODIFY);
+	testConflictMeta (conflicts.lookup ("user:/m/config/key1/sub"), CONFLICT_ADD, CONFLICT_SAME);
+	testConflictMeta (conflicts.lookup ("user:/m/config/key2"), CONFLICT_SAME, CONFLICT_ADD);
+}
+
 TEST_F (ThreeWayMergeTest, SameDeletedKeyMerge)
 {
 	ours.lookup ("user:/parento/config/key1", KDB_O_POP);
@@ -0,0 +1,254 @@
+/**
+ * @file
+ *
+ * @brief Buffered writer for storage plugins.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <kdbutility.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <kdbassert.h>
+#include <kdbhelper.h>
+
+/** size of the heap buffer short data is copied into */
+#define ELEKTRA_WRITER_BUFFER_SIZE (64 * 1024)
+
+/** maximum number of segments collected before a flush */
+#define ELEKTRA_WRITER_MAX_SEGMENTS 64
+
+struct _ElektraWriter
+{
+	int fd;
+	ElektraWriterCallback callback;
+	void * context;
+
+	char * buffer;
+	size_t used;
+	struct iovec segments[ELEKTRA_WRITER_MAX_SEGMENTS];
+	int count;
+
+	int error;
+};
+
+static ElektraWriter * writerNew (int fd, ElektraWriterCallback callback, void * context)
+{
+	ElektraWriter * writer = elektraCalloc (sizeof (ElektraWriter));
+	if (writer == NULL)
+	{
+		return NULL;
+	}
+	writer->buffer = elektraMalloc (ELEKTRA_WRITER_BUFFER_SIZE);
+	if (writer->buffer == NULL)
+	{
+		elektraFree (writer);
+		return NULL;
+	}
+	writer->fd = fd;
+	writer->callback = callback;
+	writer->context = context;
+	return writer;
+}
+
+/**
+ * @brief Create a writer for the file descriptor @p fd.
+ *
+ * Data is collected in a fixed heap buffer, a flush writes all collected segments with a single writev() call.
+ * The memory used by the writer does not depend on the amount of data written.
+ *
+ * @param fd file descriptor opened for writing, not closed by the writer
+ *
+ * @return new writer, free it with elektraWriterDel()
+ * @retval NULL on memory allocation errors
+ */
+ElektraWriter * elektraWriterNew (int fd)
+{
+	return writerNew (fd, NULL, NULL);
+}
+
+/**
+ * @brief Create a writer that passes flushed segments to @p callback.
+ *
+ * @param callback called once per segment on each flush, returns 0 on success or an errno value
+ * @param context passed to @p callback
+ *
+ * @return new writer, free it with elektraWriterDel()
+ * @retval NULL on memory allocation errors
+ */
+ElektraWriter * elektraWriterNewCallback (ElektraWriterCallback callback, void * context)
+{
+	ELEKTRA_NOT_NULL (callback);
+	return writerNew (-1, callback, context);
+}
+
+/**
+ * @brief Free @p writer without flushing it.
+ *
+ * @param writer the writer to free, may be NULL
+ */
+void elektraWriterDel (ElektraWriter * writer)
+{
+	if (writer == NULL)
+	{
+		return;
+	}
+	elektraFree (writer->buffer);
+	elektraFree (writer);
+}
+
+static void flushCallback (ElektraWriter * writer)
+{
+	for (int i = 0; i < writer->count; ++i)
+	{
+		int error = writer->callback (writer->context, writer->segments[i].iov_base, writer->segments[i].iov_len);
+		if (error != 0)
+		{
+			writer->error = error;
+			return;
+		}
+	}
+}
+
+static void flushDescriptor (ElektraWriter * writer)
+{
+	struct iovec * segment = writer->segments;
+	int left = writer->count;
+	while (left > 0)
+	{
+		ssize_t written = writev (writer->fd, segment, left);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			writer->error = errno;
+			return;
+		}
+
+		size_t done = (size_t) written;
+		while (left > 0 && done >= segment->iov_len)
+		{
+			done -= segment->iov_len;
+			++segment;
+			--left;
+		}
+		if (left > 0)
+		{
+			segment->iov_base = (char *) segment->iov_base + done;
+			segment->iov_len -= done;
+		}
+	}
+}
+
+/**
+ * @brief Write all collected data.
+ *
+ * After the first failed write, all further data is discarded.
+ *
+ * @param writer the writer
+ *
+ * @retval 0 if all data was written
+ * @return the errno value of the failed write otherwise
+ */
+int elektraWriterFlush (ElektraWriter * writer)
+{
+	ELEKTRA_NOT_NULL (writer);
+	if (writer->error == 0)
+	{
+		if (writer->callback != NULL)
+		{
+			flushCallback (writer);
+		}
+		else
+		{
+			flushDescriptor (writer);
+		}
+	}
+	writer->count = 0;
+	writer->used = 0;
+	return writer->error;
+}
+
+/**
+ * @brief Append @p size bytes of @p data.
+ *
+ * Data shorter than #ELEKTRA_WRITER_REFERENCE_SIZE is copied into the buffer of the writer.
+ * Longer data is only referenced and must stay valid until the next elektraWriterFlush().
+ *
+ * @param writer the writer
+ * @param data the data to write
+ * @param size the number of bytes in @p data
+ *
+ * @retval 0 if no write failed so far
+ * @return the errno value of the failed write otherwise
+ */
+int elektraWriterWrite (ElektraWriter * writer, const char * data, size_t size)
+{
+	ELEKTRA_NOT_NULL (writer);
+	if (size == 0)
+	{
+		return writer->error;
+	}
+
+	if (size >= ELEKTRA_WRITER_REFERENCE_SIZE)
+	{
+		if (writer->count == ELEKTRA_WRITER_MAX_SEGMENTS)
+		{
+			elektraWriterFlush (writer);
+		}
+		writer->segments[writer->count].iov_base = (char *) data;
+		writer->segments[writer->count].iov_len = size;
+		++writer->count;
+		return writer->error;
+	}
+
+	if (writer->used + size > ELEKTRA_WRITER_BUFFER_SIZE || writer->count == ELEKTRA_WRITER_MAX_SEGMENTS)
+	{
+		elektraWriterFlush (writer);
+	}
+
+	char * target = writer->buffer + writer->used;
+	memcpy (target, data, size);
+	writer->used += size;
+
+	struct iovec * last = writer->count > 0 ? &writer->segments[writer->count - 1] : NULL;
+	if (last != NULL && (char *) last->iov_base + last->iov_len == target)
+	{
+		last->iov_len += size;
+	}
+	else
+	{
+		writer->segments[writer->count].iov_base = target;
+		writer->segments[writer->count].iov_len = size;
+		++writer->count;
+	}
+	return writer->error;
+}
+
+/**
+ * @brief Append the null-terminated @p string without its terminator.
+ *
+ * @see elektraWriterWrite()
+ */
+int elektraWriterWriteString (ElektraWriter * writer, const char * string)
+{
+	return elektraWriterWrite (writer, string, strlen (string));
+}
+
+/**
+ * @param writer the writer
+ *
+ * @retval 0 if no write failed so far
+ * @return the errno value of the failed write otherwise
+ */
+int elektraWriterError (const ElektraWriter * writer)
+{
+	ELEKTRA_NOT_NULL (writer);
+	return writer->error;
+}
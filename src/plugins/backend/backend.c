@@ -7,6 +7,20 @@
 #include <kdblogger.h>
 #include <kdbprivate.h>
 
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ELEKTRA_BACKEND_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Minimum number of keys per partition, when read-only plugins are run in parallel.
+ * Smaller KeySets are always validated by a single thread.
+ */
+#define ELEKTRA_BACKEND_MIN_PARTITION_SIZE 1024
+
 int ELEKTRA_PLUGIN_FUNCTION (open) (Plugin * plugin, Key * errorKey ELEKTRA_UNUSED)
 {
 	BackendHandle * handle = elektraCalloc (sizeof (BackendHandle));
@@ -81,6 +95,33 @@ static bool loadPlugin (Plugin ** pluginPtr, Plugin * thisPlugin, Key * pluginRe
 	return true;
 }
 
+/**
+ * Checks whether a plugin declared `infos/concurrency = readonly` in its contract.
+ *
+ * Such plugins never modify the KeySet or keep state between calls, so they may be
+ * run concurrently on disjoint parts of a KeySet.
+ */
+static bool isReadOnlyPlugin (Plugin * plugin)
+{
+	if (plugin->kdbGet == NULL)
+	{
+		return false;
+	}
+
+	KeySet * contract = ksNew (0, KS_END);
+	Key * contractKey = keyNew ("system:/elektra/modules", KEY_END);
+	keyAddBaseName (contractKey, plugin->name);
+	plugin->kdbGet (plugin, contract, contractKey);
+	keyAddName (contractKey, "infos/concurrency");
+
+	Key * concurrency = ksLookup (contract, contractKey, 0);
+	bool readOnly = concurrency != NULL && strcmp (keyString (concurrency), "readonly") == 0;
+
+	keyDel (contractKey);
+	ksDel (contract);
+	return readOnly;
+}
+
 static bool loadPluginList (PluginList ** pluginListPtr, Plugin * thisPlugin, KeySet * definition, const char * pluginRefRootName,
 			    enum PluginType type, Key * parentKey)
 {
@@ -106,6 +147,7 @@ static bool loadPluginList (PluginList ** pluginListPtr, Plugin * thisPlugin, Ke
 
 		PluginList * element = elektraMalloc (sizeof (PluginList));
 		element->plugin = plugin;
+		element->concurrent = (type == PLUGIN_TYPE_GET || type == PLUGIN_TYPE_SET) && isReadOnlyPlugin (plugin);
 		element->next = NULL;
 
 		if (listEnd == NULL)
@@ -123,6 +165,39 @@ static bool loadPluginList (PluginList ** pluginListPtr, Plugin * thisPlugin, Ke
 	return true;
 }
 
+static bool loadThreads (size_t * threadsPtr, KeySet * definition, Key * parentKey)
+{
+	Key * threadsKey = ksLookupByName (definition, "system:/threads", 0);
+	if (threadsKey == NULL)
+	{
+#ifdef ELEKTRA_BACKEND_THREADS
+		long processors = sysconf (_SC_NPROCESSORS_ONLN);
+		*threadsPtr = processors > 1 ? (size_t) processors : 1;
+#else
+		*threadsPtr = 1;
+#endif
+		return true;
+	}
+
+	char * end;
+	const char * threads = keyString (threadsKey);
+	unsigned long value = strtoul (threads, &end, 10);
+	if (*threads < '0' || *threads > '9' || *end != '\0' || value == 0)
+	{
+		ELEKTRA_SET_INSTALLATION_ERRORF (
+			parentKey, "'%s/definition/threads' must be a positive number, but was '%s'. (Configuration of mountpoint: %s)",
+			keyName (parentKey), threads, keyBaseName (parentKey));
+		return false;
+	}
+
+#ifdef ELEKTRA_BACKEND_THREADS
+	*threadsPtr = value;
+#else
+	*threadsPtr = 1;
+#endif
+	return true;
+}
+
 int ELEKTRA_PLUGIN_FUNCTION (init) (Plugin * plugin, KeySet * definition, Key * parentKey)
 {
 	if (keyGetNamespace (parentKey) == KEY_NS_PROC)
@@ -130,6 +205,11 @@ int ELEKTRA_PLUGIN_FUNCTION (init) (Plugin * plugin, KeySet * definition, Key *
 		BackendHandle * handle = elektraPluginGetData (plugin);
 		handle->path = elektraStrDup ("");
 
+		if (!loadThreads (&handle->threads, definition, parentKey))
+		{
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+
 		if (!loadPluginList (&handle->getPositions.poststorage, plugin, definition, "system:/positions/get/poststorage",
 				     PLUGIN_TYPE_GET, parentKey))
 		{
@@ -152,6 +232,11 @@ int ELEKTRA_PLUGIN_FUNCTION (init) (Plugin * plugin, KeySet * definition, Key *
 	BackendHandle * handle = elektraPluginGetData (plugin);
 	handle->path = elektraStrDup (path);
 
+	if (!loadThreads (&handle->threads, definition, parentKey))
+	{
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
 	// load get plugins
 	if (!loadPlugin (&handle->getPositions.resolver, plugin, ksLookupByName (definition, "system:/positions/get/resolver", 0),
 			 PLUGIN_TYPE_GET, parentKey))
@@ -173,6 +258,10 @@ int ELEKTRA_PLUGIN_FUNCTION (init) (Plugin * plugin, KeySet * definition, Key *
 	{
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
+	if (!elektraBackendCacheInit (handle, definition, parentKey))
+	{
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
 
 	// load set plugins
 	if (!loadPlugin (&handle->setPositions.resolver, plugin, ksLookupByName (definition, "system:/positions/set/resolver", 0),
@@ -401,11 +490,257 @@ static int runPluginGet (Plugin * plugin, KeySet * ks, Key * parentKey)
 	return ret;
 }
 
-static int runPluginListGet (PluginList * plugins, KeySet * ks, Key * parentKey)
+static int runPluginSet (Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	// TODO: provide way to access kdbSet and name without kdbprivate.h
+	ksRewind (ks);
+	int ret = plugin->kdbSet (plugin, ks, parentKey);
+	if (ret == ELEKTRA_PLUGIN_STATUS_ERROR)
+	{
+		if (keyGetMeta (parentKey, "error") == NULL)
+		{
+			addGenericError (parentKey, "kdbSet", plugin->name);
+		}
+	}
+	return ret;
+}
+
+static int runPlugin (Plugin * plugin, enum PluginType type, KeySet * ks, Key * parentKey)
+{
+	return type == PLUGIN_TYPE_GET ? runPluginGet (plugin, ks, parentKey) : runPluginSet (plugin, ks, parentKey);
+}
+
+#ifdef ELEKTRA_BACKEND_THREADS
+/**
+ * Appends the error or warning @p problem of @p from to the warnings of @p to.
+ * If @p asError is true and @p to has no error yet, @p problem becomes the error of @p to.
+ */
+static void appendProblem (Key * to, Key * from, Key * problem, bool asError)
+{
+	char name[64];
+	if (asError && keyGetMeta (to, "error") == NULL)
+	{
+		strcpy (name, "error");
+	}
+	else
+	{
+		// same numbering as ELEKTRA_ADD_*_WARNING: at most 100 warnings, then start again with #0
+		const Key * warnings = keyGetMeta (to, "warnings");
+		const char * last = warnings == NULL ? NULL : keyString (warnings);
+		int index = 0;
+		if (last != NULL)
+		{
+			index = last[1] == '_' ? ((last[2] - '0') * 10 + (last[3] - '0')) : (last[1] - '0');
+			index = (index + 1) % 100;
+		}
+		strcpy (name, "warnings/");
+		elektraWriteArrayNumber (&name[sizeof ("warnings/") - 1], index);
+		keySetMeta (to, "warnings", &name[sizeof ("warnings/") - 1]);
+	}
+	keySetMeta (to, name, keyString (problem));
+
+	size_t nameSize = strlen (name);
+	size_t problemNameSize = strlen (keyName (problem));
+	KeySet * meta = keyMeta (from);
+	for (elektraCursor end, i = ksFindHierarchy (meta, problem, &end) + 1; i < end; i++)
+	{
+		Key * cur = ksAtCursor (meta, i);
+		const char * suffix = keyName (cur) + problemNameSize;
+		if (nameSize + strlen (suffix) >= sizeof (name))
+		{
+			continue;
+		}
+		strcpy (&name[nameSize], suffix);
+		keySetMeta (to, name, keyString (cur));
+	}
+}
+
+/**
+ * Moves the warnings and the error, which a plugin added to @p from, to @p to.
+ *
+ * The warnings keep their order and are appended after the warnings already present in @p to.
+ * The error becomes a warning, if @p to already has an error.
+ */
+static void mergeProblems (Key * to, Key * from)
+{
+	KeySet * meta = keyMeta (from);
+	Key * warningsRoot = keyNew ("meta:/warnings", KEY_END);
+	for (elektraCursor end, i = ksFindHierarchy (meta, warningsRoot, &end); i < end; i++)
+	{
+		Key * cur = ksAtCursor (meta, i);
+		if (keyIsDirectlyBelow (warningsRoot, cur) == 1)
+		{
+			appendProblem (to, from, cur, false);
+		}
+	}
+	keyDel (warningsRoot);
+
+	Key * error = (Key *) keyGetMeta (from, "error");
+	if (error != NULL)
+	{
+		appendProblem (to, from, error, true);
+	}
+}
+
+typedef struct
+{
+	PluginList * plugins; // first plugin of the run of read-only plugins
+	size_t pluginCount;
+	enum PluginType type;
+	KeySet * partition;
+	Key ** parentKeys; // one copy of the parentKey per plugin, collects errors and warnings
+	int * results;	   // one result per plugin
+} ValidationTask;
+
+static void * runValidationTask (void * data)
+{
+	ValidationTask * task = data;
+	PluginList * cur = task->plugins;
+	for (size_t i = 0; i < task->pluginCount; i++, cur = cur->next)
+	{
+		task->results[i] = runPlugin (cur->plugin, task->type, task->partition, task->parentKeys[i]);
+		if (task->results[i] == ELEKTRA_PLUGIN_STATUS_ERROR)
+		{
+			// the errors of all later plugins are discarded anyway
+			break;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Runs the read-only plugins starting at @p *pluginsPtr in parallel on disjoint partitions of @p ks.
+ *
+ * Every partition is processed by a single thread, so each key is only accessed by one thread.
+ * Afterwards the errors and warnings are merged into @p parentKey in the same order a serial run
+ * would have produced them: by plugin first, then by partition. Like in a serial run, nothing after
+ * the first error is kept.
+ *
+ * @param pluginsPtr  first plugin of the run, will be set to the last plugin of the run
+ * @param partitions  number of partitions, must be at least 2
+ * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS if no plugin failed
+ * @retval ELEKTRA_PLUGIN_STATUS_ERROR if any plugin failed
+ */
+static int runReadOnlyPlugins (PluginList ** pluginsPtr, enum PluginType type, size_t partitions, KeySet * ks, Key * parentKey)
+{
+	PluginList * plugins = *pluginsPtr;
+	size_t pluginCount = 1;
+	while ((*pluginsPtr)->next != NULL && (*pluginsPtr)->next->concurrent)
+	{
+		*pluginsPtr = (*pluginsPtr)->next;
+		++pluginCount;
+	}
+
+	ValidationTask * tasks = elektraCalloc (partitions * sizeof (ValidationTask));
+	Key ** parentKeys = elektraCalloc (partitions * pluginCount * sizeof (Key *));
+	int * results = elektraCalloc (partitions * pluginCount * sizeof (int));
+	pthread_t * threads = elektraCalloc (partitions * sizeof (pthread_t));
+	bool * started = elektraCalloc (partitions * sizeof (bool));
+
+	// key reference counts are not atomic, so the partitions are created before any thread is started
+	size_t size = ksGetSize (ks);
+	for (size_t p = 0; p < partitions; p++)
+	{
+		size_t begin = size * p / partitions;
+		size_t end = size * (p + 1) / partitions;
+
+		tasks[p].plugins = plugins;
+		tasks[p].pluginCount = pluginCount;
+		tasks[p].type = type;
+		tasks[p].partition = ksNew (end - begin, KS_END);
+		for (size_t i = begin; i < end; i++)
+		{
+			ksAppendKey (tasks[p].partition, ksAtCursor (ks, i));
+		}
+		tasks[p].parentKeys = &parentKeys[p * pluginCount];
+		tasks[p].results = &results[p * pluginCount];
+		for (size_t i = 0; i < pluginCount; i++)
+		{
+			tasks[p].parentKeys[i] = keyDup (parentKey, KEY_CP_NAME | KEY_CP_STRING);
+			tasks[p].results[i] = ELEKTRA_PLUGIN_STATUS_SUCCESS;
+		}
+	}
+
+	// the first partition is processed by the calling thread
+	for (size_t p = 1; p < partitions; p++)
+	{
+		started[p] = pthread_create (&threads[p], NULL, runValidationTask, &tasks[p]) == 0;
+	}
+	runValidationTask (&tasks[0]);
+	for (size_t p = 1; p < partitions; p++)
+	{
+		if (started[p])
+		{
+			pthread_join (threads[p], NULL);
+		}
+		else
+		{
+			runValidationTask (&tasks[p]);
+		}
+	}
+
+	int ret = ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	for (size_t i = 0; i < pluginCount && ret != ELEKTRA_PLUGIN_STATUS_ERROR; i++)
+	{
+		for (size_t p = 0; p < partitions && ret != ELEKTRA_PLUGIN_STATUS_ERROR; p++)
+		{
+			mergeProblems (parentKey, tasks[p].parentKeys[i]);
+			if (tasks[p].results[i] == ELEKTRA_PLUGIN_STATUS_ERROR)
+			{
+				ret = ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
+		}
+	}
+
+	for (size_t p = 0; p < partitions; p++)
+	{
+		for (size_t i = 0; i < pluginCount; i++)
+		{
+			keyDel (tasks[p].parentKeys[i]);
+		}
+		ksDel (tasks[p].partition);
+	}
+	elektraFree (started);
+	elektraFree (threads);
+	elektraFree (results);
+	elektraFree (parentKeys);
+	elektraFree (tasks);
+
+	return ret;
+}
+#endif
+
+/**
+ * Runs a list of plugins for kdbGet() or kdbSet().
+ *
+ * Consecutive read-only plugins (see isReadOnlyPlugin()) are run in parallel,
+ * if @p ks is large enough to give every thread at least
+ * #ELEKTRA_BACKEND_MIN_PARTITION_SIZE keys.
+ */
+static int runPluginList (PluginList * plugins, enum PluginType type, size_t threads, KeySet * ks, Key * parentKey)
 {
+	size_t partitions = ksGetSize (ks) / ELEKTRA_BACKEND_MIN_PARTITION_SIZE;
+	if (partitions > threads)
+	{
+		partitions = threads;
+	}
+
 	for (PluginList * cur = plugins; cur != NULL; cur = cur->next)
 	{
-		if (runPluginGet (cur->plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR)
+		int ret;
+#ifdef ELEKTRA_BACKEND_THREADS
+		if (cur->concurrent && partitions > 1)
+		{
+			ret = runReadOnlyPlugins (&cur, type, partitions, ks, parentKey);
+		}
+		else
+		{
+			ret = runPlugin (cur->plugin, type, ks, parentKey);
+		}
+#else
+		ret = runPlugin (cur->plugin, type, ks, parentKey);
+#endif
+		if (ret == ELEKTRA_PLUGIN_STATUS_ERROR)
 		{
 			return ELEKTRA_PLUGIN_STATUS_ERROR;
 		}
@@ -413,6 +748,39 @@ static int runPluginListGet (PluginList * plugins, KeySet * ks, Key * parentKey)
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
+/**
+ * Runs the storage plugin for kdbGet(), unless the prestorage phase found an entry in the cache.
+ *
+ * The warnings of the storage plugin are not part of the entries, so files that cause warnings are never cached.
+ */
+static int runStorageGet (BackendHandle * handle, KeySet * ks, Key * parentKey)
+{
+	if (elektraBackendCacheLoad (&handle->cache, ks))
+	{
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	}
+
+	if (!handle->cache.known)
+	{
+		return runPluginGet (handle->getPositions.storage, ks, parentKey);
+	}
+
+	const Key * warnings = keyGetMeta (parentKey, "warnings");
+	char * lastWarning = warnings == NULL ? NULL : elektraStrDup (keyString (warnings));
+
+	int ret = runPluginGet (handle->getPositions.storage, ks, parentKey);
+
+	warnings = keyGetMeta (parentKey, "warnings");
+	bool newWarnings = warnings != NULL && (lastWarning == NULL || strcmp (lastWarning, keyString (warnings)) != 0);
+	if (ret == ELEKTRA_PLUGIN_STATUS_SUCCESS && !newWarnings)
+	{
+		elektraBackendCacheStore (&handle->cache, ks);
+	}
+
+	elektraFree (lastWarning);
+	return ret;
+}
+
 int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * plugin, KeySet * ks, Key * parentKey)
 {
 	if (!elektraStrCmp (keyName (parentKey), "system:/elektra/modules/backend"))
@@ -435,6 +803,12 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * plugin, KeySet * ks, Key * parentKey
 		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 	}
 
+	if (!elektraStrCmp (keyName (parentKey), "system:/elektra/cache") && keyGetMeta (parentKey, "cache/stats") != NULL)
+	{
+		// used by `kdb cache stats`
+		return elektraBackendCacheStats (ks, parentKey);
+	}
+
 	BackendHandle * handle = elektraPluginGetData (plugin);
 
 	if (handle == NULL)
@@ -462,11 +836,17 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * plugin, KeySet * ks, Key * parentKey
 		// TODO [new_backend]: implement cache
 		return ELEKTRA_PLUGIN_STATUS_NO_UPDATE;
 	case ELEKTRA_KDB_GET_PHASE_PRE_STORAGE:
-		return runPluginListGet (handle->getPositions.prestorage, ks, parentKey);
+		elektraBackendCacheLookup (&handle->cache, parentKey);
+		if (handle->cache.keys != NULL)
+		{
+			// prestorage plugins only prepare the file for the storage plugin, which is not run
+			return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+		}
+		return runPluginList (handle->getPositions.prestorage, PLUGIN_TYPE_GET, handle->threads, ks, parentKey);
 	case ELEKTRA_KDB_GET_PHASE_STORAGE:
-		return runPluginGet (handle->getPositions.storage, ks, parentKey);
+		return runStorageGet (handle, ks, parentKey);
 	case ELEKTRA_KDB_GET_PHASE_POST_STORAGE:
-		return runPluginListGet (handle->getPositions.poststorage, ks, parentKey);
+		return runPluginList (handle->getPositions.poststorage, PLUGIN_TYPE_GET, handle->threads, ks, parentKey);
 	default:
 		ELEKTRA_SET_INTERNAL_ERRORF (
 			parentKey, "Unknown phase of kdbGet(): %02x\n Please report this bug at https://issues.libelektra.org.", phase);
@@ -474,33 +854,6 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * plugin, KeySet * ks, Key * parentKey
 	}
 }
 
-static int runPluginSet (Plugin * plugin, KeySet * ks, Key * parentKey)
-{
-	// TODO: provide way to access kdbSet and name without kdbprivate.h
-	ksRewind (ks);
-	int ret = plugin->kdbSet (plugin, ks, parentKey);
-	if (ret == ELEKTRA_PLUGIN_STATUS_ERROR)
-	{
-		if (keyGetMeta (parentKey, "error") == NULL)
-		{
-			addGenericError (parentKey, "kdbSet", plugin->name);
-		}
-	}
-	return ret;
-}
-
-static int runPluginListSet (PluginList * plugins, KeySet * ks, Key * parentKey)
-{
-	for (PluginList * cur = plugins; cur != NULL; cur = cur->next)
-	{
-		if (runPluginSet (cur->plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR)
-		{
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
-		}
-	}
-	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
-}
-
 int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * plugin, KeySet * ks, Key * parentKey)
 {
 	BackendHandle * handle = elektraPluginGetData (plugin);
@@ -528,11 +881,11 @@ int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * plugin, KeySet * ks, Key * parentKey
 
 		return runPluginSet (handle->setPositions.resolver, ks, parentKey);
 	case ELEKTRA_KDB_SET_PHASE_PRE_STORAGE:
-		return runPluginListSet (handle->setPositions.prestorage, ks, parentKey);
+		return runPluginList (handle->setPositions.prestorage, PLUGIN_TYPE_SET, handle->threads, ks, parentKey);
 	case ELEKTRA_KDB_SET_PHASE_STORAGE:
 		return runPluginSet (handle->setPositions.storage, ks, parentKey);
 	case ELEKTRA_KDB_SET_PHASE_POST_STORAGE:
-		return runPluginListSet (handle->setPositions.poststorage, ks, parentKey);
+		return runPluginList (handle->setPositions.poststorage, PLUGIN_TYPE_SET, handle->threads, ks, parentKey);
 	default:
 
 		ELEKTRA_SET_INTERNAL_ERRORF (
@@ -672,6 +1025,8 @@ int ELEKTRA_PLUGIN_FUNCTION (close) (Plugin * plugin, Key * errorKey ELEKTRA_UNU
 		elektraFree (handle->path);
 	}
 
+	elektraBackendCacheClose (&handle->cache);
+
 	freePluginList (&handle->getPositions.prestorage);
 	freePluginList (&handle->getPositions.poststorage);
 	freePluginList (&handle->setPositions.prestorage);
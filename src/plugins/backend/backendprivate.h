@@ -15,12 +15,47 @@
 typedef struct _PluginList
 {
 	Plugin * plugin;
+	bool concurrent; // plugin declared `infos/concurrency = readonly` in its contract
 	struct _PluginList * next;
 } PluginList;
 
+/**
+ * Mapping of a cache entry in shared mode.
+ */
+typedef struct _BackendCacheMapping
+{
+	void * data;
+	size_t size;
+	KeySet * keys; // all keys mapped from data, used to find out when the mapping can be removed
+	struct _BackendCacheMapping * next;
+} BackendCacheMapping;
+
+/**
+ * Parse cache of a single mountpoint, see `definition/cache` in the README.
+ */
+typedef struct
+{
+	char * directory; // cache directory, NULL if the cache is disabled
+	char * file;	  // cache file of the mountpoint
+	uint64_t id;	  // name of the cache file, hash of the mountpoint
+	uint64_t chain;	  // hash of everything besides the file content that influences the result of the storage phase
+	uint64_t budget;  // maximum size of all entries in the directory in bytes, 0 for no limit
+	bool shared;	  // entries are mapped instead of read, see `definition/cache/shared`
+	struct _BackendCacheMapping * mappings; // mappings of entries used in shared mode, newest first
+	bool known;	  // the prestorage phase hashed the file, the storage phase may write an entry
+	uint64_t fileSize;
+	uint64_t content; // hash of the file content
+	KeySet * keys;	  // keys of the entry found in the prestorage phase, the storage phase uses them instead of parsing the file
+	uint64_t hits;	  // counters not yet written to the index
+	uint64_t misses;
+	uint64_t used; // time of the last use not yet written to the index, 0 if none
+} BackendCache;
+
 typedef struct
 {
 	char * path;
+	size_t threads; // maximum number of threads used for read-only plugins
+	BackendCache cache;
 	struct
 	{
 		Plugin * resolver;
@@ -43,4 +78,11 @@ typedef struct
 	} setPositions;
 } BackendHandle;
 
+bool elektraBackendCacheInit (BackendHandle * handle, KeySet * definition, Key * parentKey);
+void elektraBackendCacheLookup (BackendCache * cache, Key * parentKey);
+bool elektraBackendCacheLoad (BackendCache * cache, KeySet * ks);
+void elektraBackendCacheStore (BackendCache * cache, KeySet * ks);
+void elektraBackendCacheClose (BackendCache * cache);
+int elektraBackendCacheStats (KeySet * ks, Key * parentKey);
+
 #endif // ELEKTRA_BACKENDPRIVATE_H
@@ -0,0 +1,893 @@
+/**
+ * @file
+ *
+ * @brief Parse cache of the backend plugin.
+ *
+ * Every mountpoint with `definition/cache = 1` stores the result of its storage phase
+ * in a file of the cache directory. The entry is reused as long as the content of the
+ * configuration file and the configuration of the plugins stay the same.
+ *
+ * The directory is shared by all mountpoints. Its `index` file counts hits, misses
+ * and evictions and lists the size and the time of the last use of every entry,
+ * so the least recently used entries are removed first, if the entries exceed the budget.
+ * Using an entry does not touch the index, the counters and the time of the last use
+ * of a mountpoint are kept in memory and written when it is closed.
+ *
+ * With `definition/cache/shared = 1`, entries are mapped read-only with `MAP_SHARED` instead
+ * of being read. The names and values of the keys stay in the mapping until they are modified,
+ * so all processes using the same entry share its memory.
+ * A mapping is removed as soon as none of its keys is used anymore.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include "backendprivate.h"
+
+#include <kdberrors.h>
+#include <kdblogger.h>
+#include <kdbproposal.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ELEKTRA_BACKEND_CACHE_MAGIC 0x3145484341434245ULL // "EBCACHE1"
+#define ELEKTRA_BACKEND_CACHE_INDEX_MAGIC 0x3258444e49434245ULL // "EBCINDX2"
+
+/**
+ * Default for `definition/cache/budget`.
+ */
+#define ELEKTRA_BACKEND_CACHE_DEFAULT_BUDGET (64 * 1024 * 1024)
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+/**
+ * Layout of a cache file: the header is followed by the flat KeySet (see elektraKsFlatExport()).
+ */
+typedef struct
+{
+	uint64_t magic;
+	uint64_t chain;
+	uint64_t fileSize;
+	uint64_t content;
+} BackendCacheHeader;
+
+/**
+ * Layout of the `index` file of the cache directory: the header is followed by `count` entries.
+ */
+typedef struct
+{
+	uint64_t magic;
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	uint64_t count;
+} BackendCacheIndex;
+
+typedef struct
+{
+	uint64_t id;   // name of the entry, see entryFile()
+	uint64_t size; // size of the entry in bytes
+	uint64_t used; // time of the last use in nanoseconds since the epoch
+} BackendCacheIndexEntry;
+
+static uint64_t hashBytes (uint64_t hash, const void * data, size_t size)
+{
+	const unsigned char * bytes = data;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+static uint64_t hashString (uint64_t hash, const char * string)
+{
+	// the terminating null separates consecutive strings
+	return hashBytes (hash, string, strlen (string) + 1);
+}
+
+static uint64_t hashKeySet (uint64_t hash, KeySet * ks)
+{
+	for (elektraCursor i = 0; i < ksGetSize (ks); ++i)
+	{
+		Key * cur = ksAtCursor (ks, i);
+		hash = hashString (hash, keyName (cur));
+		hash = hashBytes (hash, keyValue (cur), keyGetValueSize (cur));
+	}
+	return hash;
+}
+
+static uint64_t hashPlugin (uint64_t hash, Plugin * plugin)
+{
+	if (plugin == NULL)
+	{
+		return hashString (hash, "");
+	}
+	hash = hashString (hash, plugin->name);
+	return hashKeySet (hash, plugin->config);
+}
+
+static char * entryFile (const char * directory, uint64_t id)
+{
+	return elektraFormat ("%s/%016" PRIx64 ".cache", directory, id);
+}
+
+static char * defaultCacheDirectory (void)
+{
+	const char * cacheHome = getenv ("XDG_CACHE_HOME");
+	if (cacheHome != NULL && cacheHome[0] == '/')
+	{
+		return elektraFormat ("%s/elektra/backend", cacheHome);
+	}
+
+	const char * home = getenv ("HOME");
+	if (home != NULL && home[0] == '/')
+	{
+		return elektraFormat ("%s/.cache/elektra/backend", home);
+	}
+
+	return NULL;
+}
+
+static char * cacheDirectory (KeySet * definition)
+{
+	Key * pathKey = ksLookupByName (definition, "system:/cache/path", 0);
+	if (pathKey != NULL && strlen (keyString (pathKey)) > 0)
+	{
+		return elektraStrDup (keyString (pathKey));
+	}
+	return defaultCacheDirectory ();
+}
+
+static bool loadBudget (uint64_t * budgetPtr, KeySet * definition, Key * parentKey)
+{
+	Key * budgetKey = ksLookupByName (definition, "system:/cache/budget", 0);
+	if (budgetKey == NULL)
+	{
+		*budgetPtr = ELEKTRA_BACKEND_CACHE_DEFAULT_BUDGET;
+		return true;
+	}
+
+	char * end;
+	const char * budget = keyString (budgetKey);
+	errno = 0;
+	unsigned long long value = strtoull (budget, &end, 10);
+	if (*budget < '0' || *budget > '9' || *end != '\0' || errno == ERANGE)
+	{
+		ELEKTRA_SET_INSTALLATION_ERRORF (parentKey,
+						 "'%s/definition/cache/budget' must be a non-negative number of bytes, but was '%s'. "
+						 "(Configuration of mountpoint: %s)",
+						 keyName (parentKey), budget, keyBaseName (parentKey));
+		return false;
+	}
+
+	*budgetPtr = value;
+	return true;
+}
+
+static bool loadFlag (bool * flagPtr, KeySet * definition, const char * name, Key * parentKey)
+{
+	Key * flagKey = ksLookupByName (definition, name, 0);
+	*flagPtr = flagKey != NULL && strcmp (keyString (flagKey), "1") == 0;
+	if (flagKey != NULL && !*flagPtr && strcmp (keyString (flagKey), "0") != 0)
+	{
+		ELEKTRA_SET_INSTALLATION_ERRORF (
+			parentKey, "'%s/definition/%s' must be either '0' or '1', but was '%s'. (Configuration of mountpoint: %s)",
+			keyName (parentKey), name + sizeof ("system:/") - 1, keyString (flagKey), keyBaseName (parentKey));
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Enables the cache, if the definition contains `system:/cache = 1`.
+ *
+ * Must be called after all get plugins were loaded, because their configuration is part of the entries.
+ */
+bool elektraBackendCacheInit (BackendHandle * handle, KeySet * definition, Key * parentKey)
+{
+	bool enabled;
+	if (!loadFlag (&enabled, definition, "system:/cache", parentKey))
+	{
+		return false;
+	}
+	if (!enabled)
+	{
+		return true;
+	}
+
+	BackendCache * cache = &handle->cache;
+	if (!loadFlag (&cache->shared, definition, "system:/cache/shared", parentKey) ||
+	    !loadBudget (&cache->budget, definition, parentKey))
+	{
+		return false;
+	}
+
+	cache->directory = cacheDirectory (definition);
+	if (cache->directory == NULL)
+	{
+		ELEKTRA_ADD_INSTALLATION_WARNINGF (
+			parentKey,
+			"Could not determine a cache directory, the cache is disabled. Set '%s/definition/cache/path' to an absolute path "
+			"to enable it. (Configuration of mountpoint: %s)",
+			keyName (parentKey), keyBaseName (parentKey));
+		return true;
+	}
+
+	cache->id = hashString (FNV_OFFSET, keyName (parentKey));
+	cache->file = entryFile (cache->directory, cache->id);
+
+	uint64_t chain = hashString (FNV_OFFSET, KDB_VERSION);
+	chain = hashString (chain, keyName (parentKey));
+	chain = hashKeySet (chain, definition);
+	chain = hashPlugin (chain, handle->getPositions.resolver);
+	for (PluginList * cur = handle->getPositions.prestorage; cur != NULL; cur = cur->next)
+	{
+		chain = hashPlugin (chain, cur->plugin);
+	}
+	chain = hashPlugin (chain, handle->getPositions.storage);
+	cache->chain = chain;
+
+	return true;
+}
+
+static bool readAll (int fd, void * buffer, size_t size)
+{
+	char * data = buffer;
+	while (size > 0)
+	{
+		ssize_t ret = read (fd, data, size);
+		if (ret < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (ret <= 0)
+		{
+			return false;
+		}
+		data += ret;
+		size -= ret;
+	}
+	return true;
+}
+
+static bool writeAll (int fd, const void * buffer, size_t size)
+{
+	const char * data = buffer;
+	while (size > 0)
+	{
+		ssize_t ret = write (fd, data, size);
+		if (ret < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (ret <= 0)
+		{
+			return false;
+		}
+		data += ret;
+		size -= ret;
+	}
+	return true;
+}
+
+static int mkdirParents (char * path)
+{
+	if (mkdir (path, KDB_FILE_MODE | KDB_DIR_MODE) == 0 || errno == EEXIST)
+	{
+		return 0;
+	}
+	if (errno != ENOENT)
+	{
+		return -1;
+	}
+
+	char * p = strrchr (path, '/');
+	if (p == NULL || p == path)
+	{
+		return -1;
+	}
+
+	*p = '\0';
+	int ret = mkdirParents (path);
+	*p = '/';
+	if (ret == -1)
+	{
+		return -1;
+	}
+	return mkdir (path, KDB_FILE_MODE | KDB_DIR_MODE) == 0 || errno == EEXIST ? 0 : -1;
+}
+
+static uint64_t now (void)
+{
+	struct timespec time;
+	clock_gettime (CLOCK_REALTIME, &time);
+	return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+static bool lockIndex (int fd, short type)
+{
+	struct flock lock;
+	memset (&lock, 0, sizeof (lock));
+	lock.l_type = type;
+	lock.l_whence = SEEK_SET;
+	while (fcntl (fd, F_SETLKW, &lock) == -1)
+	{
+		if (errno != EINTR)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Returns the id of an entry file name like `0123456789abcdef.cache`.
+ */
+static bool parseEntryName (const char * name, uint64_t * idPtr)
+{
+	if (strlen (name) != 16 + sizeof (".cache") - 1 || strcmp (name + 16, ".cache") != 0 || strspn (name, "0123456789abcdef") != 16)
+	{
+		return false;
+	}
+	*idPtr = strtoull (name, NULL, 16);
+	return true;
+}
+
+/**
+ * Lists the entries of @p directory. Only used if the index is missing, e.g. in a new directory.
+ *
+ * @return the number of entries
+ */
+static size_t scanEntries (const char * directory, BackendCacheIndexEntry ** entriesPtr)
+{
+	*entriesPtr = NULL;
+	DIR * dir = opendir (directory);
+	if (dir == NULL)
+	{
+		return 0;
+	}
+
+	size_t count = 0;
+	size_t alloc = 0;
+	struct dirent * cur;
+	while ((cur = readdir (dir)) != NULL)
+	{
+		uint64_t id;
+		if (!parseEntryName (cur->d_name, &id))
+		{
+			continue;
+		}
+
+		char * file = entryFile (directory, id);
+		struct stat buf;
+		bool found = stat (file, &buf) == 0 && S_ISREG (buf.st_mode);
+		elektraFree (file);
+		if (!found)
+		{
+			continue;
+		}
+
+		if (count == alloc)
+		{
+			alloc = alloc == 0 ? 16 : 2 * alloc;
+			elektraRealloc ((void **) entriesPtr, alloc * sizeof (BackendCacheIndexEntry));
+		}
+		(*entriesPtr)[count].id = id;
+		(*entriesPtr)[count].size = buf.st_size;
+		(*entriesPtr)[count].used = (uint64_t) ELEKTRA_STAT_SECONDS (buf) * 1000000000 + ELEKTRA_STAT_NANO_SECONDS (buf);
+		++count;
+	}
+	closedir (dir);
+	return count;
+}
+
+/**
+ * Reads the index of @p directory from @p fd, which must be locked.
+ *
+ * If the index is missing or invalid, its entries are created from the files in @p directory.
+ * The caller must free the returned entries.
+ */
+static BackendCacheIndexEntry * readIndex (int fd, const char * directory, BackendCacheIndex * index)
+{
+	if (pread (fd, index, sizeof (BackendCacheIndex), 0) == sizeof (BackendCacheIndex) &&
+	    index->magic == ELEKTRA_BACKEND_CACHE_INDEX_MAGIC && index->count <= SIZE_MAX / sizeof (BackendCacheIndexEntry))
+	{
+		size_t size = index->count * sizeof (BackendCacheIndexEntry);
+		BackendCacheIndexEntry * entries = elektraMalloc (size + 1);
+		if (pread (fd, entries, size, sizeof (BackendCacheIndex)) == (ssize_t) size)
+		{
+			return entries;
+		}
+		elektraFree (entries);
+	}
+
+	memset (index, 0, sizeof (BackendCacheIndex));
+	index->magic = ELEKTRA_BACKEND_CACHE_INDEX_MAGIC;
+	BackendCacheIndexEntry * entries;
+	index->count = scanEntries (directory, &entries);
+	return entries;
+}
+
+static bool writeIndex (int fd, const BackendCacheIndex * index, const BackendCacheIndexEntry * entries)
+{
+	size_t size = index->count * sizeof (BackendCacheIndexEntry);
+	char * data = elektraMalloc (sizeof (BackendCacheIndex) + size);
+	memcpy (data, index, sizeof (BackendCacheIndex));
+	if (size > 0)
+	{
+		memcpy (data + sizeof (BackendCacheIndex), entries, size);
+	}
+	bool written = pwrite (fd, data, sizeof (BackendCacheIndex) + size, 0) == (ssize_t) (sizeof (BackendCacheIndex) + size) &&
+		       ftruncate (fd, sizeof (BackendCacheIndex) + size) == 0;
+	elektraFree (data);
+	return written;
+}
+
+static int compareUsed (const void * a, const void * b)
+{
+	const BackendCacheIndexEntry * first = a;
+	const BackendCacheIndexEntry * second = b;
+	if (first->used != second->used)
+	{
+		return first->used < second->used ? -1 : 1;
+	}
+	return 0;
+}
+
+/**
+ * Removes the least recently used entries, until all entries fit into the budget.
+ *
+ * @return the number of removed entries
+ */
+static uint64_t evictEntries (BackendCache * cache, BackendCacheIndex * index, BackendCacheIndexEntry * entries)
+{
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < index->count; ++i)
+	{
+		bytes += entries[i].size;
+	}
+	if (cache->budget == 0 || bytes <= cache->budget)
+	{
+		return 0;
+	}
+
+	qsort (entries, index->count, sizeof (BackendCacheIndexEntry), compareUsed);
+	uint64_t evictions = 0;
+	size_t kept = 0;
+	for (size_t i = 0; i < index->count; ++i)
+	{
+		if (bytes > cache->budget)
+		{
+			char * file = entryFile (cache->directory, entries[i].id);
+			bool removed = unlink (file) == 0;
+			bool missing = !removed && errno == ENOENT;
+			elektraFree (file);
+			if (removed || missing)
+			{
+				bytes -= entries[i].size;
+				evictions += removed;
+				continue;
+			}
+		}
+		entries[kept++] = entries[i];
+	}
+	index->count = kept;
+	return evictions;
+}
+
+/**
+ * Writes the counters and the last use of the mountpoint to the `index` file of the cache directory.
+ *
+ * If @p stored is given, the entry is added to the index and the least recently used entries are evicted,
+ * if the entries exceed the budget. The file is locked, so concurrent processes do not lose updates.
+ * This is only called when an entry is written or the mountpoint is closed, never when an entry is used.
+ */
+static void updateIndex (BackendCache * cache, const BackendCacheIndexEntry * stored)
+{
+	char * indexFile = elektraFormat ("%s/index", cache->directory);
+	int fd = open (indexFile, O_RDWR | O_CREAT, KDB_FILE_MODE);
+	if (fd == -1 && errno == ENOENT && mkdirParents (cache->directory) == 0)
+	{
+		fd = open (indexFile, O_RDWR | O_CREAT, KDB_FILE_MODE);
+	}
+	elektraFree (indexFile);
+	if (fd == -1)
+	{
+		return;
+	}
+
+	if (!lockIndex (fd, F_WRLCK))
+	{
+		close (fd);
+		return;
+	}
+
+	BackendCacheIndex index;
+	BackendCacheIndexEntry * entries = readIndex (fd, cache->directory, &index);
+	index.hits += cache->hits;
+	index.misses += cache->misses;
+
+	size_t found = index.count;
+	for (size_t i = 0; i < index.count; ++i)
+	{
+		if (entries[i].id == cache->id)
+		{
+			found = i;
+		}
+	}
+
+	if (stored != NULL)
+	{
+		if (found == index.count)
+		{
+			elektraRealloc ((void **) &entries, (index.count + 1) * sizeof (BackendCacheIndexEntry));
+			++index.count;
+		}
+		entries[found] = *stored;
+		index.evictions += evictEntries (cache, &index, entries);
+	}
+	else if (found < index.count && cache->used > entries[found].used)
+	{
+		entries[found].used = cache->used;
+	}
+
+	if (writeIndex (fd, &index, entries))
+	{
+		cache->hits = 0;
+		cache->misses = 0;
+		cache->used = 0;
+	}
+	else
+	{
+		ELEKTRA_LOG_WARNING ("could not update cache index in %s", cache->directory);
+	}
+	elektraFree (entries);
+	close (fd);
+}
+
+static bool hashFile (const char * path, uint64_t * sizePtr, uint64_t * contentPtr)
+{
+	int fd = open (path, O_RDONLY);
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	struct stat buf;
+	if (fstat (fd, &buf) == -1 || !S_ISREG (buf.st_mode))
+	{
+		close (fd);
+		return false;
+	}
+
+	char data[65536];
+	uint64_t size = 0;
+	uint64_t hash = FNV_OFFSET;
+	ssize_t ret;
+	while ((ret = read (fd, data, sizeof (data))) != 0)
+	{
+		if (ret < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (ret < 0)
+		{
+			close (fd);
+			return false;
+		}
+		hash = hashBytes (hash, data, ret);
+		size += ret;
+	}
+	close (fd);
+
+	*sizePtr = size;
+	*contentPtr = hash;
+	return true;
+}
+
+static KeySet * loadEntry (int fd, size_t size)
+{
+	void * data = elektraMalloc (size + 1);
+	if (!readAll (fd, data, size))
+	{
+		elektraFree (data);
+		return NULL;
+	}
+
+	KeySet * keys = ksNew (0, KS_END);
+	if (elektraKsFlatImport (keys, data, size) < 0)
+	{
+		ksDel (keys);
+		keys = NULL;
+	}
+	elektraFree (data);
+	return keys;
+}
+
+/**
+ * Creates keys whose names and values stay in a read-only shared mapping of the entry.
+ *
+ * Every use maps the entry again, so the keys of each mapping are known exactly.
+ * As the pages of the file are shared, this needs only address space, not memory.
+ */
+static KeySet * mapEntry (BackendCache * cache, int fd, size_t fileSize)
+{
+	void * data = mmap (NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+	if (data == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+	KeySet * keys = ksNew (0, KS_END);
+	if (elektraKsFlatMap (keys, (char *) data + sizeof (BackendCacheHeader), fileSize - sizeof (BackendCacheHeader)) < 0)
+	{
+		ksDel (keys);
+		munmap (data, fileSize);
+		return NULL;
+	}
+
+	BackendCacheMapping * mapping = elektraMalloc (sizeof (BackendCacheMapping));
+	mapping->data = data;
+	mapping->size = fileSize;
+	mapping->keys = ksNew (ksGetSize (keys), KS_END);
+	ksAppend (mapping->keys, keys);
+	mapping->next = cache->mappings;
+	cache->mappings = mapping;
+	return keys;
+}
+
+/**
+ * Removes all mappings, whose keys are no longer used.
+ */
+static void unmapEntries (BackendCache * cache)
+{
+	BackendCacheMapping ** next = &cache->mappings;
+	while (*next != NULL)
+	{
+		BackendCacheMapping * mapping = *next;
+		if (elektraKsFlatMapInUse (mapping->keys))
+		{
+			next = &mapping->next;
+			continue;
+		}
+
+		*next = mapping->next;
+		ksDel (mapping->keys);
+		munmap (mapping->data, mapping->size);
+		elektraFree (mapping);
+	}
+}
+
+static KeySet * readEntry (BackendCache * cache)
+{
+	int fd = open (cache->file, O_RDONLY);
+	if (fd == -1)
+	{
+		return NULL;
+	}
+
+	struct stat buf;
+	BackendCacheHeader header;
+	if (fstat (fd, &buf) == -1 || (size_t) buf.st_size < sizeof (header) || !readAll (fd, &header, sizeof (header)) ||
+	    header.magic != ELEKTRA_BACKEND_CACHE_MAGIC || header.chain != cache->chain || header.fileSize != cache->fileSize ||
+	    header.content != cache->content)
+	{
+		close (fd);
+		return NULL;
+	}
+
+	KeySet * keys = cache->shared ? mapEntry (cache, fd, buf.st_size) : loadEntry (fd, buf.st_size - sizeof (header));
+	if (keys == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("ignoring invalid cache file %s", cache->file);
+	}
+	else
+	{
+		// recorded in the index by elektraBackendCacheClose(), see evictEntries()
+		cache->used = now ();
+	}
+	close (fd);
+	return keys;
+}
+
+/**
+ * Looks up the entry for the file in the value of @p parentKey.
+ *
+ * Called in the prestorage phase, i.e. before the file is parsed. If a valid
+ * entry exists, its keys are kept until elektraBackendCacheLoad() is called.
+ */
+void elektraBackendCacheLookup (BackendCache * cache, Key * parentKey)
+{
+	cache->known = false;
+	if (cache->keys != NULL)
+	{
+		ksDel (cache->keys);
+		cache->keys = NULL;
+	}
+	unmapEntries (cache);
+
+	if (cache->directory == NULL || !hashFile (keyString (parentKey), &cache->fileSize, &cache->content))
+	{
+		return;
+	}
+	cache->known = true;
+	cache->keys = readEntry (cache);
+	ELEKTRA_LOG_DEBUG ("cache %s for %s", cache->keys != NULL ? "hit" : "miss", keyName (parentKey));
+	if (cache->keys != NULL)
+	{
+		++cache->hits;
+	}
+	else
+	{
+		++cache->misses;
+	}
+}
+
+/**
+ * Appends the keys found by elektraBackendCacheLookup() to @p ks.
+ *
+ * @retval true if there was a valid entry
+ * @retval false if the file must be parsed
+ */
+bool elektraBackendCacheLoad (BackendCache * cache, KeySet * ks)
+{
+	if (cache->keys == NULL)
+	{
+		return false;
+	}
+
+	ksAppend (ks, cache->keys);
+	ksDel (cache->keys);
+	cache->keys = NULL;
+	return true;
+}
+
+/**
+ * Writes the result @p ks of the storage phase as entry for the file hashed by elektraBackendCacheLookup().
+ *
+ * The entry is written to a temporary file first, so concurrent readers never see partial entries.
+ * Failures are not reported, the file is simply parsed again next time.
+ */
+void elektraBackendCacheStore (BackendCache * cache, KeySet * ks)
+{
+	if (!cache->known)
+	{
+		return;
+	}
+	cache->known = false;
+
+	size_t size = cache->shared ? elektraKsFlatSizeMappable (ks, 0, ksGetSize (ks)) : elektraKsFlatSize (ks, 0, ksGetSize (ks));
+	BackendCacheHeader header = { ELEKTRA_BACKEND_CACHE_MAGIC, cache->chain, cache->fileSize, cache->content };
+	char * data = elektraMalloc (sizeof (header) + size);
+	memcpy (data, &header, sizeof (header));
+	size_t exported;
+	if (cache->shared)
+	{
+		exported = elektraKsFlatExportMappable (ks, 0, ksGetSize (ks), data + sizeof (header), size);
+	}
+	else
+	{
+		exported = elektraKsFlatExport (ks, 0, ksGetSize (ks), data + sizeof (header), size);
+	}
+	if (exported != size || mkdirParents (cache->directory) == -1)
+	{
+		elektraFree (data);
+		return;
+	}
+
+	char * tmpFile = elektraFormat ("%s.%d.tmp", cache->file, (int) getpid ());
+	int fd = open (tmpFile, O_WRONLY | O_CREAT | O_TRUNC, KDB_FILE_MODE);
+	if (fd != -1)
+	{
+		bool written = writeAll (fd, data, sizeof (header) + size);
+		if (close (fd) == -1 || !written || rename (tmpFile, cache->file) == -1)
+		{
+			ELEKTRA_LOG_WARNING ("could not write cache file %s", cache->file);
+			unlink (tmpFile);
+		}
+		else
+		{
+			BackendCacheIndexEntry stored = { cache->id, sizeof (header) + size, now () };
+			updateIndex (cache, &stored);
+		}
+	}
+	elektraFree (tmpFile);
+	elektraFree (data);
+}
+
+/**
+ * Frees the cache of a mountpoint.
+ *
+ * Mappings whose keys are still used outlive the mountpoint and are only removed when the process exits.
+ */
+void elektraBackendCacheClose (BackendCache * cache)
+{
+	if (cache->directory != NULL && (cache->hits > 0 || cache->misses > 0 || cache->used > 0))
+	{
+		updateIndex (cache, NULL);
+	}
+	elektraFree (cache->directory);
+	elektraFree (cache->file);
+	ksDel (cache->keys);
+	cache->keys = NULL;
+	unmapEntries (cache);
+	while (cache->mappings != NULL)
+	{
+		BackendCacheMapping * mapping = cache->mappings;
+		cache->mappings = mapping->next;
+		ksDel (mapping->keys);
+		elektraFree (mapping);
+	}
+	memset (cache, 0, sizeof (BackendCache));
+}
+
+/**
+ * Appends the statistics of a cache directory below @p parentKey to @p ks.
+ *
+ * The directory is the value of @p parentKey, by default the directory used without `definition/cache/path`.
+ */
+int elektraBackendCacheStats (KeySet * ks, Key * parentKey)
+{
+	char * directory = strlen (keyString (parentKey)) > 0 ? elektraStrDup (keyString (parentKey)) : defaultCacheDirectory ();
+	if (directory == NULL)
+	{
+		ELEKTRA_SET_RESOURCE_ERROR (parentKey, "Could not determine the cache directory, neither XDG_CACHE_HOME nor HOME is set");
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	BackendCacheIndex index;
+	BackendCacheIndexEntry * entries = NULL;
+	char * indexFile = elektraFormat ("%s/index", directory);
+	int fd = open (indexFile, O_RDONLY);
+	elektraFree (indexFile);
+	if (fd != -1 && lockIndex (fd, F_RDLCK))
+	{
+		entries = readIndex (fd, directory, &index);
+	}
+	else
+	{
+		memset (&index, 0, sizeof (index));
+		index.count = scanEntries (directory, &entries);
+	}
+	if (fd != -1)
+	{
+		close (fd);
+	}
+
+	uint64_t count = index.count;
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < index.count; ++i)
+	{
+		bytes += entries[i].size;
+	}
+	elektraFree (entries);
+
+	const char * names[] = { "hits", "misses", "evictions", "entries", "bytes" };
+	uint64_t values[] = { index.hits, index.misses, index.evictions, count, bytes };
+	Key * directoryKey = keyNew (keyName (parentKey), KEY_VALUE, directory, KEY_END);
+	keyAddBaseName (directoryKey, "directory");
+	ksAppendKey (ks, directoryKey);
+	for (size_t i = 0; i < sizeof (names) / sizeof (names[0]); ++i)
+	{
+		char * value = elektraFormat ("%" PRIu64, values[i]);
+		Key * key = keyNew (keyName (parentKey), KEY_VALUE, value, KEY_END);
+		keyAddBaseName (key, names[i]);
+		ksAppendKey (ks, key);
+		elektraFree (value);
+	}
+
+	elektraFree (directory);
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
@@ -9,7 +9,10 @@
 
 #include "backendprivate.h"
 #include <stdlib.h>
+#include <fcntl.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <kdbconfig.h>
 
@@ -376,6 +379,468 @@ static void test_backref (void)
 }
 */
 
+static KeySet * createRangeKeys (size_t count, size_t firstInvalid)
+{
+	KeySet * ks = ksNew (count, KS_END);
+	char name[64];
+	for (size_t i = 0; i < count; i++)
+	{
+		snprintf (name, sizeof (name), "user:/tests/backend/%05zu", i);
+		// every 97th key starting at firstInvalid is out of range
+		bool invalid = i >= firstInvalid && i % 97 == 0;
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, invalid ? "1000" : "50", KEY_META, "check/range", "0-100", KEY_META, "type",
+					 "long", KEY_END));
+	}
+	return ks;
+}
+
+static void test_readOnlyValidation (void)
+{
+	printf ("test read-only validation\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("backend");
+
+	Key * rangeErrorKey = keyNew ("/", KEY_END);
+	Plugin * range = elektraPluginOpen ("range", modules, ksNew (0, KS_END), rangeErrorKey);
+	exit_if_fail (range != NULL, "could not open range plugin");
+
+	KeySet * plugins =
+		ksNew (1, keyNew ("system:/range", KEY_BINARY, KEY_SIZE, sizeof (range), KEY_VALUE, &range, KEY_END), KS_END);
+
+	ElektraKdbPhase phase = ELEKTRA_KDB_GET_PHASE_POST_STORAGE;
+	plugin->global = ksNew (
+		2, keyNew ("system:/elektra/kdb/backend/phase", KEY_BINARY, KEY_SIZE, sizeof (ElektraKdbPhase), KEY_VALUE, &phase, KEY_END),
+		keyNew ("system:/elektra/kdb/backend/plugins", KEY_BINARY, KEY_SIZE, sizeof (KeySet *), KEY_VALUE, &plugins, KEY_END),
+		KS_END);
+
+	// more threads than cores are fine, the result must not depend on scheduling
+	KeySet * definition = ksNew (3, keyNew ("system:/path", KEY_VALUE, "/tmp/backend.ecf", KEY_END),
+				     keyNew ("system:/threads", KEY_VALUE, "4", KEY_END),
+				     keyNew ("system:/positions/get/poststorage/#0", KEY_VALUE, "range", KEY_END), KS_END);
+	// init warns about the missing storage plugin
+	Key * initKey = keyNew ("user:/tests/backend", KEY_END);
+	succeed_if (plugin->kdbInit (plugin, definition, initKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "kdbInit failed");
+	succeed_if (keyGetMeta (initKey, "error") == NULL, "kdbInit failed");
+	keyDel (initKey);
+	ksDel (definition);
+
+	Key * parentKey = keyNew ("user:/tests/backend", KEY_VALUE, "/tmp/backend.ecf", KEY_END);
+
+	BackendHandle * handle = elektraPluginGetData (plugin);
+	succeed_if (handle->threads == 4, "threads not loaded from definition");
+	exit_if_fail (handle->getPositions.poststorage != NULL, "range not loaded");
+	succeed_if (handle->getPositions.poststorage->concurrent, "range should be run concurrently");
+
+	KeySet * ks = createRangeKeys (10000, 0);
+	Key * serialParentKey = keyDup (parentKey, KEY_CP_NAME | KEY_CP_STRING);
+	succeed_if (range->kdbGet (range, ks, serialParentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "range kdbGet failed");
+
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "backend kdbGet failed");
+	succeed_if (keyGetMeta (parentKey, "error") == NULL, "range should only add warnings in kdbGet");
+	succeed_if_same_string (keyString (keyGetMeta (parentKey, "warnings")), keyString (keyGetMeta (serialParentKey, "warnings")));
+	compare_keyset (keyMeta (serialParentKey), keyMeta (parentKey));
+
+	KeySet * expected = createRangeKeys (10000, 0);
+	compare_keyset (expected, ks);
+	ksDel (expected);
+
+	keyDel (serialParentKey);
+	keyDel (parentKey);
+	ksDel (ks);
+	ksDel (plugin->global);
+	ksDel (plugins);
+	elektraPluginClose (range, rangeErrorKey);
+	keyDel (rangeErrorKey);
+	PLUGIN_CLOSE ();
+}
+
+static void test_readOnlyValidationSet (void)
+{
+	printf ("test read-only validation in kdbSet\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("backend");
+
+	Key * rangeErrorKey = keyNew ("/", KEY_END);
+	Plugin * range = elektraPluginOpen ("range", modules, ksNew (0, KS_END), rangeErrorKey);
+	exit_if_fail (range != NULL, "could not open range plugin");
+
+	KeySet * plugins =
+		ksNew (1, keyNew ("system:/range", KEY_BINARY, KEY_SIZE, sizeof (range), KEY_VALUE, &range, KEY_END), KS_END);
+
+	ElektraKdbPhase phase = ELEKTRA_KDB_SET_PHASE_PRE_STORAGE;
+	plugin->global = ksNew (
+		2, keyNew ("system:/elektra/kdb/backend/phase", KEY_BINARY, KEY_SIZE, sizeof (ElektraKdbPhase), KEY_VALUE, &phase, KEY_END),
+		keyNew ("system:/elektra/kdb/backend/plugins", KEY_BINARY, KEY_SIZE, sizeof (KeySet *), KEY_VALUE, &plugins, KEY_END),
+		KS_END);
+
+	KeySet * definition = ksNew (4, keyNew ("system:/path", KEY_VALUE, "/tmp/backend.ecf", KEY_END),
+				     keyNew ("system:/threads", KEY_VALUE, "4", KEY_END),
+				     keyNew ("system:/positions/set/prestorage/#0", KEY_VALUE, "range", KEY_END),
+				     keyNew ("system:/positions/set/prestorage/#1", KEY_VALUE, "range", KEY_END), KS_END);
+	// init warns about the missing storage plugin
+	Key * initKey = keyNew ("user:/tests/backend", KEY_END);
+	succeed_if (plugin->kdbInit (plugin, definition, initKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "kdbInit failed");
+	succeed_if (keyGetMeta (initKey, "error") == NULL, "kdbInit failed");
+	keyDel (initKey);
+	ksDel (definition);
+
+	Key * parentKey = keyNew ("user:/tests/backend", KEY_VALUE, "/tmp/backend.ecf", KEY_END);
+
+	// the first invalid key is in the third partition, a serial run stops there
+	KeySet * ks = createRangeKeys (10000, 6000);
+	Key * serialParentKey = keyDup (parentKey, KEY_CP_NAME | KEY_CP_STRING);
+	succeed_if (range->kdbSet (range, ks, serialParentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "range kdbSet should fail");
+
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "backend kdbSet should fail");
+	succeed_if (keyGetMeta (parentKey, "warnings") == NULL, "no warnings expected");
+	compare_keyset (keyMeta (serialParentKey), keyMeta (parentKey));
+
+	keyDel (serialParentKey);
+	keyDel (parentKey);
+	ksDel (ks);
+	ksDel (plugin->global);
+	ksDel (plugins);
+	elektraPluginClose (range, rangeErrorKey);
+	keyDel (rangeErrorKey);
+	PLUGIN_CLOSE ();
+}
+
+static void setPhase (Plugin * plugin, ElektraKdbPhase phase)
+{
+	keySetBinary (ksLookupByName (plugin->global, "system:/elektra/kdb/backend/phase", 0), &phase, sizeof (ElektraKdbPhase));
+}
+
+static int getStorage (Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	setPhase (plugin, ELEKTRA_KDB_GET_PHASE_PRE_STORAGE);
+	if (plugin->kdbGet (plugin, ks, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+	{
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+	ksClear (ks);
+	setPhase (plugin, ELEKTRA_KDB_GET_PHASE_STORAGE);
+	return plugin->kdbGet (plugin, ks, parentKey);
+}
+
+static void test_cache (void)
+{
+	printf ("test parse cache\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("backend");
+
+	Key * dumpErrorKey = keyNew ("/", KEY_END);
+	Plugin * dump = elektraPluginOpen ("dump", modules, ksNew (0, KS_END), dumpErrorKey);
+	exit_if_fail (dump != NULL, "could not open dump plugin");
+
+	KeySet * plugins = ksNew (1, keyNew ("system:/dump", KEY_BINARY, KEY_SIZE, sizeof (dump), KEY_VALUE, &dump, KEY_END), KS_END);
+
+	ElektraKdbPhase phase = ELEKTRA_KDB_GET_PHASE_PRE_STORAGE;
+	plugin->global = ksNew (
+		2, keyNew ("system:/elektra/kdb/backend/phase", KEY_BINARY, KEY_SIZE, sizeof (ElektraKdbPhase), KEY_VALUE, &phase, KEY_END),
+		keyNew ("system:/elektra/kdb/backend/plugins", KEY_BINARY, KEY_SIZE, sizeof (KeySet *), KEY_VALUE, &plugins, KEY_END),
+		KS_END);
+
+	char * cacheDir = elektraFormat ("%s/cache", tempHome);
+	KeySet * definition = ksNew (4, keyNew ("system:/path", KEY_VALUE, elektraFilename (), KEY_END),
+				     keyNew ("system:/cache", KEY_VALUE, "1", KEY_END),
+				     keyNew ("system:/cache/path", KEY_VALUE, cacheDir, KEY_END),
+				     keyNew ("system:/positions/get/storage", KEY_VALUE, "dump", KEY_END), KS_END);
+	Key * initKey = keyNew ("user:/tests/backend", KEY_END);
+	succeed_if (plugin->kdbInit (plugin, definition, initKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "kdbInit failed");
+	succeed_if (keyGetMeta (initKey, "error") == NULL, "kdbInit failed");
+	keyDel (initKey);
+	ksDel (definition);
+
+	BackendHandle * handle = elektraPluginGetData (plugin);
+	exit_if_fail (handle->cache.file != NULL, "cache not enabled");
+	succeed_if (strncmp (handle->cache.file, cacheDir, strlen (cacheDir)) == 0, "cache file not in configured directory");
+
+	Key * parentKey = keyNew ("user:/tests/backend", KEY_VALUE, elektraFilename (), KEY_END);
+	KeySet * expected = ksNew (2, keyNew ("user:/tests/backend/a", KEY_VALUE, "a", KEY_META, "comment/#0", "first", KEY_END),
+				   keyNew ("user:/tests/backend/b", KEY_VALUE, "b", KEY_END), KS_END);
+	succeed_if (dump->kdbSet (dump, expected, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "could not write file");
+
+	// the first run parses the file and writes the entry
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (getStorage (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "first kdbGet failed");
+	succeed_if (access (handle->cache.file, F_OK) == 0, "cache file not written");
+	compare_keyset (expected, ks);
+
+	// the second run uses the entry
+	setPhase (plugin, ELEKTRA_KDB_GET_PHASE_PRE_STORAGE);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "prestorage failed");
+	succeed_if (handle->cache.keys != NULL, "entry not found");
+	ksClear (ks);
+	setPhase (plugin, ELEKTRA_KDB_GET_PHASE_STORAGE);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "second kdbGet failed");
+	compare_keyset (expected, ks);
+
+	// a changed file invalidates the entry
+	ksAppendKey (expected, keyNew ("user:/tests/backend/c", KEY_VALUE, "c", KEY_END));
+	succeed_if (dump->kdbSet (dump, expected, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "could not write file");
+	setPhase (plugin, ELEKTRA_KDB_GET_PHASE_PRE_STORAGE);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "prestorage failed");
+	succeed_if (handle->cache.keys == NULL, "outdated entry used");
+	ksClear (ks);
+	setPhase (plugin, ELEKTRA_KDB_GET_PHASE_STORAGE);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "third kdbGet failed");
+	compare_keyset (expected, ks);
+
+	// a changed plugin configuration invalidates the entry
+	uint64_t chain = handle->cache.chain;
+	handle->cache.chain ^= 1;
+	setPhase (plugin, ELEKTRA_KDB_GET_PHASE_PRE_STORAGE);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "prestorage failed");
+	succeed_if (handle->cache.keys == NULL, "entry of other configuration used");
+	handle->cache.chain = chain;
+
+	unlink (handle->cache.file);
+	rmdir (cacheDir);
+	elektraFree (cacheDir);
+	keyDel (parentKey);
+	ksDel (expected);
+	ksDel (ks);
+	ksDel (plugin->global);
+	ksDel (plugins);
+	elektraPluginClose (dump, dumpErrorKey);
+	keyDel (dumpErrorKey);
+	PLUGIN_CLOSE ();
+}
+
+static void test_cacheEviction (void)
+{
+	printf ("test cache eviction and statistics\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("backend");
+
+	Key * dumpErrorKey = keyNew ("/", KEY_END);
+	Plugin * dump = elektraPluginOpen ("dump", modules, ksNew (0, KS_END), dumpErrorKey);
+	exit_if_fail (dump != NULL, "could not open dump plugin");
+
+	KeySet * plugins = ksNew (1, keyNew ("system:/dump", KEY_BINARY, KEY_SIZE, sizeof (dump), KEY_VALUE, &dump, KEY_END), KS_END);
+
+	ElektraKdbPhase phase = ELEKTRA_KDB_GET_PHASE_PRE_STORAGE;
+	plugin->global = ksNew (
+		2, keyNew ("system:/elektra/kdb/backend/phase", KEY_BINARY, KEY_SIZE, sizeof (ElektraKdbPhase), KEY_VALUE, &phase, KEY_END),
+		keyNew ("system:/elektra/kdb/backend/plugins", KEY_BINARY, KEY_SIZE, sizeof (KeySet *), KEY_VALUE, &plugins, KEY_END),
+		KS_END);
+
+	// an entry of another mountpoint, which was used long ago
+	char * cacheDir = elektraFormat ("%s/eviction", tempHome);
+	char * oldEntry = elektraFormat ("%s/0000000000000001.cache", cacheDir);
+	succeed_if (mkdir (cacheDir, 0700) == 0, "could not create cache directory");
+	FILE * file = fopen (oldEntry, "w");
+	exit_if_fail (file != NULL, "could not create old entry");
+	for (int i = 0; i < 4096; ++i)
+	{
+		fputc ('x', file);
+	}
+	fclose (file);
+	struct timespec times[2] = { { 1000, 0 }, { 1000, 0 } };
+	succeed_if (utimensat (AT_FDCWD, oldEntry, times, 0) == 0, "could not set time of old entry");
+
+	KeySet * definition = ksNew (5, keyNew ("system:/path", KEY_VALUE, elektraFilename (), KEY_END),
+				     keyNew ("system:/cache", KEY_VALUE, "1", KEY_END),
+				     keyNew ("system:/cache/budget", KEY_VALUE, "4096", KEY_END),
+				     keyNew ("system:/cache/path", KEY_VALUE, cacheDir, KEY_END),
+				     keyNew ("system:/positions/get/storage", KEY_VALUE, "dump", KEY_END), KS_END);
+	Key * initKey = keyNew ("user:/tests/backend", KEY_END);
+	succeed_if (plugin->kdbInit (plugin, definition, initKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "kdbInit failed");
+	succeed_if (keyGetMeta (initKey, "error") == NULL, "kdbInit failed");
+	keyDel (initKey);
+	ksDel (definition);
+
+	BackendHandle * handle = elektraPluginGetData (plugin);
+	succeed_if (handle->cache.budget == 4096, "budget not loaded from definition");
+
+	Key * parentKey = keyNew ("user:/tests/backend", KEY_VALUE, elektraFilename (), KEY_END);
+	KeySet * expected = ksNew (1, keyNew ("user:/tests/backend/a", KEY_VALUE, "a", KEY_END), KS_END);
+	succeed_if (dump->kdbSet (dump, expected, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "could not write file");
+
+	// writing the new entry exceeds the budget, the least recently used entry is removed
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (getStorage (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "first kdbGet failed");
+	succeed_if (access (oldEntry, F_OK) != 0, "old entry not evicted");
+	succeed_if (access (handle->cache.file, F_OK) == 0, "new entry evicted");
+	succeed_if (getStorage (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "second kdbGet failed");
+	compare_keyset (expected, ks);
+
+	// the counters are written to the index, when the mountpoint is closed
+	char * indexFile = elektraFormat ("%s/index", cacheDir);
+	struct stat before;
+	succeed_if (stat (indexFile, &before) == 0, "index not written with the entry");
+	succeed_if (getStorage (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "third kdbGet failed");
+	struct stat after;
+	succeed_if (stat (indexFile, &after) == 0 && after.st_size == before.st_size && after.st_mtime == before.st_mtime &&
+			    ELEKTRA_STAT_NANO_SECONDS (after) == ELEKTRA_STAT_NANO_SECONDS (before),
+		    "index written on hit");
+	elektraFree (indexFile);
+
+	keyDel (parentKey);
+	ksDel (expected);
+	ksDel (ks);
+	ksDel (plugin->global);
+	ksDel (plugins);
+	elektraPluginClose (dump, dumpErrorKey);
+	keyDel (dumpErrorKey);
+	PLUGIN_CLOSE ();
+
+	KeySet * stats = ksNew (0, KS_END);
+	Key * statsKey = keyNew ("system:/elektra/cache", KEY_VALUE, cacheDir, KEY_META, "cache/stats", "1", KEY_END);
+	succeed_if (elektraBackendCacheStats (stats, statsKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "could not get statistics");
+	succeed_if_same_string (keyString (ksLookupByName (stats, "system:/elektra/cache/directory", 0)), cacheDir);
+	succeed_if_same_string (keyString (ksLookupByName (stats, "system:/elektra/cache/hits", 0)), "2");
+	succeed_if_same_string (keyString (ksLookupByName (stats, "system:/elektra/cache/misses", 0)), "1");
+	succeed_if_same_string (keyString (ksLookupByName (stats, "system:/elektra/cache/evictions", 0)), "1");
+	succeed_if_same_string (keyString (ksLookupByName (stats, "system:/elektra/cache/entries", 0)), "1");
+	keyDel (statsKey);
+	ksDel (stats);
+
+	elektraFree (oldEntry);
+	elektraFree (cacheDir);
+}
+
+static size_t countMappings (BackendHandle * handle)
+{
+	size_t count = 0;
+	for (BackendCacheMapping * mapping = handle->cache.mappings; mapping != NULL; mapping = mapping->next)
+	{
+		++count;
+	}
+	return count;
+}
+
+static void test_cacheShared (void)
+{
+	printf ("test shared parse cache\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("backend");
+
+	Key * dumpErrorKey = keyNew ("/", KEY_END);
+	Plugin * dump = elektraPluginOpen ("dump", modules, ksNew (0, KS_END), dumpErrorKey);
+	exit_if_fail (dump != NULL, "could not open dump plugin");
+
+	KeySet * plugins = ksNew (1, keyNew ("system:/dump", KEY_BINARY, KEY_SIZE, sizeof (dump), KEY_VALUE, &dump, KEY_END), KS_END);
+
+	ElektraKdbPhase phase = ELEKTRA_KDB_GET_PHASE_PRE_STORAGE;
+	plugin->global = ksNew (
+		2, keyNew ("system:/elektra/kdb/backend/phase", KEY_BINARY, KEY_SIZE, sizeof (ElektraKdbPhase), KEY_VALUE, &phase, KEY_END),
+		keyNew ("system:/elektra/kdb/backend/plugins", KEY_BINARY, KEY_SIZE, sizeof (KeySet *), KEY_VALUE, &plugins, KEY_END),
+		KS_END);
+
+	char * cacheDir = elektraFormat ("%s/shared", tempHome);
+	KeySet * definition = ksNew (5, keyNew ("system:/path", KEY_VALUE, elektraFilename (), KEY_END),
+				     keyNew ("system:/cache", KEY_VALUE, "1", KEY_END),
+				     keyNew ("system:/cache/path", KEY_VALUE, cacheDir, KEY_END),
+				     keyNew ("system:/cache/shared", KEY_VALUE, "1", KEY_END),
+				     keyNew ("system:/positions/get/storage", KEY_VALUE, "dump", KEY_END), KS_END);
+	Key * initKey = keyNew ("user:/tests/backend", KEY_END);
+	succeed_if (plugin->kdbInit (plugin, definition, initKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "kdbInit failed");
+	succeed_if (keyGetMeta (initKey, "error") == NULL, "kdbInit failed");
+	keyDel (initKey);
+	ksDel (definition);
+
+	BackendHandle * handle = elektraPluginGetData (plugin);
+	succeed_if (handle->cache.shared, "shared mode not enabled");
+
+	Key * parentKey = keyNew ("user:/tests/backend", KEY_VALUE, elektraFilename (), KEY_END);
+	KeySet * expected = ksNew (2, keyNew ("user:/tests/backend/a", KEY_VALUE, "a", KEY_META, "comment/#0", "first", KEY_END),
+				   keyNew ("user:/tests/backend/b", KEY_VALUE, "b", KEY_END), KS_END);
+	succeed_if (dump->kdbSet (dump, expected, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "could not write file");
+
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (getStorage (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "first kdbGet failed");
+	succeed_if (countMappings (handle) == 0, "file parsed, but entry mapped");
+
+	// the second run maps the entry, the keys use the mapping
+	succeed_if (getStorage (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "second kdbGet failed");
+	exit_if_fail (countMappings (handle) == 1, "entry not mapped");
+	compare_keyset (expected, ks);
+	const char * mapping = handle->cache.mappings->data;
+	size_t mappingSize = handle->cache.mappings->size;
+	Key * key = ksLookupByName (ks, "user:/tests/backend/b", 0);
+	exit_if_fail (key != NULL, "key not found");
+	succeed_if (keyName (key) > mapping && keyName (key) < mapping + mappingSize, "name not in mapping");
+	succeed_if (keyString (key) > mapping && keyString (key) < mapping + mappingSize, "value not in mapping");
+
+	// keys are copied on write
+	keySetString (key, "changed");
+	succeed_if_same_string (keyString (key), "changed");
+
+	// mappings are removed once their keys are no longer used
+	KeySet * second = ksNew (0, KS_END);
+	succeed_if (getStorage (plugin, second, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "third kdbGet failed");
+	compare_keyset (expected, second);
+	succeed_if (countMappings (handle) == 2, "entry not mapped again");
+	Key * dup = keyDup (ksLookupByName (second, "user:/tests/backend/a", 0), KEY_CP_ALL);
+	ksDel (second);
+
+	KeySet * third = ksNew (0, KS_END);
+	succeed_if (getStorage (plugin, third, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "fourth kdbGet failed");
+	succeed_if (countMappings (handle) == 3, "mapping used by a copied key was removed");
+	keyDel (dup);
+	ksDel (third);
+
+	KeySet * fourth = ksNew (0, KS_END);
+	succeed_if (getStorage (plugin, fourth, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "fifth kdbGet failed");
+	succeed_if (countMappings (handle) == 2, "unused mappings were not removed");
+	ksDel (fourth);
+
+	unlink (handle->cache.file);
+	elektraFree (cacheDir);
+	keyDel (parentKey);
+	ksDel (plugin->global);
+	ksDel (plugins);
+	elektraPluginClose (dump, dumpErrorKey);
+	keyDel (dumpErrorKey);
+	PLUGIN_CLOSE ();
+
+	// the keys stay valid after the plugin was closed and the entry was removed
+	succeed_if_same_string (keyString (ksLookupByName (ks, "user:/tests/backend/a", 0)), "a");
+	ksDel (expected);
+	ksDel (ks);
+}
+
+static void test_cacheInvalid (void)
+{
+	printf ("test invalid cache definition\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("backend");
+
+	KeySet * plugins = ksNew (0, KS_END);
+	plugin->global = ksNew (
+		1, keyNew ("system:/elektra/kdb/backend/plugins", KEY_BINARY, KEY_SIZE, sizeof (KeySet *), KEY_VALUE, &plugins, KEY_END),
+		KS_END);
+
+	KeySet * definition = ksNew (3, keyNew ("system:/path", KEY_VALUE, "/tmp/backend.ecf", KEY_END),
+				     keyNew ("system:/cache", KEY_VALUE, "yes", KEY_END),
+				     keyNew ("system:/positions/get/storage/omit", KEY_END), KS_END);
+	Key * initKey = keyNew ("user:/tests/backend", KEY_END);
+	succeed_if (plugin->kdbInit (plugin, definition, initKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "invalid cache value accepted");
+	succeed_if (keyGetMeta (initKey, "error") != NULL, "no error set");
+	keyDel (initKey);
+	ksDel (definition);
+
+	definition = ksNew (4, keyNew ("system:/path", KEY_VALUE, "/tmp/backend.ecf", KEY_END),
+			    keyNew ("system:/cache", KEY_VALUE, "1", KEY_END), keyNew ("system:/cache/shared", KEY_VALUE, "yes", KEY_END),
+			    keyNew ("system:/positions/get/storage/omit", KEY_END), KS_END);
+	initKey = keyNew ("user:/tests/backend", KEY_END);
+	succeed_if (plugin->kdbInit (plugin, definition, initKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "invalid shared value accepted");
+	succeed_if (keyGetMeta (initKey, "error") != NULL, "no error set");
+	keyDel (initKey);
+	ksDel (definition);
+
+	ksDel (plugin->global);
+	ksDel (plugins);
+	PLUGIN_CLOSE ();
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("BACKEND     TESTS\n");
@@ -389,6 +854,12 @@ int main (int argc, char ** argv)
 		test_default ();
 		test_backref ();
 	*/
+	test_readOnlyValidation ();
+	test_readOnlyValidationSet ();
+	test_cache ();
+	test_cacheEviction ();
+	test_cacheShared ();
+	test_cacheInvalid ();
 	print_result ("testmod_backend");
 
 	return nbError;
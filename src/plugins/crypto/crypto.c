@@ -180,6 +180,36 @@ static void elektraCryptoSafelyReleaseKey (Key * key)
 	}
 }
 
+/**
+ * @brief collect the Keys that are marked for encryption.
+ * @param data the KeySet holding the data
+ * @param keyCount is set to the number of collected Keys
+ * @returns an allocated array holding the Keys or NULL if no Key is marked or the allocation failed. Must be freed by the caller.
+ */
+static Key ** collectMarkedKeys (KeySet * data, size_t * keyCount)
+{
+	Key ** keys = NULL;
+	*keyCount = 0;
+
+	for (elektraCursor it = 0; it < ksGetSize (data); ++it)
+	{
+		Key * k = ksAtCursor (data, it);
+		if (!isMarkedForEncryption (k) || isSpecNamespace (k))
+		{
+			continue;
+		}
+
+		if (keys == NULL)
+		{
+			// at most the remaining keys can be marked
+			keys = elektraMalloc ((ksGetSize (data) - it) * sizeof (Key *));
+			if (!keys) return NULL;
+		}
+		keys[(*keyCount)++] = k;
+	}
+	return keys;
+}
+
 /**
  * @brief encrypt the (Elektra) Keys contained in data.
  * @param handle for the current plugin instance
@@ -190,6 +220,14 @@ static void elektraCryptoSafelyReleaseKey (Key * key)
  */
 static int elektraCryptoEncrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data ELEKTRA_UNUSED, Key * errorKey ELEKTRA_UNUSED)
 {
+	size_t keyCount;
+	Key ** keys = collectMarkedKeys (data, &keyCount);
+	if (keyCount > 0 && !keys)
+	{
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
+		return -1;
+	}
+
 	Key * masterKey = NULL;
 
 	KeySet * pluginConfig = elektraPluginGetConfig (handle);
@@ -199,34 +237,17 @@ static int elektraCryptoEncrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data E
 		goto error; // error has been set by getMasterPassword
 	}
 
-	elektraCryptoHandle * cryptoHandle = NULL;
-
-	for (elektraCursor it = 0; it < ksGetSize (data); ++it)
+	if (elektraCryptoGcryEncryptKeys (pluginConfig, errorKey, masterKey, keys, keyCount) != 1)
 	{
-		Key * k = ksAtCursor (data, it);
-		if (!isMarkedForEncryption (k) || isSpecNamespace (k))
-		{
-			continue;
-		}
-
-		if (elektraCryptoGcryHandleCreate (&cryptoHandle, pluginConfig, errorKey, masterKey, k, ELEKTRA_CRYPTO_ENCRYPT) != 1)
-		{
-			goto error;
-		}
-
-		if (elektraCryptoGcryEncrypt (cryptoHandle, k, errorKey) != 1)
-		{
-			elektraCryptoGcryHandleDestroy (cryptoHandle);
-			goto error;
-		}
-
-		elektraCryptoGcryHandleDestroy (cryptoHandle);
-		cryptoHandle = NULL;
+		goto error;
 	}
+
+	elektraFree (keys);
 	elektraCryptoSafelyReleaseKey (masterKey);
 	return 1;
 
 error:
+	elektraFree (keys);
 	elektraCryptoSafelyReleaseKey (masterKey);
 	return -1;
 }
@@ -241,6 +262,14 @@ error:
  */
 static int elektraCryptoDecrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data, Key * errorKey)
 {
+	size_t keyCount;
+	Key ** keys = collectMarkedKeys (data, &keyCount);
+	if (keyCount > 0 && !keys)
+	{
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
+		return -1;
+	}
+
 	Key * masterKey = NULL;
 
 	KeySet * pluginConfig = elektraPluginGetConfig (handle);
@@ -250,40 +279,26 @@ static int elektraCryptoDecrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data,
 		goto error; // error has been set by getMasterPassword
 	}
 
-	elektraCryptoHandle * cryptoHandle = NULL;
-
-	for (elektraCursor it = 0; it < ksGetSize (data); ++it)
+	for (size_t i = 0; i < keyCount; ++i)
 	{
-		Key * k = ksAtCursor (data, it);
-		if (!isMarkedForEncryption (k) || isSpecNamespace (k))
-		{
-			continue;
-		}
-
-		if (!checkPayloadVersion (k, errorKey))
+		if (!checkPayloadVersion (keys[i], errorKey))
 		{
 			// error has been set by checkPayloadVersion()
 			goto error;
 		}
+	}
 
-		if (elektraCryptoGcryHandleCreate (&cryptoHandle, pluginConfig, errorKey, masterKey, k, ELEKTRA_CRYPTO_DECRYPT) != 1)
-		{
-			goto error;
-		}
-
-		if (elektraCryptoGcryDecrypt (cryptoHandle, k, errorKey) != 1)
-		{
-			elektraCryptoGcryHandleDestroy (cryptoHandle);
-			goto error;
-		}
-
-		elektraCryptoGcryHandleDestroy (cryptoHandle);
-		cryptoHandle = NULL;
+	if (elektraCryptoGcryDecryptKeys (pluginConfig, errorKey, masterKey, keys, keyCount) != 1)
+	{
+		goto error;
 	}
+
+	elektraFree (keys);
 	elektraCryptoSafelyReleaseKey (masterKey);
 	return 1;
 
 error:
+	elektraFree (keys);
 	elektraCryptoSafelyReleaseKey (masterKey);
 	return -1;
 }
@@ -70,12 +70,15 @@ enum ElektraCryptoOperation
 #define ELEKTRA_CRYPTO_DEFAULT_MASTER_PWD_LENGTH (30)
 #define ELEKTRA_CRYPTO_DEFAULT_ITERATION_COUNT (15000)
 #define ELEKTRA_CRYPTO_DEFAULT_SALT_LEN (17)
+#define ELEKTRA_CRYPTO_DEFAULT_THREADS (1)
+#define ELEKTRA_CRYPTO_MAX_THREADS (256)
 
 // plugin configuration parameters
 #define ELEKTRA_CRYPTO_PARAM_MASTER_PASSWORD_LEN "/crypto/masterpasswordlength"
 #define ELEKTRA_CRYPTO_PARAM_MASTER_PASSWORD "/crypto/masterpassword"
 #define ELEKTRA_CRYPTO_PARAM_SHUTDOWN "/shutdown"
 #define ELEKTRA_CRYPTO_PARAM_ITERATION_COUNT "/crypto/iterations"
+#define ELEKTRA_CRYPTO_PARAM_THREADS "/crypto/threads"
 
 // metakeys
 #define ELEKTRA_CRYPTO_META_ENCRYPT "crypto/encrypt"
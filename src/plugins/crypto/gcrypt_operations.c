@@ -20,6 +20,7 @@
 #include <kdbtypes.h>
 #include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define KEY_BUFFER_SIZE (ELEKTRA_CRYPTO_GCRY_KEYSIZE + ELEKTRA_CRYPTO_GCRY_BLOCKSIZE)
 
@@ -29,108 +30,277 @@ GCRY_THREAD_OPTION_PTHREAD_IMPL;
 
 
 /**
- * @brief derive the cryptographic key and IV for a given (Elektra) Key k
- * @param config KeySet holding the plugin/backend configuration
- * @param errorKey holds an error description in case of failure
- * @param masterKey holds the decrypted master password from the plugin configuration
- * @param k the (Elektra)-Key to be encrypted
- * @param cKey (Elektra)-Key holding the cryptographic material
- * @param cIv (Elektra)-Key holding the initialization vector
- * @retval -1 on failure. errorKey holds the error description.
- * @retval 1 on success
+ * The stage of the cryptographic operation that failed.
  */
-static int getKeyIvForEncryption (KeySet * config, Key * errorKey, Key * masterKey, Key * k, Key * cKey, Key * cIv)
+enum CryptoJobStage
 {
-	gcry_error_t gcry_err;
-	kdb_octet_t salt[ELEKTRA_CRYPTO_DEFAULT_SALT_LEN];
-	kdb_octet_t keyBuffer[KEY_BUFFER_SIZE];
-	char * saltHexString = NULL;
+	CRYPTO_JOB_DERIVE,
+	CRYPTO_JOB_SETUP,
+	CRYPTO_JOB_CIPHER
+};
 
-	ELEKTRA_ASSERT (masterKey != NULL, "Parameter `masterKey` must not be NULL");
+/**
+ * A single (Elektra) Key to be encrypted or decrypted.
+ *
+ * Jobs are prepared and completed by the calling thread. The worker threads only
+ * access the salt and the data buffer of a job but never the Key itself.
+ */
+typedef struct
+{
+	Key * k;		     ///< the Key to be processed
+	const kdb_octet_t * salt;    ///< salt used for the key derivation
+	kdb_unsigned_long_t saltLen; ///< length of the salt
+	kdb_octet_t * output;	     ///< buffer holding the resulting payload or plain text
+	size_t outputLen;	     ///< length of output
+	kdb_octet_t * data;	     ///< part of output to be encrypted or decrypted in place
+	size_t dataLen;		     ///< length of data
+	gcry_error_t error;	     ///< error reported by libgcrypt
+	enum CryptoJobStage stage;   ///< stage at which error occurred
+} CryptoJob;
 
-	// generate the salt
-	gcry_create_nonce (salt, sizeof (salt));
-	const int encodingResult = ELEKTRA_PLUGIN_FUNCTION (base64Encode) (errorKey, salt, sizeof (salt), &saltHexString);
-	if (encodingResult < 0)
+/**
+ * A batch of jobs processed by one or more worker threads.
+ *
+ * Jobs with the same salt are grouped, so that the key and the IV only have to be
+ * derived once per group.
+ */
+typedef struct
+{
+	CryptoJob ** jobs;	       ///< the jobs sorted by salt
+	size_t * groups;	       ///< index of the first job of every group, terminated by the number of jobs
+	size_t groupCount;	       ///< number of groups
+	size_t nextGroup;	       ///< the next group to be processed
+	pthread_mutex_t mutex;	       ///< protects nextGroup
+	Key * masterKey;	       ///< the decrypted master password
+	kdb_unsigned_long_t iterations; ///< number of iterations of the key derivation function
+	enum ElektraCryptoOperation op; ///< the operation to perform
+} CryptoBatch;
+
+static int compareJobSalts (const void * a, const void * b)
+{
+	const CryptoJob * jobA = *(const CryptoJob **) a;
+	const CryptoJob * jobB = *(const CryptoJob **) b;
+	if (jobA->saltLen != jobB->saltLen)
 	{
-		// error in libinvoke - errorKey has been set by base64Encode
-		return -1;
+		return jobA->saltLen < jobB->saltLen ? -1 : 1;
 	}
-	if (!saltHexString)
+	return memcmp (jobA->salt, jobB->salt, jobA->saltLen);
+}
+
+/**
+ * @brief fetch the index of the next group to be processed
+ * @retval the index of the group
+ * @retval batch->groupCount if all groups have been processed
+ */
+static size_t takeGroup (CryptoBatch * batch)
+{
+	pthread_mutex_lock (&batch->mutex);
+	size_t group = batch->nextGroup;
+	if (group < batch->groupCount)
 	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
-		return -1;
+		batch->nextGroup++;
 	}
-	keySetMeta (k, ELEKTRA_CRYPTO_META_SALT, saltHexString);
-	elektraFree (saltHexString);
+	pthread_mutex_unlock (&batch->mutex);
+	return group;
+}
 
-	// read iteration count
-	const kdb_unsigned_long_t iterations = ELEKTRA_PLUGIN_FUNCTION (getIterationCount) (errorKey, config);
+/**
+ * @brief derive the cryptographic key and IV for every group and encrypt or decrypt the data of its jobs.
+ *
+ * A single cipher handle is used for all jobs processed by the calling thread.
+ *
+ * @param arg the batch to be processed
+ * @returns always NULL
+ */
+static void * processBatch (void * arg)
+{
+	CryptoBatch * batch = arg;
+	kdb_octet_t keyBuffer[KEY_BUFFER_SIZE];
+	gcry_cipher_hd_t handle = NULL;
+
+	gcry_error_t setupError = gcry_cipher_open (&handle, GCRY_CIPHER_AES256, GCRY_CIPHER_MODE_CBC, 0);
 
-	// generate/derive the cryptographic key and the IV
-	if ((gcry_err = gcry_kdf_derive (keyValue (masterKey), keyGetValueSize (masterKey), GCRY_KDF_PBKDF2, GCRY_MD_SHA512, salt,
-					 sizeof (salt), iterations, KEY_BUFFER_SIZE, keyBuffer)))
+	size_t group;
+	while ((group = takeGroup (batch)) < batch->groupCount)
 	{
-		ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Failed to create a cryptographic key for encryption. Reason: %s",
-					     gcry_strerror (gcry_err));
-		return -1;
+		const size_t first = batch->groups[group];
+		const size_t last = batch->groups[group + 1];
+		const CryptoJob * groupJob = batch->jobs[first];
+
+		enum CryptoJobStage stage = CRYPTO_JOB_SETUP;
+		gcry_error_t gcry_err = setupError;
+		if (!gcry_err)
+		{
+			stage = CRYPTO_JOB_DERIVE;
+			gcry_err = gcry_kdf_derive (keyValue (batch->masterKey), keyGetValueSize (batch->masterKey), GCRY_KDF_PBKDF2,
+						    GCRY_MD_SHA512, groupJob->salt, groupJob->saltLen, batch->iterations, KEY_BUFFER_SIZE,
+						    keyBuffer);
+		}
+		if (!gcry_err)
+		{
+			stage = CRYPTO_JOB_SETUP;
+			gcry_err = gcry_cipher_setkey (handle, keyBuffer, ELEKTRA_CRYPTO_GCRY_KEYSIZE);
+		}
+
+		for (size_t i = first; i < last; ++i)
+		{
+			CryptoJob * job = batch->jobs[i];
+			job->stage = stage;
+			job->error = gcry_err;
+			if (job->error) continue;
+
+			// every payload starts with the IV
+			job->error = gcry_cipher_setiv (handle, keyBuffer + ELEKTRA_CRYPTO_GCRY_KEYSIZE, ELEKTRA_CRYPTO_GCRY_BLOCKSIZE);
+			if (job->error) continue;
+
+			// in-place encryption/decryption
+			job->stage = CRYPTO_JOB_CIPHER;
+			if (batch->op == ELEKTRA_CRYPTO_ENCRYPT)
+			{
+				job->error = gcry_cipher_encrypt (handle, job->data, job->dataLen, NULL, 0);
+			}
+			else
+			{
+				job->error = gcry_cipher_decrypt (handle, job->data, job->dataLen, NULL, 0);
+			}
+		}
 	}
 
-	keySetBinary (cKey, keyBuffer, ELEKTRA_CRYPTO_GCRY_KEYSIZE);
-	keySetBinary (cIv, keyBuffer + ELEKTRA_CRYPTO_GCRY_KEYSIZE, ELEKTRA_CRYPTO_GCRY_BLOCKSIZE);
-	return 1;
+	memset (keyBuffer, 0, sizeof (keyBuffer));
+	if (!setupError)
+	{
+		gcry_cipher_close (handle);
+	}
+	return NULL;
 }
 
 /**
- * @brief derive the cryptographic key and IV for a given (Elektra) Key k
+ * @brief encrypt or decrypt the data of all jobs.
+ *
+ * Jobs with the same salt share the derived key and IV. If threads is bigger than 1,
+ * the jobs are processed by a pool of worker threads.
+ *
  * @param config KeySet holding the plugin/backend configuration
  * @param errorKey holds an error description in case of failure
  * @param masterKey holds the decrypted master password from the plugin configuration
- * @param k the (Elektra)-Key to be encrypted
- * @param cKey (Elektra)-Key holding the cryptographic material
- * @param cIv (Elektra)-Key holding the initialization vector
+ * @param jobs the prepared jobs
+ * @param jobCount the number of jobs
+ * @param op the operation to perform
  * @retval -1 on failure. errorKey holds the error description.
  * @retval 1 on success
  */
-static int getKeyIvForDecryption (KeySet * config, Key * errorKey, Key * masterKey, Key * k, Key * cKey, Key * cIv)
+static int processJobs (KeySet * config, Key * errorKey, Key * masterKey, CryptoJob * jobs, size_t jobCount,
+			const enum ElektraCryptoOperation op)
 {
-	gcry_error_t gcry_err;
-	kdb_octet_t keyBuffer[KEY_BUFFER_SIZE];
-	kdb_octet_t * saltBuffer = NULL;
-	kdb_unsigned_long_t saltBufferLen = 0;
-
 	ELEKTRA_ASSERT (masterKey != NULL, "Parameter `masterKey` must not be NULL");
 
-	// get the salt
-	if (ELEKTRA_PLUGIN_FUNCTION (getSaltFromPayload) (errorKey, k, &saltBuffer, &saltBufferLen) != 1)
+	CryptoBatch batch;
+	batch.jobs = elektraMalloc (jobCount * sizeof (CryptoJob *));
+	batch.groups = elektraMalloc ((jobCount + 1) * sizeof (size_t));
+	if (!batch.jobs || !batch.groups)
 	{
-		return -1; // error set by ELEKTRA_PLUGIN_FUNCTION(getSaltFromPayload)()
+		elektraFree (batch.jobs);
+		elektraFree (batch.groups);
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
+		return -1;
 	}
 
-	// get the iteration count
-	const kdb_unsigned_long_t iterations = ELEKTRA_PLUGIN_FUNCTION (getIterationCount) (errorKey, config);
+	// group jobs with the same salt
+	for (size_t i = 0; i < jobCount; ++i)
+	{
+		batch.jobs[i] = &jobs[i];
+	}
+	qsort (batch.jobs, jobCount, sizeof (CryptoJob *), compareJobSalts);
+	batch.groupCount = 0;
+	for (size_t i = 0; i < jobCount; ++i)
+	{
+		if (i == 0 || compareJobSalts (&batch.jobs[i - 1], &batch.jobs[i]) != 0)
+		{
+			batch.groups[batch.groupCount++] = i;
+		}
+	}
+	batch.groups[batch.groupCount] = jobCount;
+
+	batch.nextGroup = 0;
+	batch.masterKey = masterKey;
+	batch.iterations = ELEKTRA_PLUGIN_FUNCTION (getIterationCount) (errorKey, config);
+	batch.op = op;
+	pthread_mutex_init (&batch.mutex, NULL);
+
+	// the calling thread is one of the workers
+	kdb_unsigned_short_t threads = ELEKTRA_PLUGIN_FUNCTION (getThreadCount) (errorKey, config);
+	if (threads > batch.groupCount) threads = batch.groupCount;
+	pthread_t * workers = threads > 1 ? elektraMalloc ((threads - 1) * sizeof (pthread_t)) : NULL;
+	size_t started = 0;
+	if (workers)
+	{
+		while (started < (size_t) threads - 1 && pthread_create (&workers[started], NULL, processBatch, &batch) == 0)
+		{
+			++started;
+		}
+	}
+	processBatch (&batch);
+	for (size_t i = 0; i < started; ++i)
+	{
+		pthread_join (workers[i], NULL);
+	}
+	elektraFree (workers);
+	pthread_mutex_destroy (&batch.mutex);
+	elektraFree (batch.jobs);
+	elektraFree (batch.groups);
 
-	// derive the cryptographic key and the IV
-	if ((gcry_err = gcry_kdf_derive (keyValue (masterKey), keyGetValueSize (masterKey), GCRY_KDF_PBKDF2, GCRY_MD_SHA512, saltBuffer,
-					 saltBufferLen, iterations, KEY_BUFFER_SIZE, keyBuffer)))
+	// report the first error in the order of the KeySet
+	for (size_t i = 0; i < jobCount; ++i)
 	{
-		ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Failed to restore the cryptographic key for decryption. Reason: %s",
-					     gcry_strerror (gcry_err));
+		if (!jobs[i].error) continue;
+
+		switch (jobs[i].stage)
+		{
+		case CRYPTO_JOB_DERIVE:
+			if (op == ELEKTRA_CRYPTO_ENCRYPT)
+			{
+				ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Failed to create a cryptographic key for encryption. Reason: %s",
+							     gcry_strerror (jobs[i].error));
+			}
+			else
+			{
+				ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Failed to restore the cryptographic key for decryption. Reason: %s",
+							     gcry_strerror (jobs[i].error));
+			}
+			break;
+		case CRYPTO_JOB_SETUP:
+			ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Failed to setup libgcrypt. Reason: %s", gcry_strerror (jobs[i].error));
+			break;
+		case CRYPTO_JOB_CIPHER:
+			if (op == ELEKTRA_CRYPTO_ENCRYPT)
+			{
+				ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Encryption failed. Reason: %s", gcry_strerror (jobs[i].error));
+			}
+			else
+			{
+				ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Decryption failed. Reason: %s", gcry_strerror (jobs[i].error));
+			}
+			break;
+		}
 		return -1;
 	}
-
-	keySetBinary (cKey, keyBuffer, ELEKTRA_CRYPTO_GCRY_KEYSIZE);
-	keySetBinary (cIv, keyBuffer + ELEKTRA_CRYPTO_GCRY_KEYSIZE, ELEKTRA_CRYPTO_GCRY_BLOCKSIZE);
 	return 1;
 }
 
-void elektraCryptoGcryHandleDestroy (elektraCryptoHandle * handle)
+/**
+ * @brief overwrite and release the buffers of the jobs.
+ */
+static void freeJobs (CryptoJob * jobs, size_t jobCount)
 {
-	if (handle != NULL)
+	for (size_t i = 0; i < jobCount; ++i)
 	{
-		gcry_cipher_close (*handle);
-		elektraFree (handle);
+		if (jobs[i].output)
+		{
+			memset (jobs[i].output, 0, jobs[i].outputLen);
+			elektraFree (jobs[i].output);
+		}
 	}
+	elektraFree (jobs);
 }
 
 int elektraCryptoGcryInit (Key * errorKey)
@@ -156,105 +326,20 @@ int elektraCryptoGcryInit (Key * errorKey)
 	return 1;
 }
 
-int elektraCryptoGcryHandleCreate (elektraCryptoHandle ** handle, KeySet * config, Key * errorKey, Key * masterKey, Key * k,
-				   const enum ElektraCryptoOperation op)
-{
-	gcry_error_t gcry_err;
-	unsigned char keyBuffer[64], ivBuffer[64];
-	size_t keyLength, ivLength;
-
-	(*handle) = NULL;
-
-	// retrieve/derive the cryptographic material
-	Key * key = keyNew ("/", KEY_END);
-	Key * iv = keyNew ("/", KEY_END);
-	switch (op)
-	{
-	case ELEKTRA_CRYPTO_ENCRYPT:
-		if (getKeyIvForEncryption (config, errorKey, masterKey, k, key, iv) != 1)
-		{
-			keyDel (key);
-			keyDel (iv);
-			return -1;
-		}
-		break;
-
-	case ELEKTRA_CRYPTO_DECRYPT:
-		if (getKeyIvForDecryption (config, errorKey, masterKey, k, key, iv) != 1)
-		{
-			keyDel (key);
-			keyDel (iv);
-			return -1;
-		}
-		break;
-
-	default: // not supported
-		keyDel (key);
-		keyDel (iv);
-		return -1;
-	}
-
-	keyLength = keyGetBinary (key, keyBuffer, sizeof (keyBuffer));
-	ivLength = keyGetBinary (iv, ivBuffer, sizeof (ivBuffer));
-
-	// create the handle
-	(*handle) = elektraMalloc (sizeof (elektraCryptoHandle));
-	if (*handle == NULL)
-	{
-		memset (keyBuffer, 0, sizeof (keyBuffer));
-		memset (ivBuffer, 0, sizeof (ivBuffer));
-		keyDel (key);
-		keyDel (iv);
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
-		return -1;
-	}
-
-	if ((gcry_err = gcry_cipher_open (*handle, GCRY_CIPHER_AES256, GCRY_CIPHER_MODE_CBC, 0)) != 0)
-	{
-		goto error;
-	}
-
-	if ((gcry_err = gcry_cipher_setkey (**handle, keyBuffer, keyLength)) != 0)
-	{
-		goto error;
-	}
-
-	if ((gcry_err = gcry_cipher_setiv (**handle, ivBuffer, ivLength)) != 0)
-	{
-		goto error;
-	}
-
-	memset (keyBuffer, 0, sizeof (keyBuffer));
-	memset (ivBuffer, 0, sizeof (ivBuffer));
-	keyDel (key);
-	keyDel (iv);
-	return 1;
-
-error:
-	memset (keyBuffer, 0, sizeof (keyBuffer));
-	memset (ivBuffer, 0, sizeof (ivBuffer));
-	ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Failed to setup libgcrypt. Reason: %s", gcry_strerror (gcry_err));
-	gcry_cipher_close (**handle);
-	elektraFree (*handle);
-	(*handle) = NULL;
-	keyDel (key);
-	keyDel (iv);
-	return -1;
-}
-
-int elektraCryptoGcryEncrypt (elektraCryptoHandle * handle, Key * k, Key * errorKey)
+/**
+ * @brief prepare the crypto payload of a Key for encryption.
+ *
+ * A new random salt is generated for every Key.
+ *
+ * @param job the job to be prepared
+ * @param errorKey holds an error description in case of failure
+ * @retval -1 on failure. errorKey holds the error description.
+ * @retval 1 on success
+ */
+static int prepareEncryption (CryptoJob * job, Key * errorKey)
 {
+	Key * k = job->k;
 	size_t outputLen;
-	gcry_error_t gcry_err;
-
-	// prepare the salt for payload output
-	kdb_unsigned_long_t saltLen = 0;
-	kdb_octet_t * salt = NULL;
-
-	if (ELEKTRA_PLUGIN_FUNCTION (getSaltFromMetakey) (errorKey, k, &salt, &saltLen) != 1)
-	{
-		return -1; // error set by ELEKTRA_PLUGIN_FUNCTION(getSaltFromMetakey)()
-	}
 
 	// remove salt as metakey because it will be encoded into the crypto payload
 	keySetMeta (k, ELEKTRA_CRYPTO_META_SALT, NULL);
@@ -262,6 +347,7 @@ int elektraCryptoGcryEncrypt (elektraCryptoHandle * handle, Key * k, Key * error
 	// prepare the crypto header data
 	const kdb_octet_t * content = keyValue (k);
 	const kdb_unsigned_long_t contentLen = keyGetValueSize (k);
+	const kdb_unsigned_long_t saltLen = ELEKTRA_CRYPTO_DEFAULT_SALT_LEN;
 	kdb_octet_t flags;
 
 	switch (keyIsString (k))
@@ -288,15 +374,17 @@ int elektraCryptoGcryEncrypt (elektraCryptoHandle * handle, Key * k, Key * error
 		outputLen = (contentLen / ELEKTRA_CRYPTO_GCRY_BLOCKSIZE) + 2;
 	}
 	outputLen *= ELEKTRA_CRYPTO_GCRY_BLOCKSIZE;
+	job->dataLen = outputLen;
 	outputLen += ELEKTRA_CRYPTO_MAGIC_NUMBER_LEN;
 	outputLen += sizeof (kdb_unsigned_long_t) + saltLen;
 	kdb_octet_t * output = elektraCalloc (outputLen);
 	if (!output)
 	{
 		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
-		elektraFree (salt);
 		return -1;
 	}
+	job->output = output;
+	job->outputLen = outputLen;
 
 	kdb_octet_t * current = output;
 
@@ -304,63 +392,93 @@ int elektraCryptoGcryEncrypt (elektraCryptoHandle * handle, Key * k, Key * error
 	memcpy (current, ELEKTRA_CRYPTO_MAGIC_NUMBER, ELEKTRA_CRYPTO_MAGIC_NUMBER_LEN);
 	current += ELEKTRA_CRYPTO_MAGIC_NUMBER_LEN;
 
-	// encode the salt into the crypto payload
+	// generate the salt directly into the crypto payload
 	memcpy (current, &saltLen, sizeof (kdb_unsigned_long_t));
 	current += sizeof (kdb_unsigned_long_t);
-	memcpy (current, salt, saltLen);
+	gcry_create_nonce (current, saltLen);
+	job->salt = current;
+	job->saltLen = saltLen;
 	current += saltLen;
 
-	// encrypt the header (1st block) using gcrypt's in-place encryption
+	// the header (1st block) is followed by the value, both are encrypted in place
 	memcpy (current, &flags, sizeof (flags));
 	memcpy (current + sizeof (flags), &contentLen, sizeof (contentLen));
-	gcry_err = gcry_cipher_encrypt (*handle, current, ELEKTRA_CRYPTO_GCRY_BLOCKSIZE, NULL, 0);
-	if (gcry_err != 0)
+	if (contentLen) memcpy (current + ELEKTRA_CRYPTO_GCRY_BLOCKSIZE, content, contentLen);
+	job->data = current;
+	return 1;
+}
+
+/**
+ * @brief encrypt the given (Elektra) Keys.
+ *
+ * @param config KeySet holding the plugin/backend configuration
+ * @param errorKey holds an error description in case of failure
+ * @param masterKey holds the decrypted master password from the plugin configuration
+ * @param keys the Keys to be encrypted
+ * @param keyCount the number of Keys
+ * @retval -1 on failure. errorKey holds the error description. No Key has been modified.
+ * @retval 1 on success
+ */
+int elektraCryptoGcryEncryptKeys (KeySet * config, Key * errorKey, Key * masterKey, Key ** keys, size_t keyCount)
+{
+	if (keyCount == 0) return 1;
+
+	CryptoJob * jobs = elektraCalloc (keyCount * sizeof (CryptoJob));
+	if (!jobs)
 	{
-		ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Encryption failed. Reason: %s", gcry_strerror (gcry_err));
-		memset (output, 0, outputLen);
-		elektraFree (output);
-		elektraFree (salt);
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
 		return -1;
 	}
-	current += ELEKTRA_CRYPTO_GCRY_BLOCKSIZE;
 
-	// encrypt the value using gcrypt's in-place encryption
-	const size_t dataLen =
-		outputLen - ELEKTRA_CRYPTO_GCRY_BLOCKSIZE - sizeof (kdb_unsigned_long_t) - saltLen - ELEKTRA_CRYPTO_MAGIC_NUMBER_LEN;
-	if (contentLen) memcpy (current, content, contentLen);
-	gcry_err = gcry_cipher_encrypt (*handle, current, dataLen, NULL, 0);
-	if (gcry_err != 0)
+	for (size_t i = 0; i < keyCount; ++i)
 	{
-		ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Encryption failed. Reason: %s", gcry_strerror (gcry_err));
-		memset (output, 0, outputLen);
-		elektraFree (output);
-		elektraFree (salt);
+		jobs[i].k = keys[i];
+		if (prepareEncryption (&jobs[i], errorKey) != 1)
+		{
+			freeJobs (jobs, keyCount);
+			return -1;
+		}
+	}
+
+	if (processJobs (config, errorKey, masterKey, jobs, keyCount, ELEKTRA_CRYPTO_ENCRYPT) != 1)
+	{
+		freeJobs (jobs, keyCount);
 		return -1;
 	}
 
-	// write back the cipher text to the key
-	keySetBinary (k, output, outputLen);
-	memset (output, 0, outputLen);
-	elektraFree (output);
-	elektraFree (salt);
+	// write back the cipher text to the keys
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		keySetBinary (jobs[i].k, jobs[i].output, jobs[i].outputLen);
+	}
+	freeJobs (jobs, keyCount);
 	return 1;
 }
 
-int elektraCryptoGcryDecrypt (elektraCryptoHandle * handle, Key * k, Key * errorKey)
+/**
+ * @brief prepare the crypto payload of a Key for decryption.
+ * @param job the job to be prepared
+ * @param errorKey holds an error description in case of failure
+ * @retval -1 on failure. errorKey holds the error description.
+ * @retval 1 on success
+ */
+static int prepareDecryption (CryptoJob * job, Key * errorKey)
 {
-	gcry_error_t gcry_err;
-
-	// parse salt length from crypto payload
+	kdb_octet_t * salt = NULL;
 	kdb_unsigned_long_t saltLen = 0;
-	if (ELEKTRA_PLUGIN_FUNCTION (getSaltFromPayload) (errorKey, k, NULL, &saltLen) != 1)
+
+	// the salt stays in the crypto payload of the key, which is not modified until all jobs are done
+	if (ELEKTRA_PLUGIN_FUNCTION (getSaltFromPayload) (errorKey, job->k, &salt, &saltLen) != 1)
 	{
 		return -1; // error set by ELEKTRA_PLUGIN_FUNCTION(getSaltFromPayload)()
 	}
-	saltLen += sizeof (kdb_unsigned_long_t);
+	job->salt = salt;
+	job->saltLen = saltLen;
 
 	// set payload pointer
-	const kdb_octet_t * payload = ((kdb_octet_t *) keyValue (k)) + saltLen + ELEKTRA_CRYPTO_MAGIC_NUMBER_LEN;
-	const size_t payloadLen = keyGetValueSize (k) - saltLen - ELEKTRA_CRYPTO_MAGIC_NUMBER_LEN;
+	const size_t headerLen = saltLen + sizeof (kdb_unsigned_long_t) + ELEKTRA_CRYPTO_MAGIC_NUMBER_LEN;
+	const kdb_octet_t * payload = ((kdb_octet_t *) keyValue (job->k)) + headerLen;
+	const size_t payloadLen = keyGetValueSize (job->k) - headerLen;
 
 	// plausibility check
 	if (payloadLen % ELEKTRA_CRYPTO_GCRY_BLOCKSIZE != 0)
@@ -370,34 +488,38 @@ int elektraCryptoGcryDecrypt (elektraCryptoHandle * handle, Key * k, Key * error
 	}
 
 	// prepare buffer for plain text output and crypto operations
-	kdb_octet_t * output = elektraMalloc (payloadLen);
-	if (!output)
+	job->output = elektraMalloc (payloadLen);
+	if (!job->output)
 	{
 		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
 		return -1;
 	}
+	memcpy (job->output, payload, payloadLen);
+	job->outputLen = payloadLen;
+	job->data = job->output;
+	job->dataLen = payloadLen;
+	return 1;
+}
 
+/**
+ * @brief restore the original value of a decrypted Key.
+ * @param job the processed job
+ * @param errorKey holds an error description in case of failure
+ * @retval -1 on failure. errorKey holds the error description.
+ * @retval 1 on success
+ */
+static int completeDecryption (CryptoJob * job, Key * errorKey)
+{
 	// initialize crypto header data
 	kdb_unsigned_long_t contentLen = 0;
 	kdb_octet_t flags = ELEKTRA_CRYPTO_FLAG_NONE;
 
-	// in-place decryption
-	memcpy (output, payload, payloadLen);
-	gcry_err = gcry_cipher_decrypt (*handle, output, payloadLen, NULL, 0);
-	if (gcry_err != 0)
-	{
-		ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Decryption failed. Reason: %s", gcry_strerror (gcry_err));
-		memset (output, 0, payloadLen);
-		elektraFree (output);
-		return -1;
-	}
-
 	// restore the header data
-	memcpy (&flags, output, sizeof (flags));
-	memcpy (&contentLen, output + sizeof (flags), sizeof (contentLen));
+	memcpy (&flags, job->output, sizeof (flags));
+	memcpy (&contentLen, job->output + sizeof (flags), sizeof (contentLen));
 
-	const kdb_octet_t * data = output + ELEKTRA_CRYPTO_GCRY_BLOCKSIZE;
-	const size_t dataLen = payloadLen - ELEKTRA_CRYPTO_GCRY_BLOCKSIZE;
+	const kdb_octet_t * data = job->output + ELEKTRA_CRYPTO_GCRY_BLOCKSIZE;
+	const size_t dataLen = job->outputLen - ELEKTRA_CRYPTO_GCRY_BLOCKSIZE;
 
 	// validate restored content length
 	if (contentLen > dataLen)
@@ -405,27 +527,74 @@ int elektraCryptoGcryDecrypt (elektraCryptoHandle * handle, Key * k, Key * error
 		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (
 			errorKey,
 			"Restored content length is bigger than the available amount of decrypted data. The header is possibly corrupted");
-		memset (output, 0, payloadLen);
-		elektraFree (output);
 		return -1;
 	}
 
 	// restore the key to its original status
 	if ((flags & ELEKTRA_CRYPTO_FLAG_STRING) == ELEKTRA_CRYPTO_FLAG_STRING && contentLen > 0)
 	{
-		keySetString (k, (const char *) data);
+		keySetString (job->k, (const char *) data);
 	}
 	else if ((flags & ELEKTRA_CRYPTO_FLAG_NULL) == ELEKTRA_CRYPTO_FLAG_NULL || contentLen == 0)
 	{
-		keySetBinary (k, NULL, 0);
+		keySetBinary (job->k, NULL, 0);
 	}
 	else
 	{
-		keySetBinary (k, data, contentLen);
+		keySetBinary (job->k, data, contentLen);
 	}
+	return 1;
+}
 
-	memset (output, 0, payloadLen);
-	elektraFree (output);
+/**
+ * @brief decrypt the given (Elektra) Keys.
+ *
+ * The key and IV are derived only once for all Keys sharing the same salt.
+ *
+ * @param config KeySet holding the plugin/backend configuration
+ * @param errorKey holds an error description in case of failure
+ * @param masterKey holds the decrypted master password from the plugin configuration
+ * @param keys the Keys to be decrypted
+ * @param keyCount the number of Keys
+ * @retval -1 on failure. errorKey holds the error description.
+ * @retval 1 on success
+ */
+int elektraCryptoGcryDecryptKeys (KeySet * config, Key * errorKey, Key * masterKey, Key ** keys, size_t keyCount)
+{
+	if (keyCount == 0) return 1;
+
+	CryptoJob * jobs = elektraCalloc (keyCount * sizeof (CryptoJob));
+	if (!jobs)
+	{
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
+		return -1;
+	}
+
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		jobs[i].k = keys[i];
+		if (prepareDecryption (&jobs[i], errorKey) != 1)
+		{
+			freeJobs (jobs, keyCount);
+			return -1;
+		}
+	}
+
+	if (processJobs (config, errorKey, masterKey, jobs, keyCount, ELEKTRA_CRYPTO_DECRYPT) != 1)
+	{
+		freeJobs (jobs, keyCount);
+		return -1;
+	}
+
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		if (completeDecryption (&jobs[i], errorKey) != 1)
+		{
+			freeJobs (jobs, keyCount);
+			return -1;
+		}
+	}
+	freeJobs (jobs, keyCount);
 	return 1;
 }
 
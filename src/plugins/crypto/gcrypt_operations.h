@@ -15,17 +15,13 @@
 
 // gcrypt specific declarations
 #include <gcrypt.h>
-typedef gcry_cipher_hd_t elektraCryptoHandle;
 
 #define ELEKTRA_CRYPTO_GCRY_KEYSIZE (32)
 #define ELEKTRA_CRYPTO_GCRY_BLOCKSIZE (16)
 
 char * elektraCryptoGcryCreateRandomString (Key * errorKey, const kdb_unsigned_short_t length);
 int elektraCryptoGcryInit (Key * errorKey);
-int elektraCryptoGcryHandleCreate (elektraCryptoHandle ** handle, KeySet * config, Key * errorKey, Key * masterKey, Key * k,
-				   const enum ElektraCryptoOperation op);
-void elektraCryptoGcryHandleDestroy (elektraCryptoHandle * handle);
-int elektraCryptoGcryEncrypt (elektraCryptoHandle * handle, Key * k, Key * errorKey);
-int elektraCryptoGcryDecrypt (elektraCryptoHandle * handle, Key * k, Key * errorKey);
+int elektraCryptoGcryEncryptKeys (KeySet * config, Key * errorKey, Key * masterKey, Key ** keys, size_t keyCount);
+int elektraCryptoGcryDecryptKeys (KeySet * config, Key * errorKey, Key * masterKey, Key ** keys, size_t keyCount);
 
 #endif
@@ -232,6 +232,31 @@ kdb_unsigned_long_t ELEKTRA_PLUGIN_FUNCTION (getIterationCount) (Key * errorKey,
 	return ELEKTRA_CRYPTO_DEFAULT_ITERATION_COUNT;
 }
 
+/**
+ * @brief read the desired number of worker threads from config
+ * @param errorKey may hold a warning if an invalid configuration is provided
+ * @param config KeySet holding the plugin configuration
+ * @returns the number of threads used to encrypt or decrypt the keys of a KeySet
+ */
+kdb_unsigned_short_t ELEKTRA_PLUGIN_FUNCTION (getThreadCount) (Key * errorKey, KeySet * config)
+{
+	Key * k = ksLookupByName (config, ELEKTRA_CRYPTO_PARAM_THREADS, 0);
+	if (k)
+	{
+		const unsigned long threads = strtoul (keyString (k), NULL, 10);
+		if (threads > 0 && threads <= ELEKTRA_CRYPTO_MAX_THREADS)
+		{
+			return (kdb_unsigned_short_t) threads;
+		}
+		else
+		{
+			ELEKTRA_ADD_INSTALLATION_WARNING (errorKey, "Thread count provided at " ELEKTRA_CRYPTO_PARAM_THREADS
+								    " is invalid. Using default value instead.");
+		}
+	}
+	return ELEKTRA_CRYPTO_DEFAULT_THREADS;
+}
+
 /**
  * @brief call the gpg binary to encrypt the random master password.
  *
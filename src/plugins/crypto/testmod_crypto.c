@@ -159,7 +159,7 @@ static void test_incomplete_config (const char * pluginName)
 	keyDel (parentKey);
 }
 
-static void test_crypto_operations (const char * pluginName)
+static void test_crypto_operations (const char * pluginName, const char * threads)
 {
 	union
 	{
@@ -173,6 +173,10 @@ static void test_crypto_operations (const char * pluginName)
 	KeySet * config = newPluginConfiguration ();
 
 	setPluginShutdown (config);
+	if (threads)
+	{
+		ksAppendKey (config, keyNew (ELEKTRA_CRYPTO_PARAM_THREADS, KEY_VALUE, threads, KEY_END));
+	}
 
 	elektraModulesInit (modules, 0);
 
@@ -230,6 +234,13 @@ static void test_crypto_operations (const char * pluginName)
 			}
 		}
 
+		// copied payloads share the salt
+		Key * copy = keyDup (ksLookupByName (data, "user:/crypto/test/mystring", 0), KEY_CP_ALL);
+		keySetName (copy, "user:/crypto/test/mystringcopy");
+		ksAppendKey (data, copy);
+		ksAppendKey (original,
+			     keyNew ("user:/crypto/test/mystringcopy", KEY_VALUE, strVal, KEY_META, ELEKTRA_CRYPTO_META_ENCRYPT, "1", KEY_END));
+
 		// test decryption with kdb get
 		succeed_if (plugin->kdbGet (plugin, data, parentKey) == 1, "kdb get failed");
 		compare_keyset (data, original);
@@ -275,7 +286,8 @@ int main (int argc, char ** argv)
 		test_gpg ();
 		test_init (PLUGIN_NAME);
 		test_incomplete_config (PLUGIN_NAME);
-		test_crypto_operations (PLUGIN_NAME);
+		test_crypto_operations (PLUGIN_NAME, NULL);
+		test_crypto_operations (PLUGIN_NAME, "4");
 		test_teardown ();
 	}
 	else
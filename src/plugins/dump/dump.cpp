@@ -8,25 +8,192 @@
 
 #include "dump.hpp"
 
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include <fcntl.h>
 #include <unistd.h>
 
 #include <kdberrors.h>
 #include <kdblogger.h>
+#include <kdbutility.h>
 
 using namespace ckdb;
 
 namespace dump
 {
 
-int serialize (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
+/**
+ * @brief Stream operators for an ElektraWriter, used by serialize().
+ *
+ * Without a file descriptor the data is written to a std::ostream.
+ */
+class BufferedWriter
+{
+public:
+	explicit BufferedWriter (std::ostream & os) : writer_ (elektraWriterNewCallback (writeStream, &os))
+	{
+	}
+
+	explicit BufferedWriter (int fd) : writer_ (elektraWriterNew (fd))
+	{
+	}
+
+	~BufferedWriter ()
+	{
+		elektraWriterDel (writer_);
+	}
+
+	BufferedWriter (const BufferedWriter &) = delete;
+	BufferedWriter & operator= (const BufferedWriter &) = delete;
+
+	BufferedWriter & write (const char * data, size_t size)
+	{
+		if (writer_ != nullptr)
+		{
+			elektraWriterWrite (writer_, data, size);
+		}
+		return *this;
+	}
+
+	BufferedWriter & operator<< (const char * string)
+	{
+		return write (string, strlen (string));
+	}
+
+	BufferedWriter & operator<< (char c)
+	{
+		return write (&c, 1);
+	}
+
+	BufferedWriter & operator<< (size_t number)
+	{
+		char digits[3 * sizeof (size_t)];
+		size_t start = sizeof (digits);
+		do
+		{
+			digits[--start] = static_cast<char> ('0' + number % 10);
+			number /= 10;
+		} while (number > 0);
+		return write (digits + start, sizeof (digits) - start);
+	}
+
+	void flush ()
+	{
+		if (writer_ != nullptr)
+		{
+			elektraWriterFlush (writer_);
+		}
+	}
+
+	/**
+	 * @retval 0 if all data was written
+	 * @return the errno of the failed write otherwise
+	 */
+	int error () const
+	{
+		return writer_ != nullptr ? elektraWriterError (writer_) : ENOMEM;
+	}
+
+private:
+	static int writeStream (void * context, const char * data, size_t size)
+	{
+		std::ostream & os = *static_cast<std::ostream *> (context);
+		os.write (data, size);
+		return os ? 0 : EIO;
+	}
+
+	ckdb::ElektraWriter * writer_;
+};
+
+/**
+ * @brief Set of meta keys that were already serialized.
+ *
+ * Meta keys shared between keys have the same address. The set uses open addressing with
+ * linear probing on the address and remembers the key the meta key was serialized with first.
+ */
+class MetaCopies
+{
+public:
+	struct Entry
+	{
+		const ckdb::Key * meta;
+		ckdb::Key * key;
+	};
+
+	MetaCopies () : entries_ (64, Entry{ nullptr, nullptr }), size_ (0)
+	{
+	}
+
+	/**
+	 * @brief Looks up @p meta and inserts it together with @p key if it is missing.
+	 *
+	 * @return the entry of the key @p meta was serialized with first or nullptr if @p meta was inserted
+	 */
+	const Entry * insert (const ckdb::Key * meta, ckdb::Key * key)
+	{
+		if (2 * (size_ + 1) > entries_.size ())
+		{
+			grow ();
+		}
+
+		Entry * entry = slot (entries_, meta);
+		if (entry->meta == meta)
+		{
+			return entry;
+		}
+
+		entry->meta = meta;
+		entry->key = key;
+		++size_;
+		return nullptr;
+	}
+
+private:
+	static Entry * slot (std::vector<Entry> & entries, const ckdb::Key * meta)
+	{
+		// mix the address, its lower bits are always zero because of the alignment
+		uint64_t hash = reinterpret_cast<uintptr_t> (meta);
+		hash ^= hash >> 33;
+		hash *= UINT64_C (0xff51afd7ed558ccd);
+		hash ^= hash >> 33;
+
+		const size_t mask = entries.size () - 1;
+		for (size_t i = hash & mask;; i = (i + 1) & mask)
+		{
+			if (entries[i].meta == meta || entries[i].meta == nullptr)
+			{
+				return &entries[i];
+			}
+		}
+	}
+
+	void grow ()
+	{
+		std::vector<Entry> entries (2 * entries_.size (), Entry{ nullptr, nullptr });
+		for (const Entry & entry : entries_)
+		{
+			if (entry.meta != nullptr)
+			{
+				*slot (entries, entry.meta) = entry;
+			}
+		}
+		entries_.swap (entries);
+	}
+
+	std::vector<Entry> entries_;
+	size_t size_;
+};
+
+static void writeKeySet (BufferedWriter & out, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
 {
-	os << "kdbOpen 2" << std::endl;
+	out << "kdbOpen 2\n";
 
 	size_t rootOffset;
 	if (useFullNames)
@@ -42,22 +209,28 @@ int serialize (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool
 		}
 	}
 
-	ckdb::KeySet * metacopies = ksNew (0, KS_END);
-	for (elektraCursor cursor = 0; cursor < ksGetSize (ks); ++cursor)
-	{
-		ckdb::Key * cur = ksAtCursor (ks, cursor);
-
-		size_t namesize = keyGetNameSize (cur) - rootOffset;
+	const size_t metaNsOffset = sizeof ("meta:/") - 1;
+	auto relativeNameSize = [rootOffset] (const ckdb::Key * key) {
+		size_t namesize = keyGetNameSize (key) - rootOffset;
 		if (namesize > 0)
 		{
 			namesize -= 1;
 		}
+		return namesize;
+	};
+
+	MetaCopies metacopies;
+	for (elektraCursor cursor = 0; cursor < ksGetSize (ks); ++cursor)
+	{
+		ckdb::Key * cur = ksAtCursor (ks, cursor);
+
+		size_t namesize = relativeNameSize (cur);
 
 		size_t valuesize = keyGetValueSize (cur);
 
 		bool binary = keyIsBinary (cur) == 1;
 
-		std::string type;
+		const char * type;
 		if (binary)
 		{
 			type = "binary";
@@ -68,74 +241,79 @@ int serialize (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool
 			valuesize -= 1;
 		}
 
-		os << "$key " << type << " " << namesize << " " << valuesize << std::endl;
+		out << "$key " << type << ' ' << namesize << ' ' << valuesize << '\n';
 		if (namesize > 0)
 		{
-			os << &keyName (cur)[rootOffset];
+			out << &keyName (cur)[rootOffset];
 		}
-		os << std::endl;
+		out << '\n';
 
 		if (binary)
 		{
-			os.write (static_cast<const char *> (keyValue (cur)), valuesize);
-			os << std::endl;
+			out.write (static_cast<const char *> (keyValue (cur)), valuesize);
+			out << '\n';
 		}
 		else
 		{
-			os << keyString (cur) << std::endl;
+			out << keyString (cur) << '\n';
 		}
 
 		ckdb::KeySet * metaKs = keyMeta (cur);
 		for (elektraCursor metaCursor = 0; metaCursor < ksGetSize (metaKs); ++metaCursor)
 		{
 			const ckdb::Key * meta = ksAtCursor (metaKs, metaCursor);
+			const MetaCopies::Entry * copy = metacopies.insert (meta, cur);
 
-			std::stringstream ss;
-			ss << "/" << meta; // use the address of pointer as name
-
-			ckdb::Key * search = keyNew (ss.str ().c_str (), KEY_END);
-			ckdb::Key * ret = ksLookup (metacopies, search, 0);
-
-			if (!ret)
+			if (!copy)
 			{
-				const size_t metaNsOffset = sizeof ("meta:/") - 1;
 				/* This metakey was not serialized up to now */
 				size_t metanamesize = keyGetNameSize (meta) - 1 - metaNsOffset;
 				size_t metavaluesize = keyGetValueSize (meta) - 1;
 
-				os << "$meta " << metanamesize << " " << metavaluesize << std::endl;
-				os << keyName (meta) + metaNsOffset << std::endl;
-				os << keyString (meta) << std::endl;
-
-				std::stringstream ssv;
-				ssv << namesize << " " << metanamesize << std::endl;
-				if (namesize > 0)
-				{
-					ssv << &keyName (cur)[rootOffset];
-				}
-				ssv << std::endl;
-				ssv << keyName (meta) + metaNsOffset << std::endl;
-				keySetString (search, ssv.str ().c_str ());
-
-				ksAppendKey (metacopies, search);
+				out << "$meta " << metanamesize << ' ' << metavaluesize << '\n';
+				out << keyName (meta) + metaNsOffset << '\n';
+				out << keyString (meta) << '\n';
 			}
 			else
 			{
 				/* Meta key already serialized, write out a reference to it */
-				keyDel (search);
+				size_t copynamesize = relativeNameSize (copy->key);
+				size_t metanamesize = keyGetNameSize (meta) - 1 - metaNsOffset;
 
-				os << "$copymeta " << keyString (ret);
+				out << "$copymeta " << copynamesize << ' ' << metanamesize << '\n';
+				if (copynamesize > 0)
+				{
+					out << &keyName (copy->key)[rootOffset];
+				}
+				out << '\n';
+				out << keyName (meta) + metaNsOffset << '\n';
 			}
 		}
-
-		// flush after every key to speed up streaming
-		os.flush ();
 	}
-	ksDel (metacopies);
 
-	os << "$end" << std::endl;
+	out << "$end\n";
+	out.flush ();
+}
 
-	return 1;
+int serialize (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
+{
+	BufferedWriter out (os);
+	writeKeySet (out, parentKey, ks, useFullNames);
+	os.flush ();
+	return out.error () == 0 && os ? 1 : -1;
+}
+
+/**
+ * @brief Serializes @p ks directly to the file descriptor @p fd.
+ *
+ * @retval 0 on success
+ * @return the errno of the failed write otherwise
+ */
+static int serializeToFile (int fd, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
+{
+	BufferedWriter out (fd);
+	writeKeySet (out, parentKey, ks, useFullNames);
+	return out.error ();
 }
 
 static int decodeLine (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet * ks, std::string & line, ckdb::Key ** curPtr)
@@ -625,8 +803,8 @@ int elektraDumpSet (ckdb::Plugin * handle, ckdb::KeySet * returned, ckdb::Key *
 {
 	int errnosave = errno;
 	// ELEKTRA_LOG (ELEKTRA_LOG_MODULE_DUMP, "opening file %s", keyString (parentKey));
-	std::ofstream ofs (keyString (parentKey), std::ios::binary);
-	if (!ofs.is_open ())
+	int fd = open (keyString (parentKey), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1)
 	{
 		ELEKTRA_SET_ERROR_SET (parentKey);
 		errno = errnosave;
@@ -636,8 +814,21 @@ int elektraDumpSet (ckdb::Plugin * handle, ckdb::KeySet * returned, ckdb::Key *
 	// dirty workaround for pluginprocess
 	bool useFullNames = ksLookupByName (elektraPluginGetConfig (handle), "/fullname", 0) != NULL;
 
+	int error = dump::serializeToFile (fd, parentKey, returned, useFullNames);
+	if (close (fd) == -1 && error == 0)
+	{
+		error = errno;
+	}
 
-	return dump::serialize (ofs, parentKey, returned, useFullNames);
+	if (error != 0)
+	{
+		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not write file %s. Reason: %s", keyString (parentKey), strerror (error));
+		errno = errnosave;
+		return -1;
+	}
+
+	errno = errnosave;
+	return 1;
 }
 
 ckdb::Plugin * ELEKTRA_PLUGIN_EXPORT
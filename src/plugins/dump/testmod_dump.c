@@ -612,6 +612,153 @@ static void test_v2_demo_root (void)
 	ksDel (ks);
 }
 
+static void test_v2_manyCopies (void)
+{
+	printf ("test v2 many copies\n");
+
+	char * outfile = elektraStrDup (elektraFilename ());
+
+	KeySet * ks = ksNew (0, KS_END);
+	Key * first = keyNew ("user:/tests/script", KEY_VALUE, "root", KEY_META, "comment/#0", "shared", KEY_END);
+	ksAppendKey (ks, first);
+	for (int i = 0; i < 200; ++i)
+	{
+		char name[64];
+		snprintf (name, sizeof (name), "user:/tests/script/key%d", i);
+		Key * k = keyNew (name, KEY_VALUE, "value", KEY_END);
+		keyCopyMeta (k, first, "comment/#0");
+		keySetMeta (k, "order", name);
+		ksAppendKey (ks, k);
+	}
+
+	{
+		Key * setKey = keyNew ("user:/tests/script", KEY_VALUE, outfile, KEY_END);
+
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("dump");
+
+		succeed_if (plugin->kdbSet (plugin, ks, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+		keyDel (setKey);
+		PLUGIN_CLOSE ();
+	}
+
+	{
+		Key * getKey = keyNew ("user:/tests/script", KEY_VALUE, outfile, KEY_END);
+
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("dump");
+
+		KeySet * read = ksNew (0, KS_END);
+		succeed_if (plugin->kdbGet (plugin, read, getKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+		compare_keyset (ks, read);
+
+		const Key * shared = keyGetMeta (ksLookupByName (read, "user:/tests/script", 0), "comment/#0");
+		Key * last = ksLookupByName (read, "user:/tests/script/key199", 0);
+		succeed_if (last && keyGetMeta (last, "comment/#0") == shared, "meta key was not shared");
+
+		ksDel (read);
+		keyDel (getKey);
+		PLUGIN_CLOSE ();
+	}
+
+	remove (outfile);
+	elektraFree (outfile);
+	ksDel (ks);
+}
+
+static void test_v2_largeValues (void)
+{
+	printf ("test v2 large values\n");
+
+	char * outfile = elektraStrDup (elektraFilename ());
+
+	// mixes short tokens with values that are written in place and exceed the buffer
+	size_t largeSize = 200 * 1024;
+	char * large = elektraMalloc (largeSize);
+	for (size_t i = 0; i < largeSize; ++i)
+	{
+		large[i] = (char) ('a' + i % 26);
+	}
+	large[largeSize - 1] = '\0';
+
+	KeySet * ks = ksNew (0, KS_END);
+	for (int i = 0; i < 1000; ++i)
+	{
+		char name[64];
+		snprintf (name, sizeof (name), "user:/tests/script/key%d", i);
+		Key * k;
+		if (i % 100 == 0)
+		{
+			k = keyNew (name, KEY_BINARY, KEY_SIZE, largeSize, KEY_VALUE, large, KEY_END);
+		}
+		else if (i % 10 == 0)
+		{
+			k = keyNew (name, KEY_VALUE, large + i, KEY_END);
+		}
+		else
+		{
+			k = keyNew (name, KEY_VALUE, "value", KEY_META, "order", name, KEY_END);
+		}
+		ksAppendKey (ks, k);
+	}
+
+	{
+		Key * setKey = keyNew ("user:/tests/script", KEY_VALUE, outfile, KEY_END);
+
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("dump");
+
+		succeed_if (plugin->kdbSet (plugin, ks, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+		keyDel (setKey);
+		PLUGIN_CLOSE ();
+	}
+
+	{
+		Key * getKey = keyNew ("user:/tests/script", KEY_VALUE, outfile, KEY_END);
+
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("dump");
+
+		KeySet * read = ksNew (0, KS_END);
+		succeed_if (plugin->kdbGet (plugin, read, getKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+		compare_keyset (ks, read);
+
+		ksDel (read);
+		keyDel (getKey);
+		PLUGIN_CLOSE ();
+	}
+
+	remove (outfile);
+	elektraFree (outfile);
+	elektraFree (large);
+	ksDel (ks);
+}
+
+static void test_writeError (void)
+{
+	printf ("test write error\n");
+
+	if (access ("/dev/full", W_OK) != 0)
+	{
+		return;
+	}
+
+	KeySet * ks = ksNew (1, keyNew ("user:/tests/script/key", KEY_VALUE, "value", KEY_END), KS_END);
+	Key * setKey = keyNew ("user:/tests/script", KEY_VALUE, "/dev/full", KEY_END);
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("dump");
+
+	succeed_if (plugin->kdbSet (plugin, ks, setKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "write error was not detected");
+	succeed_if (keyGetMeta (setKey, "error") != NULL, "no error set");
+
+	keyDel (setKey);
+	ksDel (ks);
+	PLUGIN_CLOSE ();
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("DUMP       TESTS\n");
@@ -633,6 +780,10 @@ int main (int argc, char ** argv)
 	test_v2_fullnames ();
 	test_v2_demo ();
 	test_v2_demo_root ();
+	test_v2_manyCopies ();
+	test_v2_largeValues ();
+
+	test_writeError ();
 
 	print_result ("testmod_dump");
 
@@ -43,6 +43,7 @@ int elektraGOptsGet (Plugin * handle, KeySet * returned, Key * parentKey)
 			ksNew (30, keyNew ("system:/elektra/modules/gopts", KEY_VALUE, "gopts plugin waits for your orders", KEY_END),
 			       keyNew ("system:/elektra/modules/gopts/exports", KEY_END),
 			       keyNew ("system:/elektra/modules/gopts/exports/get", KEY_FUNC, elektraGOptsGet, KEY_END),
+			       keyNew ("system:/elektra/modules/gopts/exports/close", KEY_FUNC, elektraGOptsClose, KEY_END),
 			       keyNew ("system:/elektra/modules/gopts/exports/hook/gopts/get", KEY_FUNC, elektraGOptsGet, KEY_END),
 #include ELEKTRA_README
 			       keyNew ("system:/elektra/modules/gopts/infos/version", KEY_VALUE, PLUGINVERSION, KEY_END), KS_END);
@@ -201,7 +202,25 @@ int elektraGOptsGet (Plugin * handle, KeySet * returned, Key * parentKey)
 		offset = 0;
 	}
 
-	int ret = elektraGetOpts (returned, argc - offset, (const char **) argv + offset, (const char **) envp, optsParent);
+	ElektraOptsTable * table = elektraPluginGetData (handle);
+	if (table == NULL)
+	{
+		// the config doesn't change, so the table is only decoded once
+		Key * specTableRoot = keyNew ("user:/spec", KEY_END);
+		table = elektraOptsTableNew (config, specTableRoot);
+		keyDel (specTableRoot);
+		elektraPluginSetData (handle, table);
+	}
+
+	int ret;
+	if (table != NULL)
+	{
+		ret = elektraGetOptsTable (returned, table, argc - offset, (const char **) argv + offset, (const char **) envp, optsParent);
+	}
+	else
+	{
+		ret = elektraGetOpts (returned, argc - offset, (const char **) argv + offset, (const char **) envp, optsParent);
+	}
 
 	if (cleanupArgData) cleanupArgs (argc, argv);
 	if (cleanupEnv) cleanupEnvp (envp);
@@ -237,11 +256,19 @@ int elektraGOptsGet (Plugin * handle, KeySet * returned, Key * parentKey)
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
+int elektraGOptsClose (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
+{
+	elektraOptsTableDel (elektraPluginGetData (handle));
+	elektraPluginSetData (handle, NULL);
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
 Plugin * ELEKTRA_PLUGIN_EXPORT
 {
 	// clang-format off
 	return elektraPluginExport ("gopts",
 		ELEKTRA_PLUGIN_GET,	&elektraGOptsGet,
+		ELEKTRA_PLUGIN_CLOSE,	&elektraGOptsClose,
 		ELEKTRA_PLUGIN_END);
 	// clang-format on
 }
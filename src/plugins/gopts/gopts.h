@@ -13,6 +13,7 @@
 #include <kdbplugin.h>
 
 int elektraGOptsGet (Plugin * handle, KeySet * ks, Key * parentKey);
+int elektraGOptsClose (Plugin * handle, Key * parentKey);
 
 Plugin * ELEKTRA_PLUGIN_EXPORT;
 
@@ -12,6 +12,7 @@
 #include <unistd.h>
 
 #include <kdbconfig.h>
+#include <kdbopts.h>
 
 #include <tests_plugin.h>
 
@@ -114,6 +115,53 @@ void test_global (void)
 	PLUGIN_CLOSE ();
 }
 
+void test_global_precompiled (void)
+{
+	printf ("test global precompiled\n");
+
+	Key * parentKey = keyNew ("/tests/gopts", KEY_END);
+	KeySet * spec = ksNew (2, keyNew ("spec:/tests/gopts/apple", KEY_META, "opt", "c", KEY_END),
+			       keyNew ("spec:/tests/gopts/carrot", KEY_META, "env", "ENV_VAR", KEY_END), KS_END);
+	KeySet * conf = ksNew (0, KS_END);
+	Key * tableRoot = keyNew ("user:/spec", KEY_END);
+	succeed_if (elektraGetOptsPrecompile (spec, parentKey, conf, tableRoot) == 0, "could not precompile spec");
+	keyDel (tableRoot);
+
+	PLUGIN_OPEN ("gopts");
+
+	int argc = 2;
+	char ** argv = (char **) (char *[]){ "gopts-test", "-capple", NULL };
+	char ** envp = (char **) (char *[]){ "ENV_VAR=carrot", NULL };
+
+	plugin->global =
+		ksNew (4, keyNew ("system:/elektra/gopts/parent", KEY_VALUE, keyName (parentKey), KEY_END),
+		       keyNew ("system:/elektra/gopts/argc", KEY_BINARY, KEY_SIZE, sizeof (int), KEY_VALUE, &argc, KEY_END),
+		       keyNew ("system:/elektra/gopts/argv", KEY_BINARY, KEY_SIZE, sizeof (char **), KEY_VALUE, &argv, KEY_END),
+		       keyNew ("system:/elektra/gopts/envp", KEY_BINARY, KEY_SIZE, sizeof (char **), KEY_VALUE, &envp, KEY_END), KS_END);
+
+	// the processed spec is taken from the table in the config
+	KeySet * ks = ksDup (spec);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) >= 1, "call to kdbGet was not successful");
+	output_error (parentKey);
+
+	succeed_if_same_string (keyString (ksLookupByName (ks, "/tests/gopts/apple", 0)), "apple");
+	succeed_if_same_string (keyString (ksLookupByName (ks, "/tests/gopts/carrot", 0)), "carrot");
+	ksDel (ks);
+
+	// the table is ignored, if the spec was changed afterwards
+	ks = ksDup (spec);
+	keySetMeta (ksLookupByName (ks, "spec:/tests/gopts/apple", 0), "opt", "a");
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "outdated table used");
+	succeed_if (keyGetMeta (parentKey, "error") != NULL, "unknown option -c not reported");
+	keySetMeta (parentKey, "error", NULL);
+	ksDel (spec);
+
+	ksDel (plugin->global);
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("GOPTS     TESTS\n");
@@ -179,6 +227,7 @@ int main (int argc, char ** argv)
 	elektraFree (ldLibPath);
 
 	test_global ();
+	test_global_precompiled ();
 
 	print_result ("testmod_gopts");
 
@@ -26,15 +26,41 @@
 struct _KeyRegistration
 {
 	char * name;
+	Key * lookupKey;
+	elektraNamespace namespace;
 	char * lastValue;
+	size_t lastValueSize;
+	size_t lastValueAlloc;
 	int sameOrBelow;
 	int freeContext;
+	int matched;
 	ElektraNotificationChangeCallback callback;
 	void * context;
 	struct _KeyRegistration * next;
+	struct _KeyRegistration * nextInNode;
 };
 typedef struct _KeyRegistration KeyRegistration;
 
+/**
+ * Node of the registration trie.
+ *
+ * The trie is indexed by the unescaped name parts of the registered keys,
+ * the namespace is stored in the registration itself.
+ * @internal
+ */
+struct _RegistrationNode
+{
+	char * part;
+	size_t partSize;
+	struct _RegistrationNode ** children;
+	size_t childCount;
+	size_t childAlloc;
+	KeyRegistration * registrations;
+	size_t registrationsBelow;
+	size_t sameOrBelowBelow;
+};
+typedef struct _RegistrationNode RegistrationNode;
+
 /**
  * Structure for internal plugin state
  * @internal
@@ -43,6 +69,7 @@ struct _PluginState
 {
 	KeyRegistration * head;
 	KeyRegistration * last;
+	RegistrationNode * root;
 	ElektraNotificationConversionErrorCallback conversionErrorCallback;
 	void * conversionErrorCallbackContext;
 };
@@ -65,62 +92,235 @@ static void elektraInternalnotificationSetConversionErrorCallback (Plugin * hand
 
 /**
  * @internal
- * Check if two keys have the same name.
- * If one of the keys is cascading only the cascading names are compared.
+ * Check if the namespaces of a registration and a key are compatible.
+ * Cascading keys and registrations match every namespace.
  *
- * @param  key   key
- * @param  check check
- * @retval 1 if keys have the same name
+ * @param  registration registration
+ * @param  namespace    namespace of the key
+ * @retval 1 if the namespaces match
  * @retval 0 otherwise
  */
-static int checkKeyIsSame (Key * key, Key * check)
+static int namespaceMatches (KeyRegistration * registration, elektraNamespace namespace)
 {
-	int result = 0;
-	if (keyGetNamespace (check) == KEY_NS_CASCADING || keyGetNamespace (key) == KEY_NS_CASCADING)
+	return registration->namespace == namespace || registration->namespace == KEY_NS_CASCADING || namespace == KEY_NS_CASCADING;
+}
+
+/**
+ * @internal
+ * Compare two name parts. Any total order works, the trie only needs it for binary search.
+ */
+static int comparePart (const char * part, size_t partSize, const RegistrationNode * node)
+{
+	size_t min = partSize < node->partSize ? partSize : node->partSize;
+	int result = memcmp (part, node->part, min);
+	if (result != 0)
 	{
-		const char * cascadingCheck = strrchr (keyName (check), '/');
-		const char * cascadingKey = strrchr (keyName (key), '/');
-		if (cascadingCheck != NULL && cascadingKey != NULL)
+		return result;
+	}
+	return partSize < node->partSize ? -1 : partSize > node->partSize;
+}
+
+/**
+ * @internal
+ * Find the child of @p node for the given name part.
+ *
+ * @param  node     trie node
+ * @param  part     name part (not null terminated)
+ * @param  partSize size of @p part
+ * @param  index    set to the insertion position if not found, may be NULL
+ *
+ * @return the child node or NULL if not found
+ */
+static RegistrationNode * findChild (RegistrationNode * node, const char * part, size_t partSize, size_t * index)
+{
+	size_t low = 0;
+	size_t high = node->childCount;
+	while (low < high)
+	{
+		size_t mid = low + (high - low) / 2;
+		int cmp = comparePart (part, partSize, node->children[mid]);
+		if (cmp == 0)
 		{
-			result = elektraStrCmp (cascadingKey, cascadingCheck) == 0;
+			return node->children[mid];
+		}
+		if (cmp < 0)
+		{
+			high = mid;
 		}
 		else
 		{
-			if (!cascadingCheck || !cascadingKey)
+			low = mid + 1;
+		}
+	}
+	if (index != NULL)
+	{
+		*index = low;
+	}
+	return NULL;
+}
+
+static RegistrationNode * newNode (const char * part, size_t partSize)
+{
+	RegistrationNode * node = elektraCalloc (sizeof *node);
+	if (node == NULL)
+	{
+		return NULL;
+	}
+	if (partSize > 0)
+	{
+		node->part = elektraMalloc (partSize);
+		if (node->part == NULL)
+		{
+			elektraFree (node);
+			return NULL;
+		}
+		memcpy (node->part, part, partSize);
+		node->partSize = partSize;
+	}
+	return node;
+}
+
+static void deleteNode (RegistrationNode * node)
+{
+	if (node == NULL)
+	{
+		return;
+	}
+	for (size_t i = 0; i < node->childCount; ++i)
+	{
+		deleteNode (node->children[i]);
+	}
+	elektraFree (node->children);
+	elektraFree (node->part);
+	elektraFree (node);
+}
+
+/**
+ * @internal
+ * Get the first name part of the unescaped name of @p key.
+ *
+ * @param  key  key
+ * @param  end  set to the end of the unescaped name
+ *
+ * @return pointer to the first part or @p end if the key is a root key
+ */
+static const char * firstPart (const Key * key, const char ** end)
+{
+	const char * name = keyUnescapedName (key);
+	size_t size = keyGetUnescapedNameSize (key);
+	*end = name + size;
+	// unescaped names start with the namespace byte and a null byte, root keys only have an empty part
+	return size <= 3 ? *end : name + 2;
+}
+
+/**
+ * @internal
+ * Insert a registration into the trie. Creates all missing nodes.
+ *
+ * @retval 1 on success
+ * @retval 0 if memory allocation failed
+ */
+static int insertRegistration (RegistrationNode * root, KeyRegistration * registration)
+{
+	const char * end;
+	const char * part = firstPart (registration->lookupKey, &end);
+
+	// create path first, so that counters stay consistent if allocation fails
+	RegistrationNode * node = root;
+	while (part < end)
+	{
+		size_t partSize = strlen (part);
+		size_t index;
+		RegistrationNode * child = findChild (node, part, partSize, &index);
+		if (child == NULL)
+		{
+			if (node->childCount == node->childAlloc)
 			{
-				ELEKTRA_LOG_WARNING ("invalid key given: 'NULL' is not a valid key");
+				size_t alloc = node->childAlloc == 0 ? 4 : node->childAlloc * 2;
+				if (elektraRealloc ((void **) &node->children, alloc * sizeof (RegistrationNode *)) < 0)
+				{
+					return 0;
+				}
+				node->childAlloc = alloc;
 			}
+			child = newNode (part, partSize);
+			if (child == NULL)
+			{
+				return 0;
+			}
+			memmove (node->children + index + 1, node->children + index,
+				 (node->childCount - index) * sizeof (RegistrationNode *));
+			node->children[index] = child;
+			++node->childCount;
 		}
+		node = child;
+		part += partSize + 1;
 	}
-	else
+
+	registration->nextInNode = node->registrations;
+	node->registrations = registration;
+
+	// update counters along the path
+	part = firstPart (registration->lookupKey, &end);
+	node = root;
+	while (1)
 	{
-		result = elektraStrCmp (keyName (check), keyName (key)) == 0;
+		++node->registrationsBelow;
+		if (registration->sameOrBelow)
+		{
+			++node->sameOrBelowBelow;
+		}
+		if (part >= end)
+		{
+			break;
+		}
+		size_t partSize = strlen (part);
+		node = findChild (node, part, partSize, NULL);
+		part += partSize + 1;
 	}
-	return result;
+	return 1;
 }
 
 /**
  * @internal
- * Check if a key has the same name or is below a given key.
- *
- * @param  key   key
- * @param  check check
- * @retval 1 if key has the same name or is below
- * @retval 0 otherwise
+ * Check if @p node or any node below contains a registration matching the namespace.
  */
-static int checkKeyIsBelowOrSame (Key * key, Key * check)
+static int subtreeHasRegistration (RegistrationNode * node, elektraNamespace namespace)
 {
-	int result = 0;
-	if (keyIsBelow (key, check))
+	if (node->registrationsBelow == 0)
 	{
-		result = 1;
+		return 0;
 	}
-	else
+	for (KeyRegistration * registration = node->registrations; registration != NULL; registration = registration->nextInNode)
 	{
-		result = checkKeyIsSame (key, check);
+		if (namespaceMatches (registration, namespace))
+		{
+			return 1;
+		}
 	}
+	for (size_t i = 0; i < node->childCount; ++i)
+	{
+		if (subtreeHasRegistration (node->children[i], namespace))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
 
-	return result;
+/**
+ * @internal
+ * Mark all same or below registrations at @p node matching the namespace.
+ */
+static void markSameOrBelow (RegistrationNode * node, elektraNamespace namespace)
+{
+	for (KeyRegistration * registration = node->registrations; registration != NULL; registration = registration->nextInNode)
+	{
+		if (registration->sameOrBelow && namespaceMatches (registration, namespace))
+		{
+			registration->matched = 1;
+		}
+	}
 }
 
 /**
@@ -144,22 +344,31 @@ void elektraInternalnotificationDoUpdate (Key * changedKey, ElektraNotificationC
 	ELEKTRA_NOT_NULL (pluginState);
 
 	int kdbChanged = 0;
-	KeyRegistration * keyRegistration = pluginState->head;
-	while (keyRegistration != NULL)
+	elektraNamespace namespace = keyGetNamespace (changedKey);
+	const char * end;
+	const char * part = firstPart (changedKey, &end);
+	RegistrationNode * node = pluginState->root;
+	while (node != NULL && !kdbChanged)
 	{
-		Key * registeredKey = keyNew (keyRegistration->name, KEY_END);
-
-		// check if registered key is same or below changed/commit key
-		kdbChanged |= checkKeyIsBelowOrSame (changedKey, registeredKey);
+		if (part >= end)
+		{
+			// registered keys same or below changed key
+			kdbChanged = subtreeHasRegistration (node, namespace);
+			break;
+		}
 
-		if (keyRegistration->sameOrBelow)
+		// changed key below registered key
+		for (KeyRegistration * registration = node->registrations; registration != NULL; registration = registration->nextInNode)
 		{
-			// check if registered key is also above changed/commit key
-			kdbChanged |= checkKeyIsBelowOrSame (registeredKey, changedKey);
+			if (registration->sameOrBelow && namespaceMatches (registration, namespace))
+			{
+				kdbChanged = 1;
+			}
 		}
 
-		keyRegistration = keyRegistration->next;
-		keyDel (registeredKey);
+		size_t partSize = strlen (part);
+		node = findChild (node, part, partSize, NULL);
+		part += partSize + 1;
 	}
 
 	if (kdbChanged)
@@ -174,7 +383,8 @@ void elektraInternalnotificationDoUpdate (Key * changedKey, ElektraNotificationC
 }
 
 /**
- * Creates a new KeyRegistration structure and appends it at the end of the registration list
+ * Creates a new KeyRegistration structure, appends it at the end of the registration list
+ * and inserts it into the registration trie
  * @internal
  *
  * @param pluginState   internal plugin data structure
@@ -182,26 +392,51 @@ void elektraInternalnotificationDoUpdate (Key * changedKey, ElektraNotificationC
  * @param callback      callback for changes
  * @param context       context for callback
  * @param freeContext   context needs to be freed on close
+ * @param sameOrBelow   registration also matches keys below @p key
  *
  * @return pointer to created KeyRegistration structure or NULL if memory allocation failed
  */
 static KeyRegistration * elektraInternalnotificationAddNewRegistration (PluginState * pluginState, Key * key,
 									ElektraNotificationChangeCallback callback, void * context,
-									int freeContext)
+									int freeContext, int sameOrBelow)
 {
-	KeyRegistration * item = elektraMalloc (sizeof *item);
+	if (pluginState->root == NULL)
+	{
+		pluginState->root = newNode (NULL, 0);
+		if (pluginState->root == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	KeyRegistration * item = elektraCalloc (sizeof *item);
 	if (item == NULL)
 	{
 		return NULL;
 	}
-	item->next = NULL;
-	item->lastValue = NULL;
 	item->name = elektraStrDup (keyName (key));
+	item->lookupKey = keyNew (keyName (key), KEY_END);
+	if (item->name == NULL || item->lookupKey == NULL)
+	{
+		elektraFree (item->name);
+		keyDel (item->lookupKey);
+		elektraFree (item);
+		return NULL;
+	}
+	item->namespace = keyGetNamespace (item->lookupKey);
 	item->callback = callback;
 	item->context = context;
-	item->sameOrBelow = 0;
+	item->sameOrBelow = sameOrBelow;
 	item->freeContext = freeContext;
 
+	if (!insertRegistration (pluginState->root, item))
+	{
+		elektraFree (item->name);
+		keyDel (item->lookupKey);
+		elektraFree (item);
+		return NULL;
+	}
+
 	if (pluginState->head == NULL)
 	{
 		// Initialize list
@@ -219,26 +454,74 @@ static KeyRegistration * elektraInternalnotificationAddNewRegistration (PluginSt
 
 /**
  * @internal
- * Check if a key set contains a key that is same or below a given key.
+ * Mark all same or below registrations that have a key same or below them in the key set.
  *
- * @param  key  key
+ * Every key walks down the trie along its name parts, so the cost is
+ * proportional to the size of the key set and not to the number of registrations.
+ * The walk stops as soon as no same or below registration is left below the current node.
+ *
+ * @param  root trie root
  * @param  ks   key set
- * @retval 1 if the key set contains the key
- * @retval 0 otherwise
  */
-static int keySetContainsSameOrBelow (Key * check, KeySet * ks)
+static void markSameOrBelowRegistrations (RegistrationNode * root, KeySet * ks)
 {
-	Key * current;
+	if (root == NULL || root->sameOrBelowBelow == 0)
+	{
+		return;
+	}
 
 	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
 	{
-		current = ksAtCursor (ks, it);
-		if (checkKeyIsBelowOrSame (check, current))
+		Key * current = ksAtCursor (ks, it);
+		elektraNamespace namespace = keyGetNamespace (current);
+		const char * end;
+		const char * part = firstPart (current, &end);
+		RegistrationNode * node = root;
+		while (node != NULL && node->sameOrBelowBelow > 0)
+		{
+			markSameOrBelow (node, namespace);
+			if (part >= end)
+			{
+				break;
+			}
+			size_t partSize = strlen (part);
+			node = findChild (node, part, partSize, NULL);
+			part += partSize + 1;
+		}
+	}
+}
+
+/**
+ * @internal
+ * Compare the value of @p key with the last value of the registration and store it if changed.
+ * The buffer of the last value is reused, so no allocation happens if the value did not grow.
+ *
+ * @retval 1 if the value changed
+ * @retval 0 otherwise
+ */
+static int updateLastValue (KeyRegistration * registeredKey, Key * key)
+{
+	const char * currentValue = keyString (key);
+	size_t currentSize = keyGetValueSize (key);
+	if (registeredKey->lastValue != NULL && registeredKey->lastValueSize == currentSize &&
+	    memcmp (currentValue, registeredKey->lastValue, currentSize) == 0)
+	{
+		return 0;
+	}
+
+	// Save last value
+	if (currentSize > registeredKey->lastValueAlloc)
+	{
+		if (elektraRealloc ((void **) &registeredKey->lastValue, currentSize) < 0)
 		{
+			// value is still reported as changed, but cannot be saved
 			return 1;
 		}
+		registeredKey->lastValueAlloc = currentSize;
 	}
-	return 0;
+	memcpy (registeredKey->lastValue, currentValue, currentSize);
+	registeredKey->lastValueSize = currentSize;
+	return 1;
 }
 
 /**
@@ -255,6 +538,8 @@ void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet *
 	PluginState * pluginState = elektraPluginGetData (plugin);
 	ELEKTRA_ASSERT (pluginState != NULL, "plugin state was not initialized properly");
 
+	markSameOrBelowRegistrations (pluginState->root, keySet);
+
 	KeyRegistration * registeredKey = pluginState->head;
 	while (registeredKey != NULL)
 	{
@@ -262,20 +547,17 @@ void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet *
 		Key * key;
 		if (registeredKey->sameOrBelow)
 		{
-			Key * checkKey = keyNew (registeredKey->name, KEY_END);
-			if (keySetContainsSameOrBelow (checkKey, keySet))
-			{
-				changed = 1;
-				key = checkKey;
-			}
-			else
+			if (registeredKey->matched)
 			{
-				keyDel (checkKey);
+				registeredKey->matched = 0;
+				key = keyDup (registeredKey->lookupKey, KEY_CP_NAME);
+				changed = key != NULL;
 			}
 		}
 		else
 		{
-			key = ksLookupByName (keySet, registeredKey->name, 0);
+			// the lookup key is reused, so ksLookup can use the hash index of the key set
+			key = ksLookup (keySet, registeredKey->lookupKey, 0);
 			if (key != NULL)
 			{
 				// Detect changes for string keys
@@ -286,23 +568,7 @@ void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet *
 				}
 				else
 				{
-					const char * currentValue = keyString (key);
-					changed = registeredKey->lastValue == NULL || strcmp (currentValue, registeredKey->lastValue) != 0;
-
-					if (changed)
-					{
-						// Save last value
-						char * buffer = elektraStrDup (currentValue);
-						if (buffer)
-						{
-							if (registeredKey->lastValue != NULL)
-							{
-								// Free previous value
-								elektraFree (registeredKey->lastValue);
-							}
-							registeredKey->lastValue = buffer;
-						}
-					}
+					changed = updateLastValue (registeredKey, key);
 				}
 			}
 		}
@@ -472,7 +738,7 @@ int elektraInternalnotificationRegisterCallback (Plugin * handle, Key * key, Ele
 	PluginState * pluginState = elektraPluginGetData (handle);
 	ELEKTRA_ASSERT (pluginState != NULL, "plugin state was not initialized properly");
 
-	KeyRegistration * registeredKey = elektraInternalnotificationAddNewRegistration (pluginState, key, callback, context, 0);
+	KeyRegistration * registeredKey = elektraInternalnotificationAddNewRegistration (pluginState, key, callback, context, 0, 0);
 	if (registeredKey == NULL)
 	{
 		return 0;
@@ -490,12 +756,11 @@ int elektraInternalnotificationRegisterCallbackSameOrBelow (Plugin * handle, Key
 	PluginState * pluginState = elektraPluginGetData (handle);
 	ELEKTRA_ASSERT (pluginState != NULL, "plugin state was not initialized properly");
 
-	KeyRegistration * registeredKey = elektraInternalnotificationAddNewRegistration (pluginState, key, callback, context, 0);
+	KeyRegistration * registeredKey = elektraInternalnotificationAddNewRegistration (pluginState, key, callback, context, 0, 1);
 	if (registeredKey == NULL)
 	{
 		return 0;
 	}
-	registeredKey->sameOrBelow = 1;
 
 	return 1;
 }
@@ -614,6 +879,7 @@ int elektraInternalnotificationOpen (Plugin * handle, Key * parentKey ELEKTRA_UN
 		// Initialize list pointers for registered keys
 		pluginState->head = NULL;
 		pluginState->last = NULL;
+		pluginState->root = NULL;
 		pluginState->conversionErrorCallback = NULL;
 		pluginState->conversionErrorCallbackContext = NULL;
 	}
@@ -660,6 +926,7 @@ int elektraInternalnotificationClose (Plugin * handle, Key * parentKey ELEKTRA_U
 		{
 			next = current->next;
 			elektraFree (current->name);
+			keyDel (current->lookupKey);
 			if (current->lastValue != NULL)
 			{
 				elektraFree (current->lastValue);
@@ -673,6 +940,8 @@ int elektraInternalnotificationClose (Plugin * handle, Key * parentKey ELEKTRA_U
 			current = next;
 		}
 
+		deleteNode (pluginState->root);
+
 		// Free list pointer
 		elektraFree (pluginState);
 		elektraPluginSetData (handle, NULL);
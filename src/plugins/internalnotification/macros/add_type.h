@@ -81,7 +81,7 @@ INTERNALNOTIFICATION_REGISTER_SIGNATURE (TYPE, TYPE_NAME)
 	context->variable = variable;
 
 	KeyRegistration * registeredKey = elektraInternalnotificationAddNewRegistration (
-		pluginState, key, INTERNALNOTIFICATION_CONVERSION_CALLBACK_NAME (TYPE_NAME), context, 1);
+		pluginState, key, INTERNALNOTIFICATION_CONVERSION_CALLBACK_NAME (TYPE_NAME), context, 1, 0);
 	if (registeredKey == NULL)
 	{
 		return 0;
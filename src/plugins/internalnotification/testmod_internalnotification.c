@@ -430,6 +430,73 @@ static void test_callbackCalledWithChangeDetection (void)
 	PLUGIN_CLOSE ();
 }
 
+static void test_callbackSameOrBelow (void)
+{
+	printf ("test callback is called for keys below registered key\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("internalnotification");
+
+	Key * registeredKey = keyNew ("user:/test/internalnotification", KEY_END);
+	succeed_if (internalnotificationRegisterCallbackSameOrBelow (plugin, registeredKey, test_callback, CALLBACK_CONTEXT_MAGIC_NUMBER) ==
+			    1,
+		    "call to elektraInternalnotificationRegisterCallbackSameOrBelow was not successful");
+
+	KeySet * ks = ksNew (2, keyNew ("user:/test/other/value", KEY_END), keyNew ("user:/test/internalnotfication", KEY_END), KS_END);
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	succeed_if (callback_called == 0, "callback was called for unrelated keys");
+
+	ksAppendKey (ks, keyNew ("system:/test/internalnotification/deep/value", KEY_END));
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	succeed_if (callback_called == 0, "callback was called for key in other namespace");
+
+	ksAppendKey (ks, keyNew ("user:/test/internalnotification/deep/value", KEY_END));
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	succeed_if (callback_called, "callback was not called for key below");
+	succeed_if_same_string (callback_keyName, keyName (registeredKey));
+
+	ksDel (ks);
+	keyDel (registeredKey);
+	PLUGIN_CLOSE ();
+}
+
+static void test_callbackSameOrBelowCascading (void)
+{
+	printf ("test callback is called for keys below cascading registered key\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("internalnotification");
+
+	Key * registeredKey = keyNew ("/test/internalnotification", KEY_END);
+	Key * exactKey = keyNew ("user:/test/internalnotification/deep", KEY_END);
+	succeed_if (internalnotificationRegisterCallbackSameOrBelow (plugin, registeredKey, test_callback, CALLBACK_CONTEXT_MAGIC_NUMBER) ==
+			    1,
+		    "call to elektraInternalnotificationRegisterCallbackSameOrBelow was not successful");
+	succeed_if (internalnotificationRegisterCallback (plugin, exactKey, test_callback, CALLBACK_CONTEXT_MAGIC_NUMBER) == 1,
+		    "call to elektraInternalnotificationRegisterCallback was not successful");
+
+	KeySet * ks = ksNew (1, keyNew ("system:/test/internalnotification", KEY_VALUE, "1", KEY_END), KS_END);
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	succeed_if (callback_called, "callback was not called for same key in other namespace");
+	succeed_if_same_string (callback_keyName, keyName (registeredKey));
+
+	ksAppendKey (ks, keyNew ("user:/test/internalnotification/deep", KEY_VALUE, "value", KEY_END));
+	callback_called = 0;
+	callback_keyName = NULL;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	succeed_if (callback_called, "callback was not called for exact registration");
+	succeed_if_same_string (callback_keyName, keyName (exactKey));
+
+	ksDel (ks);
+	keyDel (registeredKey);
+	keyDel (exactKey);
+	PLUGIN_CLOSE ();
+}
+
 static void test_doUpdate_callback (KDB * kdb ELEKTRA_UNUSED, Key * changedKey ELEKTRA_UNUSED)
 {
 	doUpdate_callback_called = 1;
@@ -740,6 +807,8 @@ int main (int argc, char ** argv)
 	printf ("\nregisterCallback\n----------------\n");
 	test_callbackCalledWithKey ();
 	test_callbackCalledWithChangeDetection ();
+	test_callbackSameOrBelow ();
+	test_callbackSameOrBelowCascading ();
 
 	RUN_TYPE_TESTS (UnsignedInt)
 	RUN_TYPE_TESTS (Long)
@@ -11,28 +11,45 @@
 
 #include <kdbendian.h>
 #include <kdbhelper.h>
+#include <kdbprivate.h>
+#include <kdbproposal.h>
 
 #include <kdberrors.h>
+#include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h> // realpath()
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <sys/mman.h> // mmap(), munmap()
+#include <unistd.h>   // unlink(), fchown()
+#endif
 
 #define MAGIC_NUMBER_BASE (0x454b444200000000UL) // EKDB (in ASCII) + Version placeholder
 
 #define MAGIC_NUMBER_V1 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 1))
 #define MAGIC_NUMBER_V2 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 2))
 #define MAGIC_NUMBER_V3 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 3))
+#define MAGIC_NUMBER_V4 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 4))
+
+// all words and payloads of a v4 file start at a multiple of this
+#define V4_ALIGNMENT (sizeof (kdb_unsigned_long_long_t))
 
 struct metaLink
 {
-	const void * meta;
+	const Key * meta;
 	size_t keyNameSize;
 	const char * keyName;
+	size_t index;
 };
 
-struct list
+struct metaLinks
 {
 	size_t alloc;
 	size_t size;
-	struct metaLink ** array;
+	struct metaLink * array;
 };
 
 struct stringbuffer
@@ -42,8 +59,24 @@ struct stringbuffer
 	char * string;
 };
 
-static ssize_t findMetaLink (struct list * list, const Key * meta);
-static void insertMetaLink (struct list * list, size_t index, const Key * meta, Key * key, size_t parentOffset);
+struct v4Reader
+{
+	const char * data;
+	size_t size;
+	size_t offset;
+};
+
+// a mapped version 4 file, kept until none of its keys is used anymore
+struct v4Mapping
+{
+	void * data;
+	size_t size;
+	KeySet * keys; // all keys read from data, used to find out when the mapping can be removed
+	struct v4Mapping * next;
+};
+
+static void setupMetaLinks (struct metaLinks * links);
+static const struct metaLink * insertMetaLink (struct metaLinks * links, const Key * meta, Key * key, size_t parentOffset);
 
 static void setupBuffer (struct stringbuffer * buffer, size_t initialAlloc);
 static void ensureBufferSize (struct stringbuffer * buffer, size_t minSize);
@@ -105,13 +138,451 @@ static inline bool readStringIntoBuffer (FILE * file, struct stringbuffer * buff
 	return true;
 }
 
-int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+static inline bool readWord (struct v4Reader * reader, kdb_unsigned_long_long_t * value)
+{
+	if (reader->size - reader->offset < sizeof (kdb_unsigned_long_long_t))
+	{
+		return false;
+	}
+
+	// offset is always aligned
+	*value = le64toh (*(const kdb_unsigned_long_long_t *) &reader->data[reader->offset]);
+	reader->offset += sizeof (kdb_unsigned_long_long_t);
+	return true;
+}
+
+static inline bool readPayload (struct v4Reader * reader, const char ** data, kdb_unsigned_long_long_t * size)
+{
+	if (!readWord (reader, size) || *size > reader->size - reader->offset)
+	{
+		return false;
+	}
+
+	size_t padding = (V4_ALIGNMENT - *size % V4_ALIGNMENT) % V4_ALIGNMENT;
+	if (padding > reader->size - reader->offset - *size)
+	{
+		return false;
+	}
+
+	*data = &reader->data[reader->offset];
+	reader->offset += *size + padding;
+	return true;
+}
+
+static inline bool readName (struct v4Reader * reader, const char ** name, kdb_unsigned_long_long_t * nameSize, const char ** uname,
+			     kdb_unsigned_long_long_t * unameSize)
+{
+	if (!readPayload (reader, name, nameSize) || !readPayload (reader, uname, unameSize))
+	{
+		return false;
+	}
+
+	// escaped name is a string, unescaped name starts with the namespace and ends with a null byte
+	return *nameSize >= 2 && (*name)[*nameSize - 1] == '\0' && *unameSize >= 2 && (*uname)[*unameSize - 1] == '\0' &&
+	       (*uname)[0] >= KEY_NS_CASCADING && (*uname)[0] <= KEY_NS_LAST;
+}
+
+/**
+ * Checks a name read from a v4 file before it is used directly.
+ *
+ * @retval true if @p name is a canonical key name and @p uname is its unescaped form
+ */
+static bool isValidName (const char * name, size_t nameSize, const char * uname, size_t unameSize)
+{
+	if (strlen (name) + 1 != nameSize || !elektraKeyNameValidate (name, true))
+	{
+		return false;
+	}
+
+	char * canonical = NULL;
+	size_t canonicalSize = 0;
+	size_t usize = 0;
+	elektraKeyNameCanonicalize (name, &canonical, &canonicalSize, 0, &usize);
+
+	bool valid = canonicalSize == nameSize && usize == unameSize && memcmp (canonical, name, nameSize) == 0;
+	if (valid)
+	{
+		char * unescaped = elektraMalloc (usize);
+		elektraKeyNameUnescape (canonical, unescaped);
+		valid = memcmp (unescaped, uname, usize) == 0;
+		elektraFree (unescaped);
+	}
+
+	elektraFree (canonical);
+	return valid;
+}
+
+static struct _KeyName * newKeyName (const char * name, size_t nameSize, const char * uname, size_t unameSize, bool inMmap)
+{
+	struct _KeyName * keyName = elektraCalloc (sizeof (struct _KeyName));
+	keyName->key = inMmap ? (char *) name : elektraMemDup (name, nameSize);
+	keyName->keySize = nameSize;
+	keyName->ukey = inMmap ? (char *) uname : elektraMemDup (uname, unameSize);
+	keyName->keyUSize = unameSize;
+	keyNameUpdateParts (keyName);
+	keyName->refs = 1;
+	setKeyNameIsInMmap (keyName, inMmap);
+	return keyName;
+}
+
+static struct _KeyData * newKeyData (const char * value, size_t valueSize, bool inMmap)
+{
+	if (valueSize == 0)
+	{
+		return NULL;
+	}
+
+	struct _KeyData * keyData = elektraCalloc (sizeof (struct _KeyData));
+	keyData->data.c = inMmap ? (char *) value : elektraMemDup (value, valueSize);
+	keyData->dataSize = valueSize;
+	keyData->refs = 1;
+	setKeyDataIsInMmap (keyData, inMmap);
+	return keyData;
+}
+
+static Key * newKey (struct _KeyName * keyName)
+{
+	Key * key = elektraCalloc (sizeof (struct _Key));
+	key->keyName = keyName;
+	key->needsSync = true;
+	return key;
+}
+
+/**
+ * Reads the keys of a v4 file.
+ *
+ * If @p inMmap is set, names and values of the created keys point directly into @p data,
+ * so @p data must stay valid as long as any of those keys exist. Otherwise all payloads are copied.
+ * Metadata is always copied, because metakeys are easily shared with keys that were not read from @p data.
+ *
+ * Names are only used directly, if the file was written with the same parent key. Otherwise
+ * the relative part of each name is appended to the name of @p parentKey.
+ *
+ * @param data      the whole file including the magic number, aligned to #V4_ALIGNMENT
+ * @param size      size of @p data
+ * @param inMmap    whether the created keys should point into @p data
+ * @param returned  the keys are appended here, nothing is appended on error
+ * @param read      if not NULL, the keys are also appended here
+ * @param parentKey the parent key
+ *
+ * @return the number of keys read
+ * @retval -1 on error, @p parentKey contains the error
+ */
+static ssize_t readV4 (const char * data, size_t size, bool inMmap, KeySet * returned, KeySet * read, Key * parentKey)
+{
+	struct v4Reader reader = { data, size, sizeof (kdb_unsigned_long_long_t) };
+
+	kdb_unsigned_long_long_t keyCount;
+	const char * prefix;
+	kdb_unsigned_long_long_t prefixSize;
+	if (!readWord (&reader, &keyCount) || !readPayload (&reader, &prefix, &prefixSize))
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Premature end of file");
+		return -1;
+	}
+
+	// every key needs at least five words
+	if (keyCount > (size - reader.offset) / (5 * sizeof (kdb_unsigned_long_long_t)))
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid key count " ELEKTRA_UNSIGNED_LONG_LONG_F, keyCount);
+		return -1;
+	}
+
+	bool sameParent = keyGetNameSize (parentKey) - 1 == (ssize_t) prefixSize && memcmp (keyName (parentKey), prefix, prefixSize) == 0;
+
+	KeySet * keys = ksNew (keyCount, KS_END);
+	Key * key = NULL;
+
+	// all metakeys written with 'm' in file order, referenced by 'c'
+	size_t metaAlloc = 16;
+	size_t metaSize = 0;
+	Key ** metaKeys = elektraMalloc (metaAlloc * sizeof (Key *));
+
+	for (kdb_unsigned_long_long_t i = 0; i < keyCount; ++i)
+	{
+		const char * name;
+		kdb_unsigned_long_long_t nameSize;
+		const char * uname;
+		kdb_unsigned_long_long_t unameSize;
+		kdb_unsigned_long_long_t type;
+		const char * value;
+		kdb_unsigned_long_long_t valueSize;
+		kdb_unsigned_long_long_t metaCount;
+
+		if (!readName (&reader, &name, &nameSize, &uname, &unameSize) || !readWord (&reader, &type) ||
+		    !readPayload (&reader, &value, &valueSize) || !readWord (&reader, &metaCount))
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Premature end of file or invalid key name");
+			goto error;
+		}
+
+		if (type != 'b' && (type != 's' || valueSize == 0 || value[valueSize - 1] != '\0'))
+		{
+			ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Invalid value of type %c", (char) type);
+			goto error;
+		}
+
+		// only names at or below the stored parent name are accepted, files written with /noparent store no parent name
+		bool isBelow = prefixSize == 0 || (nameSize - 1 >= prefixSize && memcmp (name, prefix, prefixSize) == 0 &&
+						   (name[prefixSize] == '\0' || name[prefixSize] == '/' || name[prefixSize - 1] == '/'));
+
+		if (isBelow && sameParent)
+		{
+			if (isValidName (name, nameSize, uname, unameSize))
+			{
+				key = newKey (newKeyName (name, nameSize, uname, unameSize, inMmap));
+			}
+		}
+		else if (isBelow)
+		{
+			char * fullName = elektraFormat ("%s/%s", keyName (parentKey), &name[prefixSize]);
+			key = keyNew (fullName, KEY_END);
+			elektraFree (fullName);
+		}
+
+		if (key == NULL)
+		{
+			ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Invalid key name '%s'", name);
+			goto error;
+		}
+
+		key->keyData = newKeyData (value, valueSize, inMmap);
+
+		if (metaCount > (size - reader.offset) / sizeof (kdb_unsigned_long_long_t))
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid meta count " ELEKTRA_UNSIGNED_LONG_LONG_F, metaCount);
+			goto error;
+		}
+
+		if (metaCount > 0)
+		{
+			key->meta = ksNew (metaCount, KS_END);
+		}
+
+		for (kdb_unsigned_long_long_t j = 0; j < metaCount; ++j)
+		{
+			kdb_unsigned_long_long_t metaType;
+			if (!readWord (&reader, &metaType))
+			{
+				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Premature end of file");
+				goto error;
+			}
+
+			switch (metaType)
+			{
+			case 'm': {
+				if (!readName (&reader, &name, &nameSize, &uname, &unameSize) || uname[0] != KEY_NS_META ||
+				    !isValidName (name, nameSize, uname, unameSize) || !readPayload (&reader, &value, &valueSize) ||
+				    (valueSize > 0 && value[valueSize - 1] != '\0'))
+				{
+					ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Premature end of file or invalid meta key");
+					goto error;
+				}
+
+				Key * meta = newKey (newKeyName (name, nameSize, uname, unameSize, false));
+				meta->keyData = newKeyData (value, valueSize, false);
+				meta->hasReadOnlyName = true;
+				meta->hasReadOnlyValue = true;
+				meta->hasReadOnlyMeta = true;
+				ksAppendKey (key->meta, meta);
+
+				if (metaSize == metaAlloc)
+				{
+					metaAlloc *= 2;
+					elektraRealloc ((void **) &metaKeys, metaAlloc * sizeof (Key *));
+				}
+				metaKeys[metaSize++] = meta;
+				break;
+			}
+			case 'c': {
+				// copy meta
+				kdb_unsigned_long_long_t index;
+				if (!readWord (&reader, &index) || index >= metaSize)
+				{
+					ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey,
+										"Premature end of file or invalid meta reference");
+					goto error;
+				}
+				ksAppendKey (key->meta, metaKeys[index]);
+				break;
+			}
+			default:
+				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Unknown meta type %c", (char) metaType);
+				goto error;
+			}
+		}
+
+		if (type == 'b' && !keyIsBinary (key))
+		{
+			keySetMeta (key, "binary", "");
+		}
+
+		ksAppendKey (keys, key);
+		key = NULL;
+	}
+
+	if (reader.offset != reader.size)
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Unexpected data after last key");
+		goto error;
+	}
+
+	elektraFree (metaKeys);
+	ksAppend (returned, keys);
+	if (read != NULL)
+	{
+		ksAppend (read, keys);
+	}
+	ksDel (keys);
+	return keyCount;
+
+error:
+	keyDel (key);
+	elektraFree (metaKeys);
+	ksDel (keys);
+	return -1;
+}
+
+/**
+ * Reads the rest of @p file into memory, leaving space for the magic number at the start.
+ *
+ * Used for files that cannot be mapped, e.g. pipes.
+ */
+static char * readRemaining (FILE * file, size_t * size)
+{
+	size_t alloc = 4096;
+	size_t used = sizeof (kdb_unsigned_long_long_t);
+	char * buffer = elektraMalloc (alloc);
+
+	size_t read;
+	while ((read = fread (&buffer[used], sizeof (char), alloc - used, file)) > 0)
+	{
+		used += read;
+		if (used == alloc)
+		{
+			alloc *= 2;
+			elektraRealloc ((void **) &buffer, alloc);
+		}
+	}
+
+	if (ferror (file))
+	{
+		elektraFree (buffer);
+		return NULL;
+	}
+
+	*size = used;
+	return buffer;
+}
+
+#ifndef _WIN32
+/**
+ * Removes all mappings, whose keys are no longer used.
+ */
+static void unmapUnused (Plugin * handle)
+{
+	struct v4Mapping * mappings = elektraPluginGetData (handle);
+	struct v4Mapping ** next = &mappings;
+	while (*next != NULL)
+	{
+		struct v4Mapping * mapping = *next;
+		if (elektraKsFlatMapInUse (mapping->keys))
+		{
+			next = &mapping->next;
+			continue;
+		}
+
+		*next = mapping->next;
+		ksDel (mapping->keys);
+		munmap (mapping->data, mapping->size);
+		elektraFree (mapping);
+	}
+	elektraPluginSetData (handle, mappings);
+}
+#endif
+
+static int readFileV4 (Plugin * handle, FILE * file, KeySet * returned, Key * parentKey)
+{
+#ifndef _WIN32
+	struct stat buf;
+	if (fstat (fileno (file), &buf) == 0 && S_ISREG (buf.st_mode))
+	{
+		size_t size = buf.st_size;
+		char * data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno (file), 0);
+		fclose (file);
+
+		if (data == MAP_FAILED)
+		{
+			ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not map file %s. Reason: %s", keyString (parentKey),
+						     strerror (errno));
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+
+		KeySet * keys = ksNew (0, KS_END);
+		ssize_t keyCount = readV4 (data, size, true, returned, keys, parentKey);
+		if (keyCount <= 0)
+		{
+			ksDel (keys);
+			munmap (data, size);
+			return keyCount < 0 ? ELEKTRA_PLUGIN_STATUS_ERROR : ELEKTRA_PLUGIN_STATUS_SUCCESS;
+		}
+
+		// the keys point into the mapping, it is removed by unmapUnused() once they are no longer used
+		struct v4Mapping * mapping = elektraMalloc (sizeof (struct v4Mapping));
+		mapping->data = data;
+		mapping->size = size;
+		mapping->keys = keys;
+		mapping->next = elektraPluginGetData (handle);
+		elektraPluginSetData (handle, mapping);
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	}
+#endif
+
+	size_t size;
+	char * data = readRemaining (file, &size);
+	fclose (file);
+
+	if (data == NULL)
+	{
+		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not read file %s", keyString (parentKey));
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	ssize_t keyCount = readV4 (data, size, false, returned, NULL, parentKey);
+	elektraFree (data);
+	return keyCount < 0 ? ELEKTRA_PLUGIN_STATUS_ERROR : ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+/**
+ * Removes all mappings of version 4 files, whose keys are no longer used.
+ *
+ * Mappings whose keys are still used outlive the plugin and are only removed when the process exits.
+ */
+int elektraQuickdumpClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+#ifndef _WIN32
+	unmapUnused (handle);
+	struct v4Mapping * mapping = elektraPluginGetData (handle);
+	while (mapping != NULL)
+	{
+		struct v4Mapping * next = mapping->next;
+		ksDel (mapping->keys);
+		elektraFree (mapping);
+		mapping = next;
+	}
+	elektraPluginSetData (handle, NULL);
+#endif
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+int elektraQuickdumpGet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	if (!elektraStrCmp (keyName (parentKey), "system:/elektra/modules/quickdump"))
 	{
 		KeySet * contract = ksNew (
 			30, keyNew ("system:/elektra/modules/quickdump", KEY_VALUE, "quickdump plugin waits for your orders", KEY_END),
 			keyNew ("system:/elektra/modules/quickdump/exports", KEY_END),
+			keyNew ("system:/elektra/modules/quickdump/exports/close", KEY_FUNC, elektraQuickdumpClose, KEY_END),
 			keyNew ("system:/elektra/modules/quickdump/exports/get", KEY_FUNC, elektraQuickdumpGet, KEY_END),
 			keyNew ("system:/elektra/modules/quickdump/exports/set", KEY_FUNC, elektraQuickdumpSet, KEY_END),
 #include ELEKTRA_README
@@ -123,6 +594,10 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	}
 	// get all keys
 
+#ifndef _WIN32
+	unmapUnused (handle);
+#endif
+
 	FILE * file = fopen (keyString (parentKey), "rb");
 
 	if (file == NULL)
@@ -156,8 +631,10 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		ELEKTRA_SET_RESOURCE_ERROR (parentKey, "Quickdump v2 no longer supported");
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	case MAGIC_NUMBER_V3:
-		// break, current version implemented below
+		// break, v3 is implemented below
 		break;
+	case MAGIC_NUMBER_V4:
+		return readFileV4 (handle, file, returned, parentKey);
 	default:
 		fclose (file);
 		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Unknown magic number " ELEKTRA_UNSIGNED_LONG_LONG_F, magic);
@@ -378,110 +855,51 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
-int elektraQuickdumpSet (Plugin * handle, KeySet * returned, Key * parentKey)
+static bool writeV3 (FILE * file, KeySet * returned, Key * parentKey, size_t parentOffset)
 {
-	FILE * file;
-
-	// cannot open stdout for writing, because its already open
-	if (elektraStrCmp (keyString (parentKey), STDOUT_FILENAME) == 0)
-	{
-		file = stdout;
-	}
-	else
-	{
-		file = fopen (keyString (parentKey), "wb");
-	}
-
-	if (file == NULL)
-	{
-		ELEKTRA_SET_ERROR_SET (parentKey);
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
-	}
-
-	// magic number is written big endian so EKDB magic string is readable
-	kdb_unsigned_long_long_t magic = htobe64 (MAGIC_NUMBER_V3);
-	if (fwrite (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
-	{
-		closeFile (file);
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
-	}
-
-	struct list metaKeys;
-	metaKeys.alloc = 16;
-	metaKeys.size = 0;
-	metaKeys.array = elektraMalloc (metaKeys.alloc * sizeof (struct metaLink *));
-
-	// we assume all keys in returned are below parentKey
-	size_t parentOffset = keyGetNameSize (parentKey);
-
-	// ... unless /noparent is in config, then we just take the full
-	// (cascading) keynames as relative to the parentKey
-	KeySet * config = elektraPluginGetConfig (handle);
-	if (ksLookupByName (config, "/noparent", 0) != NULL)
-	{
-		parentOffset = 1;
-	}
+	struct metaLinks metaLinks;
+	setupMetaLinks (&metaLinks);
 
+	bool success = false;
 	for (elektraCursor it = 0; it < ksGetSize (returned); ++it)
 	{
 		Key * cur = ksAtCursor (returned, it);
 		size_t fullNameSize = keyGetNameSize (cur);
 		if (fullNameSize < parentOffset)
 		{
-			closeFile (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			goto end;
 		}
 
 		kdb_unsigned_long_long_t nameSize = fullNameSize == parentOffset ? 0 : fullNameSize - 1 - parentOffset;
 		if (!writeData (file, keyName (cur) + parentOffset, nameSize, parentKey))
 		{
-			closeFile (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			goto end;
 		}
 
 		if (keyIsBinary (cur))
 		{
 			if (fputc ('b', file) == EOF)
 			{
-				closeFile (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				goto end;
 			}
 
 			kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur);
-
-			char * value = NULL;
-			if (valueSize > 0)
-			{
-				value = elektraMalloc (valueSize);
-				if (keyGetBinary (cur, value, valueSize) == -1)
-				{
-					closeFile (file);
-					elektraFree (value);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
-			}
-
-			if (!writeData (file, value, valueSize, parentKey))
+			if (!writeData (file, keyValue (cur), valueSize, parentKey))
 			{
-				closeFile (file);
-				elektraFree (value);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				goto end;
 			}
-			elektraFree (value);
 		}
 		else
 		{
 			if (fputc ('s', file) == EOF)
 			{
-				closeFile (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				goto end;
 			}
 
 			kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur) - 1;
 			if (!writeData (file, keyString (cur), valueSize, parentKey))
 			{
-				closeFile (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				goto end;
 			}
 		}
 
@@ -490,138 +908,378 @@ int elektraQuickdumpSet (Plugin * handle, KeySet * returned, Key * parentKey)
 		for (elektraCursor itMeta = 0; itMeta < ksGetSize (metaKS); ++itMeta)
 		{
 			const Key * meta = ksAtCursor (metaKS, itMeta);
-			ssize_t result = findMetaLink (&metaKeys, meta);
-			if (result < 0)
+			const struct metaLink * link = insertMetaLink (&metaLinks, meta, cur, parentOffset);
+			if (link == NULL)
 			{
 				if (fputc ('m', file) == EOF)
 				{
-					closeFile (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					goto end;
 				}
 
 				// ignore meta namespace when writing to file
 				kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
 				if (!writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, parentKey))
 				{
-					closeFile (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					goto end;
 				}
 
 				kdb_unsigned_long_long_t metaValueSize = keyGetValueSize (meta) - 1;
 				if (!writeData (file, keyString (meta), metaValueSize, parentKey))
 				{
-					closeFile (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					goto end;
 				}
-
-				insertMetaLink (&metaKeys, -result - 1, meta, cur, parentOffset);
 			}
 			else
 			{
 				if (fputc ('c', file) == EOF)
 				{
-					closeFile (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					goto end;
 				}
 
-				kdb_unsigned_long_long_t keyNameSize = metaKeys.array[result]->keyNameSize;
-				if (!writeData (file, metaKeys.array[result]->keyName, keyNameSize, parentKey))
+				if (!writeData (file, link->keyName, link->keyNameSize, parentKey))
 				{
-					closeFile (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					goto end;
 				}
 
 				// ignore meta namespace when writing to file
 				kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
 				if (!writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, parentKey))
 				{
-					closeFile (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					goto end;
 				}
 			}
 		}
 
 		if (fputc (0, file) == EOF)
 		{
-			closeFile (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			goto end;
 		}
 	}
+	success = true;
+
+end:
+	elektraFree (metaLinks.array);
+	return success;
+}
+
+static inline bool writeWord (FILE * file, kdb_unsigned_long_long_t value)
+{
+	value = htole64 (value);
+	return fwrite (&value, sizeof (kdb_unsigned_long_long_t), 1, file) == 1;
+}
+
+static inline bool writePayload (FILE * file, const void * data, kdb_unsigned_long_long_t size)
+{
+	static const char padding[V4_ALIGNMENT] = { 0 };
 
-	for (size_t i = 0; i < metaKeys.size; ++i)
+	size_t paddingSize = (V4_ALIGNMENT - size % V4_ALIGNMENT) % V4_ALIGNMENT;
+	return writeWord (file, size) && (size == 0 || fwrite (data, sizeof (char), size, file) == size) &&
+	       (paddingSize == 0 || fwrite (padding, sizeof (char), paddingSize, file) == paddingSize);
+}
+
+static inline bool writeName (FILE * file, const Key * key)
+{
+	return writePayload (file, keyName (key), keyGetNameSize (key)) &&
+	       writePayload (file, keyUnescapedName (key), keyGetUnescapedNameSize (key));
+}
+
+static bool writeV4 (FILE * file, KeySet * returned, Key * parentKey, size_t parentOffset)
+{
+	if (!writeWord (file, ksGetSize (returned)) || !writePayload (file, keyName (parentKey), parentOffset - 1))
 	{
-		elektraFree (metaKeys.array[i]);
+		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not write file %s. Reason: %s", keyString (parentKey), strerror (errno));
+		return false;
 	}
-	elektraFree (metaKeys.array);
 
-	closeFile (file);
+	struct metaLinks metaLinks;
+	setupMetaLinks (&metaLinks);
 
-	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	bool success = false;
+	for (elektraCursor it = 0; it < ksGetSize (returned); ++it)
+	{
+		Key * cur = ksAtCursor (returned, it);
+		if ((size_t) keyGetNameSize (cur) < parentOffset)
+		{
+			ELEKTRA_SET_INTERFACE_ERRORF (parentKey, "Key %s is not below the parent key %s", keyName (cur),
+						      keyName (parentKey));
+			goto end;
+		}
+
+		KeySet * metaKS = keyMeta (cur);
+		if (!writeName (file, cur) || !writeWord (file, keyIsBinary (cur) ? 'b' : 's') ||
+		    !writePayload (file, keyValue (cur), keyGetValueSize (cur)) || !writeWord (file, ksGetSize (metaKS)))
+		{
+			goto writeError;
+		}
+
+		for (elektraCursor itMeta = 0; itMeta < ksGetSize (metaKS); ++itMeta)
+		{
+			const Key * meta = ksAtCursor (metaKS, itMeta);
+			const struct metaLink * link = insertMetaLink (&metaLinks, meta, cur, parentOffset);
+			if (link == NULL)
+			{
+				if (!writeWord (file, 'm') || !writeName (file, meta) ||
+				    !writePayload (file, keyValue (meta), keyGetValueSize (meta)))
+				{
+					goto writeError;
+				}
+			}
+			else if (!writeWord (file, 'c') || !writeWord (file, link->index))
+			{
+				goto writeError;
+			}
+		}
+	}
+	success = true;
+	goto end;
+
+writeError:
+	ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not write file %s. Reason: %s", keyString (parentKey), strerror (errno));
+
+end:
+	elektraFree (metaLinks.array);
+	return success;
 }
 
-ssize_t findMetaLink (struct list * list, const Key * meta)
+/**
+ * Opens @p name for writing.
+ *
+ * Keys read from a v4 file may still point into its old contents and a truncated mapping causes SIGBUS,
+ * so existing regular files are not overwritten in place. Instead a temporary file with the same mode and
+ * owner is created next to the (symlink-resolved) file, which closeReplacement() renames over it.
+ *
+ * @param name      the file to write
+ * @param fileName  set to the resolved file name, if a temporary file is used
+ * @param tempName  set to the name of the temporary file, if one is used
+ * @param parentKey warnings are added here
+ *
+ * @return the opened file
+ * @retval NULL on error, errno is set
+ */
+static FILE * openReplacement (const char * name, char ** fileName, char ** tempName, Key * parentKey)
 {
-	const void * search = meta;
+#ifndef _WIN32
+	struct stat buf;
+	if (stat (name, &buf) != 0 || !S_ISREG (buf.st_mode))
+	{
+		// new files and special files (e.g. /dev/stdout) are written directly
+		return fopen (name, "wb");
+	}
 
-	if (list->size == 0)
+	char * resolved = realpath (name, NULL);
+	if (resolved == NULL)
 	{
-		return -1;
+		return NULL;
 	}
 
-	if (search > list->array[list->size - 1]->meta)
+	char * temp = elektraFormat ("%s.XXXXXX", resolved);
+	int fd = mkstemp (temp);
+	if (fd == -1)
 	{
-		return -(ssize_t) list->size - 1;
+		elektraFree (temp);
+		free (resolved);
+		return NULL;
 	}
 
-	ssize_t left = 0;
-	ssize_t right = list->size;
-	--right;
+	if (fchmod (fd, buf.st_mode & 07777) == -1)
+	{
+		ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not change permissions of temporary file '%s' to '%o'. Reason: %s", temp,
+					       buf.st_mode & 07777, strerror (errno));
+	}
+
+	if (fchown (fd, buf.st_uid, buf.st_gid) == -1)
+	{
+		ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not change owner of temporary file '%s' to %d.%d. Reason: %s", temp,
+					       buf.st_uid, buf.st_gid, strerror (errno));
+	}
+
+	FILE * file = fdopen (fd, "wb");
+	if (file == NULL)
+	{
+		int error = errno;
+		close (fd);
+		unlink (temp);
+		elektraFree (temp);
+		free (resolved);
+		errno = error;
+		return NULL;
+	}
 
-	ssize_t insertpos = 0;
+	*fileName = elektraStrDup (resolved);
+	*tempName = temp;
+	free (resolved);
+	return file;
+#else
+	(void) fileName;
+	(void) tempName;
+	(void) parentKey;
+	return fopen (name, "wb");
+#endif
+}
 
-	while (left <= right)
+/**
+ * Closes a file opened with openReplacement().
+ *
+ * If a temporary file was used, it replaces the original file on success and is removed otherwise.
+ *
+ * @retval true if the file was written successfully
+ * @retval false on error, @p parentKey contains the error
+ */
+static bool closeReplacement (FILE * file, char * fileName, char * tempName, bool success, Key * parentKey)
+{
+	if (tempName == NULL)
 	{
-		size_t middle = left + ((right - left) / 2);
+		closeFile (file);
+		return success;
+	}
 
-		if (list->array[middle]->meta < search)
+	if (fclose (file) != 0 && success)
+	{
+		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not write file %s. Reason: %s", tempName, strerror (errno));
+		success = false;
+	}
+
+	if (success && rename (tempName, fileName) == -1)
+	{
+		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not rename file '%s'. Reason: %s", tempName, strerror (errno));
+		success = false;
+	}
+
+	if (!success)
+	{
+		unlink (tempName);
+	}
+
+	elektraFree (fileName);
+	elektraFree (tempName);
+	return success;
+}
+
+int elektraQuickdumpSet (Plugin * handle, KeySet * returned, Key * parentKey)
+{
+	KeySet * config = elektraPluginGetConfig (handle);
+
+	kdb_unsigned_long_long_t version = 3;
+	const Key * versionKey = ksLookupByName (config, "/version", 0);
+	if (versionKey != NULL)
+	{
+		if (elektraStrCmp (keyString (versionKey), "4") == 0)
 		{
-			insertpos = left = middle + 1;
+			version = 4;
 		}
-		else if (list->array[middle]->meta == search)
+		else if (elektraStrCmp (keyString (versionKey), "3") != 0)
 		{
-			return middle;
+			ELEKTRA_SET_INSTALLATION_ERRORF (parentKey, "Unsupported quickdump version '%s', use 3 or 4",
+							 keyString (versionKey));
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
 		}
-		else
+	}
+
+	FILE * file;
+	char * fileName = NULL;
+	char * tempName = NULL;
+
+	// cannot open stdout for writing, because its already open
+	if (elektraStrCmp (keyString (parentKey), STDOUT_FILENAME) == 0)
+	{
+		file = stdout;
+	}
+	else
+	{
+		file = openReplacement (keyString (parentKey), &fileName, &tempName, parentKey);
+	}
+
+	if (file == NULL)
+	{
+		ELEKTRA_SET_ERROR_SET (parentKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	// magic number is written big endian so EKDB magic string is readable
+	kdb_unsigned_long_long_t magic = htobe64 (version == 3 ? MAGIC_NUMBER_V3 : MAGIC_NUMBER_V4);
+	if (fwrite (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
+	{
+		closeReplacement (file, fileName, tempName, false, parentKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	// we assume all keys in returned are below parentKey
+	size_t parentOffset = keyGetNameSize (parentKey);
+
+	// ... unless /noparent is in config, then we just take the full
+	// (cascading) keynames as relative to the parentKey
+	if (ksLookupByName (config, "/noparent", 0) != NULL)
+	{
+		parentOffset = 1;
+	}
+
+	bool success = version == 3 ? writeV3 (file, returned, parentKey, parentOffset) : writeV4 (file, returned, parentKey, parentOffset);
+
+	success = closeReplacement (file, fileName, tempName, success, parentKey) && success;
+
+	return success ? ELEKTRA_PLUGIN_STATUS_SUCCESS : ELEKTRA_PLUGIN_STATUS_ERROR;
+}
+
+void setupMetaLinks (struct metaLinks * links)
+{
+	links->alloc = 64;
+	links->size = 0;
+	links->array = elektraCalloc (links->alloc * sizeof (struct metaLink));
+}
+
+static struct metaLink * findMetaLink (struct metaLink * array, size_t alloc, const Key * meta)
+{
+	// mix the address, its lower bits are always zero because of the alignment
+	uint64_t hash = (uintptr_t) meta;
+	hash ^= hash >> 33;
+	hash *= UINT64_C (0xff51afd7ed558ccd);
+	hash ^= hash >> 33;
+
+	const size_t mask = alloc - 1;
+	for (size_t i = hash & mask;; i = (i + 1) & mask)
+	{
+		if (array[i].meta == meta || array[i].meta == NULL)
 		{
-			insertpos = middle;
-			right = middle - 1;
+			return &array[i];
 		}
 	}
-
-	return -insertpos - 1;
 }
 
-void insertMetaLink (struct list * list, size_t index, const Key * meta, Key * key, size_t parentOffset)
+/**
+ * Looks up @p meta and inserts it together with @p key if it is missing.
+ *
+ * @return the link of the key @p meta was written with first or NULL, if @p meta was inserted
+ */
+const struct metaLink * insertMetaLink (struct metaLinks * links, const Key * meta, Key * key, size_t parentOffset)
 {
-	if (list->size + 1 >= list->alloc)
+	if (2 * (links->size + 1) > links->alloc)
+	{
+		size_t alloc = 2 * links->alloc;
+		struct metaLink * array = elektraCalloc (alloc * sizeof (struct metaLink));
+		for (size_t i = 0; i < links->alloc; ++i)
+		{
+			if (links->array[i].meta != NULL)
+			{
+				*findMetaLink (array, alloc, links->array[i].meta) = links->array[i];
+			}
+		}
+		elektraFree (links->array);
+		links->array = array;
+		links->alloc = alloc;
+	}
+
+	struct metaLink * link = findMetaLink (links->array, links->alloc, meta);
+	if (link->meta == meta)
 	{
-		list->alloc *= 2;
-		elektraRealloc ((void **) &list->array, sizeof (struct metaLink *) * list->alloc);
+		return link;
 	}
 
-	struct metaLink * link = elektraMalloc (sizeof (struct metaLink));
 	link->meta = meta;
 	size_t fullNameSize = keyGetNameSize (key);
 	link->keyNameSize = fullNameSize <= parentOffset ? 0 : fullNameSize - 1 - parentOffset;
 	link->keyName = keyName (key) + parentOffset;
-
-	if (index < list->size)
-	{
-		memmove (&list->array[index + 1], &list->array[index], (list->size - index) * sizeof (struct metaLink *));
-	}
-
-	list->array[index] = link;
-	++list->size;
+	link->index = links->size++;
+	return NULL;
 }
 
 void setupBuffer (struct stringbuffer * buffer, size_t initialAlloc)
@@ -650,6 +1308,7 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 {
 	// clang-format off
 	return elektraPluginExport ("quickdump",
+				    ELEKTRA_PLUGIN_CLOSE,	&elektraQuickdumpClose,
 				    ELEKTRA_PLUGIN_GET,	&elektraQuickdumpGet,
 				    ELEKTRA_PLUGIN_SET,	&elektraQuickdumpSet,
 				    ELEKTRA_PLUGIN_END);
@@ -13,6 +13,7 @@
 #include <kdbplugin.h>
 
 
+int elektraQuickdumpClose (Plugin * handle, Key * errorKey);
 int elektraQuickdumpGet (Plugin * handle, KeySet * ks, Key * parentKey);
 int elektraQuickdumpSet (Plugin * handle, KeySet * ks, Key * parentKey);
 
@@ -11,11 +11,13 @@
 #include <string.h>
 
 #include <kdbconfig.h>
+#include <kdbprivate.h>
 #include <kdbtypes.h>
 
 #include <tests_plugin.h>
 
 #include <stdio.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "quickdump/test.quickdump.h"
@@ -122,9 +124,9 @@ static void test_basics (void)
 	ksDel (ks);
 }
 
-static void test_noParent (void)
+static void test_noParent (const char * version, const unsigned char * data, size_t dataSize)
 {
-	printf ("test noparent\n");
+	printf ("test noparent (v%s)\n", version);
 
 	KeySet * input = ksNew (2, keyNew ("/", KEY_VALUE, "value", KEY_END), keyNew ("/a", KEY_VALUE, "value1", KEY_END), KS_END);
 	KeySet * expected = ksNew (2, keyNew ("dir:/tests/bench", KEY_VALUE, "value", KEY_END),
@@ -134,13 +136,13 @@ static void test_noParent (void)
 	{
 		Key * setKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
 
-		KeySet * conf = ksNew (1, keyNew ("user:/noparent", KEY_END), KS_END);
+		KeySet * conf =
+			ksNew (2, keyNew ("user:/noparent", KEY_END), keyNew ("user:/version", KEY_VALUE, version, KEY_END), KS_END);
 		PLUGIN_OPEN ("quickdump");
 
 		succeed_if (plugin->kdbSet (plugin, input, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
 
-		succeed_if (check_binary_file (outfile, test_quickdump_noParent_data, test_quickdump_noParent_dataSize) == 0,
-			    "files differ");
+		succeed_if (check_binary_file (outfile, data, dataSize) == 0, "files differ");
 
 		keyDel (setKey);
 		PLUGIN_CLOSE ();
@@ -170,9 +172,9 @@ static void test_noParent (void)
 	ksDel (expected);
 }
 
-static void test_parentKeyValue (void)
+static void test_parentKeyValue (const char * version, const unsigned char * data, size_t dataSize)
 {
-	printf ("test parent key value\n");
+	printf ("test parent key value (v%s)\n", version);
 
 	KeySet * expected = ksNew (1, keyNew ("dir:/tests/bench", KEY_VALUE, "value", KEY_END), KS_END);
 	char * outfile = elektraStrDup (elektraFilename ());
@@ -180,14 +182,13 @@ static void test_parentKeyValue (void)
 	{
 		Key * setKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
 
-		KeySet * conf = ksNew (0, KS_END);
+		KeySet * conf = ksNew (1, keyNew ("user:/version", KEY_VALUE, version, KEY_END), KS_END);
 		PLUGIN_OPEN ("quickdump");
 
 		succeed_if (plugin->kdbSet (plugin, expected, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS,
 			    "call to kdbSet was not successful");
 
-		succeed_if (check_binary_file (outfile, test_quickdump_parentKeyValue_data, test_quickdump_parentKeyValue_dataSize) == 0,
-			    "files differ");
+		succeed_if (check_binary_file (outfile, data, dataSize) == 0, "files differ");
 
 		keyDel (setKey);
 		PLUGIN_CLOSE ();
@@ -216,6 +217,259 @@ static void test_parentKeyValue (void)
 	ksDel (expected);
 }
 
+static void test_v4 (void)
+{
+	printf ("test v4\n");
+
+	KeySet * expected = test_quickdump_expected ();
+	char * outfile = elektraStrDup (elektraFilename ());
+
+	Key * parentKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
+	KeySet * conf = ksNew (1, keyNew ("user:/version", KEY_VALUE, "4", KEY_END), KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	succeed_if (plugin->kdbSet (plugin, expected, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, actual, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (expected, actual);
+
+	Key * k1 = ksLookupByName (actual, "dir:/tests/bench/__112", 0);
+	Key * k8 = ksLookupByName (actual, "dir:/tests/bench/__911", 0);
+	succeed_if (keyGetMeta (k1, "meta/_35") == keyGetMeta (k8, "meta/_35"), "copy meta failed");
+	succeed_if (isKeyNameInMmap (k1->keyName) && isKeyDataInMmap (k1->keyData), "key should point into the file");
+	succeed_if (!isKeyNameInMmap (keyGetMeta (k1, "meta/_39")->keyName), "metakey should be copied");
+	succeed_if (keyIsBinary (ksLookupByName (actual, "dir:/tests/bench/__114", 0)), "binary key not binary");
+
+	// overwriting the file must not affect keys that point into it
+	succeed_if (plugin->kdbSet (plugin, actual, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	succeed_if_same_string (keyString (k1), "gQHLlzB36CqIFlf");
+
+	// modifications copy the data out of the mapping
+	Key * dup = keyDup (k1, KEY_CP_ALL);
+	keySetString (k1, "changed");
+	keySetName (dup, "dir:/tests/bench/__113");
+	succeed_if (!isKeyDataInMmap (k1->keyData), "value still in file");
+	succeed_if_same_string (keyString (k1), "changed");
+	succeed_if_same_string (keyName (dup), "dir:/tests/bench/__113");
+	succeed_if_same_string (keyString (dup), "gQHLlzB36CqIFlf");
+	keyDel (dup);
+
+	ksDel (actual);
+	PLUGIN_CLOSE ();
+
+	remove (outfile);
+	keyDel (parentKey);
+	elektraFree (outfile);
+	ksDel (expected);
+}
+
+static void test_v4Unmap (void)
+{
+	printf ("test v4 unmap\n");
+
+	KeySet * expected = test_quickdump_expected ();
+	char * outfile = elektraStrDup (elektraFilename ());
+
+	Key * parentKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
+	Key * missingKey = keyNew ("dir:/tests/bench", KEY_VALUE, "/does/not/exist.quickdump", KEY_END);
+	KeySet * conf = ksNew (1, keyNew ("user:/version", KEY_VALUE, "4", KEY_END), KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	succeed_if (plugin->kdbSet (plugin, expected, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, actual, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	succeed_if (elektraPluginGetData (plugin) != NULL, "mapping not recorded");
+
+	// a copy shares the value in the mapping
+	Key * kept = keyDup (ksLookupByName (actual, "dir:/tests/bench/__112", 0), KEY_CP_ALL);
+	ksDel (actual);
+
+	KeySet * ks = ksNew (0, KS_END);
+	plugin->kdbGet (plugin, ks, missingKey);
+	succeed_if (elektraPluginGetData (plugin) != NULL, "mapping removed while in use");
+	succeed_if_same_string (keyString (kept), "gQHLlzB36CqIFlf");
+
+	keyDel (kept);
+	plugin->kdbGet (plugin, ks, missingKey);
+	succeed_if (elektraPluginGetData (plugin) == NULL, "unused mapping not removed");
+	ksDel (ks);
+
+	// close removes unused mappings
+	actual = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, actual, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	ksDel (actual);
+	PLUGIN_CLOSE ();
+
+	remove (outfile);
+	keyDel (missingKey);
+	keyDel (parentKey);
+	elektraFree (outfile);
+	ksDel (expected);
+}
+
+static void test_v4OtherParent (void)
+{
+	printf ("test v4 with other parent\n");
+
+	KeySet * input = test_quickdump_expected ();
+	char * outfile = elektraStrDup (elektraFilename ());
+
+	Key * setKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
+	Key * getKey = keyNew ("user:/other", KEY_VALUE, outfile, KEY_END);
+	KeySet * conf = ksNew (1, keyNew ("user:/version", KEY_VALUE, "4", KEY_END), KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	succeed_if (plugin->kdbSet (plugin, input, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, actual, getKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	succeed_if (ksGetSize (actual) == ksGetSize (input), "wrong number of keys");
+
+	Key * k1 = ksLookupByName (actual, "user:/other/__112", 0);
+	Key * k8 = ksLookupByName (actual, "user:/other/__911", 0);
+	exit_if_fail (k1 != NULL && k8 != NULL, "keys not found below other parent");
+	succeed_if_same_string (keyString (k1), "gQHLlzB36CqIFlf");
+	succeed_if_same_string (keyString (keyGetMeta (k1, "meta/_90")), "0kCcc1pK7hOgY3F");
+	succeed_if (keyGetMeta (k1, "meta/_35") == keyGetMeta (k8, "meta/_35"), "copy meta failed");
+	succeed_if (!isKeyNameInMmap (k1->keyName) && isKeyDataInMmap (k1->keyData), "only the value should point into the file");
+
+	ksDel (actual);
+	PLUGIN_CLOSE ();
+
+	remove (outfile);
+	keyDel (setKey);
+	keyDel (getKey);
+	elektraFree (outfile);
+	ksDel (input);
+}
+
+static void test_v4Pipe (void)
+{
+	printf ("test v4 from pipe\n");
+
+	int fds[2];
+	exit_if_fail (pipe (fds) == 0, "could not create pipe");
+	succeed_if (write (fds[1], test_quickdump_parentKeyValueV4_data, test_quickdump_parentKeyValueV4_dataSize) ==
+			    (ssize_t) test_quickdump_parentKeyValueV4_dataSize,
+		    "could not write to pipe");
+	close (fds[1]);
+
+	char * infile = elektraFormat ("/dev/fd/%d", fds[0]);
+	Key * getKey = keyNew ("dir:/tests/bench", KEY_VALUE, infile, KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	KeySet * expected = ksNew (1, keyNew ("dir:/tests/bench", KEY_VALUE, "value", KEY_END), KS_END);
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, actual, getKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (expected, actual);
+	succeed_if (!isKeyNameInMmap (ksAtCursor (actual, 0)->keyName), "key from pipe cannot be mapped");
+
+	ksDel (expected);
+	ksDel (actual);
+	PLUGIN_CLOSE ();
+
+	close (fds[0]);
+	keyDel (getKey);
+	elektraFree (infile);
+}
+
+static void check_invalid (Plugin * plugin, Key * getKey)
+{
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, actual, getKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "invalid file should not be read");
+	succeed_if (ksGetSize (actual) == 0, "keys of invalid file returned");
+	succeed_if (keyGetMeta (getKey, "error") != NULL, "no error set");
+	keySetMeta (getKey, "error", NULL);
+	ksDel (actual);
+}
+
+static void test_v4Invalid (void)
+{
+	printf ("test invalid v4\n");
+
+	char * infile = elektraStrDup (elektraFilename ());
+	Key * getKey = keyNew ("dir:/tests/bench", KEY_VALUE, infile, KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	// truncated value, data after the last key
+	size_t sizes[] = { test_quickdump_parentKeyValueV4_dataSize - 16, test_quickdump_parentKeyValueV4_dataSize + 8 };
+	for (size_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i)
+	{
+		FILE * file = fopen (infile, "wb");
+		fwrite (test_quickdump_parentKeyValueV4_data, 1, test_quickdump_parentKeyValueV4_dataSize, file);
+		fwrite ("\0\0\0\0\0\0\0\0", 1, 8, file);
+		fclose (file);
+		succeed_if (truncate (infile, sizes[i]) == 0, "could not truncate file");
+
+		check_invalid (plugin, getKey);
+	}
+
+	// the names are used directly, because the parent is the same:
+	// name not below the parent (dir:/tests/bencx), unescaped name does not match the name
+	size_t offsets[] = { 63, 88 };
+	for (size_t i = 0; i < sizeof (offsets) / sizeof (offsets[0]); ++i)
+	{
+		unsigned char * data = elektraMemDup (test_quickdump_parentKeyValueV4_data, test_quickdump_parentKeyValueV4_dataSize);
+		data[offsets[i]] = 'x';
+
+		FILE * file = fopen (infile, "wb");
+		fwrite (data, 1, test_quickdump_parentKeyValueV4_dataSize, file);
+		fclose (file);
+		elektraFree (data);
+
+		check_invalid (plugin, getKey);
+	}
+
+	PLUGIN_CLOSE ();
+
+	remove (infile);
+	keyDel (getKey);
+	elektraFree (infile);
+}
+
+static void test_replaceFile (void)
+{
+	printf ("test replace file\n");
+
+	char * target = elektraStrDup (elektraFilename ());
+	char * link = elektraFormat ("%s.link", target);
+	KeySet * ks = ksNew (1, keyNew ("dir:/tests/bench", KEY_VALUE, "value", KEY_END), KS_END);
+
+	FILE * file = fopen (target, "wb");
+	fclose (file);
+	succeed_if (chmod (target, 0640) == 0, "could not change mode");
+	succeed_if (symlink (target, link) == 0, "could not create symlink");
+
+	Key * parentKey = keyNew ("dir:/tests/bench", KEY_VALUE, link, KEY_END);
+	KeySet * conf = ksNew (1, keyNew ("user:/version", KEY_VALUE, "4", KEY_END), KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	// write twice, the second write replaces a file that is still mapped
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, actual, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	succeed_if (plugin->kdbSet (plugin, actual, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	compare_keyset (ks, actual);
+
+	struct stat buf;
+	succeed_if (lstat (link, &buf) == 0 && S_ISLNK (buf.st_mode), "symlink was replaced");
+	succeed_if (stat (target, &buf) == 0 && (buf.st_mode & 07777) == 0640, "mode of the file was not kept");
+
+	ksDel (actual);
+	PLUGIN_CLOSE ();
+
+	remove (link);
+	remove (target);
+	keyDel (parentKey);
+	elektraFree (link);
+	elektraFree (target);
+	ksDel (ks);
+}
+
 #include "varint.c"
 
 static void test_varint (void)
@@ -276,8 +530,16 @@ int main (int argc, char ** argv)
 	test_varint ();
 
 	test_basics ();
-	test_noParent ();
-	test_parentKeyValue ();
+	test_noParent ("3", test_quickdump_noParent_data, test_quickdump_noParent_dataSize);
+	test_noParent ("4", test_quickdump_noParentV4_data, test_quickdump_noParentV4_dataSize);
+	test_parentKeyValue ("3", test_quickdump_parentKeyValue_data, test_quickdump_parentKeyValue_dataSize);
+	test_parentKeyValue ("4", test_quickdump_parentKeyValueV4_data, test_quickdump_parentKeyValueV4_dataSize);
+	test_v4 ();
+	test_v4Unmap ();
+	test_v4OtherParent ();
+	test_v4Pipe ();
+	test_v4Invalid ();
+	test_replaceFile ();
 
 	print_result ("testmod_quickdump");
 
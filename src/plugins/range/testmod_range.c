@@ -99,6 +99,27 @@ void testChar (const char * value, int ret, const char * rangeString)
 	PLUGIN_CLOSE ();
 }
 
+void testUnchanged (void)
+{
+	Key * parentKey = keyNew ("user:/tests/range", KEY_VALUE, "", KEY_END);
+	Key * key = keyNew ("user:/tests/range/key", KEY_VALUE, "0", KEY_META, "check/range", "1-10", KEY_END);
+	KeySet * ks = ksNew (10, key, KS_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("range");
+
+	// an invalid value in the file only causes a warning in kdbGet
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == 1, "kdbGet should only warn");
+	succeed_if (keyGetMeta (parentKey, "warnings") != NULL, "no warning for invalid value");
+
+	// kdbSet must still reject it, even though the key was not changed since kdbGet
+	keyClearSync (key);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == -1, "unchanged invalid key should be rejected");
+
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("RANGE     TESTS\n");
@@ -193,6 +214,8 @@ int main (int argc, char ** argv)
 	snprintf (number, 256, "%llu", 1ULL);
 	testUInt (number, 1, range);
 
+	testUnchanged ();
+
 	setlocale (LC_ALL, old_locale);
 	elektraFree (old_locale);
 	print_result ("testmod_range");
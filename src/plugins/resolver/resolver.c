@@ -40,6 +40,14 @@
 #include <pthread.h>
 #endif
 
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+#include <sys/inotify.h>
+
+/** events on the directory that may change the resolved file */
+#define ELEKTRA_RESOLVER_INOTIFY_MASK                                                                                                      \
+	(IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF)
+#endif
+
 #ifdef ELEKTRA_LOCK_MUTEX
 #if defined(PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP)
 static pthread_mutex_t elektraResolverMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
@@ -62,6 +70,8 @@ static void resolverInit (resolverHandle * p, const char * path)
 	p->dirmode = KDB_FILE_MODE | KDB_DIR_MODE;
 	p->removalNeeded = 0;
 	p->isMissing = 0;
+	p->isDirty = 1;
+	p->watch = -1;
 	p->timeFix = 1;
 
 	p->filename = 0;
@@ -114,6 +124,18 @@ static void resolverCloseOne (resolverHandle * p)
 
 static void resolverClose (resolverHandles * p)
 {
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+	if (p->inotifyOp)
+	{
+		elektraIoBindingRemoveFd (p->inotifyOp);
+		elektraFree (p->inotifyOp);
+	}
+	if (p->inotifyFd != -1)
+	{
+		close (p->inotifyFd);
+	}
+#endif
+
 	// shared by all, freed at the end
 	char * path = (char *) p->system.path;
 	resolverCloseOne (&p->spec);
@@ -441,6 +463,10 @@ static int initHandles (Plugin * handle, Key * parentKey)
 	resolverInit (&p->dir, path);
 	resolverInit (&p->user, path);
 	resolverInit (&p->system, path);
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+	p->inotifyFd = -1;
+	p->inotifyOp = NULL;
+#endif
 
 #if defined(ELEKTRA_RESOLVER_RECURSIVE_MUTEX_INITIALIZATION)
 	// PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP is available in glibc only
@@ -489,12 +515,174 @@ static int initHandles (Plugin * handle, Key * parentKey)
 
 	if (ret != -1)
 	{
+		if (ksLookupByName (elektraPluginGetConfig (handle), "/inotify", 0) != NULL)
+		{
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+			p->inotifyFd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+			if (p->inotifyFd == -1)
+			{
+				ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not create inotify instance. Reason: %s",
+							       strerror (errno));
+			}
+#else
+			ELEKTRA_ADD_INSTALLATION_WARNING (parentKey, "The resolver was compiled without inotify, falling back to stat()");
+#endif
+		}
 		elektraPluginSetData (handle, p);
 	}
 
 	return ret;
 }
 
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+
+/**
+ * @brief Mark a handle dirty if an inotify event concerns its file
+ *
+ * @param pk the handle to check
+ * @param event the event read from the inotify instance
+ */
+static void resolverMarkDirty (resolverHandle * pk, const struct inotify_event * event)
+{
+	if (pk->watch == -1 || pk->watch != event->wd)
+	{
+		return;
+	}
+
+	if (event->mask & IN_IGNORED)
+	{
+		// directory was removed, watch it again with the next kdbGet()
+		pk->watch = -1;
+		pk->isDirty = 1;
+		return;
+	}
+
+	const char * basename = strrchr (pk->filename, '/');
+	basename = basename ? basename + 1 : pk->filename;
+	if (event->len == 0 || strcmp (event->name, basename) == 0)
+	{
+		pk->isDirty = 1;
+	}
+}
+
+/**
+ * @brief Read all pending inotify events without blocking
+ *
+ * If the event queue overflowed or cannot be read, all
+ * handles are marked dirty, so that they fall back to stat().
+ *
+ * @param p the handles of the plugin
+ */
+static void resolverReadEvents (resolverHandles * p)
+{
+	char buffer[4096] __attribute__ ((aligned (__alignof__ (struct inotify_event))));
+	int errnoSave = errno;
+
+	for (;;)
+	{
+		ssize_t length = read (p->inotifyFd, buffer, sizeof (buffer));
+		if (length <= 0)
+		{
+			if (length == -1 && errno != EAGAIN && errno != EINTR)
+			{
+				ELEKTRA_LOG_WARNING ("could not read inotify events: %s", strerror (errno));
+				p->spec.isDirty = p->dir.isDirty = p->user.isDirty = p->system.isDirty = 1;
+			}
+			break;
+		}
+
+		const struct inotify_event * event;
+		for (char * current = buffer; current < buffer + length; current += sizeof (struct inotify_event) + event->len)
+		{
+			event = (const struct inotify_event *) current;
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				ELEKTRA_LOG_DEBUG ("inotify queue overflow, falling back to stat()");
+				p->spec.isDirty = p->dir.isDirty = p->user.isDirty = p->system.isDirty = 1;
+				continue;
+			}
+			resolverMarkDirty (&p->spec, event);
+			resolverMarkDirty (&p->dir, event);
+			resolverMarkDirty (&p->user, event);
+			resolverMarkDirty (&p->system, event);
+		}
+	}
+
+	errno = errnoSave;
+}
+
+static void resolverInotifyCallback (ElektraIoFdOperation * fdOp, int flags ELEKTRA_UNUSED)
+{
+	resolverReadEvents (elektraIoFdGetData (fdOp));
+}
+
+/**
+ * @brief Check if the file of a handle is unchanged according to inotify
+ *
+ * Registers the inotify instance with the I/O binding, if one is available,
+ * and starts watching the directory of the file. Pending events are always
+ * read directly, so that the result does not depend on whether the event
+ * loop ran since the last call.
+ *
+ * @param handle the plugin handle
+ * @param p the handles of the plugin
+ * @param pk the handle of the file
+ *
+ * @retval 1 if no event concerning the file was received since the last stat()
+ * @retval 0 if stat() is needed
+ */
+static int resolverIsUnchanged (Plugin * handle, resolverHandles * p, resolverHandle * pk)
+{
+	if (p->inotifyFd == -1)
+	{
+		return 0;
+	}
+
+	if (p->inotifyOp == NULL)
+	{
+		Key * binding = ksLookupByName (elektraPluginGetGlobalKeySet (handle), "system:/elektra/io/binding", 0);
+		if (binding != NULL && keyGetValueSize (binding) == sizeof (ElektraIoInterface *))
+		{
+			ElektraIoInterface * ioBinding = *(ElektraIoInterface **) keyValue (binding);
+			p->inotifyOp = elektraIoNewFdOperation (p->inotifyFd, ELEKTRA_IO_READABLE, 1, resolverInotifyCallback, p);
+			if (!elektraIoBindingAddFd (ioBinding, p->inotifyOp))
+			{
+				ELEKTRA_LOG_WARNING ("could not add inotify instance to I/O binding");
+				elektraFree (p->inotifyOp);
+				p->inotifyOp = NULL;
+			}
+		}
+	}
+
+	// the instance is non-blocking, so this is cheap if the event loop already read all events
+	resolverReadEvents (p);
+
+	if (pk->watch == -1)
+	{
+		int errnoSave = errno;
+		pk->watch = inotify_add_watch (p->inotifyFd, pk->dirname, ELEKTRA_RESOLVER_INOTIFY_MASK);
+		if (pk->watch == -1)
+		{
+			// e.g. directory does not exist (yet)
+			ELEKTRA_LOG_DEBUG ("could not watch %s: %s", pk->dirname, strerror (errno));
+			errno = errnoSave;
+		}
+		pk->isDirty = 1;
+		return 0;
+	}
+
+	return !pk->isDirty;
+}
+
+#else
+
+static int resolverIsUnchanged (Plugin * handle ELEKTRA_UNUSED, resolverHandles * p ELEKTRA_UNUSED, resolverHandle * pk ELEKTRA_UNUSED)
+{
+	return 0;
+}
+
+#endif
+
 
 int ELEKTRA_PLUGIN_FUNCTION (open) (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 {
@@ -542,6 +730,13 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle, KeySet * returned, Key * par
 	resolverHandle * pk = elektraGetResolverHandle (handle, parentKey);
 	keySetString (parentKey, pk->filename);
 
+	if (resolverIsUnchanged (handle, elektraPluginGetData (handle), pk))
+	{
+		// no event since the last stat(), so storage has no job
+		return ELEKTRA_PLUGIN_STATUS_NO_UPDATE;
+	}
+	pk->isDirty = 0;
+
 	int errnoSave = errno;
 	struct stat buf;
 
@@ -20,6 +20,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+#include <kdbio.h>
+#endif
+
 #define ERROR_SIZE 1024
 
 typedef struct _resolverHandle resolverHandle;
@@ -32,6 +36,8 @@ struct _resolverHandle
 	mode_t dirmode;			///< The mode to set for new directories
 	unsigned int removalNeeded : 1; ///< Error on freshly created files need removal
 	unsigned int isMissing : 1;	///< when doing kdbGet(), no file was there
+	unsigned int isDirty : 1;	///< the file might have changed since the last stat()
+	int watch;			///< inotify watch descriptor of dirname or -1 if not watched
 	int timeFix;			///< time increment to use for fixing the time
 
 	char * dirname;	 ///< directory where real+temp file is
@@ -54,6 +60,11 @@ struct _resolverHandles
 	resolverHandle dir;
 	resolverHandle user;
 	resolverHandle system;
+
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+	int inotifyFd;			    ///< inotify instance watching the directories, -1 if not used
+	ElektraIoFdOperation * inotifyOp; ///< watch of inotifyFd, if an I/O binding is present
+#endif
 };
 
 void ELEKTRA_PLUGIN_FUNCTION (freeHandle) (ElektraResolved *);
@@ -10,7 +10,9 @@
 
 #include <kdbinternal.h>
 
+#include <fcntl.h>
 #include <langinfo.h>
+#include <sys/stat.h>
 
 #include "resolver.h"
 
@@ -292,6 +294,167 @@ void test_checkfile (void)
 	ksDel (modules);
 }
 
+static void test_inotify (void)
+{
+	printf ("Resolve with inotify\n");
+
+	int pathLen = tempHomeLen + strlen ("/inotify/elektra.ecf") + 1;
+	char * path = elektraMalloc (pathLen);
+	exit_if_fail (path != 0, "elektraMalloc failed");
+	snprintf (path, pathLen, "%s/inotify", tempHome);
+	mkdir (path, 0700);
+	snprintf (path, pathLen, "%s/inotify/elektra.ecf", tempHome);
+
+	FILE * file = fopen (path, "w");
+	exit_if_fail (file != NULL, "could not create file");
+	fputs ("a", file);
+	fclose (file);
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+
+	Key * parentKey = keyNew ("system:/", KEY_VALUE, path, KEY_END);
+	Plugin * plugin = elektraPluginOpen ("resolver", modules, ksNew (1, keyNew ("user:/inotify", KEY_END), KS_END), 0);
+	exit_if_fail (plugin, "could not load resolver plugin");
+
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "first get should read the file");
+	succeed_if_same_string (keyString (parentKey), path);
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "file was not modified");
+
+	resolverHandles * h = elektraPluginGetData (plugin);
+	exit_if_fail (h != 0, "no plugin handle");
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+	succeed_if (h->inotifyFd != -1, "inotify was not initialized");
+	succeed_if (h->system.watch != -1, "directory is not watched");
+	succeed_if (!h->system.isDirty, "unmodified file is dirty");
+#endif
+
+	file = fopen (path, "a");
+	exit_if_fail (file != NULL, "could not modify file");
+	fputs ("b", file);
+	fclose (file);
+	// timestamps might be too coarse to detect the modification
+	struct timespec times[2] = { { 0, UTIME_OMIT }, { h->system.mtime.tv_sec + 1, 0 } };
+	succeed_if (utimensat (AT_FDCWD, path, times, 0) == 0, "could not update modification time");
+
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "modification was not detected");
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "file was not modified again");
+
+	unlink (path);
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "missing file should not be read");
+	succeed_if (h->system.isMissing, "removal was not detected");
+
+	keyDel (parentKey);
+	elektraPluginClose (plugin, 0);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+	elektraFree (path);
+}
+
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+static int fdAdded;
+
+static int idleAddFd (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoFdOperation * fdOp ELEKTRA_UNUSED)
+{
+	fdAdded = 1;
+	return 1;
+}
+
+static int idleRemoveFd (ElektraIoFdOperation * fdOp ELEKTRA_UNUSED)
+{
+	fdAdded = 0;
+	return 1;
+}
+
+static int idleUpdateFd (ElektraIoFdOperation * fdOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int idleAddTimer (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoTimerOperation * timerOp ELEKTRA_UNUSED)
+{
+	return 0;
+}
+
+static int idleTimerOp (ElektraIoTimerOperation * timerOp ELEKTRA_UNUSED)
+{
+	return 0;
+}
+
+static int idleAddIdle (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoIdleOperation * idleOp ELEKTRA_UNUSED)
+{
+	return 0;
+}
+
+static int idleIdleOp (ElektraIoIdleOperation * idleOp ELEKTRA_UNUSED)
+{
+	return 0;
+}
+
+static int idleCleanup (ElektraIoInterface * binding)
+{
+	elektraFree (binding);
+	return 1;
+}
+
+static void test_inotifyIdleBinding (void)
+{
+	printf ("Resolve with inotify and an event loop that does not run\n");
+
+	int pathLen = tempHomeLen + strlen ("/inotifyidle/elektra.ecf") + 1;
+	char * path = elektraMalloc (pathLen);
+	exit_if_fail (path != 0, "elektraMalloc failed");
+	snprintf (path, pathLen, "%s/inotifyidle", tempHome);
+	mkdir (path, 0700);
+	snprintf (path, pathLen, "%s/inotifyidle/elektra.ecf", tempHome);
+
+	FILE * file = fopen (path, "w");
+	exit_if_fail (file != NULL, "could not create file");
+	fputs ("a", file);
+	fclose (file);
+
+	// the binding only records the operation, its loop never reads the inotify instance
+	ElektraIoInterface * binding = elektraIoNewBinding (idleAddFd, idleUpdateFd, idleRemoveFd, idleAddTimer, idleTimerOp, idleTimerOp,
+							   idleAddIdle, idleIdleOp, idleIdleOp, idleCleanup);
+	exit_if_fail (binding != NULL, "could not create I/O binding");
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+
+	Key * parentKey = keyNew ("system:/", KEY_VALUE, path, KEY_END);
+	Plugin * plugin = elektraPluginOpen ("resolver", modules, ksNew (1, keyNew ("user:/inotify", KEY_END), KS_END), 0);
+	exit_if_fail (plugin, "could not load resolver plugin");
+	ksDel (plugin->global);
+	plugin->global =
+		ksNew (1, keyNew ("system:/elektra/io/binding", KEY_BINARY, KEY_SIZE, sizeof (binding), KEY_VALUE, &binding, KEY_END), KS_END);
+
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "first get should read the file");
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "file was not modified");
+	succeed_if (fdAdded, "inotify instance was not added to the binding");
+
+	resolverHandles * h = elektraPluginGetData (plugin);
+	exit_if_fail (h != 0, "no plugin handle");
+
+	file = fopen (path, "a");
+	exit_if_fail (file != NULL, "could not modify file");
+	fputs ("b", file);
+	fclose (file);
+	struct timespec times[2] = { { 0, UTIME_OMIT }, { h->system.mtime.tv_sec + 1, 0 } };
+	succeed_if (utimensat (AT_FDCWD, path, times, 0) == 0, "could not update modification time");
+
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "modification was not detected");
+
+	unlink (path);
+	keyDel (parentKey);
+	elektraPluginClose (plugin, 0);
+	succeed_if (!fdAdded, "inotify instance was not removed from the binding");
+	elektraIoBindingCleanup (binding);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+	elektraFree (path);
+}
+#endif
+
 static void check_xdg (void)
 {
 	KeySet * modules = ksNew (0, KS_END);
@@ -326,6 +489,10 @@ int main (int argc, char ** argv)
 	init (argc, argv);
 
 	test_checkfile ();
+	test_inotify ();
+#ifdef ELEKTRA_RESOLVER_INOTIFY
+	test_inotifyIdleBinding ();
+#endif
 
 	check_xdg ();
 
@@ -631,6 +631,35 @@ static void test_remove_meta (void)
 }
 
 
+static void test_hook_copy_unchanged (void)
+{
+	printf ("test %s\n", __func__);
+
+	KeySet * _conf = ksNew (2, keyNew ("user:/conflict/get", KEY_VALUE, "IGNORE", KEY_END),
+				keyNew ("user:/conflict/set", KEY_VALUE, "ERROR", KEY_END), KS_END);
+
+	TEST_BEGIN
+	{
+		Key * specKey = keyNew ("spec:/" PARENT_KEY "/a", KEY_META, "othermeta", "spec", KEY_END);
+		Key * key = keyNew ("user:/" PARENT_KEY "/a", KEY_META, "othermeta", "user", KEY_END);
+		KeySet * ks = ksNew (10, specKey, key, KS_END);
+
+		// the collision in the file is ignored in kdbGet
+		TEST_CHECK (elektraSpecCopy (plugin, ks, parentKey, true) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "hook spec/copy failed");
+		TEST_ON_FAIL (output_error (parentKey));
+
+		// kdbSet must still report it, even though neither key nor spec key were changed
+		keyClearSync (specKey);
+		keyClearSync (key);
+		succeed_if (elektraSpecCopy (plugin, ks, parentKey, false) == ELEKTRA_PLUGIN_STATUS_ERROR,
+			    "unchanged collision should be an error in kdbSet");
+
+		ksDel (ks);
+	}
+	TEST_END
+	ksDel (_conf);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("SPEC     TESTS\n");
@@ -648,6 +677,7 @@ int main (int argc, char ** argv)
 	test_hook_copy_require_array ();
 	test_hook_copy_array_member ();
 	test_remove_meta ();
+	test_hook_copy_unchanged ();
 
 	print_result ("testmod_spec");
 
@@ -57,6 +57,27 @@ void test_validate (void)
 	PLUGIN_CLOSE ();
 }
 
+static void test_typeNames (void)
+{
+	const char * names[] = { "any", "string", "wstring", "char", "wchar", "octet", "short", "long", "long_long", "unsigned_short",
+				 "unsigned_long", "unsigned_long_long", "float", "double", "boolean", "enum" };
+	Key * k = keyNew ("user:/anything", KEY_VALUE, "0", KEY_META, "check/enum", "#0", KEY_META, "check/enum/#0", "0", KEY_END);
+	for (size_t i = 0; i < sizeof (names) / sizeof (names[0]); ++i)
+	{
+		keySetMeta (k, "check/type", names[i]);
+		succeed_if_fmt (checkType (k), "type %s should be found", names[i]);
+	}
+
+	keySetMeta (k, "check/type", "unknown");
+	succeed_if (!checkType (k), "unknown type should not be found");
+	keySetMeta (k, "check/type", "shorts");
+	succeed_if (!checkType (k), "unknown type should not be found");
+	keySetMeta (k, "check/type", "sxort");
+	succeed_if (!checkType (k), "unknown type should not be found");
+
+	keyDel (k);
+}
+
 void test_short (void)
 {
 	Key * k = keyNew ("user:/anything", KEY_VALUE, "0", KEY_META, "check/type", "short", KEY_END);
@@ -334,6 +355,41 @@ static void test_enum (void)
 	PLUGIN_CLOSE ();
 }
 
+static void test_enumShared (void)
+{
+	Key * parentKey = keyNew ("user:/tests/type/enum", KEY_VALUE, "", KEY_END);
+	Key * spec = keyNew ("spec:/tests/type/enum", KEY_META, "check/type", "enum", KEY_META, "check/enum", "#2", KEY_META,
+			     "check/enum/#0", "LOW", KEY_META, "check/enum/#1", "MIDDLE", KEY_META, "check/enum/#2", "HIGH", KEY_END);
+	Key * k1 = keyNew ("user:/tests/type/enum/valid1", KEY_VALUE, "LOW", KEY_END);
+	Key * k2 = keyNew ("user:/tests/type/enum/valid2", KEY_VALUE, "HIGH", KEY_END);
+	Key * k3 = keyNew ("user:/tests/type/enum/valid3", KEY_VALUE, "MIDDLE", KEY_END);
+	keyCopyAllMeta (k1, spec);
+	keyCopyAllMeta (k2, spec);
+	keyCopyAllMeta (k3, spec);
+
+	KeySet * conf = ksNew (0, KS_END);
+	KeySet * ks = ksNew (3, k1, k2, k3, KS_END);
+	PLUGIN_OPEN ("type");
+
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "kdbGet failed");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "kdbSet failed");
+
+	// a different value for one element must not reuse the compiled enum of the other keys
+	keySetMeta (k3, "check/enum/#1", "MEDIUM");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "kdbSet should fail");
+
+	keySetString (k3, "MEDIUM");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "kdbSet failed");
+
+	keySetString (k2, "MEDIUM");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "kdbSet should fail");
+
+	ksDel (ks);
+	keyDel (spec);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
 static void test_enumMulti (void)
 {
 	Key * parentKey = keyNew ("user:/tests/type/enum", KEY_VALUE, "", KEY_END);
@@ -478,8 +534,9 @@ static void test_enumMultiNormalize (void)
 	keySetString (k2, "0");
 	keySetString (k3, "1");
 
+	// restored values are ordered by their array index
 	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "kdbSet failed");
-	succeed_if_same_string (keyString (k1), "high_low");
+	succeed_if_same_string (keyString (k1), "low_high");
 	succeed_if_same_string (keyString (k2), "none");
 	succeed_if_same_string (keyString (k3), "low");
 	succeed_if_same_string (keyString (k4), "high_low");
@@ -802,6 +859,34 @@ static void test_booleanRestoreDisabled (const char * type)
 	PLUGIN_CLOSE ();
 }
 
+static void test_unchanged (const char * type)
+{
+	Key * parentKey = keyNew ("user:/tests/type", KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("type");
+	KeySet * ks = ksNew (30, keyNew ("user:/tests/type/b", KEY_VALUE, "on", KEY_META, type, "boolean", KEY_END),
+			     keyNew ("user:/tests/type/l", KEY_VALUE, "1", KEY_META, type, "long", KEY_END), KS_END);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+
+	// simulate state after kdbGet, unchanged keys are not checked again
+	Key * b = ksLookupByName (ks, "user:/tests/type/b", 0);
+	Key * l = ksLookupByName (ks, "user:/tests/type/l", 0);
+	keySetString (l, "x");
+	keyClearSync (b);
+	keyClearSync (l);
+
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "unchanged key should not be checked");
+	succeed_if_same_string (keyString (b), "on");
+
+	keySetString (l, "x");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "changed key should be checked");
+
+	ksDel (ks);
+	keyDel (parentKey);
+
+	PLUGIN_CLOSE ();
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("TYPE     TESTS\n");
@@ -810,6 +895,7 @@ int main (int argc, char ** argv)
 	init (argc, argv);
 
 	test_validate ();
+	test_typeNames ();
 	test_short ();
 	test_unsignedShort ();
 	test_float ();
@@ -823,6 +909,7 @@ int main (int argc, char ** argv)
 
 	test_enum ();
 	test_enumMulti ();
+	test_enumShared ();
 
 	test_enumNormalize ();
 	test_enumMultiNormalize ();
@@ -863,6 +950,9 @@ int main (int argc, char ** argv)
 
 	test_booleanUserValueError ();
 
+	test_unchanged ("type");
+	test_unchanged ("check/type");
+
 	print_result ("testmod_type");
 
 	return nbError;
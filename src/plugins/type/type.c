@@ -18,51 +18,53 @@ struct _Type
 {
 	const char * name;
 	bool (*normalize) (Plugin * handle, Key * key);
-	bool (*check) (const Key * key);
+	bool (*check) (Plugin * handle, const Key * key);
 	bool (*restore) (Plugin * handle, Key * key);
 	void (*setError) (Plugin * handle, Key * errorKey, const Key * key);
 };
 
 static void elektraTypeSetDefaultError (Plugin * handle, Key * errorKey, const Key * key);
 
-static const Type elektraTypesList[] = {
-	{ "any", NULL, &elektraTypeCheckAny, NULL, &elektraTypeSetDefaultError },
-	{ "string", NULL, &elektraTypeCheckString, NULL, &elektraTypeSetDefaultError },
-	{ "wstring", NULL, &elektraTypeCheckWString, NULL, &elektraTypeSetDefaultError },
-	{ "char", NULL, &elektraTypeCheckChar, NULL, &elektraTypeSetDefaultError },
-	{ "wchar", NULL, &elektraTypeCheckWChar, NULL, &elektraTypeSetDefaultError },
-	{ "octet", NULL, &elektraTypeCheckChar, NULL, &elektraTypeSetDefaultError },
-	{ "short", NULL, &elektraTypeCheckShort, NULL, &elektraTypeSetDefaultError },
-	{ "long", NULL, &elektraTypeCheckLong, NULL, &elektraTypeSetDefaultError },
-	{ "long_long", NULL, &elektraTypeCheckLongLong, NULL, &elektraTypeSetDefaultError },
-	{ "unsigned_short", NULL, &elektraTypeCheckUnsignedShort, NULL, &elektraTypeSetDefaultError },
-	{ "unsigned_long", NULL, &elektraTypeCheckUnsignedLong, NULL, &elektraTypeSetDefaultError },
-	{ "unsigned_long_long", NULL, &elektraTypeCheckUnsignedLongLong, NULL, &elektraTypeSetDefaultError },
-	{ "float", NULL, &elektraTypeCheckFloat, NULL, &elektraTypeSetDefaultError },
-	{ "double", NULL, &elektraTypeCheckDouble, NULL, &elektraTypeSetDefaultError },
+/**
+ * Perfect hash of the supported type names, i.e. there are no collisions within elektraTypesTable.
+ * Keep the slots in elektraTypesTable in sync, when adding types.
+ */
+#define TYPE_HASH(name, length) ((3 * (length) + (unsigned char) (name)[0]) % 32)
+
+static const Type elektraTypesTable[32] = {
+	[2] = { "short", NULL, &elektraTypeCheckShort, NULL, &elektraTypeSetDefaultError },
+	[5] = { "string", NULL, &elektraTypeCheckString, NULL, &elektraTypeSetDefaultError },
+	[6] = { "wchar", NULL, &elektraTypeCheckWChar, NULL, &elektraTypeSetDefaultError },
+	[7] = { "long_long", NULL, &elektraTypeCheckLongLong, NULL, &elektraTypeSetDefaultError },
+	[10] = { "any", NULL, &elektraTypeCheckAny, NULL, &elektraTypeSetDefaultError },
+	[11] = { "unsigned_long_long", NULL, &elektraTypeCheckUnsignedLongLong, NULL, &elektraTypeSetDefaultError },
+	[12] = { "wstring", NULL, &elektraTypeCheckWString, NULL, &elektraTypeSetDefaultError },
 #ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
-	{ "long_double", NULL, &elektraTypeCheckLongDouble, NULL, &elektraTypeSetDefaultError },
+	[13] = { "long_double", NULL, &elektraTypeCheckLongDouble, NULL, &elektraTypeSetDefaultError },
 #endif
-	{ "boolean", &elektraTypeNormalizeBoolean, &elektraTypeCheckBoolean, &elektraTypeRestoreBoolean, &elektraTypeSetDefaultError },
-	{ "enum", &elektraTypeNormalizeEnum, &elektraTypeCheckEnum, &elektraTypeRestoreEnum, &elektraTypeSetErrorEnum },
-	{ NULL, NULL, NULL, NULL, NULL }
+	[15] = { "char", NULL, &elektraTypeCheckChar, NULL, &elektraTypeSetDefaultError },
+	[17] = { "enum", &elektraTypeNormalizeEnum, &elektraTypeCheckEnum, &elektraTypeRestoreEnum, &elektraTypeSetErrorEnum },
+	[21] = { "float", NULL, &elektraTypeCheckFloat, NULL, &elektraTypeSetDefaultError },
+	[22] = { "double", NULL, &elektraTypeCheckDouble, NULL, &elektraTypeSetDefaultError },
+	[23] = { "boolean", &elektraTypeNormalizeBoolean, &elektraTypeCheckBoolean, &elektraTypeRestoreBoolean,
+		 &elektraTypeSetDefaultError },
+	[24] = { "long", NULL, &elektraTypeCheckLong, NULL, &elektraTypeSetDefaultError },
+	[28] = { "unsigned_long", NULL, &elektraTypeCheckUnsignedLong, NULL, &elektraTypeSetDefaultError },
+	[30] = { "octet", NULL, &elektraTypeCheckChar, NULL, &elektraTypeSetDefaultError },
+	[31] = { "unsigned_short", NULL, &elektraTypeCheckUnsignedShort, NULL, &elektraTypeSetDefaultError },
 };
 
 static const Type * findType (const char * name)
 {
-	const Type * cur = &elektraTypesList[0];
-	while (cur->name != NULL)
+	const Type * type = &elektraTypesTable[TYPE_HASH (name, strlen (name))];
+	if (type->name != NULL && strcmp (type->name, name) == 0)
 	{
-		if (strcmp (cur->name, name) == 0)
-		{
-			return cur;
-		}
-		++cur;
+		return type;
 	}
 	return NULL;
 }
 
-static const char * getTypeName (const Key * key)
+static const Key * getTypeMeta (const Key * key)
 {
 	const Key * meta = keyGetMeta (key, "check/type");
 	if (meta == NULL)
@@ -75,8 +77,13 @@ static const char * getTypeName (const Key * key)
 		return NULL;
 	}
 
-	const char * type = keyString (meta);
-	return strlen (type) == 0 ? NULL : type;
+	return keyString (meta)[0] == '\0' ? NULL : meta;
+}
+
+static const char * getTypeName (const Key * key)
+{
+	const Key * meta = getTypeMeta (key);
+	return meta == NULL ? NULL : keyString (meta);
 }
 
 bool elektraTypeCheckType (const Key * key)
@@ -88,7 +95,7 @@ bool elektraTypeCheckType (const Key * key)
 	}
 
 	const Type * type = findType (typeName);
-	return type != NULL && type->check (key);
+	return type != NULL && type->check (NULL, key);
 }
 
 static void elektraTypeSetDefaultError (Plugin * handle ELEKTRA_UNUSED, Key * errorKey, const Key * key)
@@ -119,7 +126,7 @@ bool elektraTypeValidateKey (Plugin * handle, Key * key, Key * errorKey)
 		return false;
 	}
 
-	if (!type->check (key))
+	if (!type->check (handle, key))
 	{
 		type->setError (handle, errorKey, key);
 		return false;
@@ -240,7 +247,7 @@ static kdb_long_long_t readBooleanRestore (KeySet * config)
 int elektraTypeOpen (Plugin * handle, Key * errorKey)
 {
 	KeySet * conf = elektraPluginGetConfig (handle);
-	TypeData * data = elektraMalloc (sizeof (TypeData));
+	TypeData * data = elektraCalloc (sizeof (TypeData));
 
 	kdb_long_long_t result = readBooleans (conf, &data->booleans, errorKey);
 	if (result < -1)
@@ -272,12 +279,13 @@ int elektraTypeOpen (Plugin * handle, Key * errorKey)
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
+	data->enumRoot = keyNew ("meta:/check/enum", KEY_END);
 	elektraPluginSetData (handle, data);
 
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
-int elektraTypeGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraTypeGet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	if (!elektraStrCmp (keyName (parentKey), "system:/elektra/modules/type"))
 	{
@@ -299,17 +307,25 @@ int elektraTypeGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 	}
 
 	Key * cur = NULL;
-
+	const Key * lastTypeMeta = NULL;
+	const Type * type = NULL;
 	for (elektraCursor it = 0; it < ksGetSize (returned); ++it)
 	{
 		cur = ksAtCursor (returned, it);
-		const char * typeName = getTypeName (cur);
-		if (typeName == NULL)
+		const Key * typeMeta = getTypeMeta (cur);
+		if (typeMeta == NULL)
 		{
 			continue;
 		}
 
-		const Type * type = findType (typeName);
+		// metakeys copied by spec are shared between keys, so a type is usually only resolved once
+		const char * typeName = keyString (typeMeta);
+		if (typeMeta != lastTypeMeta)
+		{
+			type = findType (typeName);
+			lastTypeMeta = typeMeta;
+		}
+
 		if (type == NULL)
 		{
 			ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Unknown type '%s' for key '%s'", typeName, keyName (cur));
@@ -338,7 +354,7 @@ int elektraTypeGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 			}
 		}
 
-		if (!type->check (cur))
+		if (!type->check (handle, cur))
 		{
 			type->setError (handle, parentKey, cur);
 			return ELEKTRA_PLUGIN_STATUS_ERROR;
@@ -348,19 +364,28 @@ int elektraTypeGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
-int elektraTypeSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraTypeSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	Key * cur = NULL;
+	const Key * lastTypeMeta = NULL;
+	const Type * type = NULL;
 	for (elektraCursor it = 0; it < ksGetSize (returned); ++it)
 	{
 		cur = ksAtCursor (returned, it);
-		const char * typeName = getTypeName (cur);
-		if (typeName == NULL)
+		const Key * typeMeta = getTypeMeta (cur);
+		if (typeMeta == NULL)
 		{
 			continue;
 		}
 
-		const Type * type = findType (typeName);
+		// metakeys copied by spec are shared between keys, so a type is usually only resolved once
+		const char * typeName = keyString (typeMeta);
+		if (typeMeta != lastTypeMeta)
+		{
+			type = findType (typeName);
+			lastTypeMeta = typeMeta;
+		}
+
 		if (type == NULL)
 		{
 			ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Unknown type '%s' for key '%s'", typeName, keyName (cur));
@@ -380,7 +405,8 @@ int elektraTypeSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 			}
 		}
 
-		if (!type->check (cur))
+		// keys that were not changed since kdbGet were already checked there
+		if (keyNeedSync (cur) && !type->check (handle, cur))
 		{
 			type->setError (handle, parentKey, cur);
 			return ELEKTRA_PLUGIN_STATUS_ERROR;
@@ -408,6 +434,8 @@ int elektraTypeClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 		{
 			elektraFree (data->booleans);
 		}
+		elektraTypeClearEnumCache (data);
+		keyDel (data->enumRoot);
 		elektraFree (data);
 	}
 	elektraPluginSetData (handle, NULL);
@@ -30,11 +30,18 @@ struct boolean_pair
 	const char * falseValue;
 };
 
+/** number of compiled enums cached per plugin instance */
+#define ELEKTRA_TYPE_ENUM_CACHE_SIZE 16
+
+typedef struct _CompiledEnum CompiledEnum;
+
 typedef struct
 {
 	kdb_long_long_t booleanRestore;
 	struct boolean_pair * booleans;
 	kdb_long_long_t booleanCount;
+	Key * enumRoot;
+	CompiledEnum * enums[ELEKTRA_TYPE_ENUM_CACHE_SIZE];
 } TypeData;
 
 int elektraTypeOpen (Plugin * handle, Key * errorKey);
@@ -44,6 +51,7 @@ int elektraTypeClose (Plugin * handle, Key * errorKey);
 int elektraTypeCheckConf (Key * errorKey, KeySet * conf);
 
 bool elektraTypeCheckType (const Key * key);
+void elektraTypeClearEnumCache (TypeData * data);
 bool elektraTypeValidateKey (Plugin * handle, Key * key, Key * errorKey);
 
 Plugin * ELEKTRA_PLUGIN_EXPORT;
@@ -11,11 +11,13 @@
 #include "type.h"
 
 #include <ctype.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <kdbhelper.h>
+#include <kdbprivate.h>
 
 #include <kdbease.h>
 #include <kdberrors.h>
@@ -39,29 +41,29 @@
 		elektraFree (string);                                                                                                      \
 	}
 
-bool elektraTypeCheckAny (const Key * key ELEKTRA_UNUSED)
+bool elektraTypeCheckAny (Plugin * handle ELEKTRA_UNUSED, const Key * key ELEKTRA_UNUSED)
 {
 	return true;
 }
 
-bool elektraTypeCheckChar (const Key * key)
+bool elektraTypeCheckChar (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	return strlen (keyString (key)) == 1;
 }
 
 
-bool elektraTypeCheckWChar (const Key * key)
+bool elektraTypeCheckWChar (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	wchar_t out[2];
 	return mbstowcs (out, keyString (key), 2) == 1;
 }
 
-bool elektraTypeCheckString (const Key * key)
+bool elektraTypeCheckString (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	return keyIsString (key) == 1;
 }
 
-bool elektraTypeCheckWString (const Key * key)
+bool elektraTypeCheckWString (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	const char * value = keyString (key);
 	size_t max = strlen (value) + 1;
@@ -159,7 +161,7 @@ bool elektraTypeNormalizeBoolean (Plugin * handle, Key * key)
 	return false;
 }
 
-bool elektraTypeCheckBoolean (const Key * key)
+bool elektraTypeCheckBoolean (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	const char * value = keyString (key);
 	return (value[0] == '1' || value[0] == '0') && value[1] == '\0';
@@ -176,14 +178,14 @@ bool elektraTypeRestoreBoolean (Plugin * handle ELEKTRA_UNUSED, Key * key)
 	return true;
 }
 
-bool elektraTypeCheckFloat (const Key * key)
+bool elektraTypeCheckFloat (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	kdb_float_t value;
 	CHECK_TYPE (key, value, elektraKeyToFloat)
 	return true;
 }
 
-bool elektraTypeCheckDouble (const Key * key)
+bool elektraTypeCheckDouble (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	kdb_double_t value;
 	CHECK_TYPE (key, value, elektraKeyToDouble)
@@ -191,7 +193,7 @@ bool elektraTypeCheckDouble (const Key * key)
 }
 
 #ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
-bool elektraTypeCheckLongDouble (const Key * key)
+bool elektraTypeCheckLongDouble (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	kdb_long_double_t value;
 	CHECK_TYPE (key, value, elektraKeyToLongDouble)
@@ -200,7 +202,7 @@ bool elektraTypeCheckLongDouble (const Key * key)
 
 #endif
 
-bool elektraTypeCheckShort (const Key * key)
+bool elektraTypeCheckShort (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	kdb_short_t value;
 	CHECK_TYPE (key, value, elektraKeyToShort)
@@ -208,7 +210,7 @@ bool elektraTypeCheckShort (const Key * key)
 	return true;
 }
 
-bool elektraTypeCheckLong (const Key * key)
+bool elektraTypeCheckLong (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	kdb_long_t value;
 	CHECK_TYPE (key, value, elektraKeyToLong)
@@ -216,7 +218,7 @@ bool elektraTypeCheckLong (const Key * key)
 	return true;
 }
 
-bool elektraTypeCheckLongLong (const Key * key)
+bool elektraTypeCheckLongLong (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	kdb_long_long_t value;
 	CHECK_TYPE (key, value, elektraKeyToLongLong)
@@ -224,7 +226,7 @@ bool elektraTypeCheckLongLong (const Key * key)
 	return true;
 }
 
-bool elektraTypeCheckUnsignedShort (const Key * key)
+bool elektraTypeCheckUnsignedShort (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	kdb_unsigned_short_t value;
 	CHECK_TYPE (key, value, elektraKeyToUnsignedShort)
@@ -232,7 +234,7 @@ bool elektraTypeCheckUnsignedShort (const Key * key)
 	return true;
 }
 
-bool elektraTypeCheckUnsignedLong (const Key * key)
+bool elektraTypeCheckUnsignedLong (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	kdb_unsigned_long_t value;
 	CHECK_TYPE (key, value, elektraKeyToUnsignedLong)
@@ -240,7 +242,7 @@ bool elektraTypeCheckUnsignedLong (const Key * key)
 	return true;
 }
 
-bool elektraTypeCheckUnsignedLongLong (const Key * key)
+bool elektraTypeCheckUnsignedLongLong (Plugin * handle ELEKTRA_UNUSED, const Key * key)
 {
 	kdb_unsigned_long_long_t value;
 	CHECK_TYPE (key, value, elektraKeyToUnsignedLongLong)
@@ -248,85 +250,305 @@ bool elektraTypeCheckUnsignedLongLong (const Key * key)
 	return true;
 }
 
-static bool enumValidValues (const Key * key, KeySet * validValues, char * delim)
+struct enumValue
 {
+	const char * name;
+	kdb_unsigned_long_long_t value;
+};
 
-	const Key * maxKey = keyGetMeta (key, "check/enum");
-	const char * max = maxKey == NULL ? NULL : keyString (maxKey);
+/**
+ * An enum compiled from the `check/enum` metadata of a key.
+ *
+ * The compiled enum keeps a reference to all metakeys below `check/enum` it was compiled from.
+ * Because metakeys are shared between keys (e.g. if they were copied by spec), most keys with
+ * the same enum reuse the compiled enum after comparing these pointers.
+ */
+struct _CompiledEnum
+{
+	Key ** metaKeys;
+	size_t metaCount;
+	struct enumValue * values; // in the order of the array indices, restored values use this order
+	size_t valueCount;
+	size_t * slots; // open addressing hash set of value indices + 1, 0 marks empty slots, used for lookups
+	size_t slotCount;
+	char delimiter;
+	bool valid;
+};
+
+static size_t hashEnumValue (const char * name, size_t length)
+{
+	// FNV-1a
+	size_t hash = 14695981039346656037ULL & SIZE_MAX;
+	for (size_t i = 0; i < length; ++i)
+	{
+		hash ^= (unsigned char) name[i];
+		hash *= 1099511628211ULL & SIZE_MAX;
+	}
+	return hash;
+}
 
-	if (max == NULL)
+static const struct enumValue * findEnumValue (const CompiledEnum * compiled, const char * name, size_t length)
+{
+	if (compiled->slotCount == 0)
 	{
-		return false;
+		return NULL;
 	}
 
-	char elem[sizeof ("check/enum/") + ELEKTRA_MAX_ARRAY_SIZE];
-	strcpy (elem, "check/enum/");
-	char * indexStart = elem + sizeof ("check/enum/") - 1;
+	size_t mask = compiled->slotCount - 1;
+	for (size_t i = hashEnumValue (name, length) & mask; compiled->slots[i] != 0; i = (i + 1) & mask)
+	{
+		const struct enumValue * cur = &compiled->values[compiled->slots[i] - 1];
+		if (strncmp (cur->name, name, length) == 0 && cur->name[length] == '\0')
+		{
+			return cur;
+		}
+	}
+	return NULL;
+}
 
-	kdb_long_long_t index = 0;
-	elektraWriteArrayNumber (indexStart, index);
-	while (strcmp (indexStart, max) <= 0)
+static void freeCompiledEnum (CompiledEnum * compiled)
+{
+	for (size_t i = 0; i < compiled->metaCount; ++i)
 	{
-		const Key * enumKey = keyGetMeta (key, elem);
-		const char * name = enumKey != NULL ? keyString (enumKey) : "";
-		if (strlen (name) > 0)
+		keyDecRef (compiled->metaKeys[i]);
+		keyDel (compiled->metaKeys[i]);
+	}
+	elektraFree (compiled->metaKeys);
+	elektraFree (compiled->values);
+	elektraFree (compiled->slots);
+	elektraFree (compiled);
+}
+
+/**
+ * Finds the range of metakeys relevant for enums, i.e. `check/enum` (given as @p root) and everything below.
+ * The range is empty, if `check/enum` does not exist.
+ */
+static elektraCursor findEnumMeta (const Key * key, const Key * root, elektraCursor * end)
+{
+	if (key->meta == NULL)
+	{
+		*end = 0;
+		return 0;
+	}
+
+	elektraCursor start = ksFindHierarchy (key->meta, root, end);
+	if (start >= ksGetSize (key->meta) || keyCmp (ksAtCursor (key->meta, start), root) != 0)
+	{
+		*end = start;
+	}
+	return start;
+}
+
+static CompiledEnum * compileEnum (const Key * key, elektraCursor start, elektraCursor end)
+{
+	CompiledEnum * compiled = elektraCalloc (sizeof (CompiledEnum));
+	compiled->metaCount = end - start;
+	if (compiled->metaCount == 0)
+	{
+		return compiled;
+	}
+
+	compiled->metaKeys = elektraMalloc (compiled->metaCount * sizeof (Key *));
+	compiled->values = elektraMalloc (compiled->metaCount * sizeof (struct enumValue));
+	compiled->valid = true;
+
+	const char * max = keyString (ksAtCursor (key->meta, start));
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		Key * cur = ksAtCursor (key->meta, it);
+		keyIncRef (cur);
+		compiled->metaKeys[it - start] = cur;
+
+		const char * name = keyName (cur) + sizeof ("meta:/check/enum") - 1;
+		if (*name != '/' || strchr (name + 1, '/') != NULL)
 		{
-			kdb_unsigned_long_long_t val = index;
-			Key * k = keyNew ("user:/", KEY_BINARY, KEY_SIZE, sizeof (kdb_unsigned_long_long_t), KEY_VALUE, &val, KEY_END);
-			keyAddName (k, name);
-			ksAppendKey (validValues, k);
+			continue;
 		}
+		++name;
 
-		++index;
-		elektraWriteArrayNumber (indexStart, index);
+		if (strcmp (name, "delimiter") == 0)
+		{
+			const char * delimString = keyString (cur);
+			compiled->valid = strlen (delimString) == 1;
+			compiled->delimiter = delimString[0];
+			continue;
+		}
+
+		int digitStart = elektraArrayValidateBaseNameString (name);
+		const char * value = keyString (cur);
+		if (digitStart <= 0 || strcmp (name, max) > 0 || strlen (value) == 0)
+		{
+			continue;
+		}
+
+		// later elements take precedence, if a value is used twice
+		size_t i = 0;
+		while (i < compiled->valueCount && strcmp (compiled->values[i].name, value) != 0)
+		{
+			++i;
+		}
+		compiled->values[i].name = value;
+		compiled->values[i].value = ELEKTRA_UNSIGNED_LONG_LONG_S (&name[digitStart], NULL, 10);
+		if (i == compiled->valueCount)
+		{
+			++compiled->valueCount;
+		}
+	}
+
+	compiled->slotCount = 1;
+	while (compiled->slotCount < 2 * compiled->valueCount)
+	{
+		compiled->slotCount *= 2;
+	}
+	compiled->slots = elektraCalloc (compiled->slotCount * sizeof (size_t));
+
+	size_t mask = compiled->slotCount - 1;
+	for (size_t i = 0; i < compiled->valueCount; ++i)
+	{
+		const char * name = compiled->values[i].name;
+		size_t slot = hashEnumValue (name, strlen (name)) & mask;
+		while (compiled->slots[slot] != 0)
+		{
+			slot = (slot + 1) & mask;
+		}
+		compiled->slots[slot] = i + 1;
 	}
 
-	const Key * multiEnum = keyGetMeta (key, "check/enum/delimiter");
-	if (multiEnum != NULL)
+	return compiled;
+}
+
+static bool isCompiledEnumOf (const CompiledEnum * compiled, const Key * key, elektraCursor start, elektraCursor end)
+{
+	if ((size_t) (end - start) != compiled->metaCount)
 	{
-		const char * delimString = keyString (multiEnum);
+		return false;
+	}
 
-		if (strlen (delimString) != 1)
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		if (ksAtCursor (key->meta, it) != compiled->metaKeys[it - start])
 		{
-			ksDel (validValues);
 			return false;
 		}
-		*delim = delimString[0];
 	}
+	return true;
+}
 
+/**
+ * Returns the compiled enum for @p key.
+ *
+ * If @p data is NULL, the result is not cached and must be released with releaseCompiledEnum().
+ */
+static CompiledEnum * getCompiledEnum (TypeData * data, const Key * key)
+{
+	elektraCursor start;
+	elektraCursor end;
+	if (data == NULL)
+	{
+		Key * root = keyNew ("meta:/check/enum", KEY_END);
+		start = findEnumMeta (key, root, &end);
+		keyDel (root);
+		return compileEnum (key, start, end);
+	}
+
+	start = findEnumMeta (key, data->enumRoot, &end);
+	const Key * enumMeta = start < end ? ksAtCursor (key->meta, start) : NULL;
+	size_t slot = ((uintptr_t) enumMeta / sizeof (void *)) % ELEKTRA_TYPE_ENUM_CACHE_SIZE;
+
+	CompiledEnum * compiled = data->enums[slot];
+	if (compiled != NULL && isCompiledEnumOf (compiled, key, start, end))
+	{
+		return compiled;
+	}
+
+	if (compiled != NULL)
+	{
+		freeCompiledEnum (compiled);
+	}
+	data->enums[slot] = compileEnum (key, start, end);
+	return data->enums[slot];
+}
+
+static void releaseCompiledEnum (TypeData * data, CompiledEnum * compiled)
+{
+	if (data == NULL)
+	{
+		freeCompiledEnum (compiled);
+	}
+}
+
+void elektraTypeClearEnumCache (TypeData * data)
+{
+	for (size_t i = 0; i < ELEKTRA_TYPE_ENUM_CACHE_SIZE; ++i)
+	{
+		if (data->enums[i] != NULL)
+		{
+			freeCompiledEnum (data->enums[i]);
+			data->enums[i] = NULL;
+		}
+	}
+}
+
+/**
+ * Looks up all values of @p string (separated by the delimiter of @p compiled, if any).
+ *
+ * @retval true if all values are valid, @p result is set to the bitwise or of their values
+ * @retval false otherwise
+ */
+static bool lookupEnumValues (const CompiledEnum * compiled, const char * string, kdb_unsigned_long_long_t * result)
+{
+	*result = 0;
+	const char * value = string;
+	const char * next;
+	while (compiled->delimiter != 0 && (next = strchr (value, compiled->delimiter)) != NULL)
+	{
+		const struct enumValue * cur = findEnumValue (compiled, value, next - value);
+		if (cur == NULL)
+		{
+			return false;
+		}
+		*result |= cur->value;
+		value = next + 1;
+	}
+
+	const struct enumValue * cur = findEnumValue (compiled, value, strlen (value));
+	if (cur == NULL)
+	{
+		return false;
+	}
+	*result |= cur->value;
 	return true;
 }
 
-static char * calculateStringValue (KeySet * validValues, char delimiter, kdb_unsigned_long_long_t value)
+static char * calculateStringValue (const CompiledEnum * compiled, kdb_unsigned_long_long_t value)
 {
 	char * stringValue = elektraStrDup ("");
-	Key * cur = NULL;
 
-	for (elektraCursor it = 0; it < ksGetSize (validValues); ++it)
+	for (size_t i = 0; i < compiled->valueCount; ++i)
 	{
-		cur = ksAtCursor (validValues, it);
-		const kdb_unsigned_long_long_t * val = keyValue (cur);
-		const char * name = keyName (cur) + sizeof ("user:/") - 1;
-		if (delimiter == 0 && *val == value)
+		kdb_unsigned_long_long_t val = compiled->values[i].value;
+		const char * name = compiled->values[i].name;
+		if (compiled->delimiter == 0 && val == value)
 		{
 			elektraFree (stringValue);
 			return elektraStrDup (name);
 		}
-		else if (delimiter != 0)
+		else if (compiled->delimiter != 0)
 		{
-			if (*val == 0 && value == 0 && stringValue[0] == '\0')
+			if (val == 0 && value == 0 && stringValue[0] == '\0')
 			{
 				elektraFree (stringValue);
 				return elektraStrDup (name);
 			}
-			else if (*val != 0 && (*val & value) == *val)
+			else if (val != 0 && (val & value) == val)
 			{
-				char * tmp = stringValue[0] == '\0' ? elektraFormat ("%s", name) :
-									    elektraFormat ("%s%c%s", stringValue, delimiter, name);
+				char * tmp = stringValue[0] == '\0' ?
+						     elektraFormat ("%s", name) :
+						     elektraFormat ("%s%c%s", stringValue, compiled->delimiter, name);
 				elektraFree (stringValue);
 				stringValue = tmp;
 
-				value &= ~*val;
+				value &= ~val;
 			}
 		}
 	}
@@ -334,7 +556,7 @@ static char * calculateStringValue (KeySet * validValues, char delimiter, kdb_un
 	return stringValue;
 }
 
-bool elektraTypeNormalizeEnum (Plugin * handle ELEKTRA_UNUSED, Key * key)
+bool elektraTypeNormalizeEnum (Plugin * handle, Key * key)
 {
 	const Key * normalize = keyGetMeta (key, "check/enum/normalize");
 	if (normalize == NULL || strcmp (keyString (normalize), "1") != 0)
@@ -342,76 +564,40 @@ bool elektraTypeNormalizeEnum (Plugin * handle ELEKTRA_UNUSED, Key * key)
 		return true;
 	}
 
-	KeySet * validValues = ksNew (0, KS_END);
-	char delim = 0;
-	if (!enumValidValues (key, validValues, &delim))
+	TypeData * data = elektraPluginGetData (handle);
+	CompiledEnum * compiled = getCompiledEnum (data, key);
+	if (!compiled->valid)
 	{
+		releaseCompiledEnum (data, compiled);
 		return false;
 	}
 
-	char * values = elektraStrDup (keyString (key));
-	char * value = values;
-	char * next;
+	const char * values = keyString (key);
 
 	if (isdigit (values[0]))
 	{
 		kdb_unsigned_long_long_t val = ELEKTRA_UNSIGNED_LONG_LONG_S (values, NULL, 10);
-		char * origValue = calculateStringValue (validValues, delim, val);
+		char * origValue = calculateStringValue (compiled, val);
+		releaseCompiledEnum (data, compiled);
 		if (origValue == NULL)
 		{
-			ksDel (validValues);
-			elektraFree (values);
 			return false;
 		}
 
 		keySetMeta (key, "origvalue", origValue);
 
 		elektraFree (origValue);
-		ksDel (validValues);
-		elektraFree (values);
 		return true;
 	}
 
-	Key * valueKey = keyNew ("user:/0", KEY_END);
-
-	kdb_unsigned_long_long_t normalized = 0;
-	if (delim != 0)
+	kdb_unsigned_long_long_t normalized;
+	bool valid = lookupEnumValues (compiled, values, &normalized);
+	releaseCompiledEnum (data, compiled);
+	if (!valid)
 	{
-		while ((next = strchr (value, delim)) != NULL)
-		{
-			*next = '\0';
-			keySetBaseName (valueKey, value);
-			Key * cur = ksLookup (validValues, valueKey, 0);
-			if (cur == NULL)
-			{
-				keyDel (valueKey);
-				ksDel (validValues);
-				elektraFree (values);
-				return false;
-			}
-
-			const kdb_unsigned_long_long_t * val = keyValue (cur);
-			normalized |= *val;
-			value = next + 1;
-		}
-	}
-
-	keySetBaseName (valueKey, value);
-	Key * cur = ksLookup (validValues, valueKey, 0);
-	keyDel (valueKey);
-	if (cur == NULL)
-	{
-		ksDel (validValues);
-		elektraFree (values);
 		return false;
 	}
 
-	const kdb_unsigned_long_long_t * val = keyValue (cur);
-	normalized |= *val;
-
-	ksDel (validValues);
-	elektraFree (values);
-
 	char * origValue = elektraStrDup (keyString (key));
 	char * normValue = elektraFormat (ELEKTRA_UNSIGNED_LONG_LONG_F, normalized);
 
@@ -424,7 +610,7 @@ bool elektraTypeNormalizeEnum (Plugin * handle ELEKTRA_UNUSED, Key * key)
 	return true;
 }
 
-bool elektraTypeCheckEnum (const Key * key)
+bool elektraTypeCheckEnum (Plugin * handle, const Key * key)
 {
 	const Key * normalize = keyGetMeta (key, "check/enum/normalize");
 	if (normalize != NULL && strcmp (keyString (normalize), "1") == 0)
@@ -433,59 +619,13 @@ bool elektraTypeCheckEnum (const Key * key)
 		return true;
 	}
 
-	const Key * maxKey = keyGetMeta (key, "check/enum");
-	const char * max = maxKey == NULL ? NULL : keyString (maxKey);
-
-	if (max == NULL)
-	{
-		return false;
-	}
+	TypeData * data = handle == NULL ? NULL : elektraPluginGetData (handle);
+	CompiledEnum * compiled = getCompiledEnum (data, key);
 
-	KeySet * validValues = ksNew (0, KS_END);
-	char delim = 0;
-	if (!enumValidValues (key, validValues, &delim))
-	{
-		return false;
-	}
-
-	char * values = elektraStrDup (keyString (key));
-	char * value = values;
-	char * next;
-
-	Key * valueKey = keyNew ("user:/0", KEY_END);
-
-	if (delim != 0)
-	{
-		while ((next = strchr (value, delim)) != NULL)
-		{
-			*next = '\0';
-			keySetBaseName (valueKey, value);
-			if (ksLookup (validValues, valueKey, 0) == NULL)
-			{
-				keyDel (valueKey);
-				ksDel (validValues);
-				elektraFree (values);
-				return false;
-			}
-			value = next + 1;
-		}
-	}
-
-	keySetBaseName (valueKey, value);
-	if (ksLookup (validValues, valueKey, 0) == NULL)
-	{
-		keyDel (valueKey);
-		ksDel (validValues);
-		elektraFree (values);
-		return false;
-	}
-
-
-	keyDel (valueKey);
-	ksDel (validValues);
-	elektraFree (values);
-
-	return true;
+	kdb_unsigned_long_long_t value;
+	bool valid = compiled->valid && lookupEnumValues (compiled, keyString (key), &value);
+	releaseCompiledEnum (data, compiled);
+	return valid;
 }
 
 bool elektraTypeRestoreEnum (Plugin * handle ELEKTRA_UNUSED, Key * key)
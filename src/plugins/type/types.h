@@ -16,33 +16,33 @@
 #include <kdbplugin.h>
 #include <kdbtypes.h>
 
-bool elektraTypeCheckAny (const Key * key);
-bool elektraTypeCheckEmpty (const Key * key);
-bool elektraTypeCheckChar (const Key * key);
-bool elektraTypeCheckWChar (const Key * key);
-bool elektraTypeCheckString (const Key * key);
-bool elektraTypeCheckWString (const Key * key);
+bool elektraTypeCheckAny (Plugin * handle, const Key * key);
+bool elektraTypeCheckEmpty (Plugin * handle, const Key * key);
+bool elektraTypeCheckChar (Plugin * handle, const Key * key);
+bool elektraTypeCheckWChar (Plugin * handle, const Key * key);
+bool elektraTypeCheckString (Plugin * handle, const Key * key);
+bool elektraTypeCheckWString (Plugin * handle, const Key * key);
 
 bool elektraTypeNormalizeBoolean (Plugin * handle, Key * key);
-bool elektraTypeCheckBoolean (const Key * key);
+bool elektraTypeCheckBoolean (Plugin * handle, const Key * key);
 bool elektraTypeRestoreBoolean (Plugin * handle, Key * key);
 
-bool elektraTypeCheckFloat (const Key * key);
-bool elektraTypeCheckDouble (const Key * key);
+bool elektraTypeCheckFloat (Plugin * handle, const Key * key);
+bool elektraTypeCheckDouble (Plugin * handle, const Key * key);
 
 #ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
-bool elektraTypeCheckLongDouble (const Key * key);
+bool elektraTypeCheckLongDouble (Plugin * handle, const Key * key);
 #endif
 
-bool elektraTypeCheckShort (const Key * key);
-bool elektraTypeCheckLong (const Key * key);
-bool elektraTypeCheckLongLong (const Key * key);
-bool elektraTypeCheckUnsignedShort (const Key * key);
-bool elektraTypeCheckUnsignedLong (const Key * key);
-bool elektraTypeCheckUnsignedLongLong (const Key * key);
+bool elektraTypeCheckShort (Plugin * handle, const Key * key);
+bool elektraTypeCheckLong (Plugin * handle, const Key * key);
+bool elektraTypeCheckLongLong (Plugin * handle, const Key * key);
+bool elektraTypeCheckUnsignedShort (Plugin * handle, const Key * key);
+bool elektraTypeCheckUnsignedLong (Plugin * handle, const Key * key);
+bool elektraTypeCheckUnsignedLongLong (Plugin * handle, const Key * key);
 
 bool elektraTypeNormalizeEnum (Plugin * handle, Key * key);
-bool elektraTypeCheckEnum (const Key * key);
+bool elektraTypeCheckEnum (Plugin * handle, const Key * key);
 bool elektraTypeRestoreEnum (Plugin * handle, Key * key);
 void elektraTypeSetErrorEnum (Plugin * handle, Key * errorKey, const Key * key);
 
@@ -91,26 +91,30 @@ static void zeroMqRecvSocketReadable (void * socket, void * context)
 	changeType[length] = '\0';
 	ELEKTRA_LOG_DEBUG ("received change type %s", changeType);
 
-	result = zmq_msg_recv (&message, socket, ZMQ_DONTWAIT);
-	if (result == -1)
+	// the change type is followed by one or more key names
+	int more = 1;
+	while (more)
 	{
-		ELEKTRA_LOG_WARNING ("receiving key name failed: %s; aborting", zmq_strerror (zmq_errno ()));
-		elektraFree (changeType);
-		zmq_msg_close (&message);
-		return;
+		result = zmq_msg_recv (&message, socket, ZMQ_DONTWAIT);
+		if (result == -1)
+		{
+			ELEKTRA_LOG_WARNING ("receiving key name failed: %s; aborting", zmq_strerror (zmq_errno ()));
+			break;
+		}
+		more = zmq_msg_more (&message);
+		length = zmq_msg_size (&message);
+		changedKeyName = elektraMemDup (zmq_msg_data (&message), length + 1);
+		changedKeyName[length] = '\0';
+		ELEKTRA_LOG_DEBUG ("received key name %s", changedKeyName);
+
+		// notify about changes
+		Key * changedKey = keyNew (changedKeyName, KEY_END);
+		data->notificationCallback (changedKey, data->notificationContext);
+		elektraFree (changedKeyName);
 	}
-	length = zmq_msg_size (&message);
-	changedKeyName = elektraMemDup (zmq_msg_data (&message), length + 1);
-	changedKeyName[length] = '\0';
-	ELEKTRA_LOG_DEBUG ("received key name %s", changedKeyName);
-
-	// notify about changes
-	Key * changedKey = keyNew (changedKeyName, KEY_END);
-	data->notificationCallback (changedKey, data->notificationContext);
 
 	zmq_msg_close (&message);
 	elektraFree (changeType);
-	elektraFree (changedKeyName);
 }
 
 /**
@@ -136,15 +136,12 @@ static int waitForConnection (void * monitorSocket, long connectTimeout)
 		if (timeout)
 		{
 			ELEKTRA_LOG_WARNING ("connection timed out. could not publish notification");
-			zmq_close (monitorSocket);
 			return -1;
 		}
 
 		switch (event)
 		{
 		case ZMQ_EVENT_CONNECTED:
-			// we do not need the publisher monitor anymore
-			zmq_close (monitorSocket);
 			connected = 1;
 			break;
 		case -1:
@@ -313,17 +310,18 @@ int elektraZeroMqSendConnect (ElektraZeroMqSendPluginData * data)
 }
 
 /**
- * Publish notification on ZeroMq connection.
+ * Connect and wait until the publish socket has a subscriber.
+ *
+ * Only called from the sender thread, so waiting for connections and
+ * subscribers does not block kdbSet.
  *
- * @param changeType type of change
- * @param keyName    name of changed key
- * @param data       plugin data
+ * @param data plugin data
  * @retval 1 on success
  * @retval -1 on connection timeout
  * @retval -2 on subscription timeout
  * @retval 0 on other errors
  */
-int elektraZeroMqSendPublish (const char * changeType, const char * keyName, ElektraZeroMqSendPluginData * data)
+int elektraZeroMqSendWaitForSubscriber (ElektraZeroMqSendPluginData * data)
 {
 	if (!elektraZeroMqSendConnect (data))
 	{
@@ -343,10 +341,17 @@ int elektraZeroMqSendPublish (const char * changeType, const char * keyName, Ele
 		// and then wait for the first subscription message.
 		// A ZMQ_XPUB socket instead of a ZMQ_PUB socket allows us to receive
 		// subscription messages
-		int result = waitForConnection (data->zmqPublisherMonitor, data->connectTimeout);
-		if (result != 1)
+		int result;
+		if (data->zmqPublisherMonitor)
 		{
-			return result;
+			result = waitForConnection (data->zmqPublisherMonitor, data->connectTimeout);
+			if (result != 1)
+			{
+				return result;
+			}
+			// we do not need the publisher monitor anymore
+			zmq_close (data->zmqPublisherMonitor);
+			data->zmqPublisherMonitor = NULL;
 		}
 		result = waitForSubscription (data->zmqPublisher, data->subscribeTimeout);
 		if (result == 1)
@@ -359,8 +364,31 @@ int elektraZeroMqSendPublish (const char * changeType, const char * keyName, Ele
 		}
 	}
 
+	return 1;
+}
+
+/**
+ * Publish notifications on ZeroMq connection.
+ *
+ * @param changeType   type of change
+ * @param keyNames     names of changed keys
+ * @param keyNameCount number of names in @p keyNames
+ * @param data         plugin data
+ * @retval 1 on success
+ * @retval -1 on connection timeout
+ * @retval -2 on subscription timeout
+ * @retval 0 on other errors
+ */
+int elektraZeroMqSendPublish (const char * changeType, const char ** keyNames, size_t keyNameCount, ElektraZeroMqSendPluginData * data)
+{
+	int result = elektraZeroMqSendWaitForSubscriber (data);
+	if (result != 1)
+	{
+		return result;
+	}
+
 	// send notification
-	if (!elektraZeroMqSendNotification (data->zmqPublisher, changeType, keyName))
+	if (!elektraZeroMqSendNotification (data->zmqPublisher, changeType, keyNames, keyNameCount))
 	{
 		ELEKTRA_LOG_WARNING ("could not send notification");
 		return 0;
@@ -373,16 +401,19 @@ int elektraZeroMqSendPublish (const char * changeType, const char * keyName, Ele
  * @internal
  * Send notification over ZeroMq socket.
  *
+ * The notification is a single multipart message: the change type followed by one part per key name.
+ *
  * zmq_send() asynchronous.
  * Processing already handled in a thread created by ZeroMq.
  *
- * @param  socket     ZeroMq socket
- * @param  changeType type of change
- * @param  keyName    name of changed key
+ * @param  socket       ZeroMq socket
+ * @param  changeType   type of change
+ * @param  keyNames     names of changed keys
+ * @param  keyNameCount number of names in @p keyNames
  * @retval 1 on success
  * @retval 0 on error
  */
-int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyName)
+int elektraZeroMqSendNotification (void * socket, const char * changeType, const char ** keyNames, size_t keyNameCount)
 {
 	unsigned int size;
 
@@ -393,10 +424,13 @@ int elektraZeroMqSendNotification (void * socket, const char * changeType, const
 		return 0;
 	}
 
-	size = zmq_send (socket, keyName, elektraStrLen (keyName), 0);
-	if (size != elektraStrLen (keyName))
+	for (size_t i = 0; i < keyNameCount; i++)
 	{
-		return 0;
+		size = zmq_send (socket, keyNames[i], elektraStrLen (keyNames[i]), i + 1 < keyNameCount ? ZMQ_SNDMORE : 0);
+		if (size != elektraStrLen (keyNames[i]))
+		{
+			return 0;
+		}
 	}
 
 	return 1;
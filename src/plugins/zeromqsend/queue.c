@@ -0,0 +1,357 @@
+/**
+ * @file
+ *
+ * @brief Asynchronous notification queue and sender thread for zeromqsend plugin
+ *
+ * Commits only enqueue the changed key name into an in-process ZeroMQ pipe.
+ * The sender thread drains the pipe, waits for connections and subscribers
+ * and publishes all queued key names with the same change type as a single
+ * multipart message.
+ *
+ * ZeroMQ implements in-process pipes as lock-free queues, the high water
+ * mark of the sockets bounds the number of queued notifications.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include "zeromqsend.h"
+
+#include <kdbhelper.h>
+#include <kdblogger.h>
+
+#include <errno.h>  // errno
+#include <string.h> // memcpy(), strcmp()
+
+/** prefix for endpoint of the in-process queue, suffixed with the address of the plugin data */
+#define ELEKTRA_ZEROMQSEND_QUEUE_ENDPOINT "inproc://zeromqsend-queue-"
+
+/**
+ * @internal
+ * Receive one queue message part.
+ *
+ * @param  socket socket
+ * @param  flags  flags for zmq_msg_recv()
+ * @param  more   set to 1 if more parts follow
+ * @return        null terminated copy of the part or NULL on error
+ */
+static char * receivePart (void * socket, int flags, int * more)
+{
+	zmq_msg_t message;
+	zmq_msg_init (&message);
+	if (zmq_msg_recv (&message, socket, flags) == -1)
+	{
+		zmq_msg_close (&message);
+		return NULL;
+	}
+	size_t length = zmq_msg_size (&message);
+	char * buffer = elektraMalloc (length + 1);
+	if (buffer != NULL)
+	{
+		memcpy (buffer, zmq_msg_data (&message), length);
+		buffer[length] = '\0';
+	}
+	*more = zmq_msg_more (&message);
+	zmq_msg_close (&message);
+	return buffer;
+}
+
+/**
+ * @internal
+ * Receive a change record from the queue.
+ *
+ * @param  socket     queue socket
+ * @param  flags      flags for zmq_msg_recv()
+ * @param  changeType set to the change type, NULL for stop records
+ * @param  keyName    set to the key name, NULL for stop records
+ * @retval 1 if a record was received
+ * @retval 0 if no record was received
+ */
+static int receiveRecord (void * socket, int flags, char ** changeType, char ** keyName)
+{
+	int more = 0;
+	*changeType = receivePart (socket, flags, &more);
+	*keyName = NULL;
+	if (*changeType == NULL)
+	{
+		return 0;
+	}
+	if (!more)
+	{
+		// stop record
+		elektraFree (*changeType);
+		*changeType = NULL;
+		return 1;
+	}
+	// the second part was sent atomically with the first one
+	*keyName = receivePart (socket, 0, &more);
+	return 1;
+}
+
+/**
+ * @internal
+ * Report result of a publish to the commit side of the queue.
+ */
+static void reportResult (void * socket, int result)
+{
+	if (result == 1)
+	{
+		return;
+	}
+	if (zmq_send (socket, &result, sizeof (result), ZMQ_DONTWAIT) == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not report publish result %d: %s", result, zmq_strerror (zmq_errno ()));
+	}
+}
+
+static void freeBatch (char ** keyNames, size_t keyNameCount)
+{
+	for (size_t i = 0; i < keyNameCount; i++)
+	{
+		elektraFree (keyNames[i]);
+	}
+}
+
+/**
+ * @internal
+ * Main function of the sender thread.
+ *
+ * @param  context plugin data
+ * @return         always NULL
+ */
+static void * senderThreadMain (void * context)
+{
+	ElektraZeroMqSendPluginData * data = context;
+	void * queue = data->zmqQueueReceiver;
+	char * keyNames[ELEKTRA_ZEROMQSEND_MAX_BATCH];
+
+	char * changeType = NULL;
+	char * keyName = NULL;
+	int running = 1;
+	while (running)
+	{
+		if (changeType == NULL)
+		{
+			// wait for next record
+			if (!receiveRecord (queue, 0, &changeType, &keyName))
+			{
+				if (zmq_errno () == EINTR)
+				{
+					continue;
+				}
+				// context was terminated
+				break;
+			}
+			if (changeType == NULL)
+			{
+				break;
+			}
+		}
+
+		// records queued while waiting for the subscriber end up in the same batch
+		int ready = elektraZeroMqSendWaitForSubscriber (data);
+
+		// batch all queued records with the same change type
+		char * batchType = changeType;
+		size_t keyNameCount = 0;
+		changeType = NULL;
+		if (keyName != NULL)
+		{
+			keyNames[keyNameCount++] = keyName;
+		}
+		while (keyNameCount < ELEKTRA_ZEROMQSEND_MAX_BATCH)
+		{
+			if (!receiveRecord (queue, ZMQ_DONTWAIT, &changeType, &keyName))
+			{
+				break;
+			}
+			if (changeType == NULL)
+			{
+				running = 0;
+				break;
+			}
+			if (strcmp (changeType, batchType) != 0)
+			{
+				// keep record for next batch
+				break;
+			}
+			elektraFree (changeType);
+			changeType = NULL;
+			if (keyName != NULL)
+			{
+				keyNames[keyNameCount++] = keyName;
+			}
+		}
+
+		if (keyNameCount > 0)
+		{
+			int result = ready == 1 ? elektraZeroMqSendPublish (batchType, (const char **) keyNames, keyNameCount, data) : ready;
+			reportResult (queue, result);
+		}
+		freeBatch (keyNames, keyNameCount);
+		elektraFree (batchType);
+	}
+
+	elektraFree (changeType);
+	elektraFree (keyName);
+
+	if (data->zmqPublisherMonitor)
+	{
+		zmq_close (data->zmqPublisherMonitor);
+		data->zmqPublisherMonitor = NULL;
+	}
+	if (data->zmqPublisher)
+	{
+		zmq_close (data->zmqPublisher);
+		data->zmqPublisher = NULL;
+	}
+	zmq_close (queue);
+	data->zmqQueueReceiver = NULL;
+
+	return NULL;
+}
+
+/**
+ * @internal
+ * Create the in-process queue and start the sender thread.
+ *
+ * @param  data plugin data
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+int elektraZeroMqSendStartSender (ElektraZeroMqSendPluginData * data)
+{
+	if (data->senderRunning)
+	{
+		return 1;
+	}
+
+	if (!data->zmqContext)
+	{
+		data->zmqContext = zmq_ctx_new ();
+		if (data->zmqContext == NULL)
+		{
+			ELEKTRA_LOG_WARNING ("zmq_ctx_new failed %s", zmq_strerror (zmq_errno ()));
+			return 0;
+		}
+	}
+
+	int hwm = data->queueSize;
+	int linger = 0;
+	data->queueEndpoint = elektraFormat ("%s%p", ELEKTRA_ZEROMQSEND_QUEUE_ENDPOINT, (void *) data);
+	data->zmqQueue = zmq_socket (data->zmqContext, ZMQ_PAIR);
+	data->zmqQueueReceiver = zmq_socket (data->zmqContext, ZMQ_PAIR);
+	if (data->queueEndpoint == NULL || data->zmqQueue == NULL || data->zmqQueueReceiver == NULL ||
+	    zmq_setsockopt (data->zmqQueue, ZMQ_SNDHWM, &hwm, sizeof (hwm)) != 0 ||
+	    zmq_setsockopt (data->zmqQueue, ZMQ_LINGER, &linger, sizeof (linger)) != 0 ||
+	    zmq_setsockopt (data->zmqQueueReceiver, ZMQ_RCVHWM, &hwm, sizeof (hwm)) != 0 ||
+	    zmq_setsockopt (data->zmqQueueReceiver, ZMQ_LINGER, &linger, sizeof (linger)) != 0 ||
+	    zmq_bind (data->zmqQueueReceiver, data->queueEndpoint) != 0 || zmq_connect (data->zmqQueue, data->queueEndpoint) != 0)
+	{
+		ELEKTRA_LOG_WARNING ("creating notification queue failed: %s", zmq_strerror (zmq_errno ()));
+		goto error;
+	}
+
+	if (pthread_create (&data->senderThread, NULL, senderThreadMain, data) != 0)
+	{
+		ELEKTRA_LOG_WARNING ("creating sender thread failed");
+		goto error;
+	}
+	data->senderRunning = 1;
+	return 1;
+
+error:
+	if (data->zmqQueue) zmq_close (data->zmqQueue);
+	if (data->zmqQueueReceiver) zmq_close (data->zmqQueueReceiver);
+	data->zmqQueue = NULL;
+	data->zmqQueueReceiver = NULL;
+	elektraFree (data->queueEndpoint);
+	data->queueEndpoint = NULL;
+	return 0;
+}
+
+/**
+ * @internal
+ * Stop the sender thread after all queued notifications were published.
+ *
+ * If the stop record cannot be queued within the configured timeouts the
+ * ZeroMq context is shut down, which aborts the sender thread.
+ *
+ * @param data plugin data
+ */
+void elektraZeroMqSendStopSender (ElektraZeroMqSendPluginData * data)
+{
+	if (!data->senderRunning)
+	{
+		return;
+	}
+
+	int timeout = data->connectTimeout + data->subscribeTimeout;
+	zmq_setsockopt (data->zmqQueue, ZMQ_SNDTIMEO, &timeout, sizeof (timeout));
+	if (zmq_send (data->zmqQueue, "", 0, 0) == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not stop sender thread: %s; aborting queued notifications", zmq_strerror (zmq_errno ()));
+		zmq_ctx_shutdown (data->zmqContext);
+	}
+	pthread_join (data->senderThread, NULL);
+	data->senderRunning = 0;
+
+	zmq_close (data->zmqQueue);
+	data->zmqQueue = NULL;
+	elektraFree (data->queueEndpoint);
+	data->queueEndpoint = NULL;
+}
+
+/**
+ * @internal
+ * Queue a notification for the sender thread without blocking.
+ *
+ * @param  changeType type of change
+ * @param  keyName    name of changed key
+ * @param  data       plugin data
+ * @retval 1 on success
+ * @retval -3 if the queue is full
+ * @retval 0 on other errors
+ */
+int elektraZeroMqSendEnqueue (const char * changeType, const char * keyName, ElektraZeroMqSendPluginData * data)
+{
+	if (!elektraZeroMqSendStartSender (data))
+	{
+		return 0;
+	}
+
+	// both parts are delivered atomically, so a full queue rejects the first part
+	if (zmq_send (data->zmqQueue, changeType, elektraStrLen (changeType), ZMQ_SNDMORE | ZMQ_DONTWAIT) == -1)
+	{
+		return zmq_errno () == EAGAIN ? -3 : 0;
+	}
+	if (zmq_send (data->zmqQueue, keyName, elektraStrLen (keyName), ZMQ_DONTWAIT) == -1)
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * @internal
+ * Get the result of a publish that failed in the sender thread since the last call.
+ *
+ * @param  data plugin data
+ * @return result of elektraZeroMqSendPublish()
+ * @retval 1 if no failures were reported
+ */
+int elektraZeroMqSendPollResult (ElektraZeroMqSendPluginData * data)
+{
+	if (!data->senderRunning)
+	{
+		return 1;
+	}
+
+	int result;
+	int lastResult = 1;
+	while (zmq_recv (data->zmqQueue, &result, sizeof (result), ZMQ_DONTWAIT) == sizeof (result))
+	{
+		lastResult = result;
+	}
+	return lastResult;
+}
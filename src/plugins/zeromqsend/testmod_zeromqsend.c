@@ -9,7 +9,8 @@
 #include "zeromqsend.h"
 
 #include <stdio.h>  // printf() & co
-#include <time.h>   // time()
+#include <stdlib.h> // atol()
+#include <time.h>   // time(), clock_gettime()
 #include <unistd.h> // usleep()
 
 #include <kdberrors.h>	 // TIMEOUT ERROR
@@ -26,12 +27,23 @@ char * receivedChangeType;
 /** key name received by readNotificationFromTestSocket() */
 char * receivedKeyName;
 
+/** second key name of a batched notification received by readNotificationFromTestSocket() */
+char * receivedSecondKeyName;
+
+/** number of message parts readNotificationFromTestSocket() waits for */
+int expectedParts = 2;
+
 /** variable indicating that a timeout occurred while receiving */
 int receiveTimeout;
 
 /** zmq context for tests */
 void * context;
 
+/** variable indicating that the reader thread may bind its socket, see releaseNotificationReader() */
+int readerReleased = 1;
+pthread_mutex_t readerMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t readerCondition = PTHREAD_COND_INITIALIZER;
+
 /** time in microseconds before a new socket is created. leaves the system some after binding a socket again */
 #define TIME_HOLDOFF (1000 * 1000)
 
@@ -45,6 +57,17 @@ void * context;
 #define TESTCONFIG_CONNECT_TIMEOUT "5000"
 #define TESTCONFIG_SUBSCRIBE_TIMEOUT "5000"
 
+/** short connection timeout for test_timeoutConnect() */
+#define TESTCONFIG_SHORT_CONNECT_TIMEOUT "1000"
+
+/** @return value of the monotonic clock in milliseconds */
+static long currentMillis (void)
+{
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
 /**
  * Create subscriber socket for tests.
  * @internal
@@ -85,6 +108,14 @@ static void * createTestSocket (char * subscribeFilter)
  */
 static void * notificationReaderThreadMain (void * filter)
 {
+	// without a subscriber the plugin cannot publish, so queued notifications stay queued until we bind
+	pthread_mutex_lock (&readerMutex);
+	while (!readerReleased)
+	{
+		pthread_cond_wait (&readerCondition, &readerMutex);
+	}
+	pthread_mutex_unlock (&readerMutex);
+
 	void * subSocket = createTestSocket ((char *) filter);
 
 	time_t start = time (NULL);
@@ -95,7 +126,7 @@ static void * notificationReaderThreadMain (void * filter)
 	size_t moreSize = sizeof (more);
 	int rc;
 	int partCounter = 0;
-	int maxParts = 2; // change type and key name
+	int maxParts = expectedParts; // change type and key names
 	int lastErrno;
 	do
 	{
@@ -152,6 +183,9 @@ static void * notificationReaderThreadMain (void * filter)
 			case 1:
 				receivedKeyName = buffer;
 				break;
+			case 2:
+				receivedSecondKeyName = buffer;
+				break;
 			default:
 				yield_error ("test inconsistency");
 			}
@@ -180,6 +214,18 @@ static pthread_t * startNotificationReaderThread (char * filter)
 	return thread;
 }
 
+/**
+ * Allow a reader thread started with readerReleased set to 0 to bind its socket.
+ * @internal
+ */
+static void releaseNotificationReader (void)
+{
+	pthread_mutex_lock (&readerMutex);
+	readerReleased = 1;
+	pthread_cond_signal (&readerCondition);
+	pthread_mutex_unlock (&readerMutex);
+}
+
 static void test_commit (void)
 {
 	printf ("test commit notification\n");
@@ -220,6 +266,50 @@ static void test_commit (void)
 	elektraFree (thread);
 }
 
+static void test_commitBatch (void)
+{
+	printf ("test batched commit notifications\n");
+
+	Key * parentKey = keyNew ("system:/tests/foo", KEY_END);
+	Key * secondParentKey = keyNew ("system:/tests/bar", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+
+	KeySet * conf = ksNew (3, keyNew ("/endpoint", KEY_VALUE, TEST_ENDPOINT, KEY_END),
+			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_CONNECT_TIMEOUT, KEY_END),
+			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SUBSCRIBE_TIMEOUT, KEY_END), KS_END);
+	PLUGIN_OPEN ("zeromqsend");
+
+	receiveTimeout = 0;
+	receivedKeyName = NULL;
+	receivedSecondKeyName = NULL;
+	receivedChangeType = NULL;
+	expectedParts = 3;
+	readerReleased = 0;
+
+	pthread_t * thread = startNotificationReaderThread ("Commit");
+	// the reader subscribes only after both notifications are queued, so the sender thread publishes them in one message
+	plugin->kdbCommit (plugin, ks, parentKey);
+	plugin->kdbCommit (plugin, ks, secondParentKey);
+	releaseNotificationReader ();
+	pthread_join (*thread, NULL);
+
+	succeed_if (receiveTimeout == 0, "receiving did time out");
+	succeed_if (!keyGetMeta (parentKey, "warnings"), "warning meta key was set");
+	succeed_if_same_string ("Commit", receivedChangeType);
+	succeed_if_same_string (keyName (parentKey), receivedKeyName);
+	succeed_if_same_string (keyName (secondParentKey), receivedSecondKeyName);
+
+	expectedParts = 2;
+	ksDel (ks);
+	keyDel (parentKey);
+	keyDel (secondParentKey);
+	PLUGIN_CLOSE ();
+	elektraFree (receivedKeyName);
+	elektraFree (receivedSecondKeyName);
+	elektraFree (receivedChangeType);
+	elektraFree (thread);
+}
+
 static void test_timeoutConnect (void)
 {
 	printf ("test connect timeout\n");
@@ -229,7 +319,7 @@ static void test_timeoutConnect (void)
 	KeySet * ks = ksNew (0, KS_END);
 
 	KeySet * conf = ksNew (3, keyNew ("/endpoint", KEY_VALUE, TEST_ENDPOINT, KEY_END),
-			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_CONNECT_TIMEOUT, KEY_END),
+			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_SHORT_CONNECT_TIMEOUT, KEY_END),
 			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SUBSCRIBE_TIMEOUT, KEY_END), KS_END);
 	PLUGIN_OPEN ("zeromqsend");
 
@@ -239,6 +329,21 @@ static void test_timeoutConnect (void)
 	// add key to keyset
 	ksAppendKey (ks, toAdd);
 
+	// notifications are sent asynchronously, the commit must not wait for the connection
+	long start = currentMillis ();
+	plugin->kdbCommit (plugin, ks, parentKey);
+	succeed_if (currentMillis () - start < atol (TESTCONFIG_SHORT_CONNECT_TIMEOUT), "commit waited for connection");
+	succeed_if (!keyGetMeta (parentKey, "warnings"), "warning meta key was set before connection timed out");
+
+	// wait until the sender thread reports the connection timeout, the report is read by the next commit
+	ElektraZeroMqSendPluginData * data = elektraPluginGetData (plugin);
+	zmq_pollitem_t reportItem = { .socket = data->zmqQueue, .events = ZMQ_POLLIN };
+	int polled;
+	do
+	{
+		polled = zmq_poll (&reportItem, 1, TEST_TIMEOUT * 1000);
+	} while (polled == -1 && zmq_errno () == EINTR);
+	succeed_if (polled == 1, "connection timeout was not reported");
 	plugin->kdbCommit (plugin, ks, parentKey);
 
 	char * expectedWarningNumber = elektraFormat ("%s", ELEKTRA_ERROR_INSTALLATION);
@@ -309,6 +414,7 @@ int main (int argc, char ** argv)
 
 	// Test notification from plugin
 	test_commit ();
+	test_commitBatch ();
 
 	// test timeouts
 	test_timeoutConnect ();
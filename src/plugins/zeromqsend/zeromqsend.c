@@ -19,6 +19,7 @@
 #include <kdblogger.h>
 
 #include <errno.h>  // errno
+#include <limits.h> // INT_MAX
 #include <stdlib.h> // strtol()
 
 static long convertUnsignedLong (const char * string, long defaultValue)
@@ -62,12 +63,37 @@ int elektraZeroMqSendOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 		subscribeTimeout = convertUnsignedLong (keyString (subscribeTimeoutKey), ELEKTRA_ZEROMQ_DEFAULT_SUBSCRIBE_TIMEOUT);
 	}
 
+	// read size of notification queue from plugin configuration
+	Key * queueSizeKey = ksLookupByName (elektraPluginGetConfig (handle), "/queueSize", 0);
+	long queueSize = ELEKTRA_ZEROMQ_DEFAULT_QUEUE_SIZE;
+	if (queueSizeKey)
+	{
+		queueSize = convertUnsignedLong (keyString (queueSizeKey), ELEKTRA_ZEROMQ_DEFAULT_QUEUE_SIZE);
+	}
+	// the queue size is used as high water mark of the queue sockets, which is an int
+	if (queueSize < 0)
+	{
+		ELEKTRA_LOG_WARNING ("negative queue size %ld, using default", queueSize);
+		queueSize = ELEKTRA_ZEROMQ_DEFAULT_QUEUE_SIZE;
+	}
+	else if (queueSize > INT_MAX)
+	{
+		ELEKTRA_LOG_WARNING ("queue size %ld too large, using %d", queueSize, INT_MAX);
+		queueSize = INT_MAX;
+	}
+
 	ElektraZeroMqSendPluginData * data = elektraPluginGetData (handle);
 	if (!data)
 	{
 		data = elektraMalloc (sizeof (*data));
 		data->zmqContext = NULL;
 		data->zmqPublisher = NULL;
+		data->zmqPublisherMonitor = NULL;
+		data->zmqQueue = NULL;
+		data->zmqQueueReceiver = NULL;
+		data->queueEndpoint = NULL;
+		data->queueSize = (int) queueSize;
+		data->senderRunning = 0;
 		data->endpoint = endpoint;
 		data->connectTimeout = connectTimeout;
 		data->subscribeTimeout = subscribeTimeout;
@@ -109,7 +135,8 @@ int elektraZeroMqSendCommit (Plugin * handle, KeySet * returned ELEKTRA_UNUSED,
 	ElektraZeroMqSendPluginData * pluginData = elektraPluginGetData (handle);
 	ELEKTRA_NOT_NULL (pluginData);
 
-	int result = elektraZeroMqSendPublish ("Commit", keyName (parentKey), pluginData);
+	// notifications are published asynchronously, report failures of previous commits
+	int result = elektraZeroMqSendPollResult (pluginData);
 	switch (result)
 	{
 	case 1:
@@ -127,6 +154,20 @@ int elektraZeroMqSendCommit (Plugin * handle, KeySet * returned ELEKTRA_UNUSED,
 		break;
 	}
 
+	result = elektraZeroMqSendEnqueue ("Commit", keyName (parentKey), pluginData);
+	switch (result)
+	{
+	case 1:
+		// success!
+		break;
+	case -3:
+		ELEKTRA_ADD_RESOURCE_WARNING (parentKey, "Notification queue is full, dropping notification");
+		break;
+	default:
+		ELEKTRA_ADD_PLUGIN_MISBEHAVIOR_WARNING (parentKey, "Could not queue notification");
+		break;
+	}
+
 	return 1; /* success */
 }
 
@@ -138,11 +179,8 @@ int elektraZeroMqSendClose (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 		return 1;
 	}
 
-	if (pluginData->zmqPublisher)
-	{
-		zmq_close (pluginData->zmqPublisher);
-		pluginData->zmqPublisher = NULL;
-	}
+	// publishes all queued notifications and closes the publish socket
+	elektraZeroMqSendStopSender (pluginData);
 
 	if (pluginData->zmqContext)
 	{
@@ -13,6 +13,7 @@
 #include <kdbassert.h>
 #include <kdbplugin.h>
 
+#include <pthread.h>
 #include <time.h> // struct timespec
 
 #include <zmq.h>
@@ -26,17 +27,35 @@
 /** default subscription timeout for plugin */
 #define ELEKTRA_ZEROMQ_DEFAULT_SUBSCRIBE_TIMEOUT 200
 
+/** default number of queued notifications before commits start dropping them */
+#define ELEKTRA_ZEROMQ_DEFAULT_QUEUE_SIZE 1000
+
+/** maximum number of key names sent in one multipart message */
+#define ELEKTRA_ZEROMQSEND_MAX_BATCH 256
+
 /**
  * @internal
  * Private plugin state
  */
 typedef struct
 {
-	// ZeroMQ context and socket (NULL until initialized at first elektraZeroMqSendPublish())
+	// ZeroMQ context (NULL until initialized at first elektraZeroMqSendEnqueue())
 	void * zmqContext;
+
+	// publish socket and monitor, only used by the sender thread
 	void * zmqPublisher;
 	void * zmqPublisherMonitor;
 
+	// commit side of the in-process notification queue
+	void * zmqQueue;
+	// sender thread side of the in-process notification queue
+	void * zmqQueueReceiver;
+	char * queueEndpoint;
+	int queueSize;
+
+	pthread_t senderThread;
+	int senderRunning;
+
 	// endpoint for publish socket
 	const char * endpoint;
 
@@ -48,8 +67,14 @@ typedef struct
 } ElektraZeroMqSendPluginData;
 
 int elektraZeroMqSendConnect (ElektraZeroMqSendPluginData * data);
-int elektraZeroMqSendPublish (const char * changeType, const char * keyName, ElektraZeroMqSendPluginData * data);
-int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyName);
+int elektraZeroMqSendWaitForSubscriber (ElektraZeroMqSendPluginData * data);
+int elektraZeroMqSendPublish (const char * changeType, const char ** keyNames, size_t keyNameCount, ElektraZeroMqSendPluginData * data);
+int elektraZeroMqSendNotification (void * socket, const char * changeType, const char ** keyNames, size_t keyNameCount);
+
+int elektraZeroMqSendStartSender (ElektraZeroMqSendPluginData * data);
+void elektraZeroMqSendStopSender (ElektraZeroMqSendPluginData * data);
+int elektraZeroMqSendEnqueue (const char * changeType, const char * keyName, ElektraZeroMqSendPluginData * data);
+int elektraZeroMqSendPollResult (ElektraZeroMqSendPluginData * data);
 
 int elektraZeroMqSendOpen (Plugin * handle, Key * errorKey);
 int elektraZeroMqSendClose (Plugin * handle, Key * errorKey);
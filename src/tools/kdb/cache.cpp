@@ -25,7 +25,9 @@ CacheCommand::CacheCommand ()
 
 int CacheCommand::execute (Cmdline const & cl)
 {
-	if (cl.arguments.size () != 1) throw invalid_argument ("1 argument required");
+	// only stats takes an optional directory
+	size_t maxArguments = !cl.arguments.empty () && cl.arguments[0] == "stats" ? 2 : 1;
+	if (cl.arguments.empty () || cl.arguments.size () > maxArguments) throw invalid_argument ("1 argument required");
 
 	KeySet conf;
 	Key parentKey ("system:/elektra/cache", KEY_END);
@@ -65,6 +67,22 @@ int CacheCommand::execute (Cmdline const & cl)
 		parentKey.setMeta ("cache/clear", "1");
 		plugin->get (ks, parentKey);
 	}
+	else if (cmd == "stats")
+	{
+		Modules modules;
+		PluginPtr plugin = modules.load ("backend", cl.getPluginsConfig ());
+
+		KeySet ks;
+		parentKey.setMeta ("cache/stats", "1");
+		// an empty value selects the default directory
+		parentKey.setString (cl.arguments.size () == 2 ? cl.arguments[1] : "");
+		plugin->get (ks, parentKey);
+
+		for (Key k : ks)
+		{
+			cout << k.getBaseName () << ": " << k.getString () << endl;
+		}
+	}
 	else
 	{
 		throw invalid_argument ("not a valid subcommand");
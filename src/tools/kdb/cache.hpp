@@ -25,12 +25,12 @@ public:
 
 	virtual std::string getSynopsis () override
 	{
-		return "{enable,disable,default,clear}";
+		return "{enable,disable,default,clear,stats [<directory>]}";
 	}
 
 	virtual std::string getShortHelpText () override
 	{
-		return "Enable, disable, clear the cache or revert to default.";
+		return "Enable, disable, clear the cache, revert to default or show statistics.";
 	}
 
 	virtual std::string getLongHelpText () override
@@ -38,7 +38,11 @@ public:
 		return "This command is used to enable or disable the cache and to revert\n"
 		       "to the default settings. The default settings will let the system\n"
 		       "decide whether to use the cache or not. The clear command will\n"
-		       "remove the generated cache files in a safe way.\n";
+		       "remove the generated cache files in a safe way.\n"
+		       "\n"
+		       "The stats command shows the statistics of the parse cache of the\n"
+		       "backend plugin (see `definition/cache`). Without a directory the\n"
+		       "default cache directory is used.\n";
 	}
 
 	virtual int execute (Cmdline const & cmdline) override;
@@ -23,6 +23,7 @@
 #include <kdbplugin.h>
 #include <kdbtypes.h>
 
+#include <algorithm>
 #include <fstream>
 #include <key.hpp>
 #include <memory>
@@ -44,6 +45,8 @@ const char * HighlevelGenTemplate::Params::InstallPrefix = "installPrefix";
 const char * HighlevelGenTemplate::Params::EmbedHelpFallback = "embedHelpFallback";
 const char * HighlevelGenTemplate::Params::UseCommands = "useCommands";
 const char * HighlevelGenTemplate::Params::InitWithPointers = "initWithPointers";
+const char * HighlevelGenTemplate::Params::SnapshotFunctionName = "snapshotFn";
+const char * HighlevelGenTemplate::Params::SnapshotType = "snapshotType";
 
 enum class EmbeddedSpec
 {
@@ -182,6 +185,70 @@ static void keySetToQuickdump (kdb::KeySet & set, const std::string & path, cons
 	}
 }
 
+namespace
+{
+/** a member of the snapshot struct, either a field or a nested struct */
+struct SnapshotMember
+{
+	std::string name;
+	bool isField = false;
+	kainjow::mustache::object field;
+	std::vector<SnapshotMember> children;
+};
+} // namespace
+
+static void addSnapshotField (SnapshotMember & root, const std::string & keyName, const std::vector<std::string> & path,
+			      kainjow::mustache::object field)
+{
+	SnapshotMember * cur = &root;
+	for (const auto & part : path)
+	{
+		if (cur->isField)
+		{
+			throw CommandAbortException ("The key '" + keyName +
+						     "' is below a key with a value, this is not supported in snapshot structs!");
+		}
+
+		auto child = std::find_if (cur->children.begin (), cur->children.end (),
+					   [&part] (const SnapshotMember & member) { return member.name == part; });
+		if (child == cur->children.end ())
+		{
+			cur->children.emplace_back ();
+			cur->children.back ().name = part;
+			child = cur->children.end () - 1;
+		}
+		cur = &*child;
+	}
+
+	if (cur->isField || !cur->children.empty ())
+	{
+		throw CommandAbortException ("The key '" + keyName + "' has a value and keys below it, this is not supported in snapshot structs!");
+	}
+	cur->isField = true;
+	cur->field = std::move (field);
+}
+
+static void listSnapshotMembers (const SnapshotMember & member, const std::string & indent, kainjow::mustache::list & members)
+{
+	using namespace kainjow::mustache;
+
+	for (const auto & child : member.children)
+	{
+		if (child.isField)
+		{
+			object field = child.field;
+			field["field?"] = true;
+			field["indent"] = indent;
+			members.emplace_back (field);
+			continue;
+		}
+
+		members.emplace_back (object{ { "open?", true }, { "indent", indent } });
+		listSnapshotMembers (child, indent + "\t", members);
+		members.emplace_back (object{ { "close?", true }, { "indent", indent }, { "field_name", child.name } });
+	}
+}
+
 static kdb::KeySet cascadingToSpec (const kdb::KeySet & ks)
 {
 	auto result = kdb::KeySet (ks.size (), KS_END);
@@ -249,6 +316,8 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 										      { "strcmp", EnumConversion::Strcmp } });
 	auto useCommands = getBoolParameter (Params::UseCommands, false);
 	auto initWithPointers = getBoolParameter (Params::InitWithPointers, true);
+	auto snapshotFunctionName = getParameter (Params::SnapshotFunctionName, "");
+	auto snapshotType = getParameter (Params::SnapshotType, "Config");
 
 
 	std::string cascadingParent;
@@ -289,13 +358,18 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 			    { "embed_defaults?", specHandling == EmbeddedSpec::Defaults },
 			    { "spec_as_defaults?", specHandling == EmbeddedSpec::Full },
 			    { "more_headers", list (additionalHeaders.begin (), additionalHeaders.end ()) },
-			    { "init_with_pointers?", initWithPointers } };
+			    { "init_with_pointers?", initWithPointers },
+			    { "snapshot_function_name", snapshotFunctionName },
+			    { "snapshot_type", snapshotType } };
 
 	list enums;
 	list structs;
 	list keys;
 	list unions;
 	list commands;
+	list snapshotFields;
+	SnapshotMember snapshotRoot;
+	size_t handleCount = 0;
 
 	auto specParent = kdb::Key (specParentName, KEY_END);
 
@@ -481,14 +555,24 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 
 		auto isArray = key.getBaseName () == "#";
 
+		// keys of builtin types are read via static const ElektraKeyHandles, each with its own slot in the Elektra instance
+		auto isBuiltin = type != "enum" && type != "struct" && type != "struct_ref";
+
 		object keyObject = { { "name", name.substr (cascadingParent.size () + 1) }, // + 2 to remove slash
 				     { "native_type", nativeType },
 				     { "macro_name", tagPrefix + snakeCaseToMacroCase (tagName) },
 				     { "tag_name", snakeCaseToPascalCase (tagName) },
 				     { "type_name", typeName },
+				     { "kdb_type", type },
 				     { "is_string?", isString },
+				     { "is_builtin?", isBuiltin },
 				     { "is_array?", isArray } };
 
+		if (args.empty () && isBuiltin)
+		{
+			keyObject["handle_index"] = std::to_string (handleCount++);
+		}
+
 		if (!args.empty ())
 		{
 			keyObject["args?"] = object{ { "args", args } };
@@ -611,6 +695,32 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 			}
 		}
 
+		// keys without placeholders are part of the snapshot struct, keys below other keys become nested structs
+		if (!snapshotFunctionName.empty () && args.empty () && (isBuiltin || type == "enum"))
+		{
+			auto parts = getKeyParts (key);
+			parts.erase (parts.begin (), parts.begin () + parentKeyParts.size ());
+
+			std::vector<std::string> path;
+			std::string fieldPath;
+			for (const auto & namePart : parts)
+			{
+				path.push_back (snakeCaseToCamelCase (getTagName (namePart)));
+				fieldPath += (fieldPath.empty () ? "" : ".") + path.back ();
+			}
+
+			object field = { { "name", keyObject["name"].string_value () },
+					 { "field_name", path.back () },
+					 { "field_path", fieldPath },
+					 { "native_type", keyObject["native_type"].string_value () },
+					 { "type_name", keyObject["type_name"].string_value () },
+					 { "kdb_type", type },
+					 { "index", std::to_string (snapshotFields.size ()) },
+					 { "handle_index", std::to_string (handleCount++) } };
+			snapshotFields.emplace_back (field);
+			addSnapshotField (snapshotRoot, name, path, field);
+		}
+
 		keys.emplace_back (keyObject);
 	}
 
@@ -636,6 +746,16 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 	// FIXME [new_backend]: token calculation broken
 	// contract.append (kdb::Key ("system:/elektra/contract/highlevel/check/spec/token", KEY_VALUE, token, KEY_END));
 
+	// precompile the option specification, so that gopts doesn't have to process it on every start
+	kdb::Key optsTableRoot ("system:/elektra/contract/mountglobal/gopts/spec", KEY_END);
+	kdb::Key optsParent (specParentName, KEY_END);
+	if (ckdb::elektraGetOptsPrecompile (specWithParent.getKeySet (), optsParent.getKey (), contract.getKeySet (),
+					    optsTableRoot.getKey ()) != 0)
+	{
+		kdb::printError (std::cerr, optsParent, false, false);
+		throw CommandAbortException ("Error during precompilation of command-line options.");
+	}
+
 
 	data["keys_count"] = std::to_string (keys.size ());
 	data["keys"] = keys;
@@ -644,6 +764,12 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 	data["structs"] = structs;
 	data["commands"] = commands;
 	data["commands_count"] = std::to_string (commands.size ());
+	data["snapshot?"] = !snapshotFields.empty ();
+	data["snapshot_fields"] = snapshotFields;
+
+	list snapshotMembers;
+	listSnapshotMembers (snapshotRoot, "\t", snapshotMembers);
+	data["snapshot_members"] = snapshotMembers;
 	data["spec"] = keySetToCCode (spec);
 	data["defaults"] = keySetToCCode (defaults);
 	data["contract"] = keySetToCCode (contract);
@@ -28,6 +28,8 @@ class HighlevelGenTemplate : public GenTemplate
 		static const char * EmbedHelpFallback;
 		static const char * UseCommands;
 		static const char * InitWithPointers;
+		static const char * SnapshotFunctionName;
+		static const char * SnapshotType;
 	};
 
 public:
@@ -47,7 +49,9 @@ public:
 			 { Params::InstallPrefix, false },
 			 { Params::EmbedHelpFallback, false },
 			 { Params::UseCommands, false },
-			 { Params::InitWithPointers, false } })
+			 { Params::InitWithPointers, false },
+			 { Params::SnapshotFunctionName, false },
+			 { Params::SnapshotType, false } })
 	{
 	}
 
@@ -192,6 +192,9 @@ ScrollView {
 							property var elements: model.children
 							property var text: model.name
 							sourceComponent: (expanded && !!model.childCount > 0) ? treeBranch : undefined
+
+							onExpandedChanged: if (expanded) fetchChildren(model)
+							Component.onCompleted: if (expanded) fetchChildren(model)
 						}
 					}
 				}
@@ -208,6 +211,7 @@ ScrollView {
 	}
 
 	function mousePressed(mouse, model, itemLoader) {
+			fetchChildren(model)
 			currentNode = model
 			currentItem = itemLoader
 			keyAreaSelectedItem = null
@@ -219,6 +223,12 @@ ScrollView {
 		view.updateIndicator()
 	}
 
+	//the children of a node are created when they are shown for the first time
+	function fetchChildren(model) {
+		if (model.parentModel !== null)
+			model.parentModel.fetchChildren(model.index)
+	}
+
 	function getOpacity(model) {
 		if (model.childCount > 0 && !model.childrenHaveNoChildren)
 			return 1
@@ -9,11 +9,13 @@
 #include "confignode.hpp"
 #include "treeviewmodel.hpp"
 
+#include <QHash>
+
 using namespace kdb;
 
 ConfigNode::ConfigNode (QString name, QString path, const Key & key, TreeViewModel * parentModel)
 : m_name (std::move (name)), m_path (std::move (path)), m_key (key), m_children (new TreeViewModel), m_metaData (nullptr),
-  m_parentModel (parentModel), m_isExpanded (false), m_isDirty (false)
+  m_parentModel (parentModel), m_isExpanded (false), m_isDirty (false), m_isLoaded (false), m_pendingDeepKeys (0)
 {
 	setValue ();
 
@@ -30,7 +32,8 @@ ConfigNode::ConfigNode (QString name, QString path, const Key & key, TreeViewMod
 
 ConfigNode::ConfigNode (const ConfigNode & other)
 : QObject (), m_name (other.m_name), m_path (other.m_path), m_value (other.m_value), m_key (other.m_key.dup ()),
-  m_children (new TreeViewModel), m_metaData (nullptr), m_parentModel (nullptr), m_isExpanded (other.m_isExpanded), m_isDirty (false)
+  m_children (new TreeViewModel), m_metaData (nullptr), m_parentModel (nullptr), m_isExpanded (other.m_isExpanded), m_isDirty (false),
+  m_isLoaded (other.m_isLoaded), m_pendingChildNames (other.m_pendingChildNames), m_pendingDeepKeys (other.m_pendingDeepKeys)
 {
 	if (other.m_children)
 	{
@@ -40,6 +43,11 @@ ConfigNode::ConfigNode (const ConfigNode & other)
 		}
 	}
 
+	for (auto & pending : other.m_pendingKeys)
+	{
+		m_pendingKeys.append (qMakePair (pending.first, pending.second.dup ()));
+	}
+
 	if (other.m_metaData)
 	{
 		m_metaData = new TreeViewModel;
@@ -52,7 +60,9 @@ ConfigNode::ConfigNode (const ConfigNode & other)
 	connect (m_children, SIGNAL (expandNode (bool)), this, SLOT (setIsExpanded (bool)));
 }
 
-ConfigNode::ConfigNode () : m_children (nullptr), m_metaData (nullptr), m_parentModel (nullptr), m_isExpanded (false), m_isDirty (false)
+ConfigNode::ConfigNode ()
+: m_children (nullptr), m_metaData (nullptr), m_parentModel (nullptr), m_isExpanded (false), m_isDirty (false), m_isLoaded (true),
+  m_pendingDeepKeys (0)
 {
 	// this constructor is used to create metanodes
 }
@@ -65,7 +75,7 @@ ConfigNode::~ConfigNode ()
 
 int ConfigNode::getChildCount () const
 {
-	if (m_children) return m_children->rowCount ();
+	if (m_children) return m_children->rowCount () + m_pendingChildNames.count ();
 	return 0;
 }
 
@@ -190,6 +200,9 @@ void ConfigNode::accept (Visitor & visitor)
 
 	if (m_children)
 	{
+		// visitors that handle the pending keys on their own do not need ConfigNodes for them
+		if (visitor.needsAllNodes ()) fetchChildren ();
+
 		foreach (ConfigNodePtr node, m_children->model ())
 			node->accept (visitor);
 	}
@@ -241,9 +254,99 @@ void ConfigNode::updateNode (Key key)
 {
 	m_key = key;
 	setValue ();
+
+	if (!m_metaData) m_metaData = new TreeViewModel;
 	populateMetaModel ();
 }
 
+bool ConfigNode::isLoaded () const
+{
+	return m_isLoaded;
+}
+
+void ConfigNode::addPendingKey (const QStringList & keys, const Key & key)
+{
+	m_pendingKeys.append (qMakePair (keys, key));
+	m_isLoaded = false;
+
+	if (!hasChild (keys.first ())) m_pendingChildNames.insert (keys.first ());
+	if (keys.count () > 1) m_pendingDeepKeys++;
+}
+
+void ConfigNode::removePendingKey (const Key & key)
+{
+	for (int i = m_pendingKeys.count () - 1; i >= 0; i--)
+	{
+		if (m_pendingKeys.at (i).second == key) m_pendingKeys.removeAt (i);
+	}
+
+	countPendingKeys ();
+}
+
+const QList<QPair<QStringList, Key>> & ConfigNode::getPendingKeys () const
+{
+	return m_pendingKeys;
+}
+
+void ConfigNode::countPendingKeys ()
+{
+	m_pendingChildNames.clear ();
+	m_pendingDeepKeys = 0;
+
+	for (auto & pending : m_pendingKeys)
+	{
+		if (!hasChild (pending.first.first ())) m_pendingChildNames.insert (pending.first.first ());
+		if (pending.first.count () > 1) m_pendingDeepKeys++;
+	}
+}
+
+void ConfigNode::fetchChildren ()
+{
+	if (m_isLoaded || !m_children) return;
+
+	m_isLoaded = true;
+
+	QList<QPair<QStringList, Key>> pendingKeys;
+	pendingKeys.swap (m_pendingKeys);
+	countPendingKeys ();
+
+	QHash<QString, ConfigNodePtr> children;
+	foreach (ConfigNodePtr node, m_children->model ())
+	{
+		children.insert (node->getName (), node);
+	}
+
+	QList<ConfigNodePtr> newChildren;
+
+	for (auto & pending : pendingKeys)
+	{
+		QString name = pending.first.takeFirst ();
+		bool isLeaf = pending.first.isEmpty ();
+		ConfigNodePtr child = children.value (name);
+
+		if (!child)
+		{
+			// in a sorted KeySet the key of a node comes before the keys below it
+			if (isLeaf)
+				child = ConfigNodePtr (new ConfigNode (name, (m_path + "/" + name), pending.second, m_children));
+			else
+				child = ConfigNodePtr (new ConfigNode (name, (m_path + "/" + name), nullptr, m_children));
+
+			children.insert (name, child);
+			newChildren.append (child);
+		}
+		else if (isLeaf)
+		{
+			child->updateNode (pending.second);
+			m_children->nodeChanged (child);
+		}
+
+		if (!isLeaf) child->addPendingKey (pending.first, pending.second);
+	}
+
+	m_children->append (newChildren);
+}
+
 void ConfigNode::setIsExpanded (bool value)
 {
 	m_isExpanded = value;
@@ -256,10 +359,10 @@ bool ConfigNode::isNamespaceRoot () const
 
 void ConfigNode::populateMetaModel ()
 {
+	m_metaData->clearMetaModel ();
+
 	if (m_key)
 	{
-		m_metaData->clearMetaModel ();
-
 		ckdb::KeySet * metaKeys = ckdb::keyMeta (m_key.getKey ());
 		for (ssize_t it = 0; it < ckdb::ksGetSize (metaKeys); ++it)
 		{
@@ -282,6 +385,8 @@ void ConfigNode::setValue ()
 		m_value = QVariant::fromValue (QString::fromStdString (m_key.getString ()));
 	else if (m_key && m_key.isBinary ())
 		m_value = QVariant::fromValue (QString::fromStdString (m_key.getBinary ()));
+	else
+		m_value = QVariant ();
 }
 
 void ConfigNode::setKey (Key key)
@@ -308,6 +413,7 @@ void ConfigNode::setKeyName (const QString & name)
 
 void ConfigNode::appendChild (ConfigNodePtr node)
 {
+	fetchChildren ();
 	m_children->append (node);
 }
 
@@ -370,6 +476,8 @@ void ConfigNode::setPath (const QString & path)
 
 	if (m_children)
 	{
+		// the names of the pending keys would still use the old path
+		fetchChildren ();
 		foreach (ConfigNodePtr node, m_children->model ())
 		{
 			node->setPath (m_path + "/" + node->getName ());
@@ -389,5 +497,5 @@ bool ConfigNode::childrenHaveNoChildren () const
 		}
 	}
 
-	return childcount == 0;
+	return childcount == 0 && m_pendingDeepKeys == 0;
 }
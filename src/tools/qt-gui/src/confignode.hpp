@@ -9,8 +9,12 @@
 #ifndef CONFIGNODE_H
 #define CONFIGNODE_H
 
+#include <QList>
 #include <QObject>
+#include <QPair>
+#include <QSet>
 #include <QSharedPointer>
+#include <QStringList>
 #include <QVariant>
 
 #include <cassert>
@@ -52,7 +56,7 @@ public:
 	}
 
 	/**
-	 * @brief Returns the number of children of this ConfigNode.
+	 * @brief Returns the number of children of this ConfigNode, including the children that were not fetched yet.
 	 *
 	 * @return The number of children of this ConfigNode.
 	 */
@@ -110,7 +114,8 @@ public:
 	bool hasChild (const QString & name) const;
 
 	/**
-	 * @brief Get the children of this ConfigNode.
+	 * @brief Get the children of this ConfigNode. Children that were not fetched yet are not part of the model, see
+	 * TreeViewModel::fetchMore().
 	 *
 	 * @return The children of this ConfigNode as model.
 	 */
@@ -240,6 +245,42 @@ public:
 	void setIsDirty (bool dirty);
 	void updateNode (kdb::Key key);
 
+	/**
+	 * @brief Returns if the children of this ConfigNode were fetched already.
+	 *
+	 * @return True if the children of this ConfigNode were fetched.
+	 */
+	bool isLoaded () const;
+
+	/**
+	 * @brief Creates the direct children of this ConfigNode for the pending keys and passes the keys further below on to them.
+	 * Views request this with TreeViewModel::fetchMore().
+	 */
+	void fetchChildren ();
+
+	/**
+	 * @brief Remembers a key below this ConfigNode. The ConfigNodes for the key are created when the children of this
+	 * ConfigNode are fetched.
+	 *
+	 * @param keys The path of the key relative to this ConfigNode, splitted up into a QStringList.
+	 * @param key The key below this ConfigNode.
+	 */
+	void addPendingKey (const QStringList & keys, const kdb::Key & key);
+
+	/**
+	 * @brief Forgets a key that was added with addPendingKey().
+	 *
+	 * @param key The key that is not below this ConfigNode anymore.
+	 */
+	void removePendingKey (const kdb::Key & key);
+
+	/**
+	 * @brief Returns the keys below this ConfigNode for which no ConfigNodes were created yet.
+	 *
+	 * @return The keys together with their path relative to this ConfigNode.
+	 */
+	const QList<QPair<QStringList, kdb::Key>> & getPendingKeys () const;
+
 	/**
 	 * @return true if this is ConfigNode is the root of a namespace
 	 */
@@ -258,6 +299,18 @@ private:
 	bool m_isExpanded;
 	bool m_isDirty;
 
+	bool m_isLoaded;
+	QList<QPair<QStringList, kdb::Key>> m_pendingKeys;
+	// names of the children that only exist as pending keys
+	QSet<QString> m_pendingChildNames;
+	// number of pending keys below the children
+	int m_pendingDeepKeys;
+
+	/**
+	 * @brief Recalculates m_pendingChildNames and m_pendingDeepKeys from the pending keys.
+	 */
+	void countPendingKeys ();
+
 	/**
 	 * @brief Populates the TreeViewModel which holds the metakeys of this ConfigNode.
 	 */
@@ -23,6 +23,11 @@ void KeySetVisitor::visit (ConfigNode & node)
 	{
 		m_set.append (key);
 	}
+
+	for (auto & pending : node.getPendingKeys ())
+	{
+		m_set.append (pending.second);
+	}
 }
 
 void KeySetVisitor::visit (TreeViewModel * model)
@@ -33,6 +38,11 @@ void KeySetVisitor::visit (TreeViewModel * model)
 	}
 }
 
+bool KeySetVisitor::needsAllNodes () const
+{
+	return false;
+}
+
 KeySet KeySetVisitor::getKeySet ()
 {
 	return m_set.dup ();
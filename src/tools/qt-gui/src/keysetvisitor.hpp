@@ -27,6 +27,7 @@ public:
 
 	void visit (ConfigNode & node) override;
 	void visit (TreeViewModel * model) override;
+	bool needsAllNodes () const override;
 
 	/**
 	 * @brief getKeySet Returns the kdb::KeySet with all current valid keys
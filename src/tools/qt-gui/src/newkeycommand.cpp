@@ -13,6 +13,9 @@ NewKeyCommand::NewKeyCommand (TreeViewModel * model, int index, DataContainer *
 : QUndoCommand (parent), m_parentNode (model->model ().at (index)), m_newNode (nullptr), m_value (data->newValue ()),
   m_metaData (data->newMetadata ())
 {
+	// the new node is looked up among the children below
+	model->fetchMore (model->index (index));
+
 	TreeViewModel * parentModel = m_parentNode->getChildren ();
 	kdb::Key newKey = parentModel->createNewKey (m_parentNode->getPath () + "/" + data->newName (), m_value, m_metaData);
 
@@ -9,6 +9,7 @@
 #include "treeviewmodel.hpp"
 
 #include <backends.hpp>
+#include <cstring>
 #include <kdbconfig.h> // for DEBUG and VERBOSE
 #include <kdbease.h>
 #include <modules.hpp>
@@ -344,6 +345,26 @@ Qt::ItemFlags TreeViewModel::flags (const QModelIndex & idx) const
 	return QAbstractItemModel::flags (idx) | Qt::ItemIsEditable | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled;
 }
 
+bool TreeViewModel::canFetchMore (const QModelIndex & parentIndex) const
+{
+	// this model is a flat list, a valid index stands for the ConfigNode whose children model gets filled
+	if (!parentIndex.isValid () || parentIndex.row () > (m_model.size () - 1)) return false;
+
+	return !m_model.at (parentIndex.row ())->isLoaded ();
+}
+
+void TreeViewModel::fetchMore (const QModelIndex & parentIndex)
+{
+	if (!canFetchMore (parentIndex)) return;
+
+	m_model.at (parentIndex.row ())->fetchChildren ();
+}
+
+void TreeViewModel::fetchChildren (int idx)
+{
+	fetchMore (index (idx));
+}
+
 void TreeViewModel::accept (Visitor & visitor)
 {
 	visitor.visit (this);
@@ -461,25 +482,31 @@ void TreeViewModel::sink (ConfigNodePtr node, QStringList keys, const Key & key)
 {
 	if (keys.length () == 0) return;
 
+	if (!node->isLoaded ())
+	{
+		// the ConfigNodes are created as soon as the children of node are requested
+		node->addPendingKey (keys, key);
+		return;
+	}
+
 	bool isLeaf = (keys.length () == 1);
 
 	QString name = keys.takeFirst ();
+	ConfigNodePtr child = node->getChildByName (name);
 
-	if (node->hasChild (name) && !node->getChildByName (name)->isDirty ())
+	if (child && !child->isDirty ())
 	{
-		if (node->getChildByName (name)->getKey () && node->getChildByName (name)->getKey ().getName () == key.getName ())
+		if (isLeaf && (!child->getKey () || child->getKey ().getName () == key.getName ()))
 		{
-			if (node->getChildByName (name)->getKey ().getName () == key.getName ())
-			{
-				node->getChildByName (name)->updateNode (key);
-			}
+			child->updateNode (key);
+			node->getChildren ()->nodeChanged (child);
 		}
 
-		sink (node->getChildByName (name), keys, key);
+		sink (child, keys, key);
 	}
 	else
 	{
-		if (node->hasChild (name)) node->getChildren ()->removeRow (node->getChildIndexByName (name));
+		if (child) node->getChildren ()->removeRow (node->getChildIndexByName (name));
 
 		ConfigNodePtr newNode;
 
@@ -494,6 +521,57 @@ void TreeViewModel::sink (ConfigNodePtr node, QStringList keys, const Key & key)
 	}
 }
 
+void TreeViewModel::sinkKey (const Key & key)
+{
+	QStringList keys = getSplittedKeyname (key);
+	QString root = keys.takeFirst ();
+
+	foreach (ConfigNodePtr node, m_model)
+	{
+		if (root == node->getName ()) sink (node, keys, key);
+	}
+}
+
+void TreeViewModel::remove (ConfigNodePtr node, QStringList keys, const Key & key)
+{
+	if (keys.length () == 0) return;
+
+	if (!node->isLoaded ())
+	{
+		node->removePendingKey (key);
+		return;
+	}
+
+	QString name = keys.takeFirst ();
+	ConfigNodePtr child = node->getChildByName (name);
+
+	if (!child || child->isDirty ()) return;
+
+	if (!keys.isEmpty ())
+	{
+		remove (child, keys, key);
+	}
+	else if (child->getKey () && child->getKey () == key)
+	{
+		child->updateNode (nullptr);
+		node->getChildren ()->nodeChanged (child);
+	}
+
+	// nodes without a key only exist to hold the nodes below them
+	if (!child->getKey () && child->getChildCount () == 0) node->getChildren ()->removeRow (node->getChildIndexByName (name));
+}
+
+void TreeViewModel::removeKey (const Key & key)
+{
+	QStringList keys = getSplittedKeyname (key);
+	QString root = keys.takeFirst ();
+
+	foreach (ConfigNodePtr node, m_model)
+	{
+		if (root == node->getName ()) remove (node, keys, key);
+	}
+}
+
 void TreeViewModel::populateModel ()
 {
 	kdb::KeySet config;
@@ -503,6 +581,7 @@ void TreeViewModel::populateModel ()
 
 void TreeViewModel::populateModel (KeySet const & keySet)
 {
+	beginResetModel ();
 	m_model.clear ();
 
 	auto nsToShow = { ElektraNamespace::SPEC, ElektraNamespace::DIR, ElektraNamespace::USER, ElektraNamespace::SYSTEM };
@@ -519,23 +598,79 @@ void TreeViewModel::populateModel (KeySet const & keySet)
 							  QString::fromStdString (name), nullptr, this));
 	}
 
+	// the root nodes only remember the keys, nodes are created when the view requests them
 	createNewNodes (keySet);
+	endResetModel ();
 }
 
 void TreeViewModel::createNewNodes (KeySet keySet)
 {
 	for (ssize_t it = 0; it < keySet.size (); ++it)
 	{
-		Key k = keySet.at (it);
-		QStringList keys = getSplittedKeyname (k);
-		QString root = keys.takeFirst ();
+		sinkKey (keySet.at (it));
+	}
+}
+
+namespace
+{
 
-		for (int i = 0; i < m_model.count (); i++)
+bool hasSameData (Key const & a, Key const & b)
+{
+	if (*a == *b) return true;
+
+	ssize_t size = ckdb::keyGetValueSize (*a);
+	if (a.isBinary () != b.isBinary () || size != ckdb::keyGetValueSize (*b)) return false;
+	if (size > 0 && memcmp (ckdb::keyValue (*a), ckdb::keyValue (*b), size) != 0) return false;
+
+	ckdb::KeySet * aMeta = ckdb::keyMeta (*a);
+	ckdb::KeySet * bMeta = ckdb::keyMeta (*b);
+	if (ckdb::ksGetSize (aMeta) != ckdb::ksGetSize (bMeta)) return false;
+
+	for (elektraCursor it = 0; it < ckdb::ksGetSize (aMeta); ++it)
+	{
+		ckdb::Key * aCurrent = ckdb::ksAtCursor (aMeta, it);
+		ckdb::Key * bCurrent = ckdb::ksAtCursor (bMeta, it);
+		if (ckdb::keyCmp (aCurrent, bCurrent) != 0 || strcmp (ckdb::keyString (aCurrent), ckdb::keyString (bCurrent)) != 0)
 		{
-			if (root == m_model.at (i)->getName ())
-			{
-				sink (m_model.at (i), keys, k);
-			}
+			return false;
+		}
+	}
+
+	return true;
+}
+
+} // namespace
+
+void TreeViewModel::updateNodes (KeySet const & oldKeys, KeySet const & newKeys)
+{
+	elektraCursor oldIt = 0;
+	elektraCursor newIt = 0;
+
+	// both KeySets are sorted, so a single pass finds all differences
+	while (oldIt < oldKeys.size () || newIt < newKeys.size ())
+	{
+		int cmp;
+
+		if (oldIt == oldKeys.size ())
+			cmp = 1;
+		else if (newIt == newKeys.size ())
+			cmp = -1;
+		else
+			cmp = ckdb::keyCmp (*oldKeys.at (oldIt), *newKeys.at (newIt));
+
+		if (cmp < 0)
+		{
+			removeKey (oldKeys.at (oldIt++));
+		}
+		else if (cmp > 0)
+		{
+			sinkKey (newKeys.at (newIt++));
+		}
+		else
+		{
+			if (!hasSameData (oldKeys.at (oldIt), newKeys.at (newIt))) sinkKey (newKeys.at (newIt));
+			oldIt++;
+			newIt++;
 		}
 	}
 }
@@ -559,6 +694,31 @@ void TreeViewModel::append (ConfigNodePtr node)
 	insertRow (rowCount (), node);
 }
 
+void TreeViewModel::append (const QList<ConfigNodePtr> & nodes)
+{
+	if (nodes.isEmpty ()) return;
+
+	beginInsertRows (QModelIndex (), rowCount (), rowCount () + nodes.count () - 1);
+	foreach (ConfigNodePtr node, nodes)
+	{
+		node->setParentModel (this);
+		m_model.append (node);
+	}
+	endInsertRows ();
+
+	emit updateIndicator ();
+}
+
+void TreeViewModel::nodeChanged (ConfigNodePtr node)
+{
+	int row = m_model.indexOf (node);
+
+	if (row < 0) return;
+
+	QModelIndex idx = index (row);
+	emit dataChanged (idx, idx);
+}
+
 namespace
 {
 
@@ -620,6 +780,8 @@ QStringList getConflicts (KeySet const & conflictSet)
 void TreeViewModel::synchronize ()
 {
 	KeySet ours = collectCurrentKeySet ();
+	// kdbGet replaces keys instead of changing them, so a shallow copy keeps the state that is shown
+	KeySet shown = ours.dup ();
 
 	try
 	{
@@ -640,7 +802,7 @@ void TreeViewModel::synchronize ()
 		printKeys (ours, ours, ours);
 #endif
 
-		createNewNodes (ours);
+		updateNodes (shown, ours);
 	}
 	catch (MergingKDBException const & exc)
 	{
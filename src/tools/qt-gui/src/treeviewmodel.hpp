@@ -117,6 +117,31 @@ public:
 	 */
 	Qt::ItemFlags flags (const QModelIndex & idx) const override;
 
+	/**
+	 * @brief Returns if the children of the ConfigNode at a valid index were not fetched yet. The children of a ConfigNode are
+	 * created lazily, so the getters of ConfigNode only know about the children that were fetched.
+	 *
+	 * @param parentIndex The index of the ConfigNode.
+	 *
+	 * @return True if fetchMore() would create children for the ConfigNode.
+	 */
+	bool canFetchMore (const QModelIndex & parentIndex) const override;
+
+	/**
+	 * @brief Creates the children of the ConfigNode at a valid index and inserts them into its children model.
+	 *
+	 * @param parentIndex The index of the ConfigNode.
+	 */
+	void fetchMore (const QModelIndex & parentIndex) override;
+
+	/**
+	 * @brief Creates the children of a ConfigNode in this TreeViewModel, see fetchMore(). Views call this before they show the
+	 * children.
+	 *
+	 * @param idx The index of the ConfigNode.
+	 */
+	Q_INVOKABLE void fetchChildren (int idx);
+
 	/**
 	 * @brief Populates this TreeViewModel with a keyset. The root keys (system, user and spec) will be recreated.
 	 */
@@ -134,6 +159,14 @@ public:
 	 */
 	void createNewNodes (kdb::KeySet keySet);
 
+	/**
+	 * @brief Updates this TreeViewModel from one state of the configuration to another. Only the ConfigNodes of keys that were
+	 * added, changed or removed are touched.
+	 * @param oldKeys The KeySet currently shown by this TreeViewModel.
+	 * @param newKeys The KeySet that is supposed to be shown.
+	 */
+	void updateNodes (kdb::KeySet const & oldKeys, kdb::KeySet const & newKeys);
+
 	/**
 	 * @brief The recursive method that actually populates this TreeViewModel.
 	 *
@@ -143,6 +176,18 @@ public:
 	 */
 	void sink (ConfigNodePtr node, QStringList keys, const kdb::Key & key);
 
+	/**
+	 * @brief Puts a Key into its place in the hierarchy below the matching root node.
+	 * @param key The Key that is supposed to be shown.
+	 */
+	void sinkKey (const kdb::Key & key);
+
+	/**
+	 * @brief Removes the ConfigNode of a Key and all ConfigNodes that only existed to hold it.
+	 * @param key The Key that is not supposed to be shown anymore.
+	 */
+	void removeKey (const kdb::Key & key);
+
 	/**
 	 * @brief The method thats accepts a Visitor object to support the Vistor Pattern.
 	 * @param visitor The visitor that visits this TreeViewModel.
@@ -208,6 +253,20 @@ public:
 	 */
 	void append (ConfigNodePtr node);
 
+	/**
+	 * @brief Appends several ConfigNodes to this TreeViewModel at once.
+	 *
+	 * @param nodes The ConfigNodes that are appended to this TreeViewModel.
+	 */
+	void append (const QList<ConfigNodePtr> & nodes);
+
+	/**
+	 * @brief Notifies the views that the data of a ConfigNode in this TreeViewModel changed.
+	 *
+	 * @param node The ConfigNode that changed.
+	 */
+	void nodeChanged (ConfigNodePtr node);
+
 	/**
 	 * @brief Returns the index of a ConfigNode in this TreeViewModel based in the ConfigNode's name.
 	 *
@@ -302,6 +361,15 @@ private:
 	 */
 	kdb::tools::merging::MergeConflictStrategy * getMergeStrategy (const QString & mergeStrategy);
 
+	/**
+	 * @brief The recursive method that removes the ConfigNode of a Key, the counterpart of sink().
+	 *
+	 * @param node The ConfigNode below which the Key is located.
+	 * @param keys The path of the Key relative to node, splitted up into a QStringList.
+	 * @param key The Key that is removed.
+	 */
+	void remove (ConfigNodePtr node, QStringList keys, const kdb::Key & key);
+
 	/**
 	 * @brief Connect to system D-Bus
 	 */
@@ -34,6 +34,17 @@ public:
 	 * @param model The visited TreeViewModel
 	 */
 	virtual void visit (TreeViewModel * model) = 0;
+
+	/**
+	 * @brief Returns if ConfigNodes have to be created for all keys before they are visited. Visitors that return false get the keys
+	 * without ConfigNodes from ConfigNode::getPendingKeys().
+	 *
+	 * @return True if this visitor needs a ConfigNode for every key.
+	 */
+	virtual bool needsAllNodes () const
+	{
+		return true;
+	}
 };
 
 #endif // VISITOR_H
@@ -7,6 +7,7 @@
  */
 
 #include <kdbease.h>
+#include <kdbprivate.h>
 
 #include "tests.h"
 
@@ -369,6 +370,52 @@ static void test_roundtrip (void)
 	ELEKTRA_DIAG_RESTORE
 }
 
+static void test_value_cache (void)
+{
+	Key * key = keyNew ("user:/test", KEY_VALUE, "42", KEY_END);
+	kdb_long_t longValue = 0;
+	succeed_if (elektraKeyToLong (key, &longValue), "conversion failed");
+	succeed_if (longValue == 42, "wrong value");
+	succeed_if (key->keyData->cacheType == KEY_VALUE_CACHE_LONG, "value was not cached");
+
+	// a cached value is returned without parsing the string
+	key->keyData->cache.longValue = 43;
+	succeed_if (elektraKeyToLong (key, &longValue), "conversion failed");
+	succeed_if (longValue == 43, "cached value was not used");
+
+	// other types replace the cached value
+	kdb_double_t doubleValue = 0;
+	succeed_if (elektraKeyToDouble (key, &doubleValue), "conversion failed");
+	succeed_if ((kdb_long_t) doubleValue == 42, "wrong value");
+	succeed_if (key->keyData->cacheType == KEY_VALUE_CACHE_DOUBLE, "value was not cached");
+
+	// changing the value invalidates the cache
+	keySetString (key, "17");
+	succeed_if (key->keyData->cacheType == KEY_VALUE_CACHE_NONE, "cache was not invalidated");
+	succeed_if (elektraKeyToLong (key, &longValue), "conversion failed");
+	succeed_if (longValue == 17, "wrong value after keySetString");
+
+	// failed conversions are not cached
+	keySetString (key, "abc");
+	succeed_if (!elektraKeyToLong (key, &longValue), "conversion should fail");
+	succeed_if (key->keyData->cacheType == KEY_VALUE_CACHE_NONE, "failed conversion was cached");
+	succeed_if (longValue == 17, "variable changed by failed conversion");
+
+	// keys sharing their value also share the cache
+	keySetString (key, "5");
+	Key * copy = keyDup (key, KEY_CP_VALUE);
+	succeed_if (elektraKeyToLong (copy, &longValue), "conversion failed");
+	succeed_if (key->keyData->cacheType == KEY_VALUE_CACHE_LONG, "value was not cached");
+	keySetString (copy, "6");
+	succeed_if (elektraKeyToLong (key, &longValue), "conversion failed");
+	succeed_if (longValue == 5, "changing the copy changed the original");
+	succeed_if (elektraKeyToLong (copy, &longValue), "conversion failed");
+	succeed_if (longValue == 6, "wrong value of copy");
+
+	keyDel (copy);
+	keyDel (key);
+}
+
 int main (int argc, char ** argv)
 {
 	printf (" CONVERSION   TESTS\n");
@@ -379,6 +426,7 @@ int main (int argc, char ** argv)
 	test_to_string ();
 	test_from_key ();
 	test_roundtrip ();
+	test_value_cache ();
 
 	print_result ("test_conversion");
 
@@ -691,6 +691,34 @@ static void test_keyNeedSync (void)
 	keySetMeta (k, "metakey", "metaval");
 	succeed_if (keyNeedSync (k), "new meta, should definitely need sync");
 
+	Key * m = keyNew ("/", KEY_META, "metakey", "other", KEY_META, "metakey2", "metaval2", KEY_END);
+	k->needsSync = false;
+	m->needsSync = false;
+	keyCopyMeta (k, m, "metakey");
+	succeed_if (keyNeedSync (k), "copied meta, should definitely need sync");
+	succeed_if (!keyNeedSync (m), "sources sync flag should not be affected");
+
+	k->needsSync = false;
+	keyCopyMeta (k, m, "metakey");
+	succeed_if (!keyNeedSync (k), "same meta copied again, should not need sync");
+
+	keyCopyMeta (k, m, "nonexisting");
+	succeed_if (!keyNeedSync (k), "no meta removed, should not need sync");
+
+	Key * empty = keyNew ("/", KEY_END);
+	keyCopyMeta (k, empty, "metakey");
+	succeed_if (keyNeedSync (k), "meta removed by copy, should definitely need sync");
+	succeed_if (keyGetMeta (k, "metakey") == NULL, "meta should be removed");
+
+	k->needsSync = false;
+	succeed_if (keyCopyAllMeta (k, empty) == 0, "empty source should not copy");
+	succeed_if (!keyNeedSync (k), "nothing copied, should not need sync");
+	keyDel (empty);
+
+	keyCopyAllMeta (k, m);
+	succeed_if (keyNeedSync (k), "copied all meta, should definitely need sync");
+	keyDel (m);
+
 	k->needsSync = false;
 	Key * d = keyDup (k, KEY_CP_ALL);
 	succeed_if (keyNeedSync (d), "dup key, should definitely need sync");
@@ -1211,6 +1239,63 @@ static void test_keyReplacePrefix (void)
 	keyDel (newPrefix);
 }
 
+#define succeed_if_parts(key, expectedDepth, expectedBaseName)                                                                             \
+	do                                                                                                                                 \
+	{                                                                                                                                  \
+		succeed_if ((key)->keyName->depth == (expectedDepth), "wrong depth of " #key);                                             \
+		succeed_if_same_string (keyBaseName (key), (expectedBaseName));                                                            \
+	} while (0)
+
+static void test_keyNameParts (void)
+{
+	printf ("Test cached name parts\n");
+
+	Key * key = keyNew ("user:/", KEY_END);
+	succeed_if_parts (key, 0, "");
+
+	keySetName (key, "system:/a/b\\/c/%");
+	succeed_if_parts (key, 3, "");
+
+	keySetName (key, "/%/x");
+	succeed_if_parts (key, 2, "x");
+
+	keyAddName (key, "y/../z/w");
+	succeed_if_parts (key, 4, "w");
+
+	keyAddBaseName (key, "v/u");
+	succeed_if_parts (key, 5, "v/u");
+
+	keySetBaseName (key, "t");
+	succeed_if_parts (key, 5, "t");
+
+	keySetBaseName (key, 0);
+	succeed_if_parts (key, 4, "w");
+
+	keySetName (key, "user:/");
+	keyAddBaseName (key, "a");
+	succeed_if_parts (key, 1, "a");
+
+	Key * copy = keyDup (key, KEY_CP_NAME);
+	succeed_if_parts (copy, 1, "a");
+	keyAddBaseName (copy, "b");
+	succeed_if_parts (copy, 2, "b");
+	succeed_if_parts (key, 1, "a");
+
+	Key * oldPrefix = keyNew ("user:/a", KEY_END);
+	Key * newPrefix = keyNew ("system:/x/y/z", KEY_END);
+	succeed_if (keyReplacePrefix (copy, oldPrefix, newPrefix) == 1, "didn't correctly replace");
+	succeed_if_parts (copy, 4, "b");
+
+	keySetName (newPrefix, "system:/");
+	succeed_if (keyReplacePrefix (key, oldPrefix, newPrefix) == 1, "didn't correctly replace");
+	succeed_if_parts (key, 0, "");
+
+	keyDel (oldPrefix);
+	keyDel (newPrefix);
+	keyDel (copy);
+	keyDel (key);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("KEY      TESTS\n");
@@ -1234,6 +1319,7 @@ int main (int argc, char ** argv)
 	test_keyFlags ();
 	test_warnings ();
 	test_keyReplacePrefix ();
+	test_keyNameParts ();
 
 	print_result ("test_key");
 	return nbError;
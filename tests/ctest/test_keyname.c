@@ -936,6 +936,52 @@ static void test_escapePart (void)
 
 #undef TEST_ESCAPE_PART_OK
 
+static void test_longParts (void)
+{
+	// long parts with escape sequences at every position and alignment
+	char buffer[128];
+	char uname[128];
+	for (size_t align = 0; align < 16; ++align)
+	{
+		for (size_t i = 0; i < 40; ++i)
+		{
+			for (size_t j = 0; j < 40; j += 13)
+			{
+				char * name = buffer + align;
+				char * cur = name;
+				*cur++ = '/';
+				memset (cur, 'a', i);
+				cur += i;
+				*cur++ = '\\';
+				*cur++ = '/';
+				memset (cur, 'b', j);
+				cur += j;
+				strcpy (cur, "/c");
+
+				char * canonical = NULL;
+				size_t canonicalSize = 0;
+				size_t usize = 0;
+				elektraKeyNameCanonicalize (name, &canonical, &canonicalSize, 0, &usize);
+				succeed_if_same_string (canonical, name);
+				succeed_if_fmt (usize == i + j + 6, "wrong unescaped size %zu for '%s'", usize, name);
+
+				char expected[128];
+				expected[0] = KEY_NS_CASCADING;
+				expected[1] = '\0';
+				memset (expected + 2, 'a', i);
+				expected[i + 2] = '/';
+				memset (expected + i + 3, 'b', j);
+				memcpy (expected + i + j + 3, "\0c", 3);
+
+				elektraKeyNameUnescape (canonical, uname);
+				succeed_if_fmt (memcmp (uname, expected, i + j + 6) == 0, "wrong unescaped name for '%s'", name);
+
+				elektraFree (canonical);
+			}
+		}
+	}
+}
+
 int main (int argc, char ** argv)
 {
 	printf (" KEYNAME   TESTS\n");
@@ -947,6 +993,7 @@ int main (int argc, char ** argv)
 	test_canonicalize ();
 	test_unescape ();
 	test_escapePart ();
+	test_longParts ();
 
 	print_result ("test_keyname");
 
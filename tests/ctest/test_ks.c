@@ -454,6 +454,16 @@ void test_ksFindHierarchy (void)
 	keySetName (root, "system:/baz/bar/bar");
 	succeed_if (ksFindHierarchy (ks, root, NULL) == 6, "should accept NULL for end");
 
+	// root itself is part of ks
+	for (elektraCursor i = 0; i < ksGetSize (ks); i++)
+	{
+		Key * cur = ksAtCursor (ks, i);
+		elektraCursor expectedEnd;
+		keySetName (root, keyName (cur));
+		ksFindHierarchy (ks, root, &expectedEnd);
+		succeed_if (ksFindHierarchy (ks, cur, &end) == i && end == expectedEnd, "hierarchy below key of keyset should be present");
+	}
+
 	keyDel (root);
 	ksDel (ks);
 }
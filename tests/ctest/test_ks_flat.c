@@ -0,0 +1,414 @@
+/**
+ * @file
+ *
+ * @brief Tests for the flat KeySet layout.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <kdbproposal.h>
+#include <tests_internal.h>
+
+#include <sys/mman.h>
+
+static KeySet * createKeySet (void)
+{
+	return ksNew (10, keyNew ("user:/tests/flat", KEY_VALUE, "root", KEY_META, "comment/#0", "a comment", KEY_END),
+		      keyNew ("user:/tests/flat/binary", KEY_BINARY, KEY_SIZE, 5, KEY_VALUE, "a\0b\0c", KEY_END),
+		      keyNew ("user:/tests/flat/empty", KEY_END), keyNew ("user:/tests/flat/null", KEY_BINARY, KEY_END),
+		      keyNew ("user:/tests/flat/escaped\\/name", KEY_VALUE, "value", KEY_META, "type", "string", KEY_META, "order", "",
+			      KEY_END),
+		      keyNew ("system:/tests/flat", KEY_VALUE, "system", KEY_END), KS_END);
+}
+
+static void * exportKeySet (KeySet * ks, elektraCursor start, elektraCursor end, size_t * size)
+{
+	*size = elektraKsFlatSize (ks, start, end);
+	exit_if_fail (*size > 0, "could not calculate size");
+	void * buffer = elektraMalloc (*size);
+	succeed_if (elektraKsFlatExport (ks, start, end, buffer, *size - 1) == 0, "export into too small buffer succeeded");
+	succeed_if (elektraKsFlatExport (ks, start, end, buffer, *size) == *size, "export did not fill buffer");
+	return buffer;
+}
+
+static void test_roundtrip (void)
+{
+	printf ("Test roundtrip\n");
+
+	KeySet * ks = createKeySet ();
+	size_t size;
+	void * buffer = exportKeySet (ks, 0, ksGetSize (ks), &size);
+
+	KeySet * imported = ksNew (0, KS_END);
+	succeed_if (elektraKsFlatImport (imported, buffer, size) == ksGetSize (ks), "wrong number of keys imported");
+	compare_keyset (ks, imported);
+
+	Key * binary = ksLookupByName (imported, "user:/tests/flat/binary", 0);
+	exit_if_fail (binary != NULL, "binary key not found");
+	succeed_if (keyIsBinary (binary), "key is not binary");
+	succeed_if (keyGetValueSize (binary) == 5 && memcmp (keyValue (binary), "a\0b\0c", 5) == 0, "wrong binary value");
+
+	Key * null = ksLookupByName (imported, "user:/tests/flat/null", 0);
+	exit_if_fail (null != NULL, "null key not found");
+	succeed_if (keyIsBinary (null) && keyValue (null) == NULL, "null value not preserved");
+
+	Key * escaped = ksLookupByName (imported, "user:/tests/flat/escaped\\/name", 0);
+	exit_if_fail (escaped != NULL, "escaped key not found");
+	succeed_if_same_string (keyString (keyGetMeta (escaped, "type")), "string");
+	succeed_if_same_string (keyString (keyGetMeta (escaped, "order")), "");
+
+	elektraFree (buffer);
+	ksDel (imported);
+	ksDel (ks);
+}
+
+static void test_emptyValue (void)
+{
+	printf ("Test empty value\n");
+
+	// keySetString() stores "" as NULL, but keys read by storage plugins may contain an empty string
+	Key * key = keyNew ("user:/tests/flat/empty", KEY_END);
+	keySetRaw (key, "", 1);
+	KeySet * ks = ksNew (2, key, keyNew ("user:/tests/flat/null", KEY_VALUE, "", KEY_END), KS_END);
+	exit_if_fail (key->keyData != NULL && key->keyData->data.v != NULL, "empty string has no value");
+
+	size_t size = elektraKsFlatSizeMappable (ks, 0, ksGetSize (ks));
+	char * buffer = elektraMalloc (size);
+	succeed_if (elektraKsFlatExportMappable (ks, 0, ksGetSize (ks), buffer, size) == size, "export did not fill buffer");
+
+	KeySet * imported = ksNew (0, KS_END);
+	KeySet * mapped = ksNew (0, KS_END);
+	succeed_if (elektraKsFlatImport (imported, buffer, size) == 2, "wrong number of keys imported");
+	succeed_if (elektraKsFlatMap (mapped, buffer, size) == 2, "wrong number of keys mapped");
+
+	KeySet * results[] = { imported, mapped };
+	for (size_t i = 0; i < 2; ++i)
+	{
+		Key * empty = ksLookupByName (results[i], "user:/tests/flat/empty", 0);
+		Key * null = ksLookupByName (results[i], "user:/tests/flat/null", 0);
+		exit_if_fail (empty != NULL && null != NULL, "keys not found");
+		succeed_if (empty->keyData != NULL && empty->keyData->data.v != NULL, "empty string became NULL");
+		succeed_if_same_string (keyString (empty), "");
+		succeed_if (keyGetValueSize (empty) == 1, "wrong size of empty string");
+		succeed_if (null->keyData == NULL || null->keyData->data.v == NULL, "NULL value became empty string");
+	}
+
+	ksDel (mapped);
+	ksDel (imported);
+	elektraFree (buffer);
+	ksDel (ks);
+}
+
+static void test_layout (void)
+{
+	printf ("Test layout\n");
+
+	KeySet * ks = createKeySet ();
+	size_t size;
+	char * buffer = exportKeySet (ks, 0, ksGetSize (ks), &size);
+
+	ElektraKsFlatHeader header;
+	memcpy (&header, buffer, sizeof (header));
+	succeed_if (header.magic == ELEKTRA_KS_FLAT_MAGIC, "wrong magic");
+	succeed_if (header.keyCount == 6, "wrong number of keys");
+	// binary keys have the metakey binary
+	succeed_if (header.metaCount == 5, "wrong number of metakeys");
+	succeed_if (header.size == size, "wrong size");
+
+	for (uint64_t i = 0; i < header.keyCount; ++i)
+	{
+		ElektraKsFlatKey entry;
+		memcpy (&entry, buffer + sizeof (header) + i * sizeof (entry), sizeof (entry));
+		Key * key = ksAtCursor (ks, i);
+		succeed_if_same_string (buffer + entry.nameOffset, keyName (key));
+		succeed_if (entry.nameSize == strlen (keyName (key)), "wrong name size");
+		if (!keyIsBinary (key))
+		{
+			succeed_if_same_string (buffer + entry.valueOffset, keyString (key));
+		}
+	}
+
+	ElektraKsFlatKey escaped;
+	memcpy (&escaped, buffer + sizeof (header) + 3 * sizeof (escaped), sizeof (escaped));
+	succeed_if (escaped.metaIndex == 2 && escaped.metaCount == 2, "wrong meta range");
+	ElektraKsFlatMeta meta;
+	memcpy (&meta, buffer + sizeof (header) + header.keyCount * sizeof (escaped) + escaped.metaIndex * sizeof (meta), sizeof (meta));
+	succeed_if_same_string (buffer + meta.nameOffset, "meta:/order");
+	succeed_if (meta.valueSize == 0 && buffer[meta.valueOffset] == '\0', "wrong empty meta value");
+
+	elektraFree (buffer);
+	ksDel (ks);
+}
+
+static void test_range (void)
+{
+	printf ("Test range\n");
+
+	KeySet * ks = createKeySet ();
+	succeed_if (elektraKsFlatSize (ks, -1, 2) == 0, "negative start accepted");
+	succeed_if (elektraKsFlatSize (ks, 3, 2) == 0, "start after end accepted");
+	succeed_if (elektraKsFlatSize (ks, 0, ksGetSize (ks) + 1) == 0, "end after last key accepted");
+	succeed_if (elektraKsFlatSize (NULL, 0, 0) == 0, "NULL keyset accepted");
+	succeed_if (elektraKsFlatSize (ks, 2, 2) == sizeof (ElektraKsFlatHeader), "empty range has wrong size");
+
+	size_t size;
+	void * buffer = exportKeySet (ks, 1, 3, &size);
+	KeySet * imported = ksNew (0, keyNew ("user:/tests/flat/binary", KEY_VALUE, "replaced", KEY_END), KS_END);
+	succeed_if (elektraKsFlatImport (imported, buffer, size) == 2, "wrong number of keys imported");
+	succeed_if (ksGetSize (imported) == 2, "wrong size after import");
+	succeed_if (keyIsBinary (ksLookupByName (imported, "user:/tests/flat/binary", 0)), "existing key was not replaced");
+	succeed_if (ksLookupByName (imported, "user:/tests/flat/empty", 0) != NULL, "empty key missing");
+
+	elektraFree (buffer);
+	ksDel (imported);
+	ksDel (ks);
+}
+
+static void test_unsorted (void)
+{
+	printf ("Test unsorted buffer\n");
+
+	const char * names[] = { "user:/tests/b", "user:/tests/a", "user:/tests/b" };
+	const char * values[] = { "first", "a", "second" };
+	char buffer[sizeof (ElektraKsFlatHeader) + 3 * sizeof (ElektraKsFlatKey) + 64];
+	size_t position = sizeof (ElektraKsFlatHeader) + 3 * sizeof (ElektraKsFlatKey);
+	for (size_t i = 0; i < 3; ++i)
+	{
+		ElektraKsFlatKey entry = { position, strlen (names[i]), position + strlen (names[i]) + 1, strlen (values[i]), 0, 0, 0 };
+		memcpy (buffer + sizeof (ElektraKsFlatHeader) + i * sizeof (entry), &entry, sizeof (entry));
+		memcpy (buffer + position, names[i], entry.nameSize + 1);
+		memcpy (buffer + entry.valueOffset, values[i], entry.valueSize + 1);
+		position = entry.valueOffset + entry.valueSize + 1;
+	}
+	ElektraKsFlatHeader header = { ELEKTRA_KS_FLAT_MAGIC, 3, 0, position };
+	memcpy (buffer, &header, sizeof (header));
+
+	KeySet * imported = ksNew (0, KS_END);
+	succeed_if (elektraKsFlatImport (imported, buffer, position) == 3, "wrong number of keys read");
+	succeed_if (ksGetSize (imported) == 2, "duplicate was not replaced");
+	succeed_if_same_string (keyName (ksAtCursor (imported, 0)), "user:/tests/a");
+	succeed_if_same_string (keyString (ksAtCursor (imported, 1)), "second");
+	ksDel (imported);
+}
+
+static void test_invalid (void)
+{
+	printf ("Test invalid buffers\n");
+
+	KeySet * ks = createKeySet ();
+	size_t size;
+	char * buffer = exportKeySet (ks, 0, ksGetSize (ks), &size);
+	KeySet * imported = ksNew (0, KS_END);
+
+	succeed_if (elektraKsFlatImport (imported, buffer, size - 1) == -1, "truncated buffer accepted");
+	succeed_if (elektraKsFlatImport (imported, buffer, 8) == -1, "buffer without header accepted");
+	succeed_if (elektraKsFlatImport (NULL, buffer, size) == -1, "NULL keyset accepted");
+
+	ElektraKsFlatHeader header;
+	memcpy (&header, buffer, sizeof (header));
+	ElektraKsFlatHeader broken = header;
+	broken.magic ^= 1;
+	memcpy (buffer, &broken, sizeof (broken));
+	succeed_if (elektraKsFlatImport (imported, buffer, size) == -1, "wrong magic accepted");
+
+	broken = header;
+	broken.keyCount = UINT64_MAX / 2;
+	memcpy (buffer, &broken, sizeof (broken));
+	succeed_if (elektraKsFlatImport (imported, buffer, size) == -1, "too many keys accepted");
+	memcpy (buffer, &header, sizeof (header));
+
+	ElektraKsFlatKey entry;
+	char * last = buffer + sizeof (header) + (header.keyCount - 1) * sizeof (entry);
+	memcpy (&entry, last, sizeof (entry));
+	ElektraKsFlatKey brokenEntry = entry;
+	brokenEntry.nameSize += 1;
+	memcpy (last, &brokenEntry, sizeof (brokenEntry));
+	succeed_if (elektraKsFlatImport (imported, buffer, size) == -1, "unterminated name accepted");
+
+	brokenEntry = entry;
+	brokenEntry.valueOffset = size;
+	memcpy (last, &brokenEntry, sizeof (brokenEntry));
+	succeed_if (elektraKsFlatImport (imported, buffer, size) == -1, "value outside of buffer accepted");
+
+	brokenEntry = entry;
+	brokenEntry.metaCount = header.metaCount + 1;
+	memcpy (last, &brokenEntry, sizeof (brokenEntry));
+	succeed_if (elektraKsFlatImport (imported, buffer, size) == -1, "meta range outside of buffer accepted");
+
+	succeed_if (ksGetSize (imported) == 0, "keyset modified by failed import");
+
+	elektraFree (buffer);
+	ksDel (imported);
+	ksDel (ks);
+}
+
+static bool inBuffer (const void * pointer, const char * buffer, size_t size)
+{
+	return (const char *) pointer >= buffer && (const char *) pointer < buffer + size;
+}
+
+static void test_map (void)
+{
+	printf ("Test map\n");
+
+	KeySet * ks = createKeySet ();
+	size_t size = elektraKsFlatSizeMappable (ks, 0, ksGetSize (ks));
+	exit_if_fail (size > elektraKsFlatSize (ks, 0, ksGetSize (ks)), "unescaped names missing");
+	char * buffer = elektraMalloc (size);
+	succeed_if (elektraKsFlatExportMappable (ks, 0, ksGetSize (ks), buffer, size) == size, "export did not fill buffer");
+
+	// mappable buffers can still be imported
+	KeySet * imported = ksNew (0, KS_END);
+	succeed_if (elektraKsFlatImport (imported, buffer, size) == ksGetSize (ks), "wrong number of keys imported");
+	compare_keyset (ks, imported);
+	ksDel (imported);
+
+	char * copy = elektraMalloc (size);
+	memcpy (copy, buffer, size);
+
+	KeySet * mapped = ksNew (0, KS_END);
+	succeed_if (elektraKsFlatMap (mapped, buffer, size) == ksGetSize (ks), "wrong number of keys mapped");
+	compare_keyset (ks, mapped);
+
+	Key * key = ksLookupByName (mapped, "user:/tests/flat/escaped\\/name", 0);
+	exit_if_fail (key != NULL, "escaped key not found");
+	succeed_if (inBuffer (keyName (key), buffer, size), "name was copied");
+	succeed_if (inBuffer (keyUnescapedName (key), buffer, size), "unescaped name was copied");
+	succeed_if (inBuffer (keyString (key), buffer, size), "value was copied");
+	succeed_if_same_string (keyBaseName (key), "escaped/name");
+
+	// keys are copied on write, the buffer stays unchanged
+	Key * dup = keyDup (key, KEY_CP_ALL);
+	succeed_if (inBuffer (keyName (dup), buffer, size), "copy of key does not share name");
+	keySetString (key, "changed");
+	succeed_if_same_string (keyString (key), "changed");
+	succeed_if (!inBuffer (keyString (key), buffer, size), "modified value still in buffer");
+	succeed_if_same_string (keyString (dup), "value");
+	keyAddBaseName (dup, "below");
+	succeed_if_same_string (keyName (dup), "user:/tests/flat/escaped\\/name/below");
+	succeed_if (!inBuffer (keyName (dup), buffer, size), "modified name still in buffer");
+	succeed_if (inBuffer (keyName (key), buffer, size), "name of original key was copied");
+	keySetNamespace (dup, KEY_NS_SYSTEM);
+	succeed_if_same_string (keyName (dup), "system:/tests/flat/escaped\\/name/below");
+	keyDel (dup);
+	succeed_if (memcmp (buffer, copy, size) == 0, "buffer was modified");
+
+	Key * binary = ksLookupByName (mapped, "user:/tests/flat/binary", 0);
+	exit_if_fail (binary != NULL, "binary key not found");
+	succeed_if (keyIsBinary (binary) && keyGetValueSize (binary) == 5 && memcmp (keyValue (binary), "a\0b\0c", 5) == 0,
+		    "wrong binary value");
+
+	// buffers without unescaped names cannot be mapped
+	size_t plainSize;
+	void * plain = exportKeySet (ks, 0, ksGetSize (ks), &plainSize);
+	succeed_if (elektraKsFlatMap (mapped, plain, plainSize) == -1, "buffer without unescaped names mapped");
+	elektraFree (plain);
+
+	ksDel (mapped);
+	elektraFree (copy);
+	elektraFree (buffer);
+	ksDel (ks);
+}
+
+static void test_mapRoot (void)
+{
+	printf ("Test mapped root keys\n");
+
+	KeySet * ks = ksNew (4, keyNew ("user:/a", KEY_END), keyNew ("user:/a/b", KEY_END), keyNew ("/c", KEY_END),
+			     keyNew ("/c/d", KEY_END), KS_END);
+	size_t size = elektraKsFlatSizeMappable (ks, 0, ksGetSize (ks));
+
+	// the names are read-only, like in a mapped file
+	char * buffer = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	exit_if_fail (buffer != MAP_FAILED, "could not map memory");
+	succeed_if (elektraKsFlatExportMappable (ks, 0, ksGetSize (ks), buffer, size) == size, "export did not fill buffer");
+	exit_if_fail (mprotect (buffer, size, PROT_READ) == 0, "could not protect memory");
+
+	KeySet * mapped = ksNew (0, KS_END);
+	succeed_if (elektraKsFlatMap (mapped, buffer, size) == 4, "wrong number of keys mapped");
+	Key * root = ksLookupByName (mapped, "user:/a", 0);
+	Key * cascading = ksLookupByName (mapped, "/c", 0);
+	exit_if_fail (root != NULL && cascading != NULL, "mapped keys not found");
+
+	// mapped keys are used as root of other key sets
+	KeySet * other = ksNew (4, keyNew ("user:/a/x", KEY_END), keyNew ("user:/b", KEY_END), keyNew ("system:/c/y", KEY_END),
+				keyNew ("/c/z", KEY_END), KS_END);
+	KeySet * below = ksBelow (other, root);
+	succeed_if (ksGetSize (below) == 1 && ksLookupByName (below, "user:/a/x", 0) != NULL, "wrong keys below mapped root");
+	ksDel (below);
+	below = ksBelow (other, cascading);
+	succeed_if (ksGetSize (below) == 2 && ksLookupByName (below, "system:/c/y", 0) != NULL, "wrong keys below cascading root");
+	ksDel (below);
+	elektraCursor end;
+	succeed_if (ksFindHierarchy (mapped, root, &end) == 2 && end == 4, "wrong hierarchy in mapped key set");
+
+	KeySet * cut = ksCut (other, root);
+	succeed_if (ksGetSize (cut) == 1 && ksGetSize (other) == 3, "wrong keys cut at mapped root");
+	ksDel (cut);
+	cut = ksCut (other, cascading);
+	succeed_if (ksGetSize (cut) == 2 && ksGetSize (other) == 1, "wrong keys cut at cascading root");
+	ksDel (cut);
+	succeed_if_same_string (keyName (root), "user:/a");
+	succeed_if_same_string (keyName (cascading), "/c");
+
+	ksDel (other);
+	ksDel (mapped);
+	munmap (buffer, size);
+	ksDel (ks);
+}
+
+static void test_mapInUse (void)
+{
+	printf ("Test map in use\n");
+
+	KeySet * ks = createKeySet ();
+	size_t size = elektraKsFlatSizeMappable (ks, 0, ksGetSize (ks));
+	char * buffer = elektraMalloc (size);
+	succeed_if (elektraKsFlatExportMappable (ks, 0, ksGetSize (ks), buffer, size) == size, "export did not fill buffer");
+
+	KeySet * mapped = ksNew (0, KS_END);
+	succeed_if (elektraKsFlatMap (mapped, buffer, size) == ksGetSize (ks), "wrong number of keys mapped");
+	KeySet * tracked = ksNew (ksGetSize (mapped), KS_END);
+	ksAppend (tracked, mapped);
+	succeed_if (elektraKsFlatMapInUse (tracked) == 1, "returned keys not in use");
+
+	Key * dup = keyDup (ksLookupByName (mapped, "user:/tests/flat", 0), KEY_CP_ALL);
+	Key * key = ksLookupByName (mapped, "user:/tests/flat/escaped\\/name", 0);
+	keyIncRef (key);
+	ksDel (mapped);
+	succeed_if (elektraKsFlatMapInUse (tracked) == 1, "copied key not in use");
+	keyDel (dup);
+	succeed_if (elektraKsFlatMapInUse (tracked) == 1, "held key not in use");
+
+	// the name of a held key still uses the buffer, after its value was copied
+	keySetString (key, "changed");
+	succeed_if (elektraKsFlatMapInUse (tracked) == 1, "held key with copied value not in use");
+	keyDecRef (key);
+	succeed_if (elektraKsFlatMapInUse (tracked) == 0, "released keys still in use");
+
+	ksDel (tracked);
+	elektraFree (buffer);
+	ksDel (ks);
+}
+
+int main (int argc, char ** argv)
+{
+	printf ("FLAT KEYSET TESTS\n");
+	printf ("=================\n\n");
+
+	init (argc, argv);
+
+	test_roundtrip ();
+	test_emptyValue ();
+	test_layout ();
+	test_range ();
+	test_unsorted ();
+	test_invalid ();
+	test_map ();
+	test_mapRoot ();
+	test_mapInUse ();
+
+	printf ("\ntest_ks_flat RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
+
+	return nbError;
+}
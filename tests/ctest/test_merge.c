@@ -308,6 +308,25 @@ static void test_changed_same_key_our (void)
 	ksDel (result);
 }
 
+static void test_invalid_statistics (void)
+{
+	printf ("test invalid statistics in information key\n");
+
+	KeySet * ks = ksNew (1, keyNew ("system:/test/k1", KEY_VALUE, "k1", KEY_END), KS_END);
+	Key * root = keyNew ("system:/test", KEY_END);
+
+	Key * information = keyNew ("system:/", KEY_META, "overlap1empty", "-2", KEY_END);
+
+	KeySet * result = elektraMerge (ks, root, ks, root, ks, root, root, MERGE_STRATEGY_ABORT, information);
+
+	succeed_if (result == NULL, "result must be NULL for invalid statistics");
+	succeed_if (keyGetMeta (information, "error") != NULL, "error must be set in information key");
+
+	keyDel (root);
+	keyDel (information);
+	ksDel (ks);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("MERGE       TESTS\n");
@@ -321,6 +340,7 @@ int main (int argc, char ** argv)
 	test_changed_same_key_abort ();
 	test_changed_same_key_their ();
 	test_changed_same_key_our ();
+	test_invalid_statistics ();
 
 	printf ("\ntest_merge RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
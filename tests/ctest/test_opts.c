@@ -1402,6 +1402,161 @@ static void test_commands (void)
 	ksDel (ks);
 }
 
+static void test_precompiled (void)
+{
+	KeySet * spec = ksNew (10, keyNew (SPEC_BASE_KEY, KEY_META, "command", "", KEY_END),
+			       keyNew (SPEC_BASE_KEY "/printversion", KEY_META, "opt", "v", KEY_META, "opt/long", "version", KEY_META,
+				       "opt/arg", "none", KEY_META, "opt/help", "print version", KEY_END),
+			       keyNew (SPEC_BASE_KEY "/get", KEY_META, "command", "get", KEY_END),
+			       keyNew (SPEC_BASE_KEY "/get/verbose", KEY_META, "opt", "v", KEY_META, "opt/long", "verbose", KEY_META,
+				       "opt/arg", "none", KEY_END),
+			       keyNew (SPEC_BASE_KEY "/get/keyname", KEY_META, "args", "indexed", KEY_META, "args/index", "0", KEY_END),
+			       keyWithOpt (SPEC_BASE_KEY "/apple", 'a', "apple", "APPLE"),
+			       keyNew (SPEC_BASE_KEY "/dynamic/#", KEY_META, "args", "remaining", KEY_END), KS_END);
+
+	KeySet * table = ksNew (0, KS_END);
+	Key * tableRoot = keyNew ("user:/tests/opts/table", KEY_END);
+	Key * parentKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOptsPrecompile (spec, parentKey, table, tableRoot) == 0, "precompile failed");
+	output_error (parentKey);
+	keyDel (parentKey);
+	succeed_if (ksLookup (table, tableRoot, 0) != NULL, "table root missing");
+
+	// the spec keys are only used for the fingerprint
+	KeySet * ks = ksDup (spec);
+	parentKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOptsPrecompiled (ks, table, tableRoot, ARGS ("-v", "get", "-v", "x"), ENVP ("APPLE=env"), parentKey) == 0,
+		    "precompiled failed");
+	output_error (parentKey);
+	keyDel (parentKey);
+	succeed_if (checkValue (ks, PROC_BASE_KEY, "get"), "precompiled failed: {kdb} -v get -v x");
+	succeed_if (checkValue (ks, PROC_BASE_KEY "/printversion", "1"), "precompiled failed: kdb {-v} get -v x");
+	succeed_if (checkValue (ks, PROC_BASE_KEY "/get/verbose", "1"), "precompiled failed: kdb -v get {-v} x");
+	succeed_if (checkValue (ks, PROC_BASE_KEY "/get/keyname", "x"), "precompiled failed: kdb -v get -v {x}");
+	succeed_if (checkValue (ks, PROC_BASE_KEY "/apple", "env"), "precompiled failed: env-var");
+	ksDel (ks);
+
+	// help message must be the same as without a table
+	Key * helpKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOpts (spec, ARGS ("--help"), NO_ENVP, helpKey) == 1, "help not found");
+	char * expected = elektraGetOptsHelpMessage (helpKey, NULL, NULL);
+	keyDel (helpKey);
+
+	ks = ksDup (spec);
+	helpKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOptsPrecompiled (ks, table, tableRoot, ARGS ("--help"), NO_ENVP, helpKey) == 1, "precompiled help not found");
+	checkHelpMessage (helpKey, expected);
+	elektraFree (expected);
+	keyDel (helpKey);
+	ksDel (ks);
+
+	// the table only works for the parent key it was created for
+	ks = ksNew (0, KS_END);
+	Key * errorKey = keyNew ("spec:/tests/other", KEY_END);
+	succeed_if (elektraGetOptsPrecompiled (ks, table, tableRoot, NO_ARGS, NO_ENVP, errorKey) == -1, "wrong parent accepted");
+	succeed_if (checkError (errorKey, ELEKTRA_ERROR_INTERFACE,
+				"The option table 'user:/tests/opts/table' was not created for the parent key 'spec:/tests/other'"),
+		    "wrong parent: wrong error");
+	succeed_if (ksGetSize (ks) == 0, "keyset modified on error");
+	ksDel (ks);
+
+	// a table for an outdated spec is not used
+	ks = ksDup (spec);
+	keySetMeta (ksLookupByName (ks, SPEC_BASE_KEY "/apple", 0), "env", "PEAR");
+	ksAppendKey (ks, keyNew (SPEC_BASE_KEY "/banana", KEY_META, "opt", "b", KEY_END));
+	parentKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOptsPrecompiled (ks, table, tableRoot, ARGS ("-b", "x"), ENVP ("APPLE=env", "PEAR=pear"), parentKey) == 0,
+		    "outdated table failed");
+	output_error (parentKey);
+	keyDel (parentKey);
+	succeed_if (checkValue (ks, PROC_BASE_KEY "/banana", "x"), "outdated table: new option not found");
+	succeed_if (checkValue (ks, PROC_BASE_KEY "/apple", "pear"), "outdated table: changed env-var not used");
+	ksDel (ks);
+
+	// without spec keys, the options of the table are unknown
+	ks = ksNew (0, KS_END);
+	parentKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOptsPrecompiled (ks, table, tableRoot, ARGS ("-v"), NO_ENVP, parentKey) == -1, "table used without spec keys");
+	succeed_if (checkError (parentKey, ELEKTRA_ERROR_VALIDATION_SEMANTIC, "Unknown short option: -v"), "no spec: wrong error");
+	ksDel (ks);
+
+	// errors in the spec are reported by precompile
+	ksAppendKey (spec, keyNew (SPEC_BASE_KEY "/banana", KEY_META, "opt", "a", KEY_END));
+	errorKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOptsPrecompile (spec, errorKey, table, tableRoot) == -1, "illegal spec accepted");
+	succeed_if (keyGetMeta (errorKey, "error") != NULL, "no error for illegal spec");
+	keyDel (errorKey);
+	succeed_if (ksLookup (table, tableRoot, 0) != NULL, "table modified on error");
+
+	keyDel (tableRoot);
+	ksDel (table);
+	ksDel (spec);
+}
+
+static void test_precompiled_reuse (void)
+{
+	KeySet * spec = ksNew (10, keyNew (SPEC_BASE_KEY, KEY_END), keyWithOpt (SPEC_BASE_KEY "/apple", 'a', "apple", "APPLE"),
+			       keyWithOpt (SPEC_BASE_KEY "/banana", 'b', "banana", "BANANA"), KS_END);
+
+	KeySet * table = ksNew (0, KS_END);
+	Key * tableRoot = keyNew ("user:/tests/opts/table", KEY_END);
+	Key * parentKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOptsPrecompile (spec, parentKey, table, tableRoot) == 0, "precompile failed");
+	output_error (parentKey);
+	keyDel (parentKey);
+
+	ElektraOptsTable * decoded = elektraOptsTableNew (table, tableRoot);
+	succeed_if (decoded != NULL, "table not decoded");
+	ksDel (table);
+
+	// the decoded table doesn't depend on the table KeySet and can be used repeatedly
+	for (int i = 0; i < 2; ++i)
+	{
+		KeySet * ks = ksDup (spec);
+		parentKey = keyNew (SPEC_BASE_KEY, KEY_END);
+		succeed_if (elektraGetOptsTable (ks, decoded, ARGS ("-afirst"), ENVP ("BANANA=env"), parentKey) == 0,
+			    "decoded table failed");
+		output_error (parentKey);
+		keyDel (parentKey);
+		succeed_if (checkValue (ks, PROC_BASE_KEY "/apple", "first"), "decoded table failed: option");
+		succeed_if (checkValue (ks, PROC_BASE_KEY "/banana", "env"), "decoded table failed: env-var");
+		ksDel (ks);
+	}
+
+	// changes of the same spec keys are detected
+	KeySet * ks = ksDup (spec);
+	keySetMeta (ksLookupByName (ks, SPEC_BASE_KEY "/banana", 0), "env", "PEAR");
+	parentKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOptsTable (ks, decoded, NO_ARGS, ENVP ("BANANA=env", "PEAR=pear"), parentKey) == 0, "outdated table failed");
+	output_error (parentKey);
+	keyDel (parentKey);
+	succeed_if (checkValue (ks, PROC_BASE_KEY "/banana", "pear"), "outdated table: changed env-var not used");
+	ksDel (ks);
+
+	// the table is used again, once the spec matches again
+	ks = ksDup (spec);
+	keySetMeta (ksLookupByName (ks, SPEC_BASE_KEY "/banana", 0), "env", "BANANA");
+	parentKey = keyNew (SPEC_BASE_KEY, KEY_END);
+	succeed_if (elektraGetOptsTable (ks, decoded, NO_ARGS, ENVP ("BANANA=env", "PEAR=pear"), parentKey) == 0, "decoded table failed");
+	output_error (parentKey);
+	keyDel (parentKey);
+	succeed_if (checkValue (ks, PROC_BASE_KEY "/banana", "env"), "decoded table failed: env-var after change");
+	ksDel (ks);
+
+	// the table only works for the parent key it was created for
+	ks = ksNew (0, KS_END);
+	Key * errorKey = keyNew ("spec:/tests/other", KEY_END);
+	succeed_if (elektraGetOptsTable (ks, decoded, NO_ARGS, NO_ENVP, errorKey) == -1, "wrong parent accepted");
+	succeed_if (checkError (errorKey, ELEKTRA_ERROR_INTERFACE,
+				"The option table for '" SPEC_BASE_KEY "' was not created for the parent key 'spec:/tests/other'"),
+		    "wrong parent: wrong error");
+	ksDel (ks);
+
+	elektraOptsTableDel (decoded);
+	keyDel (tableRoot);
+	ksDel (spec);
+}
+
 int main (int argc, char ** argv)
 {
 	printf (" OPTS   TESTS\n");
@@ -1430,6 +1585,8 @@ int main (int argc, char ** argv)
 	test_args_indexed ();
 	test_args_indexed_and_remaining ();
 	test_commands ();
+	test_precompiled ();
+	test_precompiled_reuse ();
 
 	print_result ("test_opts");
 
@@ -8,6 +8,10 @@
 
 #include <kdbutility.h>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "tests.h"
 
 #define MAX_LENGTH 100
@@ -86,6 +90,130 @@ static void test_elektraStrip (void)
 	succeed_if_same_string (elektraStrip (text), "Leading And Trailing Whitespace\n\tSecond Line");
 }
 
+typedef struct
+{
+	char data[4 * 64 * 1024];
+	size_t size;
+	int calls;
+	int error;
+} WriterOutput;
+
+static int collectOutput (void * context, const char * data, size_t size)
+{
+	WriterOutput * output = context;
+	output->calls++;
+	if (output->error != 0)
+	{
+		return output->error;
+	}
+	if (output->size + size > sizeof (output->data))
+	{
+		return ENOSPC;
+	}
+	memcpy (output->data + output->size, data, size);
+	output->size += size;
+	return 0;
+}
+
+static void test_elektraWriter (void)
+{
+	printf ("Test elektraWriter\n");
+
+	static WriterOutput output;
+	static char expected[sizeof (output.data)];
+	size_t expectedSize = 0;
+	char longData[2 * ELEKTRA_WRITER_REFERENCE_SIZE];
+	memset (longData, 'x', sizeof (longData));
+
+	ElektraWriter * writer = elektraWriterNewCallback (collectOutput, &output);
+	exit_if_fail (writer != NULL, "could not create writer");
+
+	// enough short and long writes to fill the buffer and the segments several times
+	for (int i = 0; i < 500; ++i)
+	{
+		char line[32];
+		snprintf (line, sizeof (line), "line %d\n", i);
+		succeed_if (elektraWriterWriteString (writer, line) == 0, "write failed");
+		memcpy (expected + expectedSize, line, strlen (line));
+		expectedSize += strlen (line);
+
+		if (i % 7 == 0)
+		{
+			succeed_if (elektraWriterWrite (writer, longData, sizeof (longData)) == 0, "write failed");
+			memcpy (expected + expectedSize, longData, sizeof (longData));
+			expectedSize += sizeof (longData);
+		}
+	}
+	succeed_if (elektraWriterWrite (writer, "", 0) == 0, "empty write failed");
+	succeed_if (elektraWriterFlush (writer) == 0, "flush failed");
+	succeed_if (elektraWriterError (writer) == 0, "error was reported");
+
+	succeed_if (output.size == expectedSize, "wrong output size");
+	succeed_if (memcmp (output.data, expected, expectedSize) == 0, "wrong output");
+
+	elektraWriterDel (writer);
+}
+
+static void test_elektraWriterError (void)
+{
+	printf ("Test elektraWriterError\n");
+
+	static WriterOutput output;
+	output.error = EIO;
+
+	ElektraWriter * writer = elektraWriterNewCallback (collectOutput, &output);
+	exit_if_fail (writer != NULL, "could not create writer");
+
+	succeed_if (elektraWriterWriteString (writer, "first") == 0, "error reported before flush");
+	succeed_if (elektraWriterFlush (writer) == EIO, "failed flush not reported");
+	succeed_if (output.calls == 1, "callback not called once");
+
+	// data after a failed write is discarded
+	succeed_if (elektraWriterWriteString (writer, "second") == EIO, "error not kept");
+	succeed_if (elektraWriterFlush (writer) == EIO, "error not kept");
+	succeed_if (output.calls == 1, "callback called after failed write");
+
+	elektraWriterDel (writer);
+}
+
+static void test_elektraWriterFile (void)
+{
+	printf ("Test elektraWriter with file descriptor\n");
+
+	const char * fileName = elektraFilename ();
+	int fd = open (fileName, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	exit_if_fail (fd != -1, "could not open file");
+
+	char longData[ELEKTRA_WRITER_REFERENCE_SIZE];
+	memset (longData, 'y', sizeof (longData));
+
+	ElektraWriter * writer = elektraWriterNew (fd);
+	exit_if_fail (writer != NULL, "could not create writer");
+	succeed_if (elektraWriterWriteString (writer, "short ") == 0, "write failed");
+	succeed_if (elektraWriterWrite (writer, longData, sizeof (longData)) == 0, "write failed");
+	succeed_if (elektraWriterWriteString (writer, " end") == 0, "write failed");
+	succeed_if (elektraWriterFlush (writer) == 0, "flush failed");
+	elektraWriterDel (writer);
+	close (fd);
+
+	char buffer[sizeof (longData) + 32];
+	fd = open (fileName, O_RDONLY);
+	exit_if_fail (fd != -1, "could not open file");
+	ssize_t size = read (fd, buffer, sizeof (buffer));
+	succeed_if (size == (ssize_t) (sizeof (longData) + 10), "wrong file size");
+	succeed_if (memcmp (buffer, "short ", 6) == 0, "wrong file content");
+	succeed_if (memcmp (buffer + 6, longData, sizeof (longData)) == 0, "wrong file content");
+	succeed_if (memcmp (buffer + 6 + sizeof (longData), " end", 4) == 0, "wrong file content");
+
+	// writing to a read-only descriptor fails
+	writer = elektraWriterNew (fd);
+	exit_if_fail (writer != NULL, "could not create writer");
+	elektraWriterWriteString (writer, "fail");
+	succeed_if (elektraWriterFlush (writer) == EBADF, "failed write not reported");
+	elektraWriterDel (writer);
+	close (fd);
+	unlink (fileName);
+}
 
 int main (int argc, char ** argv)
 {
@@ -97,6 +225,9 @@ int main (int argc, char ** argv)
 	test_elektraLskip ();
 	test_elektraRstrip ();
 	test_elektraStrip ();
+	test_elektraWriter ();
+	test_elektraWriterError ();
+	test_elektraWriterFile ();
 
 	printf ("\nResults: %d Test%s done — %d Error%s.\n", nbTest, nbTest == 1 ? "" : "s", nbError, nbError == 1 ? "" : "s");
 
@@ -383,6 +383,103 @@ TEST_F (Highlevel, PrimitveGetters)
 #endif
 }
 
+TEST_F (Highlevel, HandleGetters)
+{
+	setValues ({
+		makeKey (KDB_TYPE_STRING, "stringkey", "A string"),
+		makeKey (KDB_TYPE_BOOLEAN, "booleankey", "1"),
+		makeKey (KDB_TYPE_CHAR, "charkey", "c"),
+		makeKey (KDB_TYPE_OCTET, "octetkey", "1"),
+		makeKey (KDB_TYPE_SHORT, "shortkey", "1"),
+		makeKey (KDB_TYPE_UNSIGNED_SHORT, "unsignedshortkey", "1"),
+		makeKey (KDB_TYPE_LONG, "longkey", "1"),
+		makeKey (KDB_TYPE_UNSIGNED_LONG, "unsignedlongkey", "1"),
+		makeKey (KDB_TYPE_LONG_LONG, "longlongkey", "1"),
+		makeKey (KDB_TYPE_UNSIGNED_LONG_LONG, "unsignedlonglongkey", "1"),
+		makeKey (KDB_TYPE_FLOAT, "floatkey", "1.1"),
+		makeKey (KDB_TYPE_DOUBLE, "doublekey", "1.1"),
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+		makeKey (KDB_TYPE_LONG_DOUBLE, "longdoublekey", "1.1"),
+
+#endif
+	});
+
+	createElektra ();
+
+	static const ElektraKeyHandle stringHandle = ELEKTRA_KEY_HANDLE_INIT (0, "stringkey", "string");
+	static const ElektraKeyHandle booleanHandle = ELEKTRA_KEY_HANDLE_INIT (1, "booleankey", "boolean");
+	static const ElektraKeyHandle charHandle = ELEKTRA_KEY_HANDLE_INIT (2, "charkey", "char");
+	static const ElektraKeyHandle octetHandle = ELEKTRA_KEY_HANDLE_INIT (3, "octetkey", "octet");
+	static const ElektraKeyHandle shortHandle = ELEKTRA_KEY_HANDLE_INIT (4, "shortkey", "short");
+	static const ElektraKeyHandle unsignedShortHandle = ELEKTRA_KEY_HANDLE_INIT (5, "unsignedshortkey", "unsigned_short");
+	static const ElektraKeyHandle longHandle = ELEKTRA_KEY_HANDLE_INIT (6, "longkey", "long");
+	static const ElektraKeyHandle unsignedLongHandle = ELEKTRA_KEY_HANDLE_INIT (7, "unsignedlongkey", "unsigned_long");
+	static const ElektraKeyHandle longLongHandle = ELEKTRA_KEY_HANDLE_INIT (8, "longlongkey", "long_long");
+	static const ElektraKeyHandle unsignedLongLongHandle = ELEKTRA_KEY_HANDLE_INIT (9, "unsignedlonglongkey", "unsigned_long_long");
+	static const ElektraKeyHandle floatHandle = ELEKTRA_KEY_HANDLE_INIT (10, "floatkey", "float");
+	static const ElektraKeyHandle doubleHandle = ELEKTRA_KEY_HANDLE_INIT (11, "doublekey", "double");
+
+	// the second round uses the cached keys
+	for (int i = 0; i < 2; ++i)
+	{
+		EXPECT_STREQ (elektraGetStringByHandle (elektra, &stringHandle), "A string") << "Wrong key value.";
+		EXPECT_TRUE (elektraGetBooleanByHandle (elektra, &booleanHandle)) << "Wrong key value.";
+		EXPECT_EQ (elektraGetCharByHandle (elektra, &charHandle), 'c') << "Wrong key value.";
+		EXPECT_EQ (elektraGetOctetByHandle (elektra, &octetHandle), 1) << "Wrong key value.";
+		EXPECT_EQ (elektraGetShortByHandle (elektra, &shortHandle), 1) << "Wrong key value.";
+		EXPECT_EQ (elektraGetUnsignedShortByHandle (elektra, &unsignedShortHandle), 1) << "Wrong key value.";
+		EXPECT_EQ (elektraGetLongByHandle (elektra, &longHandle), 1) << "Wrong key value.";
+		EXPECT_EQ (elektraGetUnsignedLongByHandle (elektra, &unsignedLongHandle), 1) << "Wrong key value.";
+		EXPECT_EQ (elektraGetLongLongByHandle (elektra, &longLongHandle), 1) << "Wrong key value.";
+		EXPECT_EQ (elektraGetUnsignedLongLongByHandle (elektra, &unsignedLongLongHandle), 1) << "Wrong key value.";
+
+		EXPECT_EQ (elektraGetFloatByHandle (elektra, &floatHandle), 1.1f) << "Wrong key value.";
+		EXPECT_EQ (elektraGetDoubleByHandle (elektra, &doubleHandle), 1.1) << "Wrong key value.";
+	}
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+	static const ElektraKeyHandle longDoubleHandle = ELEKTRA_KEY_HANDLE_INIT (12, "longdoublekey", "long_double");
+	EXPECT_EQ (elektraGetLongDoubleByHandle (elektra, &longDoubleHandle), 1.1L) << "Wrong key value.";
+
+#endif
+}
+
+TEST_F (Highlevel, HandleInvalidation)
+{
+	setValues ({
+		makeKey (KDB_TYPE_LONG, "longkey", "1"),
+		makeKey (KDB_TYPE_LONG, "otherkey", "3"),
+	});
+
+	createElektra ();
+
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (0, "longkey", "long");
+	EXPECT_EQ (elektraGetLongByHandle (elektra, &handle), 1) << "Wrong key value.";
+	EXPECT_EQ (elektraResolveKeyHandle (elektra, &handle), elektraFindKey (elektra, "longkey", "long"));
+
+	ElektraError * error = nullptr;
+	elektraSetLong (elektra, "longkey", 2, &error);
+	ASSERT_EQ (error, nullptr) << "elektraSet* failed" << &error << std::endl;
+
+	EXPECT_EQ (elektraGetLongByHandle (elektra, &handle), 2) << "Handle not updated after set.";
+
+	// a new instance must not reuse the key of the closed one
+	createElektra ();
+	EXPECT_EQ (elektraGetLongByHandle (elektra, &handle), 2) << "Handle not updated for new instance.";
+	EXPECT_EQ (elektraResolveKeyHandle (elektra, &handle), elektraFindKey (elektra, "longkey", "long"));
+
+	// handles sharing an index are still resolved correctly
+	static const ElektraKeyHandle sameIndex = ELEKTRA_KEY_HANDLE_INIT (0, "otherkey", "long");
+	EXPECT_EQ (elektraGetLongByHandle (elektra, &sameIndex), 3) << "Wrong key value.";
+	EXPECT_EQ (elektraGetLongByHandle (elektra, &handle), 2) << "Wrong key value.";
+
+	static const ElektraKeyHandle wrongType = ELEKTRA_KEY_HANDLE_INIT (1, "longkey", "string");
+	EXPECT_THROW (elektraGetStringByHandle (elektra, &wrongType), std::runtime_error);
+}
+
 TEST_F (Highlevel, ArrayGetters)
 {
 	setArrays ({
@@ -104,10 +104,42 @@ int loadConfiguration (Elektra ** elektra,
 	KeySet * defaults = embeddedSpec ();
 	
 
-	KeySet * contract = ksNew (3,
+	KeySet * contract = ksNew (35,
 	keyNew ("system:/elektra/contract/highlevel/check/spec/mounted", KEY_VALUE, "1", KEY_END),
 	keyNew ("system:/elektra/contract/highlevel/helpmode/ignore/require", KEY_VALUE, "1", KEY_END),
 	keyNew ("system:/elektra/contract/mountglobal/gopts", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec", KEY_VALUE, "spec:/tests/script/gen/highlevel/commands", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/argindices/get", KEY_META, "index", "#0", KEY_META, "index/#0", "spec:/tests/script/gen/highlevel/commands/get/keyname", KEY_META, "key", "", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/argindices/get/meta", KEY_META, "index", "#1", KEY_META, "index/#0", "spec:/tests/script/gen/highlevel/commands/get/meta/keyname", KEY_META, "index/#1", "spec:/tests/script/gen/highlevel/commands/get/meta/metaname", KEY_META, "key", "", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/commands", KEY_VALUE, "spec:/tests/script/gen/highlevel/commands", KEY_META, "hassubcommands", "1", KEY_META, "remainingargs", "dynamic", KEY_META, "remainingargskey", "spec:/tests/script/gen/highlevel/commands/dynamic/#", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/commands/get", KEY_META, "args", "#0", KEY_META, "args/#0", "keyname", KEY_META, "hassubcommands", "1", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/commands/get/meta", KEY_META, "args", "#1", KEY_META, "args/#0", "keyname", KEY_META, "args/#1", "metaname", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/commands/setter", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/fingerprint", KEY_VALUE, "3ebfd409fe637469", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys", KEY_META, "command", "1", KEY_META, "command/get", "get", KEY_META, "command/help", "                              ", KEY_META, "command/set", "setter", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/dynamic/#", KEY_META, "args", "remaining", KEY_META, "args/help", "  dynamic...                  ", KEY_META, "command/key", "/", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/get", KEY_META, "command", "1", KEY_META, "command/help", "  get                         ", KEY_META, "command/meta", "meta", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/get/keyname", KEY_META, "args", "indexed", KEY_META, "args/help", "  keyname                     ", KEY_META, "args/index", "0", KEY_META, "command/key", "/get", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/get/maxlength", KEY_META, "command/key", "/get", KEY_META, "opt", "#0", KEY_META, "opt/#0", "/get/long/max-length", KEY_META, "opt/help", "  , --max-length=ARG          ", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/get/meta", KEY_META, "command", "1", KEY_META, "command/help", "  meta                        ", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/get/meta/keyname", KEY_META, "args", "indexed", KEY_META, "args/help", "  keyname                     ", KEY_META, "args/index", "0", KEY_META, "command/key", "/get/meta", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/get/meta/metaname", KEY_META, "args", "indexed", KEY_META, "args/help", "  metaname                    ", KEY_META, "args/index", "1", KEY_META, "command/key", "/get/meta", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/get/meta/verbose", KEY_META, "command/key", "/get/meta", KEY_META, "opt", "#1", KEY_META, "opt/#0", "/get/meta/short/v", KEY_META, "opt/#1", "/get/meta/long/verbose", KEY_META, "opt/help", "  -v, --verbose               ", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/get/verbose", KEY_META, "command/key", "/get", KEY_META, "opt", "#1", KEY_META, "opt/#0", "/get/short/v", KEY_META, "opt/#1", "/get/long/verbose", KEY_META, "opt/help", "  -v, --verbose               ", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/printversion", KEY_META, "command/key", "/", KEY_META, "opt", "#1", KEY_META, "opt/#0", "/short/v", KEY_META, "opt/#1", "/long/version", KEY_META, "opt/help", "  -v, --version               ", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/keys/setter", KEY_META, "command", "1", KEY_META, "command/help", "  set                         ", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/get/long/help", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/get/long/max-length", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "required", KEY_META, "key", "spec:/tests/script/gen/highlevel/commands/get/maxlength", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/get/long/verbose", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "key", "spec:/tests/script/gen/highlevel/commands/get/verbose", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/get/meta/long/help", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/get/meta/long/verbose", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "key", "spec:/tests/script/gen/highlevel/commands/get/meta/verbose", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/get/meta/short/v", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "key", "spec:/tests/script/gen/highlevel/commands/get/meta/verbose", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/get/short/v", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "key", "spec:/tests/script/gen/highlevel/commands/get/verbose", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/long/help", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/long/version", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "key", "spec:/tests/script/gen/highlevel/commands/printversion", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/setter/long/help", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/short/v", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "key", "spec:/tests/script/gen/highlevel/commands/printversion", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/subcommands", KEY_VALUE, "1", KEY_END),
 	KS_END);
 ;
 	Key * parentKey = keyNew ("/tests/script/gen/highlevel/commands", KEY_END);
@@ -278,7 +278,9 @@ static inline kdb_long_long_t ELEKTRA_SIZE (ELEKTRA_TAG_DYNAMIC) (Elektra * elek
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (0, "get", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
@@ -314,7 +316,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET_KEYNAME) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get/keyname");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (1, "get/keyname", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
@@ -349,7 +353,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_KEYNAME) (Elektra * elektra,
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_GET_MAXLENGTH) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "get/maxlength");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (2, "get/maxlength", "long");
+	return ELEKTRA_GET_BY_HANDLE (Long) (elektra, &handle);
+	
 }
 
 
@@ -385,7 +391,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_MAXLENGTH) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET_META) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get/meta");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (3, "get/meta", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
@@ -421,7 +429,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_META) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET_META_KEYNAME) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get/meta/keyname");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (4, "get/meta/keyname", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
@@ -457,7 +467,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_META_KEYNAME) (Elektra * elektra
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET_META_METANAME) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get/meta/metaname");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (5, "get/meta/metaname", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
@@ -492,7 +504,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_META_METANAME) (Elektra * elektr
 static inline kdb_boolean_t ELEKTRA_GET (ELEKTRA_TAG_GET_META_VERBOSE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Boolean) (elektra, "get/meta/verbose");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (6, "get/meta/verbose", "boolean");
+	return ELEKTRA_GET_BY_HANDLE (Boolean) (elektra, &handle);
+	
 }
 
 
@@ -527,7 +541,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_META_VERBOSE) (Elektra * elektra
 static inline kdb_boolean_t ELEKTRA_GET (ELEKTRA_TAG_GET_VERBOSE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Boolean) (elektra, "get/verbose");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (7, "get/verbose", "boolean");
+	return ELEKTRA_GET_BY_HANDLE (Boolean) (elektra, &handle);
+	
 }
 
 
@@ -562,7 +578,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_VERBOSE) (Elektra * elektra,
 static inline kdb_boolean_t ELEKTRA_GET (ELEKTRA_TAG_PRINTVERSION) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Boolean) (elektra, "printversion");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (8, "printversion", "boolean");
+	return ELEKTRA_GET_BY_HANDLE (Boolean) (elektra, &handle);
+	
 }
 
 
@@ -598,7 +616,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_PRINTVERSION) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_SETTER) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "setter");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (9, "setter", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
@@ -634,7 +654,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_SETTER) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_SETTER_KEYNAME) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "setter/keyname");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (10, "setter/keyname", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
@@ -670,7 +692,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_SETTER_KEYNAME) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_SETTER_VALUE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "setter/value");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (11, "setter/value", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
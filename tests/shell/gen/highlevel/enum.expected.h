@@ -228,6 +228,7 @@ ELEKTRA_SET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumMyenum, EnumMyenum);
 static inline ElektraEnumDisjointed ELEKTRA_GET (ELEKTRA_TAG_DISJOINTED) (Elektra * elektra )
 {
 	
+	
 	return ELEKTRA_GET (EnumDisjointed) (elektra, "disjointed");
 }
 
@@ -263,6 +264,7 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_DISJOINTED) (Elektra * elektra,
 static inline ExistingColors ELEKTRA_GET (ELEKTRA_TAG_EXISTINGGENTYPE) (Elektra * elektra )
 {
 	
+	
 	return ELEKTRA_GET (EnumExistingColors) (elektra, "existinggentype");
 }
 
@@ -298,6 +300,7 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_EXISTINGGENTYPE) (Elektra * elektra,
 static inline Colors ELEKTRA_GET (ELEKTRA_TAG_GENTYPE) (Elektra * elektra )
 {
 	
+	
 	return ELEKTRA_GET (EnumColors) (elektra, "gentype");
 }
 
@@ -333,6 +336,7 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GENTYPE) (Elektra * elektra,
 static inline Colors ELEKTRA_GET (ELEKTRA_TAG_GENTYPE2) (Elektra * elektra )
 {
 	
+	
 	return ELEKTRA_GET (EnumColors) (elektra, "gentype2");
 }
 
@@ -368,6 +372,7 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GENTYPE2) (Elektra * elektra,
 static inline ElektraEnumMyenum ELEKTRA_GET (ELEKTRA_TAG_MYENUM) (Elektra * elektra )
 {
 	
+	
 	return ELEKTRA_GET (EnumMyenum) (elektra, "myenum");
 }
 
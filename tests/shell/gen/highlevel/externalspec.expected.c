@@ -86,10 +86,15 @@ int loadConfiguration (Elektra ** elektra,
 	
 	KeySet * defaults = NULL;
 
-	KeySet * contract = ksNew (3,
+	KeySet * contract = ksNew (8,
 	keyNew ("system:/elektra/contract/highlevel/check/spec/mounted", KEY_VALUE, "1", KEY_END),
 	keyNew ("system:/elektra/contract/highlevel/helpmode/ignore/require", KEY_VALUE, "1", KEY_END),
 	keyNew ("system:/elektra/contract/mountglobal/gopts", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec", KEY_VALUE, "spec:/tests/script/gen/highlevel/externalspec", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/commands", KEY_VALUE, "spec:/tests/script/gen/highlevel/externalspec", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/fingerprint", KEY_VALUE, "78a44ddfe47fbd62", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/long/help", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/subcommands", KEY_VALUE, "0", KEY_END),
 	KS_END);
 ;
 	Key * parentKey = keyNew ("/tests/script/gen/highlevel/externalspec", KEY_END);
@@ -174,7 +174,9 @@ extern "C" {
 static inline kdb_double_t ELEKTRA_GET (ELEKTRA_TAG_MYDOUBLE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Double) (elektra, "mydouble");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (0, "mydouble", "double");
+	return ELEKTRA_GET_BY_HANDLE (Double) (elektra, &handle);
+	
 }
 
 
@@ -263,7 +265,9 @@ static inline kdb_long_long_t ELEKTRA_SIZE (ELEKTRA_TAG_MYFLOATARRAY) (Elektra *
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_MYINT) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "myint");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (1, "myint", "long");
+	return ELEKTRA_GET_BY_HANDLE (Long) (elektra, &handle);
+	
 }
 
 
@@ -299,7 +303,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYINT) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_MYSTRING) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "mystring");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (2, "mystring", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
@@ -334,7 +340,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYSTRING) (Elektra * elektra,
 static inline kdb_boolean_t ELEKTRA_GET (ELEKTRA_TAG_PRINT) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Boolean) (elektra, "print");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (3, "print", "boolean");
+	return ELEKTRA_GET_BY_HANDLE (Boolean) (elektra, &handle);
+	
 }
 
 
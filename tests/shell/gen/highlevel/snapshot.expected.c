@@ -0,0 +1,436 @@
+// clang-format off
+
+
+// clang-format on
+/**
+ * @file
+ *
+ * This file was automatically generated using `kdb gen highlevel`.
+ * Any changes will be overwritten, when the file is regenerated.
+ *
+ * @copyright BSD Zero Clause License
+ *
+ *     Copyright (c) Elektra Initiative (https://www.libelektra.org)
+ *
+ *     Permission to use, copy, modify, and/or distribute this software for any
+ *     purpose with or without fee is hereby granted.
+ *
+ *     THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ *     REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *     FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ *     INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ *     LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ *     OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ *     PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "snapshot.actual.h"
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <kdbhelper.h>
+#include <kdbinvoke.h>
+#include <kdbopts.h>
+#include <kdbgopts.h>
+
+#include <elektra/conversion.h>
+
+static KeySet * embeddedSpec (void)
+{
+	return ksNew (7,
+	keyNew ("/", KEY_META, "mountpoint", "tests_gen_elektra_snapshot.ini", KEY_END),
+	keyNew ("/color", KEY_META, "check/enum", "#2", KEY_META, "check/enum/#0", "red", KEY_META, "check/enum/#1", "green", KEY_META, "check/enum/#2", "blue", KEY_META, "default", "green", KEY_META, "type", "enum", KEY_END),
+	keyNew ("/print", KEY_META, "default", "0", KEY_META, "type", "boolean", KEY_END),
+	keyNew ("/server/host", KEY_META, "default", "localhost", KEY_META, "type", "string", KEY_END),
+	keyNew ("/server/port", KEY_META, "default", "8080", KEY_META, "type", "unsigned_short", KEY_END),
+	keyNew ("/server/timeout", KEY_META, "default", "1.5", KEY_META, "type", "double", KEY_END),
+	keyNew ("/user/_/name", KEY_META, "default", "", KEY_META, "type", "string", KEY_END),
+	KS_END);
+;
+}
+
+static const char * helpFallback = "Usage: tests_script_gen_highlevel_snapshot [OPTION...]\n\nOPTIONS\n  --help                      Print this help message\n";
+
+static int isHelpMode (int argc, const char * const * argv)
+{
+	for (int i = 0; i < argc; ++i)
+	{
+		if (strcmp (argv[i], "--help") == 0)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+
+/**
+ * Initializes an instance of Elektra for the application '/tests/script/gen/highlevel/snapshot'.
+ *
+ * This can be invoked as many times as you want, however it is not a cheap operation,
+ * so you should try to reuse the Elektra handle as much as possible.
+ *
+ * @param elektra A reference to where the Elektra instance shall be stored.
+ *                Has to be disposed of with elektraClose().
+ * @param error   A reference to an ElektraError pointer. Will be passed to elektraOpen().
+ *
+ * @retval 0  on success, @p elektra will contain a new Elektra instance coming from elektraOpen(),
+ *            @p error will be unchanged
+ * @retval -1 on error, @p elektra will be unchanged, @p error will be set
+ * @retval 1  help mode, '--help' was specified call printHelpMessage to display
+ *            the help message. @p elektra will contain a new Elektra instance. It has to be passed
+ *            to printHelpMessage. You also need to elektraClose() it.
+ *            @p error will be unchanged
+ *
+ * @see elektraOpen
+ */// 
+int loadConfiguration (Elektra ** elektra, 
+				 int argc, const char * const * argv, const char * const * envp,
+				 ElektraError ** error)
+{
+	KeySet * defaults = embeddedSpec ();
+	
+
+	KeySet * contract = ksNew (8,
+	keyNew ("system:/elektra/contract/highlevel/check/spec/mounted", KEY_VALUE, "1", KEY_END),
+	keyNew ("system:/elektra/contract/highlevel/helpmode/ignore/require", KEY_VALUE, "1", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec", KEY_VALUE, "spec:/tests/script/gen/highlevel/snapshot", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/commands", KEY_VALUE, "spec:/tests/script/gen/highlevel/snapshot", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/fingerprint", KEY_VALUE, "f733dfc8a50c1e31", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/options/long/help", KEY_META, "flagvalue", "1", KEY_META, "hasarg", "none", KEY_META, "kind", "single", KEY_END),
+	keyNew ("system:/elektra/contract/mountglobal/gopts/spec/subcommands", KEY_VALUE, "0", KEY_END),
+	KS_END);
+;
+	Key * parentKey = keyNew ("/tests/script/gen/highlevel/snapshot", KEY_END);
+
+	elektraGOptsContract (contract, argc, argv, envp, parentKey, NULL);
+	
+
+	keyDel (parentKey);
+
+	Elektra * e = elektraOpen ("/tests/script/gen/highlevel/snapshot", defaults, contract, error);
+
+	if (defaults != NULL)
+	{
+		ksDel (defaults);
+	}
+
+	if (contract != NULL)
+	{
+		ksDel (contract);
+	}
+
+	if (e == NULL)
+	{
+		*elektra = NULL;
+		if (isHelpMode (argc, argv))
+		{
+			elektraErrorReset (error);
+			return 1;
+		}
+		
+
+		return -1;
+	}
+
+	*elektra = e;
+	return elektraHelpKey (e) != NULL && strcmp (keyString (elektraHelpKey (e)), "1") == 0 ? 1 : 0;
+}
+
+/**
+ * Checks whether specload mode was invoked and if so, sends the specification over stdout
+ * in the format expected by specload.
+ *
+ * You MUST not output anything to stdout before invoking this function. Ideally invoking this
+ * is the first thing you do in your main()-function.
+ *
+ * This function will ONLY RETURN, if specload mode was NOT invoked. Otherwise it will call `exit()`.
+ *
+ * @param argc pass the value of argc from main
+ * @param argv pass the value of argv from main
+ */
+void exitForSpecload (int argc, const char * const * argv)
+{
+	if (argc != 2 || strcmp (argv[1], "--elektra-spec") != 0)
+	{
+		return;
+	}
+
+	KeySet * spec = embeddedSpec ();
+
+	Key * parentKey = keyNew ("spec:/tests/script/gen/highlevel/snapshot", KEY_META, "system:/elektra/quickdump/noparent", "", KEY_END);
+
+	KeySet * specloadConf = ksNew (1, keyNew ("system:/sendspec", KEY_END), KS_END);
+	ElektraInvokeHandle * specload = elektraInvokeOpen ("specload", specloadConf, parentKey);
+
+	int result = elektraInvoke2Args (specload, "sendspec", spec, parentKey);
+
+	elektraInvokeClose (specload, parentKey);
+	keyDel (parentKey);
+	ksDel (specloadConf);
+	ksDel (spec);
+
+	exit (result == ELEKTRA_PLUGIN_STATUS_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/**
+ * Reads all keys of the struct AppConfig in one pass.
+ *
+ * The keys are resolved in the order of the specification. Each key is only looked up again,
+ * if @p elektra was modified since the last call, otherwise just its value is converted again.
+ *
+ * @p config is only modified, if all keys could be read. If a key cannot be read, the fatal
+ * error handler of @p elektra will be called.
+ *
+ * @param elektra The elektra instance initialized with loadConfiguration().
+ * @param config  The struct into which the values will be stored.
+ *   Strings stored in @p config remain valid until the internal state of @p elektra is modified.
+ *   All calls to elektraSet* modify this state.
+ */// 
+void loadConfig (Elektra * elektra, AppConfig * config)
+{
+	static const ElektraKeyHandle handles[] = {
+		ELEKTRA_KEY_HANDLE_INIT (0, "color", "enum"),
+		ELEKTRA_KEY_HANDLE_INIT (2, "print", "boolean"),
+		ELEKTRA_KEY_HANDLE_INIT (4, "server/host", "string"),
+		ELEKTRA_KEY_HANDLE_INIT (6, "server/port", "unsigned_short"),
+		ELEKTRA_KEY_HANDLE_INIT (8, "server/timeout", "double"),
+	};
+
+	AppConfig snapshot;
+	const Key * key;
+
+	key = elektraResolveKeyHandle (elektra, &handles[0]);
+	if (key == NULL)
+	{
+		return;
+	}
+	if (!ELEKTRA_KEY_TO (EnumColor) (key, &snapshot.color))
+	{
+		elektraFatalError (elektra, elektraErrorConversionFromString ("enum", "color", keyString (key)));
+		return;
+	}
+
+	key = elektraResolveKeyHandle (elektra, &handles[1]);
+	if (key == NULL)
+	{
+		return;
+	}
+	if (!ELEKTRA_KEY_TO (Boolean) (key, &snapshot.print))
+	{
+		elektraFatalError (elektra, elektraErrorConversionFromString ("boolean", "print", keyString (key)));
+		return;
+	}
+
+	key = elektraResolveKeyHandle (elektra, &handles[2]);
+	if (key == NULL)
+	{
+		return;
+	}
+	if (!ELEKTRA_KEY_TO (String) (key, &snapshot.server.host))
+	{
+		elektraFatalError (elektra, elektraErrorConversionFromString ("string", "server/host", keyString (key)));
+		return;
+	}
+
+	key = elektraResolveKeyHandle (elektra, &handles[3]);
+	if (key == NULL)
+	{
+		return;
+	}
+	if (!ELEKTRA_KEY_TO (UnsignedShort) (key, &snapshot.server.port))
+	{
+		elektraFatalError (elektra, elektraErrorConversionFromString ("unsigned_short", "server/port", keyString (key)));
+		return;
+	}
+
+	key = elektraResolveKeyHandle (elektra, &handles[4]);
+	if (key == NULL)
+	{
+		return;
+	}
+	if (!ELEKTRA_KEY_TO (Double) (key, &snapshot.server.timeout))
+	{
+		elektraFatalError (elektra, elektraErrorConversionFromString ("double", "server/timeout", keyString (key)));
+		return;
+	}
+
+	*config = snapshot;
+}
+
+/**
+ * Outputs the help message to stdout
+ *
+ * @param elektra  The Elektra instance produced by loadConfiguration.
+ * @param usage	   If this is not NULL, it will be used instead of the default usage line.
+ * @param prefix   If this is not NULL, it will be inserted between the usage line and the options list.
+ */// 
+void printHelpMessage (Elektra * elektra, const char * usage, const char * prefix)
+{
+	if (elektra == NULL)
+	{
+		printf ("%s", helpFallback);
+		return;
+	}
+
+	Key * helpKey = elektraHelpKey (elektra);
+	if (helpKey == NULL)
+	{
+		return;
+	}
+
+	char * help = elektraGetOptsHelpMessage (helpKey, usage, prefix);
+	printf ("%s", help);
+	elektraFree (help);
+}
+
+
+
+// clang-format off
+
+// clang-format on
+
+// -------------------------
+// Enum conversion functions
+// -------------------------
+
+ELEKTRA_KEY_TO_SIGNATURE (ElektraEnumColor, EnumColor)
+{
+	const char * string;
+	if (!elektraKeyToString (key, &string) || strlen (string) == 0)
+	{
+		return 0;
+	}
+
+	switch (string[0])
+{
+case 'b':
+*variable = ELEKTRA_ENUM_COLOR_BLUE;
+return 1;
+case 'g':
+*variable = ELEKTRA_ENUM_COLOR_GREEN;
+return 1;
+case 'r':
+*variable = ELEKTRA_ENUM_COLOR_RED;
+return 1;
+}
+
+	
+
+	return 0;
+}
+
+ELEKTRA_TO_STRING_SIGNATURE (ElektraEnumColor, EnumColor)
+{
+	switch (value)
+	{
+	case ELEKTRA_ENUM_COLOR_RED:
+		return elektraStrDup ("red");
+	case ELEKTRA_ENUM_COLOR_GREEN:
+		return elektraStrDup ("green");
+	case ELEKTRA_ENUM_COLOR_BLUE:
+		return elektraStrDup ("blue");
+	}
+
+	// should be unreachable
+	return elektraStrDup ("");
+}
+
+ELEKTRA_TO_CONST_STRING_SIGNATURE (ElektraEnumColor, EnumColor)
+{
+	switch (value)
+	{
+	case ELEKTRA_ENUM_COLOR_RED:
+		return "red";
+	case ELEKTRA_ENUM_COLOR_GREEN:
+		return "green";
+	case ELEKTRA_ENUM_COLOR_BLUE:
+		return "blue";
+	}
+
+	// should be unreachable
+	return "";
+}
+
+// -------------------------
+// Enum accessor functions
+// -------------------------
+
+ELEKTRA_GET_SIGNATURE (ElektraEnumColor, EnumColor)
+{
+	ElektraEnumColor result;
+	const Key * key = elektraFindKey (elektra, keyname, KDB_TYPE_ENUM);
+	if (!ELEKTRA_KEY_TO (EnumColor) (key, &result))
+	{
+		elektraFatalError (elektra, elektraErrorConversionFromString (KDB_TYPE_ENUM, keyname, keyString (key)));
+		return (ElektraEnumColor) 0;
+	}
+	return result;
+}
+
+ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumColor, EnumColor)
+{
+	ElektraEnumColor result;
+	const Key * key = elektraFindArrayElementKey (elektra, keyname, index, KDB_TYPE_ENUM);
+	if (!ELEKTRA_KEY_TO (EnumColor) (key, &result))
+	{
+		elektraFatalError (elektra, elektraErrorConversionFromString (KDB_TYPE_ENUM, keyname, keyString (key)));
+		return (ElektraEnumColor) 0;
+	}
+	return result;
+}
+
+ELEKTRA_SET_SIGNATURE (ElektraEnumColor, EnumColor)
+{
+	char * string = ELEKTRA_TO_STRING (EnumColor) (value);
+	if (string == 0)
+	{
+		*error = elektraErrorConversionToString (KDB_TYPE_ENUM, keyname);
+		return;
+	}
+	elektraSetRawString (elektra, keyname, string, KDB_TYPE_ENUM, error);
+	elektraFree (string);
+}
+
+ELEKTRA_SET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumColor, EnumColor)
+{
+	char * string = ELEKTRA_TO_STRING (EnumColor) (value);
+	if (string == 0)
+	{
+		*error = elektraErrorConversionToString (KDB_TYPE_ENUM, keyname);
+		return;
+	}
+	elektraSetRawStringArrayElement (elektra, keyname, index, string, KDB_TYPE_ENUM, error);
+	elektraFree (string);
+}
+
+
+// clang-format off
+
+// clang-format on
+
+// -------------------------
+// Union accessor functions
+// -------------------------
+
+
+
+
+// clang-format off
+
+// clang-format on
+
+// -------------------------
+// Struct accessor functions
+// -------------------------
+
+
+
@@ -0,0 +1,545 @@
+// clang-format off
+
+
+// clang-format on
+/**
+ * @file
+ *
+ * This file was automatically generated using `kdb gen highlevel`.
+ * Any changes will be overwritten, when the file is regenerated.
+ *
+ * @copyright BSD Zero Clause License
+ *
+ *     Copyright (c) Elektra Initiative (https://www.libelektra.org)
+ *
+ *     Permission to use, copy, modify, and/or distribute this software for any
+ *     purpose with or without fee is hereby granted.
+ *
+ *     THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ *     REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *     FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ *     INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ *     LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ *     OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ *     PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+#ifndef SNAPSHOT_ACTUAL_H
+#define SNAPSHOT_ACTUAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <elektra.h>
+
+#include <kdbhelper.h>
+#include <string.h>
+
+
+
+
+
+// clang-format off
+
+// clang-format on
+
+typedef enum
+{
+	ELEKTRA_ENUM_COLOR_RED = 0,
+	ELEKTRA_ENUM_COLOR_GREEN = 1,
+	ELEKTRA_ENUM_COLOR_BLUE = 2,
+} ElektraEnumColor;
+
+
+#define ELEKTRA_TO_CONST_STRING(typeName) ELEKTRA_CONCAT (ELEKTRA_CONCAT (elektra, typeName), ToConstString)
+#define ELEKTRA_TO_CONST_STRING_SIGNATURE(cType, typeName) const char * ELEKTRA_TO_CONST_STRING (typeName) (cType value)
+
+ELEKTRA_KEY_TO_SIGNATURE (ElektraEnumColor, EnumColor);
+ELEKTRA_TO_STRING_SIGNATURE (ElektraEnumColor, EnumColor);
+ELEKTRA_TO_CONST_STRING_SIGNATURE (ElektraEnumColor, EnumColor);
+
+ELEKTRA_GET_SIGNATURE (ElektraEnumColor, EnumColor);
+ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumColor, EnumColor);
+ELEKTRA_SET_SIGNATURE (ElektraEnumColor, EnumColor);
+ELEKTRA_SET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumColor, EnumColor);
+
+
+
+// clang-format off
+
+// clang-format on
+
+#define ELEKTRA_UNION_FREE(typeName) ELEKTRA_CONCAT (elektraFree, typeName)
+#define ELEKTRA_UNION_FREE_SIGNATURE(cType, typeName, discrType) void ELEKTRA_UNION_FREE (typeName) (cType * ptr, discrType discriminator)
+
+#define ELEKTRA_UNION_GET_SIGNATURE(cType, typeName, discrType)                                                                            \
+	cType ELEKTRA_GET (typeName) (Elektra * elektra, const char * keyname, discrType discriminator)
+#define ELEKTRA_UNION_GET_ARRAY_ELEMENT_SIGNATURE(cType, typeName, discrType)                                                              \
+	cType ELEKTRA_GET_ARRAY_ELEMENT (typeName) (Elektra * elektra, const char * keyname, kdb_long_long_t index, discrType discriminator)
+#define ELEKTRA_UNION_SET_SIGNATURE(cType, typeName, discrType)                                                                            \
+	void ELEKTRA_SET (typeName) (Elektra * elektra, const char * keyname, cType value, discrType discriminator, ElektraError ** error)
+#define ELEKTRA_UNION_SET_ARRAY_ELEMENT_SIGNATURE(cType, typeName, discrType)                                                              \
+	void ELEKTRA_SET_ARRAY_ELEMENT (typeName) (Elektra * elektra, const char * keyname, kdb_long_long_t index, cType value,            \
+						   discrType discriminator, ElektraError ** error)
+
+
+
+
+
+
+// clang-format off
+
+// clang-format on
+
+#define ELEKTRA_STRUCT_FREE(typeName) ELEKTRA_CONCAT (elektraFree, typeName)
+#define ELEKTRA_STRUCT_FREE_SIGNATURE(cType, typeName) void ELEKTRA_STRUCT_FREE (typeName) (cType * ptr)
+
+
+
+
+
+
+// clang-format off
+
+// clang-format on
+
+// clang-format off
+
+/**
+* Tag name for 'color'
+* 
+*/// 
+#define ELEKTRA_TAG_COLOR Color
+
+/**
+* Tag name for 'print'
+* 
+*/// 
+#define ELEKTRA_TAG_PRINT Print
+
+/**
+* Tag name for 'server/host'
+* 
+*/// 
+#define ELEKTRA_TAG_SERVER_HOST ServerHost
+
+/**
+* Tag name for 'server/port'
+* 
+*/// 
+#define ELEKTRA_TAG_SERVER_PORT ServerPort
+
+/**
+* Tag name for 'server/timeout'
+* 
+*/// 
+#define ELEKTRA_TAG_SERVER_TIMEOUT ServerTimeout
+
+/**
+* Tag name for 'user/_/name'
+* 
+* Required arguments:
+* 
+* - const char * name1: Replaces occurrence no. 1 of _ in the keyname.
+* 
+* 
+*/// 
+#define ELEKTRA_TAG_USER_NAME UserName
+// clang-format on
+
+
+// clang-format off
+
+// clang-format on
+
+// local helper macros to determine the length of a 64 bit integer
+#define elektra_len19(x) ((x) < 10000000000000000000ULL ? 19 : 20)
+#define elektra_len18(x) ((x) < 1000000000000000000ULL ? 18 : elektra_len19 (x))
+#define elektra_len17(x) ((x) < 100000000000000000ULL ? 17 : elektra_len18 (x))
+#define elektra_len16(x) ((x) < 10000000000000000ULL ? 16 : elektra_len17 (x))
+#define elektra_len15(x) ((x) < 1000000000000000ULL ? 15 : elektra_len16 (x))
+#define elektra_len14(x) ((x) < 100000000000000ULL ? 14 : elektra_len15 (x))
+#define elektra_len13(x) ((x) < 10000000000000ULL ? 13 : elektra_len14 (x))
+#define elektra_len12(x) ((x) < 1000000000000ULL ? 12 : elektra_len13 (x))
+#define elektra_len11(x) ((x) < 100000000000ULL ? 11 : elektra_len12 (x))
+#define elektra_len10(x) ((x) < 10000000000ULL ? 10 : elektra_len11 (x))
+#define elektra_len09(x) ((x) < 1000000000ULL ? 9 : elektra_len10 (x))
+#define elektra_len08(x) ((x) < 100000000ULL ? 8 : elektra_len09 (x))
+#define elektra_len07(x) ((x) < 10000000ULL ? 7 : elektra_len08 (x))
+#define elektra_len06(x) ((x) < 1000000ULL ? 6 : elektra_len07 (x))
+#define elektra_len05(x) ((x) < 100000ULL ? 5 : elektra_len06 (x))
+#define elektra_len04(x) ((x) < 10000ULL ? 4 : elektra_len05 (x))
+#define elektra_len03(x) ((x) < 1000ULL ? 3 : elektra_len04 (x))
+#define elektra_len02(x) ((x) < 100ULL ? 2 : elektra_len03 (x))
+#define elektra_len01(x) ((x) < 10ULL ? 1 : elektra_len02 (x))
+#define elektra_len00(x) ((x) < 0ULL ? 0 : elektra_len01 (x))
+#define elektra_len(x) elektra_len00 (x)
+
+#define ELEKTRA_SIZE(tagName) ELEKTRA_CONCAT (elektraSize, tagName)
+
+
+
+
+/**
+ * Get the value of key 'color' (tag #ELEKTRA_TAG_COLOR).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+
+ *
+ * @return the value of 'color'.
+
+ */// 
+static inline ElektraEnumColor ELEKTRA_GET (ELEKTRA_TAG_COLOR) (Elektra * elektra )
+{
+	
+	
+	return ELEKTRA_GET (EnumColor) (elektra, "color");
+}
+
+
+/**
+ * Set the value of key 'color' (tag #ELEKTRA_TAG_COLOR).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+ * @param value   The value of 'color'.
+
+ * @param error   Pass a reference to an ElektraError pointer.
+ *                Will only be set in case of an error.
+ */// 
+static inline void ELEKTRA_SET (ELEKTRA_TAG_COLOR) (Elektra * elektra,
+						      ElektraEnumColor value,  ElektraError ** error)
+{
+	
+	ELEKTRA_SET (EnumColor) (elektra, "color", value, error);
+}
+
+
+
+
+/**
+ * Get the value of key 'print' (tag #ELEKTRA_TAG_PRINT).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+
+ *
+ * @return the value of 'print'.
+
+ */// 
+static inline kdb_boolean_t ELEKTRA_GET (ELEKTRA_TAG_PRINT) (Elektra * elektra )
+{
+	
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (1, "print", "boolean");
+	return ELEKTRA_GET_BY_HANDLE (Boolean) (elektra, &handle);
+	
+}
+
+
+/**
+ * Set the value of key 'print' (tag #ELEKTRA_TAG_PRINT).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+ * @param value   The value of 'print'.
+
+ * @param error   Pass a reference to an ElektraError pointer.
+ *                Will only be set in case of an error.
+ */// 
+static inline void ELEKTRA_SET (ELEKTRA_TAG_PRINT) (Elektra * elektra,
+						      kdb_boolean_t value,  ElektraError ** error)
+{
+	
+	ELEKTRA_SET (Boolean) (elektra, "print", value, error);
+}
+
+
+
+
+/**
+ * Get the value of key 'server/host' (tag #ELEKTRA_TAG_SERVER_HOST).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+
+ *
+ * @return the value of 'server/host'.
+ *   The returned pointer may become invalid, if the internal state of @p elektra
+ *   is modified. All calls to elektraSet* modify this state.
+ */// 
+static inline const char * ELEKTRA_GET (ELEKTRA_TAG_SERVER_HOST) (Elektra * elektra )
+{
+	
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (3, "server/host", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
+}
+
+
+/**
+ * Set the value of key 'server/host' (tag #ELEKTRA_TAG_SERVER_HOST).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+ * @param value   The value of 'server/host'.
+
+ * @param error   Pass a reference to an ElektraError pointer.
+ *                Will only be set in case of an error.
+ */// 
+static inline void ELEKTRA_SET (ELEKTRA_TAG_SERVER_HOST) (Elektra * elektra,
+						      const char * value,  ElektraError ** error)
+{
+	
+	ELEKTRA_SET (String) (elektra, "server/host", value, error);
+}
+
+
+
+
+/**
+ * Get the value of key 'server/port' (tag #ELEKTRA_TAG_SERVER_PORT).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+
+ *
+ * @return the value of 'server/port'.
+
+ */// 
+static inline kdb_unsigned_short_t ELEKTRA_GET (ELEKTRA_TAG_SERVER_PORT) (Elektra * elektra )
+{
+	
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (5, "server/port", "unsigned_short");
+	return ELEKTRA_GET_BY_HANDLE (UnsignedShort) (elektra, &handle);
+	
+}
+
+
+/**
+ * Set the value of key 'server/port' (tag #ELEKTRA_TAG_SERVER_PORT).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+ * @param value   The value of 'server/port'.
+
+ * @param error   Pass a reference to an ElektraError pointer.
+ *                Will only be set in case of an error.
+ */// 
+static inline void ELEKTRA_SET (ELEKTRA_TAG_SERVER_PORT) (Elektra * elektra,
+						      kdb_unsigned_short_t value,  ElektraError ** error)
+{
+	
+	ELEKTRA_SET (UnsignedShort) (elektra, "server/port", value, error);
+}
+
+
+
+
+/**
+ * Get the value of key 'server/timeout' (tag #ELEKTRA_TAG_SERVER_TIMEOUT).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+
+ *
+ * @return the value of 'server/timeout'.
+
+ */// 
+static inline kdb_double_t ELEKTRA_GET (ELEKTRA_TAG_SERVER_TIMEOUT) (Elektra * elektra )
+{
+	
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (7, "server/timeout", "double");
+	return ELEKTRA_GET_BY_HANDLE (Double) (elektra, &handle);
+	
+}
+
+
+/**
+ * Set the value of key 'server/timeout' (tag #ELEKTRA_TAG_SERVER_TIMEOUT).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+ * @param value   The value of 'server/timeout'.
+
+ * @param error   Pass a reference to an ElektraError pointer.
+ *                Will only be set in case of an error.
+ */// 
+static inline void ELEKTRA_SET (ELEKTRA_TAG_SERVER_TIMEOUT) (Elektra * elektra,
+						      kdb_double_t value,  ElektraError ** error)
+{
+	
+	ELEKTRA_SET (Double) (elektra, "server/timeout", value, error);
+}
+
+
+
+
+/**
+ * Get the value of key 'user/_/name' (tag #ELEKTRA_TAG_USER_NAME).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+ * @param name1 Replaces occurrence no. 1 of _ in the keyname.
+ *
+ * @return the value of 'user/_/name'.
+ *   The returned pointer may become invalid, if the internal state of @p elektra
+ *   is modified. All calls to elektraSet* modify this state.
+ */// 
+static inline const char * ELEKTRA_GET (ELEKTRA_TAG_USER_NAME) (Elektra * elektra ,
+								       const char * name1   )
+{
+	char * name = elektraFormat ("user/%s/name",  name1  );
+	const char * result = ELEKTRA_GET (String) (elektra, name);
+	elektraFree (name);
+	return result;
+	
+}
+
+
+/**
+ * Set the value of key 'user/_/name' (tag #ELEKTRA_TAG_USER_NAME).
+ *
+ * @param elektra Instance of Elektra. Create with loadConfiguration().
+ * @param value   The value of 'user/_/name'.
+ * @param name1 Replaces occurrence no. 1 of _ in the keyname.
+ * @param error   Pass a reference to an ElektraError pointer.
+ *                Will only be set in case of an error.
+ */// 
+static inline void ELEKTRA_SET (ELEKTRA_TAG_USER_NAME) (Elektra * elektra,
+						      const char * value,  
+						      const char * name1,
+						        ElektraError ** error)
+{
+	char * name = elektraFormat ("user/%s/name",  name1  );
+	ELEKTRA_SET (String) (elektra, name, value, error);
+	elektraFree (name);
+	
+}
+
+
+#undef elektra_len19
+#undef elektra_len18
+#undef elektra_len17
+#undef elektra_len16
+#undef elektra_len15
+#undef elektra_len14
+#undef elektra_len13
+#undef elektra_len12
+#undef elektra_len11
+#undef elektra_len10
+#undef elektra_len09
+#undef elektra_len08
+#undef elektra_len07
+#undef elektra_len06
+#undef elektra_len05
+#undef elektra_len04
+#undef elektra_len03
+#undef elektra_len02
+#undef elektra_len01
+#undef elektra_len00
+#undef elektra_len
+
+
+
+/**
+ * Snapshot of all keys of '/tests/script/gen/highlevel/snapshot' that don't contain `_` or `#`.
+ * Keys below other keys are stored in nested structs, e.g. 'server/port' in `server.port`.
+ * Use loadConfig() to fill it.
+ */// 
+typedef struct
+{
+	ElektraEnumColor color;
+	kdb_boolean_t print;
+	struct
+	{
+		const char * host;
+		kdb_unsigned_short_t port;
+		kdb_double_t timeout;
+	} server;
+} AppConfig;
+
+int loadConfiguration (Elektra ** elektra,
+				 int argc, const char * const * argv, const char * const * envp,
+				 
+				 ElektraError ** error);
+void printHelpMessage (Elektra * elektra, const char * usage, const char * prefix);
+void exitForSpecload (int argc, const char * const * argv);
+
+void loadConfig (Elektra * elektra, AppConfig * config);
+
+
+
+/**
+ * @param elektra The elektra instance initialized with loadConfiguration().
+ * @param tag     The tag to look up.
+ *
+ * @return The value stored at the given key.
+ *   The lifetime of returned pointers is documented in the ELEKTRA_GET(*) functions above.
+ */// 
+#define elektraGet(elektra, tag) ELEKTRA_GET (tag) (elektra)
+
+
+/**
+ * @param elektra The elektra instance initialized with loadConfiguration().
+ * @param tag     The tag to look up.
+ * @param ...     Variable arguments depending on the given tag.
+ *
+ * @return The value stored at the given key.
+ *   The lifetime of returned pointers is documented in the ELEKTRA_GET(*) functions above.
+ */// 
+#define elektraGetV(elektra, tag, ...) ELEKTRA_GET (tag) (elektra, __VA_ARGS__)
+
+
+/**
+ * @param elektra The elektra instance initialized with loadConfiguration().
+ * @param result  Points to the struct into which results will be stored.
+ *   The lifetime of pointers in this struct is documented in the ELEKTRA_GET(*) functions above.
+ * @param tag     The tag to look up.
+ */// 
+#define elektraFillStruct(elektra, result, tag) ELEKTRA_GET (tag) (elektra, result)
+
+
+/**
+ * @param elektra The elektra instance initialized with loadConfiguration().
+ * @param result  Points to the struct into which results will be stored.
+ *   The lifetime of pointers in this struct is documented in the ELEKTRA_GET(*) functions above.
+ * @param tag     The tag to look up.
+ * @param ...     Variable arguments depending on the given tag.
+ */// 
+#define elektraFillStructV(elektra, result, tag, ...) ELEKTRA_GET (tag) (elektra, result, __VA_ARGS__)
+
+
+/**
+ * @param elektra The elektra instance initialized with the loadConfiguration().
+ * @param tag     The tag to write to.
+ * @param value   The new value.
+ * @param error   Pass a reference to an ElektraError pointer.
+ */// 
+#define elektraSet(elektra, tag, value, error) ELEKTRA_SET (tag) (elektra, value, error)
+
+
+/**
+ * @param elektra The elektra instance initialized with the loadConfiguration().
+ * @param tag     The tag to write to.
+ * @param value   The new value.
+ * @param error   Pass a reference to an ElektraError pointer.
+ * @param ...     Variable arguments depending on the given tag.
+ */// 
+#define elektraSetV(elektra, tag, value, error, ...) ELEKTRA_SET (tag) (elektra, value, __VA_ARGS__, error)
+
+
+/**
+ * @param elektra The elektra instance initialized with loadConfiguration().
+ * @param tag     The array tag to look up.
+ *
+ * @return The size of the array below the given key.
+ */// 
+#define elektraSize(elektra, tag) ELEKTRA_SIZE (tag) (elektra)
+
+
+/**
+ * @param elektra The elektra instance initialized with loadConfiguration().
+ * @param tag     The array tag to look up.
+ * @param ...     Variable arguments depending on the given tag.
+ *
+ * @return The size of the array below the given key.
+ */// 
+#define elektraSizeV(elektra, tag, ...) ELEKTRA_SIZE (tag) (elektra, __VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SNAPSHOT_ACTUAL_H
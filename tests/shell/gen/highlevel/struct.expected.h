@@ -338,7 +338,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYOTHERSTRUCT) (Elektra * elektra, c
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_MYOTHERSTRUCT_X) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "myotherstruct/x");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (0, "myotherstruct/x", "long");
+	return ELEKTRA_GET_BY_HANDLE (Long) (elektra, &handle);
+	
 }
 
 
@@ -373,7 +375,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYOTHERSTRUCT_X) (Elektra * elektra,
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_MYOTHERSTRUCT_X_Y) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "myotherstruct/x/y");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (1, "myotherstruct/x/y", "long");
+	return ELEKTRA_GET_BY_HANDLE (Long) (elektra, &handle);
+	
 }
 
 
@@ -448,7 +452,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYSTRUCT) (Elektra * elektra, const
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_MYSTRUCT_A) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "mystruct/a");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (2, "mystruct/a", "string");
+	return ELEKTRA_GET_BY_HANDLE (String) (elektra, &handle);
+	
 }
 
 
@@ -483,7 +489,9 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYSTRUCT_A) (Elektra * elektra,
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_MYSTRUCT_B) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "mystruct/b");
+	static const ElektraKeyHandle handle = ELEKTRA_KEY_HANDLE_INIT (3, "mystruct/b", "long");
+	return ELEKTRA_GET_BY_HANDLE (Long) (elektra, &handle);
+	
 }
 
 